@@ -121,8 +121,9 @@ add_auth_data(rijndael_ctx *ctx, const unsigned char *msg, size_t la,
   rijndael_encrypt(ctx, B, X);
   
   while (la > DTLS_CCM_BLOCKSIZE) {
-    for (i = 0; i < DTLS_CCM_BLOCKSIZE; ++i)
-      B[i] = X[i] ^ *msg++;
+    memcpy(B, msg, DTLS_CCM_BLOCKSIZE);
+    memxor(B, X, DTLS_CCM_BLOCKSIZE);
+    msg += DTLS_CCM_BLOCKSIZE;
     la -= DTLS_CCM_BLOCKSIZE;
 
     rijndael_encrypt(ctx, B, X);
@@ -155,10 +156,8 @@ mac(rijndael_ctx *ctx,
     unsigned char *msg, size_t len,
     unsigned char B[DTLS_CCM_BLOCKSIZE],
     unsigned char X[DTLS_CCM_BLOCKSIZE]) {
-  size_t i;
-
-  for (i = 0; i < len; ++i)
-    B[i] = X[i] ^ msg[i];
+  memcpy(B, msg, len);
+  memxor(B, X, len);
 
   rijndael_encrypt(ctx, B, X);
 
@@ -169,7 +168,7 @@ dtls_ccm_encrypt_message(rijndael_ctx *ctx, size_t M, size_t L,
 			 unsigned char nonce[DTLS_CCM_BLOCKSIZE], 
 			 unsigned char *msg, size_t lm, 
 			 const unsigned char *aad, size_t la) {
-  size_t i, len;
+  size_t len;
   unsigned long counter_tmp;
   unsigned long counter = 1; /* \bug does not work correctly on ia32 when
 			             lm >= 2^16 */
@@ -222,8 +221,8 @@ dtls_ccm_encrypt_message(rijndael_ctx *ctx, size_t M, size_t L,
   SET_COUNTER(A, L, 0, counter_tmp);
   rijndael_encrypt(ctx, A, S);
 
-  for (i = 0; i < M; ++i)
-    *msg++ = X[i] ^ S[i];
+  memcpy(msg, X, M);
+  memxor(msg, S, M);
 
   return len + M;
 }
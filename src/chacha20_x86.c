@@ -0,0 +1,217 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2011, 2012, 2013, 2014, 2015 Olaf Bergmann (TZI) and others.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v. 1.0 which accompanies this distribution.
+ *
+ * The Eclipse Public License is available at http://www.eclipse.org/legal/epl-v10.html
+ * and the Eclipse Distribution License is available at
+ * http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ *******************************************************************************/
+
+/*
+ * ChaCha20 backends for x86, selected at run time by
+ * dtls_chacha20_select() (see chacha20poly1305.h):
+ *
+ * - AVX2: eight blocks at once. Each of the sixteen vectors holds one
+ *   word of the state of all eight blocks, so the rounds need no
+ *   shuffles. The rotations by 16 and 8 bits are byte shuffles.
+ *
+ * - SSE2: the same with four blocks and shifts for all rotations.
+ *
+ * At the end the words are transposed back into blocks with unpack
+ * instructions, four words of four blocks at a time. Both backends only
+ * process complete groups of blocks, the rest is left to the portable
+ * code of chacha20poly1305.c.
+ */
+
+#include "chacha20poly1305.h"
+
+#ifdef CHACHA20_X86
+
+#include <immintrin.h>
+
+int dtls_chacha20_x86_best(void) {
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return DTLS_CHACHA20_AVX2;
+  if (__builtin_cpu_supports("sse2"))
+    return DTLS_CHACHA20_SSE2;
+  return DTLS_CHACHA20_C;
+}
+
+/*** SSE2: ************************************************************/
+
+#define ROTL128(v, n)							\
+  _mm_or_si128(_mm_slli_epi32(v, n), _mm_srli_epi32(v, 32 - (n)))
+
+#define QR128(a, b, c, d) {						\
+    a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = ROTL128(d, 16); \
+    c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = ROTL128(b, 12); \
+    a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = ROTL128(d, 8); \
+    c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = ROTL128(b, 7); \
+  }
+
+/* words i to i + 3 of four blocks, xored into the message */
+__attribute__((target("sse2")))
+static inline void xor4_sse2(unsigned char *msg, __m128i a, __m128i b,
+			     __m128i c, __m128i d) {
+  __m128i t0, t1, t2, t3;
+
+  t0 = _mm_unpacklo_epi32(a, b);
+  t1 = _mm_unpacklo_epi32(c, d);
+  t2 = _mm_unpackhi_epi32(a, b);
+  t3 = _mm_unpackhi_epi32(c, d);
+  a = _mm_unpacklo_epi64(t0, t1);
+  b = _mm_unpackhi_epi64(t0, t1);
+  c = _mm_unpacklo_epi64(t2, t3);
+  d = _mm_unpackhi_epi64(t2, t3);
+
+  _mm_storeu_si128((__m128i *)msg, _mm_xor_si128(a,
+		   _mm_loadu_si128((const __m128i *)msg)));
+  _mm_storeu_si128((__m128i *)(msg + 64), _mm_xor_si128(b,
+		   _mm_loadu_si128((const __m128i *)(msg + 64))));
+  _mm_storeu_si128((__m128i *)(msg + 128), _mm_xor_si128(c,
+		   _mm_loadu_si128((const __m128i *)(msg + 128))));
+  _mm_storeu_si128((__m128i *)(msg + 192), _mm_xor_si128(d,
+		   _mm_loadu_si128((const __m128i *)(msg + 192))));
+}
+
+__attribute__((target("sse2")))
+static void chacha20_4blocks_sse2(uint32_t state[16], unsigned char *msg) {
+  __m128i x[16], s[16];
+  int i;
+
+  for (i = 0; i < 16; i++)
+    s[i] = _mm_set1_epi32(state[i]);
+  s[12] = _mm_add_epi32(s[12], _mm_set_epi32(3, 2, 1, 0));
+  for (i = 0; i < 16; i++)
+    x[i] = s[i];
+
+  for (i = 0; i < 10; i++) {
+    QR128(x[0], x[4], x[8], x[12]);
+    QR128(x[1], x[5], x[9], x[13]);
+    QR128(x[2], x[6], x[10], x[14]);
+    QR128(x[3], x[7], x[11], x[15]);
+    QR128(x[0], x[5], x[10], x[15]);
+    QR128(x[1], x[6], x[11], x[12]);
+    QR128(x[2], x[7], x[8], x[13]);
+    QR128(x[3], x[4], x[9], x[14]);
+  }
+
+  for (i = 0; i < 16; i++)
+    x[i] = _mm_add_epi32(x[i], s[i]);
+  for (i = 0; i < 16; i += 4)
+    xor4_sse2(msg + 4 * i, x[i], x[i + 1], x[i + 2], x[i + 3]);
+  state[12] += 4;
+}
+
+/*** AVX2: ************************************************************/
+
+#define ROTL256(v, n)							\
+  _mm256_or_si256(_mm256_slli_epi32(v, n), _mm256_srli_epi32(v, 32 - (n)))
+
+#define QR256(a, b, c, d) {						\
+    a = _mm256_add_epi32(a, b); d = _mm256_xor_si256(d, a);		\
+    d = _mm256_shuffle_epi8(d, rot16);					\
+    c = _mm256_add_epi32(c, d); b = _mm256_xor_si256(b, c);		\
+    b = ROTL256(b, 12);							\
+    a = _mm256_add_epi32(a, b); d = _mm256_xor_si256(d, a);		\
+    d = _mm256_shuffle_epi8(d, rot8);					\
+    c = _mm256_add_epi32(c, d); b = _mm256_xor_si256(b, c);		\
+    b = ROTL256(b, 7);							\
+  }
+
+/* transposes words i to i + 3 of blocks k and k + 4 into the 128-bit
+ * halves of a, b, c and d (blocks 0 to 3 in the low halves) */
+__attribute__((target("avx2")))
+static inline void transpose4_avx2(__m256i *a, __m256i *b,
+				   __m256i *c, __m256i *d) {
+  __m256i t0, t1, t2, t3;
+
+  t0 = _mm256_unpacklo_epi32(*a, *b);
+  t1 = _mm256_unpacklo_epi32(*c, *d);
+  t2 = _mm256_unpackhi_epi32(*a, *b);
+  t3 = _mm256_unpackhi_epi32(*c, *d);
+  *a = _mm256_unpacklo_epi64(t0, t1);
+  *b = _mm256_unpackhi_epi64(t0, t1);
+  *c = _mm256_unpacklo_epi64(t2, t3);
+  *d = _mm256_unpackhi_epi64(t2, t3);
+}
+
+__attribute__((target("avx2")))
+static inline void xor32_avx2(unsigned char *msg, __m256i v) {
+  _mm256_storeu_si256((__m256i *)msg, _mm256_xor_si256(v,
+		      _mm256_loadu_si256((const __m256i *)msg)));
+}
+
+__attribute__((target("avx2")))
+static void chacha20_8blocks_avx2(uint32_t state[16], unsigned char *msg) {
+  const __m256i rot16 = _mm256_set_epi8(13, 12, 15, 14, 9, 8, 11, 10,
+					5, 4, 7, 6, 1, 0, 3, 2,
+					13, 12, 15, 14, 9, 8, 11, 10,
+					5, 4, 7, 6, 1, 0, 3, 2);
+  const __m256i rot8 = _mm256_set_epi8(14, 13, 12, 15, 10, 9, 8, 11,
+				       6, 5, 4, 7, 2, 1, 0, 3,
+				       14, 13, 12, 15, 10, 9, 8, 11,
+				       6, 5, 4, 7, 2, 1, 0, 3);
+  __m256i x[16], s[16];
+  int i, k;
+
+  for (i = 0; i < 16; i++)
+    s[i] = _mm256_set1_epi32(state[i]);
+  s[12] = _mm256_add_epi32(s[12], _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+  for (i = 0; i < 16; i++)
+    x[i] = s[i];
+
+  for (i = 0; i < 10; i++) {
+    QR256(x[0], x[4], x[8], x[12]);
+    QR256(x[1], x[5], x[9], x[13]);
+    QR256(x[2], x[6], x[10], x[14]);
+    QR256(x[3], x[7], x[11], x[15]);
+    QR256(x[0], x[5], x[10], x[15]);
+    QR256(x[1], x[6], x[11], x[12]);
+    QR256(x[2], x[7], x[8], x[13]);
+    QR256(x[3], x[4], x[9], x[14]);
+  }
+
+  for (i = 0; i < 16; i++)
+    x[i] = _mm256_add_epi32(x[i], s[i]);
+  for (i = 0; i < 16; i += 4)
+    transpose4_avx2(&x[i], &x[i + 1], &x[i + 2], &x[i + 3]);
+
+  /* x[i + k] holds words i to i + 3 of blocks k and k + 4; words 0-7
+   * and 8-15 of a block are written with one 32-byte access each */
+  for (k = 0; k < 4; k++) {
+    xor32_avx2(msg + 64 * k,
+	       _mm256_permute2x128_si256(x[k], x[4 + k], 0x20));
+    xor32_avx2(msg + 64 * k + 32,
+	       _mm256_permute2x128_si256(x[8 + k], x[12 + k], 0x20));
+    xor32_avx2(msg + 64 * (k + 4),
+	       _mm256_permute2x128_si256(x[k], x[4 + k], 0x31));
+    xor32_avx2(msg + 64 * (k + 4) + 32,
+	       _mm256_permute2x128_si256(x[8 + k], x[12 + k], 0x31));
+  }
+  state[12] += 8;
+}
+
+/*** Interface of chacha20poly1305.c: *********************************/
+
+size_t dtls_chacha20_blocks_x86(int impl, uint32_t state[16],
+				unsigned char *msg, size_t len) {
+  size_t done = 0;
+
+  if (impl == DTLS_CHACHA20_AVX2) {
+    for (; len - done >= 8 * DTLS_CHACHA20_BLOCKSIZE;
+	 done += 8 * DTLS_CHACHA20_BLOCKSIZE)
+      chacha20_8blocks_avx2(state, msg + done);
+  }
+  for (; len - done >= 4 * DTLS_CHACHA20_BLOCKSIZE;
+       done += 4 * DTLS_CHACHA20_BLOCKSIZE)
+    chacha20_4blocks_sse2(state, msg + done);
+  return done;
+}
+
+#endif /* CHACHA20_X86 */
@@ -0,0 +1,466 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2011, 2012, 2013, 2014, 2015 Olaf Bergmann (TZI) and others.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v. 1.0 which accompanies this distribution.
+ *
+ * The Eclipse Public License is available at http://www.eclipse.org/legal/epl-v10.html
+ * and the Eclipse Distribution License is available at
+ * http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ *******************************************************************************/
+
+/*
+ * ChaCha20-Poly1305 as used by the cipher suites of RFC 7905. Neither
+ * algorithm uses tables or branches on secret data, so both run in
+ * constant time without hardware support.
+ *
+ * Poly1305 keeps the accumulator in three limbs of 44, 44 and 42 bits
+ * where the compiler has a 128-bit integer type (64-bit targets), and
+ * in five limbs of 26 bits otherwise, so that the products of the limbs
+ * fit into the widest multiplication the CPU has.
+ */
+
+#include <string.h>
+
+#include "tinydtls.h"
+#include "chacha20poly1305.h"
+
+/*** ChaCha20: ********************************************************/
+
+static int chacha20_impl = -1;
+
+int
+dtls_chacha20_select(int impl) {
+  int best = DTLS_CHACHA20_C;
+
+#ifdef CHACHA20_X86
+  best = dtls_chacha20_x86_best();
+#endif /* CHACHA20_X86 */
+  if (impl > best || impl < DTLS_CHACHA20_C)
+    impl = best;
+
+  chacha20_impl = impl;
+  return impl;
+}
+
+static inline uint32_t
+get_le32(const unsigned char *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8)
+    | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void
+put_le32(unsigned char *p, uint32_t v) {
+  p[0] = v & 0xff;
+  p[1] = (v >> 8) & 0xff;
+  p[2] = (v >> 16) & 0xff;
+  p[3] = v >> 24;
+}
+
+#define ROTL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define QUARTERROUND(x, a, b, c, d) {					\
+    x[a] += x[b]; x[d] ^= x[a]; x[d] = ROTL32(x[d], 16);		\
+    x[c] += x[d]; x[b] ^= x[c]; x[b] = ROTL32(x[b], 12);		\
+    x[a] += x[b]; x[d] ^= x[a]; x[d] = ROTL32(x[d], 8);			\
+    x[c] += x[d]; x[b] ^= x[c]; x[b] = ROTL32(x[b], 7);			\
+  }
+
+/** One block of key stream for @p state, which is then incremented. */
+static void
+chacha20_block(uint32_t state[16], unsigned char out[DTLS_CHACHA20_BLOCKSIZE]) {
+  uint32_t x[16];
+  int i;
+
+  memcpy(x, state, sizeof(x));
+  for (i = 0; i < 10; i++) {
+    QUARTERROUND(x, 0, 4, 8, 12);
+    QUARTERROUND(x, 1, 5, 9, 13);
+    QUARTERROUND(x, 2, 6, 10, 14);
+    QUARTERROUND(x, 3, 7, 11, 15);
+    QUARTERROUND(x, 0, 5, 10, 15);
+    QUARTERROUND(x, 1, 6, 11, 12);
+    QUARTERROUND(x, 2, 7, 8, 13);
+    QUARTERROUND(x, 3, 4, 9, 14);
+  }
+  for (i = 0; i < 16; i++)
+    put_le32(out + 4 * i, x[i] + state[i]);
+  state[12]++;
+
+  memset(x, 0, sizeof(x));
+}
+
+void
+dtls_chacha20(const unsigned char key[DTLS_CHACHA20_KEY_SIZE],
+	      const unsigned char nonce[DTLS_CHACHA20_NONCE_SIZE],
+	      uint32_t counter, unsigned char *msg, size_t len) {
+  uint32_t state[16];
+  unsigned char ks[DTLS_CHACHA20_BLOCKSIZE];
+  size_t i, n;
+
+  if (chacha20_impl < 0)
+    dtls_chacha20_select(DTLS_CHACHA20_BEST);
+
+  /* "expand 32-byte k" */
+  state[0] = 0x61707865;
+  state[1] = 0x3320646e;
+  state[2] = 0x79622d32;
+  state[3] = 0x6b206574;
+  for (i = 0; i < 8; i++)
+    state[4 + i] = get_le32(key + 4 * i);
+  state[12] = counter;
+  for (i = 0; i < 3; i++)
+    state[13 + i] = get_le32(nonce + 4 * i);
+
+#ifdef CHACHA20_X86
+  if (chacha20_impl != DTLS_CHACHA20_C) {
+    /* complete groups of four or eight blocks */
+    n = dtls_chacha20_blocks_x86(chacha20_impl, state, msg, len);
+    msg += n;
+    len -= n;
+  }
+#endif /* CHACHA20_X86 */
+
+  while (len > 0) {
+    chacha20_block(state, ks);
+    n = len < DTLS_CHACHA20_BLOCKSIZE ? len : DTLS_CHACHA20_BLOCKSIZE;
+    for (i = 0; i < n; i++)
+      msg[i] ^= ks[i];
+    msg += n;
+    len -= n;
+  }
+
+  memset(state, 0, sizeof(state));
+  memset(ks, 0, sizeof(ks));
+}
+
+/*** Poly1305: ********************************************************/
+
+#ifdef POLY1305_64BIT
+__extension__ typedef unsigned __int128 poly1305_u128;
+
+#define MASK44 0xfffffffffffULL
+#define MASK42 0x3ffffffffffULL
+
+static inline uint64_t
+get_le64(const unsigned char *p) {
+  return (uint64_t)get_le32(p) | ((uint64_t)get_le32(p + 4) << 32);
+}
+
+void
+dtls_poly1305_init(dtls_poly1305_ctx *ctx,
+		   const unsigned char key[DTLS_POLY1305_KEY_SIZE]) {
+  uint64_t t0 = get_le64(key), t1 = get_le64(key + 8);
+  int i;
+
+  /* r is clamped as required by RFC 8439 */
+  ctx->r[0] = t0 & 0xffc0fffffffULL;
+  ctx->r[1] = ((t0 >> 44) | (t1 << 20)) & 0xfffffc0ffffULL;
+  ctx->r[2] = (t1 >> 24) & 0x00ffffffc0fULL;
+  ctx->h[0] = ctx->h[1] = ctx->h[2] = 0;
+  for (i = 0; i < 4; i++)
+    ctx->pad[i] = get_le32(key + 16 + 4 * i);
+  ctx->used = 0;
+}
+
+/** h = (h + m) * r for complete blocks, @p hibit is 2^128 except for
+ * the padded last block. */
+static void
+poly1305_blocks(dtls_poly1305_ctx *ctx, const unsigned char *m, size_t len,
+		uint64_t hibit) {
+  const uint64_t r0 = ctx->r[0], r1 = ctx->r[1], r2 = ctx->r[2];
+  const uint64_t s1 = r1 * (5 << 2), s2 = r2 * (5 << 2);
+  uint64_t h0 = ctx->h[0], h1 = ctx->h[1], h2 = ctx->h[2];
+  uint64_t t0, t1, c;
+  poly1305_u128 d0, d1, d2;
+
+  for (; len >= 16; len -= 16, m += 16) {
+    t0 = get_le64(m);
+    t1 = get_le64(m + 8);
+    h0 += t0 & MASK44;
+    h1 += ((t0 >> 44) | (t1 << 20)) & MASK44;
+    h2 += ((t1 >> 24) & MASK42) | (hibit << 40);
+
+    d0 = (poly1305_u128)h0 * r0 + (poly1305_u128)h1 * s2
+      + (poly1305_u128)h2 * s1;
+    d1 = (poly1305_u128)h0 * r1 + (poly1305_u128)h1 * r0
+      + (poly1305_u128)h2 * s2;
+    d2 = (poly1305_u128)h0 * r2 + (poly1305_u128)h1 * r1
+      + (poly1305_u128)h2 * r0;
+
+    /* partial reduction modulo 2^130 - 5 */
+    c = (uint64_t)(d0 >> 44);
+    h0 = (uint64_t)d0 & MASK44;
+    d1 += c;
+    c = (uint64_t)(d1 >> 44);
+    h1 = (uint64_t)d1 & MASK44;
+    d2 += c;
+    c = (uint64_t)(d2 >> 42);
+    h2 = (uint64_t)d2 & MASK42;
+    h0 += c * 5;
+    c = h0 >> 44;
+    h0 &= MASK44;
+    h1 += c;
+  }
+
+  ctx->h[0] = h0;
+  ctx->h[1] = h1;
+  ctx->h[2] = h2;
+}
+
+/** Writes h + s to @p tag. */
+static void
+poly1305_result(dtls_poly1305_ctx *ctx, unsigned char tag[DTLS_POLY1305_TAG_SIZE]) {
+  uint64_t h0 = ctx->h[0], h1 = ctx->h[1], h2 = ctx->h[2];
+  uint64_t g0, g1, g2, c, mask, t0, t1;
+
+  /* full carry */
+  c = h1 >> 44; h1 &= MASK44; h2 += c;
+  c = h2 >> 42; h2 &= MASK42; h0 += c * 5;
+  c = h0 >> 44; h0 &= MASK44; h1 += c;
+  c = h1 >> 44; h1 &= MASK44; h2 += c;
+  c = h2 >> 42; h2 &= MASK42; h0 += c * 5;
+  c = h0 >> 44; h0 &= MASK44; h1 += c;
+
+  /* h - p = h + 5 - 2^130, used if it is not negative */
+  g0 = h0 + 5; c = g0 >> 44; g0 &= MASK44;
+  g1 = h1 + c; c = g1 >> 44; g1 &= MASK44;
+  g2 = h2 + c - (1ULL << 42);
+  mask = (g2 >> 63) - 1;
+  h0 = (h0 & ~mask) | (g0 & mask);
+  h1 = (h1 & ~mask) | (g1 & mask);
+  h2 = (h2 & ~mask) | (g2 & mask);
+
+  /* h + s mod 2^128 */
+  t0 = (uint64_t)ctx->pad[0] | ((uint64_t)ctx->pad[1] << 32);
+  t1 = (uint64_t)ctx->pad[2] | ((uint64_t)ctx->pad[3] << 32);
+  h0 += t0 & MASK44; c = h0 >> 44; h0 &= MASK44;
+  h1 += (((t0 >> 44) | (t1 << 20)) & MASK44) + c; c = h1 >> 44; h1 &= MASK44;
+  h2 += ((t1 >> 24) & MASK42) + c;
+
+  h0 = h0 | (h1 << 44);
+  h1 = (h1 >> 20) | (h2 << 24);
+  put_le32(tag, h0 & 0xffffffff);
+  put_le32(tag + 4, h0 >> 32);
+  put_le32(tag + 8, h1 & 0xffffffff);
+  put_le32(tag + 12, h1 >> 32);
+}
+
+#else /* POLY1305_64BIT */
+
+#define MASK26 0x3ffffff
+
+void
+dtls_poly1305_init(dtls_poly1305_ctx *ctx,
+		   const unsigned char key[DTLS_POLY1305_KEY_SIZE]) {
+  int i;
+
+  /* r is clamped as required by RFC 8439 */
+  ctx->r[0] = get_le32(key) & 0x3ffffff;
+  ctx->r[1] = (get_le32(key + 3) >> 2) & 0x3ffff03;
+  ctx->r[2] = (get_le32(key + 6) >> 4) & 0x3ffc0ff;
+  ctx->r[3] = (get_le32(key + 9) >> 6) & 0x3f03fff;
+  ctx->r[4] = (get_le32(key + 12) >> 8) & 0x00fffff;
+  for (i = 0; i < 5; i++)
+    ctx->h[i] = 0;
+  for (i = 0; i < 4; i++)
+    ctx->pad[i] = get_le32(key + 16 + 4 * i);
+  ctx->used = 0;
+}
+
+/** h = (h + m) * r for complete blocks, @p hibit is 2^128 except for
+ * the padded last block. */
+static void
+poly1305_blocks(dtls_poly1305_ctx *ctx, const unsigned char *m, size_t len,
+		uint32_t hibit) {
+  const uint32_t r0 = ctx->r[0], r1 = ctx->r[1], r2 = ctx->r[2];
+  const uint32_t r3 = ctx->r[3], r4 = ctx->r[4];
+  const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+  uint32_t h0 = ctx->h[0], h1 = ctx->h[1], h2 = ctx->h[2];
+  uint32_t h3 = ctx->h[3], h4 = ctx->h[4], c;
+  uint64_t d0, d1, d2, d3, d4;
+
+  for (; len >= 16; len -= 16, m += 16) {
+    h0 += get_le32(m) & MASK26;
+    h1 += (get_le32(m + 3) >> 2) & MASK26;
+    h2 += (get_le32(m + 6) >> 4) & MASK26;
+    h3 += (get_le32(m + 9) >> 6) & MASK26;
+    h4 += (get_le32(m + 12) >> 8) | (hibit << 24);
+
+    d0 = (uint64_t)h0 * r0 + (uint64_t)h1 * s4 + (uint64_t)h2 * s3
+      + (uint64_t)h3 * s2 + (uint64_t)h4 * s1;
+    d1 = (uint64_t)h0 * r1 + (uint64_t)h1 * r0 + (uint64_t)h2 * s4
+      + (uint64_t)h3 * s3 + (uint64_t)h4 * s2;
+    d2 = (uint64_t)h0 * r2 + (uint64_t)h1 * r1 + (uint64_t)h2 * r0
+      + (uint64_t)h3 * s4 + (uint64_t)h4 * s3;
+    d3 = (uint64_t)h0 * r3 + (uint64_t)h1 * r2 + (uint64_t)h2 * r1
+      + (uint64_t)h3 * r0 + (uint64_t)h4 * s4;
+    d4 = (uint64_t)h0 * r4 + (uint64_t)h1 * r3 + (uint64_t)h2 * r2
+      + (uint64_t)h3 * r1 + (uint64_t)h4 * r0;
+
+    /* partial reduction modulo 2^130 - 5 */
+    c = (uint32_t)(d0 >> 26); h0 = (uint32_t)d0 & MASK26; d1 += c;
+    c = (uint32_t)(d1 >> 26); h1 = (uint32_t)d1 & MASK26; d2 += c;
+    c = (uint32_t)(d2 >> 26); h2 = (uint32_t)d2 & MASK26; d3 += c;
+    c = (uint32_t)(d3 >> 26); h3 = (uint32_t)d3 & MASK26; d4 += c;
+    c = (uint32_t)(d4 >> 26); h4 = (uint32_t)d4 & MASK26;
+    h0 += c * 5;
+    c = h0 >> 26;
+    h0 &= MASK26;
+    h1 += c;
+  }
+
+  ctx->h[0] = h0;
+  ctx->h[1] = h1;
+  ctx->h[2] = h2;
+  ctx->h[3] = h3;
+  ctx->h[4] = h4;
+}
+
+/** Writes h + s to @p tag. */
+static void
+poly1305_result(dtls_poly1305_ctx *ctx, unsigned char tag[DTLS_POLY1305_TAG_SIZE]) {
+  uint32_t h0 = ctx->h[0], h1 = ctx->h[1], h2 = ctx->h[2];
+  uint32_t h3 = ctx->h[3], h4 = ctx->h[4];
+  uint32_t g0, g1, g2, g3, g4, c, mask;
+  uint64_t f;
+
+  /* full carry */
+  c = h1 >> 26; h1 &= MASK26; h2 += c;
+  c = h2 >> 26; h2 &= MASK26; h3 += c;
+  c = h3 >> 26; h3 &= MASK26; h4 += c;
+  c = h4 >> 26; h4 &= MASK26; h0 += c * 5;
+  c = h0 >> 26; h0 &= MASK26; h1 += c;
+
+  /* h - p = h + 5 - 2^130, used if it is not negative */
+  g0 = h0 + 5; c = g0 >> 26; g0 &= MASK26;
+  g1 = h1 + c; c = g1 >> 26; g1 &= MASK26;
+  g2 = h2 + c; c = g2 >> 26; g2 &= MASK26;
+  g3 = h3 + c; c = g3 >> 26; g3 &= MASK26;
+  g4 = h4 + c - (1UL << 26);
+  mask = (g4 >> 31) - 1;
+  h0 = (h0 & ~mask) | (g0 & mask);
+  h1 = (h1 & ~mask) | (g1 & mask);
+  h2 = (h2 & ~mask) | (g2 & mask);
+  h3 = (h3 & ~mask) | (g3 & mask);
+  h4 = (h4 & ~mask) | (g4 & mask);
+
+  /* h + s mod 2^128 */
+  h0 = h0 | (h1 << 26);
+  h1 = (h1 >> 6) | (h2 << 20);
+  h2 = (h2 >> 12) | (h3 << 14);
+  h3 = (h3 >> 18) | (h4 << 8);
+  f = (uint64_t)h0 + ctx->pad[0];
+  put_le32(tag, (uint32_t)f);
+  f = (uint64_t)h1 + ctx->pad[1] + (f >> 32);
+  put_le32(tag + 4, (uint32_t)f);
+  f = (uint64_t)h2 + ctx->pad[2] + (f >> 32);
+  put_le32(tag + 8, (uint32_t)f);
+  f = (uint64_t)h3 + ctx->pad[3] + (f >> 32);
+  put_le32(tag + 12, (uint32_t)f);
+}
+#endif /* POLY1305_64BIT */
+
+void
+dtls_poly1305_update(dtls_poly1305_ctx *ctx,
+		     const unsigned char *data, size_t len) {
+  size_t n;
+
+  if (ctx->used > 0) {
+    n = 16 - ctx->used;
+    if (n > len)
+      n = len;
+    memcpy(ctx->buf + ctx->used, data, n);
+    ctx->used += n;
+    data += n;
+    len -= n;
+    if (ctx->used < 16)
+      return;
+    poly1305_blocks(ctx, ctx->buf, 16, 1);
+    ctx->used = 0;
+  }
+
+  n = len & ~(size_t)15;
+  poly1305_blocks(ctx, data, n, 1);
+  memcpy(ctx->buf, data + n, len - n);
+  ctx->used = len - n;
+}
+
+void
+dtls_poly1305_finish(dtls_poly1305_ctx *ctx,
+		     unsigned char tag[DTLS_POLY1305_TAG_SIZE]) {
+  if (ctx->used > 0) {
+    /* the last block is padded with a one and zeros */
+    ctx->buf[ctx->used++] = 1;
+    memset(ctx->buf + ctx->used, 0, 16 - ctx->used);
+    poly1305_blocks(ctx, ctx->buf, 16, 0);
+  }
+  poly1305_result(ctx, tag);
+  memset(ctx, 0, sizeof(*ctx));
+}
+
+/*** AEAD_CHACHA20_POLY1305: ******************************************/
+
+static void
+chacha20_poly1305_tag(const unsigned char key[DTLS_CHACHA20_KEY_SIZE],
+		      const unsigned char nonce[DTLS_CHACHA20_NONCE_SIZE],
+		      const unsigned char *c, size_t lc,
+		      const unsigned char *aad, size_t la,
+		      unsigned char tag[DTLS_POLY1305_TAG_SIZE]) {
+  static const unsigned char zeros[16] = { 0 };
+  unsigned char otk[DTLS_CHACHA20_BLOCKSIZE], lengths[16];
+  dtls_poly1305_ctx poly;
+
+  /* the one-time key is the first half of key stream block 0 */
+  memset(otk, 0, sizeof(otk));
+  dtls_chacha20(key, nonce, 0, otk, sizeof(otk));
+  dtls_poly1305_init(&poly, otk);
+  memset(otk, 0, sizeof(otk));
+
+  dtls_poly1305_update(&poly, aad, la);
+  dtls_poly1305_update(&poly, zeros, (16 - la % 16) % 16);
+  dtls_poly1305_update(&poly, c, lc);
+  dtls_poly1305_update(&poly, zeros, (16 - lc % 16) % 16);
+  put_le32(lengths, (uint32_t)la);
+  put_le32(lengths + 4, (uint32_t)((uint64_t)la >> 32));
+  put_le32(lengths + 8, (uint32_t)lc);
+  put_le32(lengths + 12, (uint32_t)((uint64_t)lc >> 32));
+  dtls_poly1305_update(&poly, lengths, sizeof(lengths));
+  dtls_poly1305_finish(&poly, tag);
+}
+
+long int
+dtls_chacha20_poly1305_encrypt_message(const unsigned char key[DTLS_CHACHA20_KEY_SIZE],
+				       const unsigned char nonce[DTLS_CHACHA20_NONCE_SIZE],
+				       unsigned char *msg, size_t lm,
+				       const unsigned char *aad, size_t la) {
+  dtls_chacha20(key, nonce, 1, msg, lm);
+  chacha20_poly1305_tag(key, nonce, msg, lm, aad, la, msg + lm);
+  return lm + DTLS_POLY1305_TAG_SIZE;
+}
+
+long int
+dtls_chacha20_poly1305_decrypt_message(const unsigned char key[DTLS_CHACHA20_KEY_SIZE],
+				       const unsigned char nonce[DTLS_CHACHA20_NONCE_SIZE],
+				       unsigned char *msg, size_t lm,
+				       const unsigned char *aad, size_t la) {
+  unsigned char tag[DTLS_POLY1305_TAG_SIZE];
+  unsigned char diff = 0;
+  int i;
+
+  if (lm < DTLS_POLY1305_TAG_SIZE)
+    return -1;
+  lm -= DTLS_POLY1305_TAG_SIZE;
+
+  /* the ciphertext is authenticated before it is decrypted */
+  chacha20_poly1305_tag(key, nonce, msg, lm, aad, la, tag);
+  for (i = 0; i < DTLS_POLY1305_TAG_SIZE; i++)
+    diff |= tag[i] ^ msg[lm + i];
+  if (diff != 0)
+    return -1;
+
+  dtls_chacha20(key, nonce, 1, msg, lm);
+  return lm;
+}
@@ -0,0 +1,134 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2011, 2012, 2013, 2014, 2015 Olaf Bergmann (TZI) and others.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v. 1.0 which accompanies this distribution.
+ *
+ * The Eclipse Public License is available at http://www.eclipse.org/legal/epl-v10.html
+ * and the Eclipse Distribution License is available at
+ * http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ *******************************************************************************/
+
+#ifndef _DTLS_CHACHA20POLY1305_H_
+#define _DTLS_CHACHA20POLY1305_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* implementation of ChaCha20 and Poly1305, RFC 8439 */
+
+#define DTLS_CHACHA20_KEY_SIZE   32 /**< size of the ChaCha20 key */
+#define DTLS_CHACHA20_NONCE_SIZE 12 /**< size of the nonce */
+#define DTLS_CHACHA20_BLOCKSIZE  64 /**< size of a ChaCha20 block */
+#define DTLS_POLY1305_KEY_SIZE   32 /**< size of the one-time key */
+#define DTLS_POLY1305_TAG_SIZE   16 /**< size of the authentication tag */
+
+/*
+ * With GCC or Clang on x86, ChaCha20 computes eight blocks at once with
+ * AVX2 or four blocks with SSE2, otherwise one block after the other.
+ * dtls_chacha20_select() chooses the implementation, e.g. to compare
+ * them; by default the best one the CPU supports is used.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CHACHA20_X86
+#endif
+#define DTLS_CHACHA20_C		0
+#define DTLS_CHACHA20_SSE2	1
+#define DTLS_CHACHA20_AVX2	2
+#define DTLS_CHACHA20_BEST	3
+
+/**
+ * Selects the ChaCha20 implementation. Returns the selected
+ * implementation, which is @p impl or the best one available if that
+ * is not supported.
+ */
+int dtls_chacha20_select(int impl);
+
+#ifdef CHACHA20_X86
+/* the backend of chacha20_x86.c, used by chacha20poly1305.c */
+int dtls_chacha20_x86_best(void);
+size_t dtls_chacha20_blocks_x86(int impl, uint32_t state[16],
+				unsigned char *msg, size_t len);
+#endif /* CHACHA20_X86 */
+
+/**
+ * Encrypts or decrypts @p len bytes at @p msg in place with the
+ * ChaCha20 key stream that starts at block @p counter.
+ */
+void dtls_chacha20(const unsigned char key[DTLS_CHACHA20_KEY_SIZE],
+		   const unsigned char nonce[DTLS_CHACHA20_NONCE_SIZE],
+		   uint32_t counter, unsigned char *msg, size_t len);
+
+/**
+ * Poly1305 works on 44-bit limbs where the compiler has 128-bit
+ * integers, and on 26-bit limbs otherwise. Define
+ * POLY1305_FORCE_32BIT to test the latter on a 64-bit host.
+ */
+#if defined(__SIZEOF_INT128__) && !defined(POLY1305_FORCE_32BIT)
+#define POLY1305_64BIT
+#endif
+
+/** State of a Poly1305 computation. */
+typedef struct {
+#ifdef POLY1305_64BIT
+  uint64_t r[3], h[3];		/**< key and accumulator, 44-bit limbs */
+#else /* POLY1305_64BIT */
+  uint32_t r[5], h[5];		/**< key and accumulator, 26-bit limbs */
+#endif /* POLY1305_64BIT */
+  uint32_t pad[4];		/**< s, added at the end */
+  unsigned char buf[16];	/**< incomplete block */
+  size_t used;			/**< bytes in buf */
+} dtls_poly1305_ctx;
+
+/** Starts a Poly1305 computation with the one-time key @p key. */
+void dtls_poly1305_init(dtls_poly1305_ctx *ctx,
+			const unsigned char key[DTLS_POLY1305_KEY_SIZE]);
+
+/** Adds @p len bytes of @p data to the message. */
+void dtls_poly1305_update(dtls_poly1305_ctx *ctx,
+			  const unsigned char *data, size_t len);
+
+/** Writes the tag to @p tag and erases @p ctx. */
+void dtls_poly1305_finish(dtls_poly1305_ctx *ctx,
+			  unsigned char tag[DTLS_POLY1305_TAG_SIZE]);
+
+/**
+ * Authenticates and encrypts a message with the AEAD_CHACHA20_POLY1305
+ * construction of RFC 8439.
+ *
+ * \param key   The key of \c DTLS_CHACHA20_KEY_SIZE bytes.
+ * \param nonce The nonce of \c DTLS_CHACHA20_NONCE_SIZE bytes.
+ * \param msg   The message to encrypt in place. The tag of \c
+ *              DTLS_POLY1305_TAG_SIZE bytes is appended, so the buffer
+ *              must be at least \p lm + \c DTLS_POLY1305_TAG_SIZE bytes
+ *              large.
+ * \param lm    The length of \p msg.
+ * \param aad   The additional authentication data (can be \c NULL if
+ *              \p la is zero).
+ * \param la    The number of additional authentication octets.
+ * \return The length of the ciphertext including the tag.
+ */
+long int
+dtls_chacha20_poly1305_encrypt_message(const unsigned char key[DTLS_CHACHA20_KEY_SIZE],
+				       const unsigned char nonce[DTLS_CHACHA20_NONCE_SIZE],
+				       unsigned char *msg, size_t lm,
+				       const unsigned char *aad, size_t la);
+
+/**
+ * Verifies and decrypts a message that has been encrypted with
+ * dtls_chacha20_poly1305_encrypt_message(). \p msg is ciphertext
+ * followed by the tag and is decrypted in place, after the tag has
+ * been verified.
+ *
+ * \return The length of the cleartext, or -1 if the tag is not valid.
+ *         \p msg is left unchanged in that case.
+ */
+long int
+dtls_chacha20_poly1305_decrypt_message(const unsigned char key[DTLS_CHACHA20_KEY_SIZE],
+				       const unsigned char nonce[DTLS_CHACHA20_NONCE_SIZE],
+				       unsigned char *msg, size_t lm,
+				       const unsigned char *aad, size_t la);
+
+#endif /* _DTLS_CHACHA20POLY1305_H_ */
@@ -32,21 +32,104 @@
 #include "crypto.h"
 #include "ccm.h"
 #include "ecc/ecc.h"
+#include "ecc/curve25519.h"
 #include "prng.h"
 #include "netq.h"
 
 #ifndef WITH_CONTIKI
 #include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
 #endif
 
 #define HMAC_UPDATE_SEED(Context,Seed,Length)		\
-  if (Seed) dtls_hmac_update(Context, (Seed), (Length))
+  if (Seed) dtls_hash_update(Context, (Seed), (Length))
 
 static struct dtls_cipher_context_t cipher_context;
 #ifndef WITH_CONTIKI
 static pthread_mutex_t cipher_context_mutex = PTHREAD_MUTEX_INITIALIZER;
 #endif
 
+#ifdef DTLS_ECC
+/** Signatures queued with dtls_ecdsa_batch_add(). */
+static struct {
+  uint8_t count;
+  dtls_handshake_parameters_t *handshake[DTLS_ECDSA_BATCH_SIZE];
+  ecc_point_table_t table[DTLS_ECDSA_BATCH_SIZE];
+  uint32_t hash[DTLS_ECDSA_BATCH_SIZE * 8];
+  uint32_t point_r[DTLS_ECDSA_BATCH_SIZE * 8];
+  uint32_t point_s[DTLS_ECDSA_BATCH_SIZE * 8];
+} ecdsa_batch;
+#ifndef WITH_CONTIKI
+static pthread_mutex_t ecdsa_batch_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t ecdsa_batch_once = PTHREAD_ONCE_INIT;
+#endif
+
+static void dtls_ecdsa_batch_remove(dtls_handshake_parameters_t *handshake);
+
+/**
+ * Precomputed part of the RFC 6979 nonce derivation for the last
+ * private key that signed: the inner hash of step d has consumed
+ * ipad || V || 0x00 || x[0..30], exactly two blocks that depend on
+ * the key only. The key itself is not kept, only its SHA-256 hash.
+ */
+static struct {
+  int valid;
+  unsigned char key_hash[DTLS_HMAC_DIGEST_SIZE]; /**< SHA-256 of the key */
+  dtls_hmac_key_t k0;		/**< HMAC with the all-zero key of step c */
+  dtls_hash_ctx step_d;		/**< inner state of step d */
+} rfc6979_cache;
+#ifndef WITH_CONTIKI
+static pthread_mutex_t rfc6979_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t rfc6979_cache_once = PTHREAD_ONCE_INIT;
+#endif
+
+#if DTLS_ECDSA_SIGN_POOL_SIZE > 0
+/** Nonces computed in advance, see dtls_ecdsa_sign_pool_configure(). */
+static struct {
+  int bound;			/**< key_hash is set */
+  unsigned char key_hash[DTLS_HMAC_DIGEST_SIZE]; /**< SHA-256 of the key */
+  unsigned int generation;	/**< changed with the key */
+  int depth;
+  int use_thread;
+  int count;
+  uint32_t kinv[DTLS_ECDSA_SIGN_POOL_SIZE][8]; /**< k^-1 mod n */
+  uint32_t r[DTLS_ECDSA_SIGN_POOL_SIZE][8];    /**< (k * G).x mod n */
+  unsigned long hits;
+  unsigned long misses;
+  unsigned long refilled;
+#if DTLS_ECDSA_SIGN_POOL_THREAD
+  int thread_running;
+#endif
+} ecdsa_sign_pool = {
+  .depth = DTLS_ECDSA_SIGN_POOL_SIZE
+};
+#ifndef WITH_CONTIKI
+static pthread_mutex_t ecdsa_sign_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t ecdsa_sign_pool_once = PTHREAD_ONCE_INIT;
+#endif
+#if DTLS_ECDSA_SIGN_POOL_THREAD
+static pthread_cond_t ecdsa_sign_pool_cond = PTHREAD_COND_INITIALIZER;
+#endif
+#endif /* DTLS_ECDSA_SIGN_POOL_SIZE > 0 */
+
+#if DTLS_ECDSA_KEY_CACHE_SIZE > 0
+/** Peer public keys seen recently, see dtls_ecdsa_key_table(). */
+static struct {
+  uint32_t pub_x[8];
+  uint32_t pub_y[8];
+  ecc_point_table_t table;	/**< odd multiples of the key */
+  unsigned long used;		/**< time stamp for the replacement */
+} ecdsa_key_cache[DTLS_ECDSA_KEY_CACHE_SIZE];
+static int ecdsa_key_cache_count;
+static unsigned long ecdsa_key_cache_clock;
+#ifndef WITH_CONTIKI
+static pthread_mutex_t ecdsa_key_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t ecdsa_key_cache_once = PTHREAD_ONCE_INIT;
+#endif
+#endif /* DTLS_ECDSA_KEY_CACHE_SIZE > 0 */
+#endif /* DTLS_ECC */
+
 static struct dtls_cipher_context_t *dtls_cipher_context_get(void)
 {
 #ifndef WITH_CONTIKI
@@ -138,6 +221,12 @@ void dtls_handshake_free(dtls_handshake_parameters_t *handshake)
   if (!handshake)
     return;
 
+#ifdef DTLS_ECC
+  dtls_ecdsa_batch_remove(handshake);
+#endif /* DTLS_ECC */
+#if DTLS_HS_TRANSCRIPT_SIZE > 0
+  free(handshake->hs_state.transcript);
+#endif /* DTLS_HS_TRANSCRIPT_SIZE */
   netq_delete_all(&handshake->reorder_queue);
   dtls_handshake_dealloc(handshake);
 }
@@ -169,69 +258,64 @@ void dtls_security_free(dtls_security_parameters_t *security)
   dtls_security_dealloc(security);
 }
 
-size_t
-dtls_p_hash(dtls_hashfunc_t h,
-	    const unsigned char *key, size_t keylen,
-	    const unsigned char *label, size_t labellen,
-	    const unsigned char *random1, size_t random1len,
-	    const unsigned char *random2, size_t random2len,
-	    unsigned char *buf, size_t buflen) {
-  dtls_hmac_context_t *hmac_a, *hmac_p;
-
+/* P_hash of rfc5246#section-5 with the HMAC key prepared in @p hkey */
+static void
+dtls_p_hash_key(const dtls_hmac_key_t *hkey,
+		const unsigned char *label, size_t labellen,
+		const unsigned char *random1, size_t random1len,
+		const unsigned char *random2, size_t random2len,
+		unsigned char *buf, size_t buflen) {
+  dtls_hash_ctx ctx;
   unsigned char A[DTLS_HMAC_DIGEST_SIZE];
   unsigned char tmp[DTLS_HMAC_DIGEST_SIZE];
-  size_t dlen;			/* digest length */
-  size_t len = 0;			/* result length */
-  (void)h;
-
-  hmac_a = dtls_hmac_new(key, keylen);
-  if (!hmac_a)
-    return 0;
 
   /* calculate A(1) from A(0) == seed */
-  HMAC_UPDATE_SEED(hmac_a, label, labellen);
-  HMAC_UPDATE_SEED(hmac_a, random1, random1len);
-  HMAC_UPDATE_SEED(hmac_a, random2, random2len);
-
-  dlen = dtls_hmac_finalize(hmac_a, A);
-
-  hmac_p = dtls_hmac_new(key, keylen);
-  if (!hmac_p)
-    goto error;
-
-  while (len + dlen < buflen) {
-
-    /* FIXME: rewrite loop to avoid superflous call to dtls_hmac_init() */
-    dtls_hmac_init(hmac_p, key, keylen);
-    dtls_hmac_update(hmac_p, A, dlen);
-
-    HMAC_UPDATE_SEED(hmac_p, label, labellen);
-    HMAC_UPDATE_SEED(hmac_p, random1, random1len);
-    HMAC_UPDATE_SEED(hmac_p, random2, random2len);
-
-    len += dtls_hmac_finalize(hmac_p, tmp);
-    memcpy(buf, tmp, dlen);
-    buf += dlen;
+  dtls_hmac_key_start(hkey, &ctx);
+  HMAC_UPDATE_SEED(&ctx, label, labellen);
+  HMAC_UPDATE_SEED(&ctx, random1, random1len);
+  HMAC_UPDATE_SEED(&ctx, random2, random2len);
+  dtls_hmac_key_finalize(hkey, &ctx, A);
+
+  for (;;) {
+    dtls_hmac_key_start(hkey, &ctx);
+    dtls_hash_update(&ctx, A, sizeof(A));
+    HMAC_UPDATE_SEED(&ctx, label, labellen);
+    HMAC_UPDATE_SEED(&ctx, random1, random1len);
+    HMAC_UPDATE_SEED(&ctx, random2, random2len);
+
+    if (buflen <= sizeof(tmp)) {
+      dtls_hmac_key_finalize(hkey, &ctx, tmp);
+      memcpy(buf, tmp, buflen);
+      break;
+    }
+    dtls_hmac_key_finalize(hkey, &ctx, buf);
+    buf += sizeof(tmp);
+    buflen -= sizeof(tmp);
 
     /* calculate A(i+1) */
-    dtls_hmac_init(hmac_a, key, keylen);
-    dtls_hmac_update(hmac_a, A, dlen);
-    dtls_hmac_finalize(hmac_a, A);
+    dtls_hmac_key_start(hkey, &ctx);
+    dtls_hash_update(&ctx, A, sizeof(A));
+    dtls_hmac_key_finalize(hkey, &ctx, A);
   }
 
-  dtls_hmac_init(hmac_p, key, keylen);
-  dtls_hmac_update(hmac_p, A, dlen);
-  
-  HMAC_UPDATE_SEED(hmac_p, label, labellen);
-  HMAC_UPDATE_SEED(hmac_p, random1, random1len);
-  HMAC_UPDATE_SEED(hmac_p, random2, random2len);
-  
-  dtls_hmac_finalize(hmac_p, tmp);
-  memcpy(buf, tmp, buflen - len);
+  memset(A, 0, sizeof(A));
+  memset(tmp, 0, sizeof(tmp));
+}
+
+size_t
+dtls_p_hash(dtls_hashfunc_t h,
+	    const unsigned char *key, size_t keylen,
+	    const unsigned char *label, size_t labellen,
+	    const unsigned char *random1, size_t random1len,
+	    const unsigned char *random2, size_t random2len,
+	    unsigned char *buf, size_t buflen) {
+  dtls_hmac_key_t hkey;
+  (void)h;
 
- error:
-  dtls_hmac_free(hmac_a);
-  dtls_hmac_free(hmac_p);
+  dtls_hmac_key_init(&hkey, key, keylen);
+  dtls_p_hash_key(&hkey, label, labellen, random1, random1len,
+		  random2, random2len, buf, buflen);
+  memset(&hkey, 0, sizeof(hkey));
 
   return buflen;
 }
@@ -242,9 +326,6 @@ dtls_prf(const unsigned char *key, size_t keylen,
 	 const unsigned char *random1, size_t random1len,
 	 const unsigned char *random2, size_t random2len,
 	 unsigned char *buf, size_t buflen) {
-
-  /* Clear the result buffer */
-  memset(buf, 0, buflen);
   return dtls_p_hash(HASH_SHA256, 
 		     key, keylen, 
 		     label, labellen, 
@@ -253,6 +334,34 @@ dtls_prf(const unsigned char *key, size_t keylen,
 		     buf, buflen);
 }
 
+void
+dtls_key_schedule(const unsigned char *pre_master_secret, size_t pre_master_len,
+		  const unsigned char *client_random,
+		  const unsigned char *server_random,
+		  unsigned char *master_secret,
+		  unsigned char *key_block, size_t key_block_len) {
+  static const unsigned char label_master[] = "master secret";
+  static const unsigned char label_key[] = "key expansion";
+  dtls_hmac_key_t hkey;
+
+  /* master_secret = PRF(pre_master_secret,
+   *                     "master secret" + client_random + server_random) */
+  dtls_hmac_key_init(&hkey, pre_master_secret, pre_master_len);
+  dtls_p_hash_key(&hkey, label_master, sizeof(label_master) - 1,
+		  client_random, DTLS_RANDOM_LENGTH,
+		  server_random, DTLS_RANDOM_LENGTH,
+		  master_secret, DTLS_MASTER_SECRET_LENGTH);
+
+  /* key_block = PRF(master_secret,
+   *                 "key expansion" + server_random + client_random) */
+  dtls_hmac_key_init(&hkey, master_secret, DTLS_MASTER_SECRET_LENGTH);
+  dtls_p_hash_key(&hkey, label_key, sizeof(label_key) - 1,
+		  server_random, DTLS_RANDOM_LENGTH,
+		  client_random, DTLS_RANDOM_LENGTH,
+		  key_block, key_block_len);
+  memset(&hkey, 0, sizeof(hkey));
+}
+
 void
 dtls_mac(dtls_hmac_context_t *hmac_ctx, 
 	 const unsigned char *record,
@@ -414,7 +523,7 @@ int dtls_ecdh_pre_master_secret(unsigned char *priv_key,
   return key_size;
 }
 
-void
+int
 dtls_ecdsa_generate_key(unsigned char *priv_key,
 			unsigned char *pub_key_x,
 			unsigned char *pub_key_y,
@@ -424,7 +533,8 @@ dtls_ecdsa_generate_key(unsigned char *priv_key,
   uint32_t pub_y[8];
 
   do {
-    dtls_prng((unsigned char *)priv, key_size);
+    if (!dtls_prng((unsigned char *)priv, key_size))
+      return -1;
   } while (!ecc_is_valid_key(priv));
 
   ecc_gen_pub_key(priv, pub_x, pub_y);
@@ -432,24 +542,613 @@ dtls_ecdsa_generate_key(unsigned char *priv_key,
   dtls_ec_key_from_uint32(priv, key_size, priv_key);
   dtls_ec_key_from_uint32(pub_x, key_size, pub_key_x);
   dtls_ec_key_from_uint32(pub_y, key_size, pub_key_y);
+  memset(priv, 0, sizeof(priv));
+  return 0;
 }
 
-/* rfc4492#section-5.4 */
+/** The order n of the P-256 base point, big-endian. */
+static const unsigned char p256_order[DTLS_EC_KEY_SIZE] = {
+  0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0xbc, 0xe6, 0xfa, 0xad, 0xa7, 0x17, 0x9e, 0x84,
+  0xf3, 0xb9, 0xca, 0xc2, 0xfc, 0x63, 0x25, 0x51
+};
+
+/**
+ * Computes @p a - n into @p result and returns the borrow, i.e. 1 if
+ * @p a < n, in constant time. @p result may be NULL.
+ */
+static int
+rfc6979_sub_order(const unsigned char *a, unsigned char *result) {
+  int i, borrow = 0, d;
+
+  for (i = DTLS_EC_KEY_SIZE - 1; i >= 0; i--) {
+    d = a[i] - p256_order[i] - borrow;
+    borrow = (d >> 8) & 1;
+    if (result)
+      result[i] = d & 0xff;
+  }
+  return borrow;
+}
+
+/** K = HMAC_K(V || sep || x || h1), the key is replaced in @p h. */
+static void
+rfc6979_update_key(dtls_hmac_key_t *h, const unsigned char *v, unsigned char sep,
+		   const unsigned char *x, const unsigned char *h1) {
+  dtls_hash_ctx inner;
+  unsigned char key[DTLS_HMAC_DIGEST_SIZE];
+
+  dtls_hmac_key_start(h, &inner);
+  dtls_hash_update(&inner, v, DTLS_HMAC_DIGEST_SIZE);
+  dtls_hash_update(&inner, &sep, 1);
+  if (x) {
+    dtls_hash_update(&inner, x, DTLS_EC_KEY_SIZE);
+    dtls_hash_update(&inner, h1, DTLS_EC_KEY_SIZE);
+  }
+  dtls_hmac_key_finalize(h, &inner, key);
+  dtls_hmac_key_init(h, key, DTLS_HMAC_DIGEST_SIZE);
+  memset(key, 0, sizeof(key));
+}
+
+/** V = HMAC_K(V) */
+static void
+rfc6979_update_v(const dtls_hmac_key_t *h, unsigned char *v) {
+  dtls_hash_ctx inner;
+
+  dtls_hmac_key_start(h, &inner);
+  dtls_hash_update(&inner, v, DTLS_HMAC_DIGEST_SIZE);
+  dtls_hmac_key_finalize(h, &inner, v);
+}
+
+/* must be called with the cache locked */
+static void
+rfc6979_cache_wipe(void) {
+  memset(&rfc6979_cache, 0, sizeof(rfc6979_cache));
+}
+
+#ifndef WITH_CONTIKI
+/* A thread may hold the cache while another one forks, and the child
+ * does not need the state of the parent's key. */
+static void
+rfc6979_cache_prepare_fork(void) {
+  pthread_mutex_lock(&rfc6979_cache_mutex);
+}
+
+static void
+rfc6979_cache_parent(void) {
+  pthread_mutex_unlock(&rfc6979_cache_mutex);
+}
+
+static void
+rfc6979_cache_child(void) {
+  rfc6979_cache_wipe();
+  pthread_mutex_unlock(&rfc6979_cache_mutex);
+}
+
+static void
+rfc6979_cache_register_fork(void) {
+  pthread_atfork(rfc6979_cache_prepare_fork,
+		 rfc6979_cache_parent, rfc6979_cache_child);
+}
+#endif /* WITH_CONTIKI */
+
+void
+dtls_ecdsa_sign_cache_clear(void) {
+#ifndef WITH_CONTIKI
+  pthread_mutex_lock(&rfc6979_cache_mutex);
+#endif
+  rfc6979_cache_wipe();
+#ifndef WITH_CONTIKI
+  pthread_mutex_unlock(&rfc6979_cache_mutex);
+#endif
+}
+
+/**
+ * Stores the SHA-256 hash of the private key @p x in @p key_hash. The
+ * caches keep the hash in place of the key.
+ */
+static void
+dtls_ecdsa_key_hash(const unsigned char *x, unsigned char *key_hash) {
+  dtls_hash_ctx ctx;
+
+  dtls_hash_init(&ctx);
+  dtls_hash_update(&ctx, x, DTLS_EC_KEY_SIZE);
+  dtls_hash_finalize(key_hash, &ctx);
+}
+
+/**
+ * Steps b to d of RFC 6979, section 3.2: returns in @p h the HMAC
+ * keyed with K = HMAC_0(V || 0x00 || x || h1) for V = 0x01 0x01 ...,
+ * using the state cached for the private key @p x.
+ */
+static void
+rfc6979_step_d(dtls_hmac_key_t *h, const unsigned char *x,
+	       const unsigned char *h1) {
+  static const unsigned char zero[DTLS_HMAC_DIGEST_SIZE];
+  unsigned char v[DTLS_HMAC_DIGEST_SIZE];
+  unsigned char key_hash[DTLS_HMAC_DIGEST_SIZE];
+  unsigned char sep = 0;
+  dtls_hash_ctx inner;
+
+  dtls_ecdsa_key_hash(x, key_hash);
+
+#ifndef WITH_CONTIKI
+  pthread_once(&rfc6979_cache_once, rfc6979_cache_register_fork);
+  pthread_mutex_lock(&rfc6979_cache_mutex);
+#endif
+  if (!rfc6979_cache.valid
+      || !equals(rfc6979_cache.key_hash, key_hash, sizeof(key_hash))) {
+    memset(v, 0x01, sizeof(v));
+    dtls_hmac_key_init(&rfc6979_cache.k0, zero, DTLS_HMAC_DIGEST_SIZE);
+    rfc6979_cache.step_d = rfc6979_cache.k0.inner;
+    dtls_hash_update(&rfc6979_cache.step_d, v, sizeof(v));
+    dtls_hash_update(&rfc6979_cache.step_d, &sep, 1);
+    dtls_hash_update(&rfc6979_cache.step_d, x, DTLS_EC_KEY_SIZE - 1);
+    memcpy(rfc6979_cache.key_hash, key_hash, sizeof(key_hash));
+    rfc6979_cache.valid = 1;
+  }
+  inner = rfc6979_cache.step_d;
+  h->outer = rfc6979_cache.k0.outer;
+#ifndef WITH_CONTIKI
+  pthread_mutex_unlock(&rfc6979_cache_mutex);
+#endif
+
+  dtls_hash_update(&inner, x + DTLS_EC_KEY_SIZE - 1, 1);
+  dtls_hash_update(&inner, h1, DTLS_EC_KEY_SIZE);
+  dtls_hmac_key_finalize(h, &inner, v);
+  dtls_hmac_key_init(h, v, DTLS_HMAC_DIGEST_SIZE);
+  memset(&inner, 0, sizeof(inner));
+  memset(v, 0, sizeof(v));
+}
+
+/** The HMAC_DRBG of rfc6979#section-3.2 after step g. */
+typedef struct {
+  dtls_hmac_key_t k;
+  unsigned char v[DTLS_HMAC_DIGEST_SIZE];
+  int started;			/**< a candidate has been returned */
+} rfc6979_state_t;
+
+static void
+rfc6979_init(rfc6979_state_t *st, const unsigned char *x,
+	     const unsigned char *h1) {
+  rfc6979_step_d(&st->k, x, h1);
+  memset(st->v, 0x01, sizeof(st->v));
+  rfc6979_update_v(&st->k, st->v);		      /* step e */
+  rfc6979_update_key(&st->k, st->v, 0x01, x, h1); /* step f */
+  rfc6979_update_v(&st->k, st->v);		      /* step g */
+  st->started = 0;
+}
+
+/**
+ * Step h: returns the next candidate for k in [1, n - 1] as
+ * little-endian words. Call it again if k is not suitable.
+ */
+static void
+rfc6979_next(rfc6979_state_t *st, uint32_t *k) {
+  unsigned char nonzero;
+  int i;
+
+  for (;;) {
+    if (st->started) {
+      rfc6979_update_key(&st->k, st->v, 0x00, NULL, NULL);
+      rfc6979_update_v(&st->k, st->v);
+    }
+    st->started = 1;
+
+    /* qlen equals hlen, so one block of output is enough */
+    rfc6979_update_v(&st->k, st->v);
+    nonzero = 0;
+    for (i = 0; i < DTLS_HMAC_DIGEST_SIZE; i++)
+      nonzero |= st->v[i];
+    if (nonzero && rfc6979_sub_order(st->v, NULL)) {
+      dtls_ec_key_to_uint32(st->v, sizeof(st->v), k);
+      return;
+    }
+  }
+}
+
+#if DTLS_ECDSA_SIGN_POOL_SIZE > 0
+/** Refill in steps of this many nonces, with one inversion each. */
+#define DTLS_ECDSA_SIGN_POOL_BATCH 8
+
+static void
+dtls_ecdsa_sign_pool_lock(void) {
+#ifndef WITH_CONTIKI
+  pthread_mutex_lock(&ecdsa_sign_pool_mutex);
+#endif
+}
+
+static void
+dtls_ecdsa_sign_pool_unlock(void) {
+#ifndef WITH_CONTIKI
+  pthread_mutex_unlock(&ecdsa_sign_pool_mutex);
+#endif
+}
+
+/* must be called with the pool locked */
+static void
+dtls_ecdsa_sign_pool_truncate(int count) {
+  if (count < ecdsa_sign_pool.count) {
+    memset(ecdsa_sign_pool.kinv[count], 0,
+	   (ecdsa_sign_pool.count - count) * sizeof(ecdsa_sign_pool.kinv[0]));
+    ecdsa_sign_pool.count = count;
+  }
+}
+
+#ifndef WITH_CONTIKI
+/* The child of fork() must not use the nonces of its parent again, nor
+ * keep the key hash, and the refill thread does not exist in the
+ * child. */
+static void
+dtls_ecdsa_sign_pool_prepare_fork(void) {
+  pthread_mutex_lock(&ecdsa_sign_pool_mutex);
+}
+
+static void
+dtls_ecdsa_sign_pool_parent(void) {
+  pthread_mutex_unlock(&ecdsa_sign_pool_mutex);
+}
+
+static void
+dtls_ecdsa_sign_pool_child(void) {
+  dtls_ecdsa_sign_pool_truncate(0);
+  memset(ecdsa_sign_pool.key_hash, 0, sizeof(ecdsa_sign_pool.key_hash));
+  ecdsa_sign_pool.bound = 0;
+#if DTLS_ECDSA_SIGN_POOL_THREAD
+  ecdsa_sign_pool.thread_running = 0;
+  pthread_cond_init(&ecdsa_sign_pool_cond, NULL);
+#endif
+  pthread_mutex_unlock(&ecdsa_sign_pool_mutex);
+}
+
+static void
+dtls_ecdsa_sign_pool_register_fork(void) {
+  pthread_atfork(dtls_ecdsa_sign_pool_prepare_fork,
+		 dtls_ecdsa_sign_pool_parent, dtls_ecdsa_sign_pool_child);
+}
+#endif /* WITH_CONTIKI */
+
+/**
+ * Computes @p count nonces for the key with the SHA-256 hash @p
+ * key_hash. They are derived as in RFC 6979 with the hash of the key
+ * in place of the key, and fresh output of dtls_prng() in place of the
+ * hash of the message. A weak random number generator thus does not
+ * make the nonces predictable, and the pool never needs the key.
+ *
+ * @return 0 if there was no random data available.
+ */
+static int
+dtls_ecdsa_sign_pool_compute(const unsigned char *key_hash,
+			     uint32_t *kinv, uint32_t *r, int count) {
+  rfc6979_state_t drbg;
+  unsigned char seed[DTLS_EC_KEY_SIZE];
+  uint32_t k[DTLS_ECDSA_SIGN_POOL_BATCH * 8];
+  int i;
+
+  if (!dtls_prng(seed, sizeof(seed)))
+    return 0;
+
+  rfc6979_init(&drbg, key_hash, seed);
+  for (i = 0; i < count; i++)
+    rfc6979_next(&drbg, &k[i * 8]);
+  ecc_ecdsa_presign_batch(k, kinv, r, count);
+
+  memset(&drbg, 0, sizeof(drbg));
+  memset(seed, 0, sizeof(seed));
+  memset(k, 0, sizeof(k));
+  return 1;
+}
+
+/* must be called with the pool locked */
+static int
+dtls_ecdsa_sign_pool_add(unsigned int generation,
+			 const uint32_t *kinv, const uint32_t *r, int count) {
+  int i, j, added = 0;
+  uint32_t nonzero;
+
+  if (generation != ecdsa_sign_pool.generation)
+    return 0;
+
+  for (i = 0; i < count && ecdsa_sign_pool.count < ecdsa_sign_pool.depth; i++) {
+    nonzero = 0;
+    for (j = 0; j < 8; j++)
+      nonzero |= r[i * 8 + j];
+    if (!nonzero)
+      continue;
+
+    memcpy(ecdsa_sign_pool.kinv[ecdsa_sign_pool.count], &kinv[i * 8],
+	   sizeof(ecdsa_sign_pool.kinv[0]));
+    memcpy(ecdsa_sign_pool.r[ecdsa_sign_pool.count], &r[i * 8],
+	   sizeof(ecdsa_sign_pool.r[0]));
+    ecdsa_sign_pool.count++;
+    added++;
+  }
+  ecdsa_sign_pool.refilled += added;
+  return added;
+}
+
+#if DTLS_ECDSA_SIGN_POOL_THREAD
+/* must be called with the pool locked */
+static int
+dtls_ecdsa_sign_pool_wanted(void) {
+  int low = ecdsa_sign_pool.depth < DTLS_ECDSA_SIGN_POOL_BATCH
+    ? ecdsa_sign_pool.depth : DTLS_ECDSA_SIGN_POOL_BATCH;
+
+  return ecdsa_sign_pool.bound && ecdsa_sign_pool.use_thread
+    && ecdsa_sign_pool.depth > 0
+    && ecdsa_sign_pool.depth - ecdsa_sign_pool.count >= low;
+}
+
+static void *
+dtls_ecdsa_sign_pool_thread(void *arg) {
+#ifdef SCHED_IDLE
+  struct sched_param param = { 0 };
+
+  /* run only when there is nothing else to do */
+  pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif /* SCHED_IDLE */
+  (void)arg;
+
+  for (;;) {
+    pthread_mutex_lock(&ecdsa_sign_pool_mutex);
+    while (!dtls_ecdsa_sign_pool_wanted())
+      pthread_cond_wait(&ecdsa_sign_pool_cond, &ecdsa_sign_pool_mutex);
+    pthread_mutex_unlock(&ecdsa_sign_pool_mutex);
+
+    if (!dtls_ecdsa_sign_pool_refill(DTLS_ECDSA_SIGN_POOL_SIZE))
+      sleep(1);			/* no random data, try again later */
+  }
+  return NULL;
+}
+#endif /* DTLS_ECDSA_SIGN_POOL_THREAD */
+
+/* must be called with the pool locked */
+static void
+dtls_ecdsa_sign_pool_wakeup(void) {
+#if DTLS_ECDSA_SIGN_POOL_THREAD
+  pthread_attr_t attr;
+  pthread_t thread;
+  int res;
+
+  if (!dtls_ecdsa_sign_pool_wanted())
+    return;
+  if (!ecdsa_sign_pool.thread_running) {
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    res = pthread_create(&thread, &attr, dtls_ecdsa_sign_pool_thread, NULL);
+    pthread_attr_destroy(&attr);
+    if (res) {
+      dtls_warn("cannot start the thread for ECDSA nonces\n");
+      return;
+    }
+    ecdsa_sign_pool.thread_running = 1;
+  }
+  pthread_cond_signal(&ecdsa_sign_pool_cond);
+#endif /* DTLS_ECDSA_SIGN_POOL_THREAD */
+}
+
+/* must be called with the pool locked, NULL releases the pool */
+static void
+dtls_ecdsa_sign_pool_set_key(const unsigned char *key_hash) {
+  if (key_hash && ecdsa_sign_pool.bound
+      && equals(ecdsa_sign_pool.key_hash, key_hash, DTLS_HMAC_DIGEST_SIZE))
+    return;
+
+#ifndef WITH_CONTIKI
+  pthread_once(&ecdsa_sign_pool_once, dtls_ecdsa_sign_pool_register_fork);
+#endif
+  dtls_ecdsa_sign_pool_truncate(0);
+  if (key_hash)
+    memcpy(ecdsa_sign_pool.key_hash, key_hash, DTLS_HMAC_DIGEST_SIZE);
+  else
+    memset(ecdsa_sign_pool.key_hash, 0, DTLS_HMAC_DIGEST_SIZE);
+  ecdsa_sign_pool.bound = key_hash != NULL;
+  ecdsa_sign_pool.generation++;
+}
+
+/**
+ * Signs with a nonce from the pool if there is one for @p priv_key.
+ *
+ * @return 1 if the signature has been created.
+ */
+static int
+dtls_ecdsa_sign_pool_sign(const unsigned char *priv_key, const uint32_t *priv,
+			  const uint32_t *hash,
+			  uint32_t *point_r, uint32_t *point_s) {
+  unsigned char key_hash[DTLS_HMAC_DIGEST_SIZE];
+  uint32_t kinv[8];
+  int ret = 0;
+
+  dtls_ecdsa_key_hash(priv_key, key_hash);
+
+  dtls_ecdsa_sign_pool_lock();
+  if (ecdsa_sign_pool.depth == 0) {
+    dtls_ecdsa_sign_pool_unlock();
+    memset(key_hash, 0, sizeof(key_hash));
+    return 0;
+  }
+
+  /* the pool is taken by the first key that signs, the nonces of
+   * that key are not thrown away for another one */
+  if (!ecdsa_sign_pool.bound)
+    dtls_ecdsa_sign_pool_set_key(key_hash);
+  else if (!equals(ecdsa_sign_pool.key_hash, key_hash, sizeof(key_hash))) {
+    ecdsa_sign_pool.misses++;
+    dtls_ecdsa_sign_pool_unlock();
+    memset(key_hash, 0, sizeof(key_hash));
+    return 0;
+  }
+
+  if (ecdsa_sign_pool.count > 0) {
+    ecdsa_sign_pool.count--;
+    memcpy(kinv, ecdsa_sign_pool.kinv[ecdsa_sign_pool.count], sizeof(kinv));
+    memcpy(point_r, ecdsa_sign_pool.r[ecdsa_sign_pool.count],
+	   sizeof(ecdsa_sign_pool.r[0]));
+    memset(ecdsa_sign_pool.kinv[ecdsa_sign_pool.count], 0, sizeof(kinv));
+    ecdsa_sign_pool.hits++;
+    ret = 1;
+  } else {
+    ecdsa_sign_pool.misses++;
+  }
+  dtls_ecdsa_sign_pool_wakeup();
+  dtls_ecdsa_sign_pool_unlock();
+  memset(key_hash, 0, sizeof(key_hash));
+
+  if (ret) {
+    /* s = 0 is as unlikely as guessing the key, then use RFC 6979 */
+    ret = !ecc_ecdsa_sign_presigned(priv, hash, kinv, point_r, point_s);
+    memset(kinv, 0, sizeof(kinv));
+  }
+  return ret;
+}
+#endif /* DTLS_ECDSA_SIGN_POOL_SIZE > 0 */
+
+void
+dtls_ecdsa_sign_pool_configure(int depth, int use_thread) {
+#if DTLS_ECDSA_SIGN_POOL_SIZE > 0
+  if (depth < 0)
+    depth = 0;
+  if (depth > DTLS_ECDSA_SIGN_POOL_SIZE)
+    depth = DTLS_ECDSA_SIGN_POOL_SIZE;
+
+  dtls_ecdsa_sign_pool_lock();
+  ecdsa_sign_pool.depth = depth;
+  ecdsa_sign_pool.use_thread = use_thread;
+  dtls_ecdsa_sign_pool_truncate(depth);
+  dtls_ecdsa_sign_pool_wakeup();
+  dtls_ecdsa_sign_pool_unlock();
+#else /* DTLS_ECDSA_SIGN_POOL_SIZE > 0 */
+  (void)depth;
+  (void)use_thread;
+#endif /* DTLS_ECDSA_SIGN_POOL_SIZE > 0 */
+}
+
+void
+dtls_ecdsa_sign_pool_bind(const unsigned char *priv_key, size_t key_size) {
+#if DTLS_ECDSA_SIGN_POOL_SIZE > 0
+  unsigned char key_hash[DTLS_HMAC_DIGEST_SIZE];
+
+  assert(!priv_key || key_size == DTLS_EC_KEY_SIZE);
+  if (priv_key)
+    dtls_ecdsa_key_hash(priv_key, key_hash);
+
+  dtls_ecdsa_sign_pool_lock();
+  dtls_ecdsa_sign_pool_set_key(priv_key ? key_hash : NULL);
+  dtls_ecdsa_sign_pool_wakeup();
+  dtls_ecdsa_sign_pool_unlock();
+  memset(key_hash, 0, sizeof(key_hash));
+#else /* DTLS_ECDSA_SIGN_POOL_SIZE > 0 */
+  (void)priv_key;
+  (void)key_size;
+#endif /* DTLS_ECDSA_SIGN_POOL_SIZE > 0 */
+}
+
+int
+dtls_ecdsa_sign_pool_refill(int max) {
+  int added = 0;
+#if DTLS_ECDSA_SIGN_POOL_SIZE > 0
+  uint32_t kinv[DTLS_ECDSA_SIGN_POOL_BATCH * 8];
+  uint32_t r[DTLS_ECDSA_SIGN_POOL_BATCH * 8];
+  unsigned char key_hash[DTLS_HMAC_DIGEST_SIZE];
+  unsigned int generation;
+  int n;
+
+  while (added < max) {
+    dtls_ecdsa_sign_pool_lock();
+    n = ecdsa_sign_pool.depth - ecdsa_sign_pool.count;
+    if (!ecdsa_sign_pool.bound || n <= 0) {
+      dtls_ecdsa_sign_pool_unlock();
+      break;
+    }
+    memcpy(key_hash, ecdsa_sign_pool.key_hash, sizeof(key_hash));
+    generation = ecdsa_sign_pool.generation;
+    dtls_ecdsa_sign_pool_unlock();
+
+    /* the expensive part is done without the lock */
+    if (n > DTLS_ECDSA_SIGN_POOL_BATCH)
+      n = DTLS_ECDSA_SIGN_POOL_BATCH;
+    if (n > max - added)
+      n = max - added;
+    if (!dtls_ecdsa_sign_pool_compute(key_hash, kinv, r, n))
+      break;
+
+    dtls_ecdsa_sign_pool_lock();
+    n = dtls_ecdsa_sign_pool_add(generation, kinv, r, n);
+    dtls_ecdsa_sign_pool_unlock();
+    if (!n)
+      break;
+    added += n;
+  }
+
+  memset(kinv, 0, sizeof(kinv));
+  memset(key_hash, 0, sizeof(key_hash));
+#else /* DTLS_ECDSA_SIGN_POOL_SIZE > 0 */
+  (void)max;
+#endif /* DTLS_ECDSA_SIGN_POOL_SIZE > 0 */
+  return added;
+}
+
+void
+dtls_ecdsa_sign_pool_stats(dtls_ecdsa_sign_pool_stats_t *stats) {
+  memset(stats, 0, sizeof(*stats));
+#if DTLS_ECDSA_SIGN_POOL_SIZE > 0
+  dtls_ecdsa_sign_pool_lock();
+  stats->depth = ecdsa_sign_pool.depth;
+  stats->available = ecdsa_sign_pool.count;
+  stats->hits = ecdsa_sign_pool.hits;
+  stats->misses = ecdsa_sign_pool.misses;
+  stats->refilled = ecdsa_sign_pool.refilled;
+  dtls_ecdsa_sign_pool_unlock();
+#endif /* DTLS_ECDSA_SIGN_POOL_SIZE > 0 */
+}
+
+/* rfc4492#section-5.4, the nonce is taken from the pool or derived
+ * deterministically from the private key and the hash as described in
+ * rfc6979#section-3.2 */
 void
 dtls_ecdsa_create_sig_hash(const unsigned char *priv_key, size_t key_size,
 			   const unsigned char *sign_hash, size_t sign_hash_size,
 			   uint32_t point_r[9], uint32_t point_s[9]) {
-  int ret;
   uint32_t priv[8];
   uint32_t hash[8];
   uint32_t rand[8];
-  
+  unsigned char h1[DTLS_EC_KEY_SIZE];
+  unsigned char reduced[DTLS_EC_KEY_SIZE];
+  unsigned char mask;
+  rfc6979_state_t drbg;
+  int i;
+
+  assert(key_size == DTLS_EC_KEY_SIZE);
+
+  /* bits2int(H): the leftmost 256 bits of the hash */
+  memset(h1, 0, sizeof(h1));
+  if (sign_hash_size >= sizeof(h1))
+    memcpy(h1, sign_hash, sizeof(h1));
+  else
+    memcpy(h1 + sizeof(h1) - sign_hash_size, sign_hash, sign_hash_size);
+  dtls_ec_key_to_uint32(h1, sizeof(h1), hash);
   dtls_ec_key_to_uint32(priv_key, key_size, priv);
-  dtls_ec_key_to_uint32(sign_hash, sign_hash_size, hash);
+
+#if DTLS_ECDSA_SIGN_POOL_SIZE > 0
+  if (dtls_ecdsa_sign_pool_sign(priv_key, priv, hash, point_r, point_s)) {
+    memset(priv, 0, sizeof(priv));
+    return;
+  }
+#endif /* DTLS_ECDSA_SIGN_POOL_SIZE > 0 */
+
+  /* bits2octets(H) = H mod n, H < 2n */
+  mask = rfc6979_sub_order(h1, reduced) - 1;
+  for (i = 0; i < DTLS_EC_KEY_SIZE; i++)
+    h1[i] = (h1[i] & ~mask) | (reduced[i] & mask);
+
+  rfc6979_init(&drbg, priv_key, h1);
   do {
-    dtls_prng((unsigned char *)rand, key_size);
-    ret = ecc_ecdsa_sign(priv, hash, rand, point_r, point_s);
-  } while (ret);
+    rfc6979_next(&drbg, rand);
+  } while (ecc_ecdsa_sign(priv, hash, rand, point_r, point_s));
+
+  memset(&drbg, 0, sizeof(drbg));
+  memset(rand, 0, sizeof(rand));
+  memset(priv, 0, sizeof(priv));
 }
 
 void
@@ -471,25 +1170,272 @@ dtls_ecdsa_create_sig(const unsigned char *priv_key, size_t key_size,
 			     sizeof(sha256hash), point_r, point_s);
 }
 
+#if DTLS_ECDSA_KEY_CACHE_SIZE > 0
+#ifndef WITH_CONTIKI
+/* the same for the key cache */
+static void
+dtls_ecdsa_key_cache_prepare_fork(void) {
+  pthread_mutex_lock(&ecdsa_key_cache_mutex);
+}
+
+static void
+dtls_ecdsa_key_cache_after_fork(void) {
+  pthread_mutex_unlock(&ecdsa_key_cache_mutex);
+}
+
+static void
+dtls_ecdsa_key_cache_register_fork(void) {
+  pthread_atfork(dtls_ecdsa_key_cache_prepare_fork,
+		 dtls_ecdsa_key_cache_after_fork,
+		 dtls_ecdsa_key_cache_after_fork);
+}
+#endif /* WITH_CONTIKI */
+
+static void
+dtls_ecdsa_key_cache_lock(void) {
+#ifndef WITH_CONTIKI
+  pthread_once(&ecdsa_key_cache_once, dtls_ecdsa_key_cache_register_fork);
+  pthread_mutex_lock(&ecdsa_key_cache_mutex);
+#endif
+}
+
+static void
+dtls_ecdsa_key_cache_unlock(void) {
+#ifndef WITH_CONTIKI
+  pthread_mutex_unlock(&ecdsa_key_cache_mutex);
+#endif
+}
+
+/* must be called with the cache locked */
+static int
+dtls_ecdsa_key_cache_find(const uint32_t *pub_x, const uint32_t *pub_y) {
+  int i;
+
+  for (i = 0; i < ecdsa_key_cache_count; i++) {
+    if (!memcmp(ecdsa_key_cache[i].pub_x, pub_x, sizeof(ecdsa_key_cache[i].pub_x)) &&
+	!memcmp(ecdsa_key_cache[i].pub_y, pub_y, sizeof(ecdsa_key_cache[i].pub_y))) {
+      ecdsa_key_cache[i].used = ++ecdsa_key_cache_clock;
+      return i;
+    }
+  }
+  return -1;
+}
+
+/* must be called with the cache locked, replaces the least recently
+ * used entry when the cache is full */
+static int
+dtls_ecdsa_key_cache_insert(const uint32_t *pub_x, const uint32_t *pub_y,
+			    const ecc_point_table_t *table) {
+  int i, n;
+
+  n = dtls_ecdsa_key_cache_find(pub_x, pub_y);
+  if (n >= 0)
+    return n;
+
+  if (ecdsa_key_cache_count < DTLS_ECDSA_KEY_CACHE_SIZE) {
+    n = ecdsa_key_cache_count++;
+  } else {
+    n = 0;
+    for (i = 1; i < DTLS_ECDSA_KEY_CACHE_SIZE; i++)
+      if (ecdsa_key_cache[i].used < ecdsa_key_cache[n].used)
+	n = i;
+  }
+
+  memcpy(ecdsa_key_cache[n].pub_x, pub_x, sizeof(ecdsa_key_cache[n].pub_x));
+  memcpy(ecdsa_key_cache[n].pub_y, pub_y, sizeof(ecdsa_key_cache[n].pub_y));
+  memcpy(&ecdsa_key_cache[n].table, table, sizeof(ecdsa_key_cache[n].table));
+  ecdsa_key_cache[n].used = ++ecdsa_key_cache_clock;
+  return n;
+}
+#endif /* DTLS_ECDSA_KEY_CACHE_SIZE > 0 */
+
+/**
+ * Returns the precomputed table of the given public key in @p table,
+ * from the key cache if possible.
+ */
+static void
+dtls_ecdsa_key_table(const unsigned char *pub_key_x,
+		     const unsigned char *pub_key_y, size_t key_size,
+		     ecc_point_table_t *table) {
+  uint32_t pub_x[8];
+  uint32_t pub_y[8];
+
+  dtls_ec_key_to_uint32(pub_key_x, key_size, pub_x);
+  dtls_ec_key_to_uint32(pub_key_y, key_size, pub_y);
+
+#if DTLS_ECDSA_KEY_CACHE_SIZE > 0
+  int n;
+
+  dtls_ecdsa_key_cache_lock();
+  n = dtls_ecdsa_key_cache_find(pub_x, pub_y);
+  if (n >= 0)
+    memcpy(table, &ecdsa_key_cache[n].table, sizeof(*table));
+  dtls_ecdsa_key_cache_unlock();
+  if (n >= 0)
+    return;
+#endif /* DTLS_ECDSA_KEY_CACHE_SIZE > 0 */
+
+  ecc_ec_precompute(pub_x, pub_y, table, 1);
+
+#if DTLS_ECDSA_KEY_CACHE_SIZE > 0
+  dtls_ecdsa_key_cache_lock();
+  dtls_ecdsa_key_cache_insert(pub_x, pub_y, table);
+  dtls_ecdsa_key_cache_unlock();
+#endif /* DTLS_ECDSA_KEY_CACHE_SIZE > 0 */
+}
+
+void
+dtls_ecdsa_key_cache_flush(void) {
+#if DTLS_ECDSA_KEY_CACHE_SIZE > 0
+  dtls_ecdsa_key_cache_lock();
+  ecdsa_key_cache_count = 0;
+  dtls_ecdsa_key_cache_unlock();
+#endif /* DTLS_ECDSA_KEY_CACHE_SIZE > 0 */
+}
+
 /* rfc4492#section-5.4 */
 int
 dtls_ecdsa_verify_sig_hash(const unsigned char *pub_key_x,
 			   const unsigned char *pub_key_y, size_t key_size,
 			   const unsigned char *sign_hash, size_t sign_hash_size,
 			   unsigned char *result_r, unsigned char *result_s) {
-  uint32_t pub_x[8];
-  uint32_t pub_y[8];
+  ecc_point_table_t table;
   uint32_t hash[8];
   uint32_t point_r[8];
   uint32_t point_s[8];
+  int result;
 
-  dtls_ec_key_to_uint32(pub_key_x, key_size, pub_x);
-  dtls_ec_key_to_uint32(pub_key_y, key_size, pub_y);
+  dtls_ecdsa_key_table(pub_key_x, pub_key_y, key_size, &table);
   dtls_ec_key_to_uint32(result_r, key_size, point_r);
   dtls_ec_key_to_uint32(result_s, key_size, point_s);
   dtls_ec_key_to_uint32(sign_hash, sign_hash_size, hash);
 
-  return ecc_ecdsa_validate(pub_x, pub_y, hash, point_r, point_s);
+  return ecc_ecdsa_validate_batch(&table, hash, point_r, point_s, &result, 1);
+}
+
+#ifndef WITH_CONTIKI
+/* The child of fork() must not find the queue locked by a thread that
+ * only exists in the parent. */
+static void
+dtls_ecdsa_batch_prepare_fork(void) {
+  pthread_mutex_lock(&ecdsa_batch_mutex);
+}
+
+static void
+dtls_ecdsa_batch_after_fork(void) {
+  pthread_mutex_unlock(&ecdsa_batch_mutex);
+}
+
+static void
+dtls_ecdsa_batch_register_fork(void) {
+  pthread_atfork(dtls_ecdsa_batch_prepare_fork,
+		 dtls_ecdsa_batch_after_fork, dtls_ecdsa_batch_after_fork);
+}
+#endif /* WITH_CONTIKI */
+
+static void
+dtls_ecdsa_batch_lock(void) {
+#ifndef WITH_CONTIKI
+  pthread_once(&ecdsa_batch_once, dtls_ecdsa_batch_register_fork);
+  pthread_mutex_lock(&ecdsa_batch_mutex);
+#endif
+}
+
+static void
+dtls_ecdsa_batch_unlock(void) {
+#ifndef WITH_CONTIKI
+  pthread_mutex_unlock(&ecdsa_batch_mutex);
+#endif
+}
+
+/* must be called with the batch locked */
+static void
+dtls_ecdsa_batch_verify_locked(void) {
+  int result[DTLS_ECDSA_BATCH_SIZE];
+  int i;
+
+  if (!ecdsa_batch.count)
+    return;
+
+  ecc_ecdsa_validate_batch(ecdsa_batch.table, ecdsa_batch.hash, ecdsa_batch.point_r,
+			   ecdsa_batch.point_s, result, ecdsa_batch.count);
+
+  for (i = 0; i < ecdsa_batch.count; i++) {
+    ecdsa_batch.handshake[i]->ecdsa_verify_pending = 0;
+    ecdsa_batch.handshake[i]->ecdsa_verify_failed = result[i] < 0;
+  }
+  ecdsa_batch.count = 0;
+}
+
+int
+dtls_ecdsa_batch_add(dtls_handshake_parameters_t *handshake,
+		     const unsigned char *pub_key_x,
+		     const unsigned char *pub_key_y, size_t key_size,
+		     const unsigned char *sign_hash, size_t sign_hash_size,
+		     unsigned char *result_r, unsigned char *result_s) {
+  ecc_point_table_t table;
+  int i;
+
+  if (key_size != DTLS_EC_KEY_SIZE || sign_hash_size != DTLS_EC_KEY_SIZE)
+    return -1;
+
+  dtls_ecdsa_key_table(pub_key_x, pub_key_y, key_size, &table);
+
+  dtls_ecdsa_batch_lock();
+  if (ecdsa_batch.count == DTLS_ECDSA_BATCH_SIZE)
+    dtls_ecdsa_batch_verify_locked();
+
+  i = ecdsa_batch.count++;
+  ecdsa_batch.handshake[i] = handshake;
+  memcpy(&ecdsa_batch.table[i], &table, sizeof(table));
+  dtls_ec_key_to_uint32(result_r, key_size, &ecdsa_batch.point_r[i * 8]);
+  dtls_ec_key_to_uint32(result_s, key_size, &ecdsa_batch.point_s[i * 8]);
+  dtls_ec_key_to_uint32(sign_hash, sign_hash_size, &ecdsa_batch.hash[i * 8]);
+  handshake->ecdsa_verify_pending = 1;
+  handshake->ecdsa_verify_failed = 0;
+  dtls_ecdsa_batch_unlock();
+  return 0;
+}
+
+void
+dtls_ecdsa_batch_verify(void) {
+  dtls_ecdsa_batch_lock();
+  dtls_ecdsa_batch_verify_locked();
+  dtls_ecdsa_batch_unlock();
+}
+
+int
+dtls_ecdsa_batch_result(dtls_handshake_parameters_t *handshake) {
+  int failed;
+
+  dtls_ecdsa_batch_lock();
+  if (handshake->ecdsa_verify_pending)
+    dtls_ecdsa_batch_verify_locked();
+  failed = handshake->ecdsa_verify_failed;
+  dtls_ecdsa_batch_unlock();
+  return failed ? -1 : 0;
+}
+
+static void
+dtls_ecdsa_batch_remove(dtls_handshake_parameters_t *handshake) {
+  int i, last;
+
+  dtls_ecdsa_batch_lock();
+  for (i = 0; handshake->ecdsa_verify_pending && i < ecdsa_batch.count; i++) {
+    if (ecdsa_batch.handshake[i] != handshake)
+      continue;
+
+    /* move the last entry into the free slot */
+    last = --ecdsa_batch.count;
+    ecdsa_batch.handshake[i] = ecdsa_batch.handshake[last];
+    memcpy(&ecdsa_batch.table[i], &ecdsa_batch.table[last], sizeof(ecc_point_table_t));
+    memcpy(&ecdsa_batch.hash[i * 8], &ecdsa_batch.hash[last * 8], 8 * sizeof(uint32_t));
+    memcpy(&ecdsa_batch.point_r[i * 8], &ecdsa_batch.point_r[last * 8], 8 * sizeof(uint32_t));
+    memcpy(&ecdsa_batch.point_s[i * 8], &ecdsa_batch.point_s[last * 8], 8 * sizeof(uint32_t));
+    break;
+  }
+  handshake->ecdsa_verify_pending = 0;
+  dtls_ecdsa_batch_unlock();
 }
 
 int
@@ -511,17 +1457,241 @@ dtls_ecdsa_verify_sig(const unsigned char *pub_key_x,
   return dtls_ecdsa_verify_sig_hash(pub_key_x, pub_key_y, key_size, sha256hash,
 				    sizeof(sha256hash), result_r, result_s);
 }
+
+int
+dtls_x25519_generate_key(unsigned char *priv_key,
+			 unsigned char *pub_key) {
+  if (!dtls_prng(priv_key, CURVE25519_KEY_SIZE))
+    return -1;
+  ecc_x25519_base(pub_key, priv_key);
+  return 0;
+}
+
+#ifdef DTLS_NTRU
+int
+dtls_ntru_generate_key(NTRU_PRIVATE_KEY *priv_key) {
+  NTRU_PUBLIC_KEY pub_key;
+  unsigned char seed[NTRU_SEED_LEN];
+
+  /* ntru_keygen() gives up after a few non-invertible candidates
+   * derived from the same seed, so just start over with a new one */
+  do {
+    if (!dtls_prng(seed, sizeof(seed)))
+      return -1;
+  } while (!ntru_keygen(priv_key, &pub_key, seed));
+  memset(seed, 0, sizeof(seed));
+  return 0;
+}
+
+int
+dtls_ntru_encaps(const NTRU_PUBLIC_KEY *pub_key,
+		 UINT16 *ciphertext, unsigned char *key) {
+  unsigned char seed[NTRU_SEED_LEN];
+
+  if (!dtls_prng(seed, sizeof(seed)))
+    return -1;
+  ntru_encaps(ciphertext, key, pub_key, seed);
+  memset(seed, 0, sizeof(seed));
+  return 0;
+}
+
+void
+dtls_ntru_decaps(const NTRU_PRIVATE_KEY *priv_key,
+		 const UINT16 *ciphertext, unsigned char *key) {
+  ntru_decaps(key, priv_key, ciphertext);
+}
+#endif /* DTLS_NTRU */
+
+int
+dtls_x25519_pre_master_secret(const unsigned char *priv_key,
+			      const unsigned char *pub_key,
+			      unsigned char *result, size_t result_len) {
+  if (result_len < CURVE25519_KEY_SIZE) {
+    return -1;
+  }
+
+  /* RFC 8422, section 5.11: abort on the all zero value */
+  if (ecc_x25519(result, priv_key, pub_key) < 0) {
+    return -1;
+  }
+  return CURVE25519_KEY_SIZE;
+}
+
+/* hashes the private key to the secret scalar and the nonce prefix */
+static void
+dtls_ed25519_expand_key(const unsigned char *priv_key, unsigned char *hash) {
+  dtls_sha512_ctx data;
+
+  dtls_sha512_init(&data);
+  dtls_sha512_update(&data, priv_key, CURVE25519_KEY_SIZE);
+  dtls_sha512_final(hash, &data);
+
+  hash[0] &= 248;
+  hash[31] &= 127;
+  hash[31] |= 64;
+}
+
+void
+dtls_ed25519_public_key(const unsigned char *priv_key,
+			unsigned char *pub_key) {
+  unsigned char hash[DTLS_SHA512_DIGEST_LENGTH];
+
+  dtls_ed25519_expand_key(priv_key, hash);
+  ecc_ed25519_base_mult(pub_key, hash);
+  memset(hash, 0, sizeof(hash));
+}
+
+/* The message is given in up to three parts to sign the
+ * ServerKeyExchange parameters without copying them. */
+static void
+dtls_ed25519_sign_parts(const unsigned char *priv_key,
+			const unsigned char *pub_key,
+			const unsigned char *part[3], const size_t part_size[3],
+			unsigned char *sig) {
+  dtls_sha512_ctx data;
+  unsigned char key[DTLS_SHA512_DIGEST_LENGTH];
+  unsigned char hash[DTLS_SHA512_DIGEST_LENGTH];
+  unsigned char r[CURVE25519_KEY_SIZE];
+  int i;
+
+  dtls_ed25519_expand_key(priv_key, key);
+
+  /* r = H(prefix || M) */
+  dtls_sha512_init(&data);
+  dtls_sha512_update(&data, key + CURVE25519_KEY_SIZE, CURVE25519_KEY_SIZE);
+  for (i = 0; i < 3; i++)
+    dtls_sha512_update(&data, part[i], part_size[i]);
+  dtls_sha512_final(hash, &data);
+  ecc_ed25519_reduce(r, hash);
+  ecc_ed25519_base_mult(sig, r);
+
+  /* S = r + H(R || A || M) a */
+  dtls_sha512_init(&data);
+  dtls_sha512_update(&data, sig, CURVE25519_KEY_SIZE);
+  dtls_sha512_update(&data, pub_key, CURVE25519_KEY_SIZE);
+  for (i = 0; i < 3; i++)
+    dtls_sha512_update(&data, part[i], part_size[i]);
+  dtls_sha512_final(hash, &data);
+  ecc_ed25519_reduce(hash, hash);
+  ecc_ed25519_muladd(sig + CURVE25519_KEY_SIZE, hash, key, r);
+
+  memset(key, 0, sizeof(key));
+  memset(r, 0, sizeof(r));
+}
+
+static int
+dtls_ed25519_verify_parts(const unsigned char *pub_key,
+			  const unsigned char *part[3], const size_t part_size[3],
+			  const unsigned char *sig) {
+  dtls_sha512_ctx data;
+  unsigned char hash[DTLS_SHA512_DIGEST_LENGTH];
+  int i;
+
+  dtls_sha512_init(&data);
+  dtls_sha512_update(&data, sig, CURVE25519_KEY_SIZE);
+  dtls_sha512_update(&data, pub_key, CURVE25519_KEY_SIZE);
+  for (i = 0; i < 3; i++)
+    dtls_sha512_update(&data, part[i], part_size[i]);
+  dtls_sha512_final(hash, &data);
+
+  return ecc_ed25519_validate(pub_key, hash, sig, sig + CURVE25519_KEY_SIZE);
+}
+
+void
+dtls_ed25519_create_sig_msg(const unsigned char *priv_key,
+			    const unsigned char *pub_key,
+			    const unsigned char *msg, size_t msg_size,
+			    unsigned char *sig) {
+  const unsigned char *part[3] = { msg, NULL, NULL };
+  const size_t part_size[3] = { msg_size, 0, 0 };
+
+  dtls_ed25519_sign_parts(priv_key, pub_key, part, part_size, sig);
+}
+
+void
+dtls_ed25519_create_sig(const unsigned char *priv_key,
+			const unsigned char *pub_key,
+			const unsigned char *client_random, size_t client_random_size,
+			const unsigned char *server_random, size_t server_random_size,
+			const unsigned char *keyx_params, size_t keyx_params_size,
+			unsigned char *sig) {
+  const unsigned char *part[3] = { client_random, server_random, keyx_params };
+  const size_t part_size[3] = {
+    client_random_size, server_random_size, keyx_params_size
+  };
+
+  dtls_ed25519_sign_parts(priv_key, pub_key, part, part_size, sig);
+}
+
+int
+dtls_ed25519_verify_sig_msg(const unsigned char *pub_key,
+			    const unsigned char *msg, size_t msg_size,
+			    const unsigned char *sig) {
+  const unsigned char *part[3] = { msg, NULL, NULL };
+  const size_t part_size[3] = { msg_size, 0, 0 };
+
+  return dtls_ed25519_verify_parts(pub_key, part, part_size, sig);
+}
+
+int
+dtls_ed25519_verify_sig(const unsigned char *pub_key,
+			const unsigned char *client_random, size_t client_random_size,
+			const unsigned char *server_random, size_t server_random_size,
+			const unsigned char *keyx_params, size_t keyx_params_size,
+			const unsigned char *sig) {
+  const unsigned char *part[3] = { client_random, server_random, keyx_params };
+  const size_t part_size[3] = {
+    client_random_size, server_random_size, keyx_params_size
+  };
+
+  return dtls_ed25519_verify_parts(pub_key, part, part_size, sig);
+}
 #endif /* DTLS_ECC */
 
 int 
-dtls_encrypt(const unsigned char *src, size_t length,
+dtls_encrypt(dtls_cipher_t cipher,
+	     const unsigned char *src, size_t length,
 	     unsigned char *buf,
 	     unsigned char *nounce,
 	     unsigned char *key, size_t keylen,
 	     const unsigned char *aad, size_t la)
 {
   int ret;
-  struct dtls_cipher_context_t *ctx = dtls_cipher_context_get();
+  struct dtls_cipher_context_t *ctx;
+
+#ifdef DTLS_CHACHA20
+  /* ChaCha20 needs no key setup and no shared context */
+  if (dtls_cipher_is_chacha20(cipher)) {
+    if (keylen != DTLS_CHACHA20_KEY_SIZE) {
+      dtls_warn("cannot set chacha20 key\n");
+      return -1;
+    }
+    if (src != buf)
+      memmove(buf, src, length);
+    return dtls_chacha20_poly1305_encrypt_message(key, nounce, buf, length,
+					     aad, la);
+  }
+#endif /* DTLS_CHACHA20 */
+
+  ctx = dtls_cipher_context_get();
+#ifdef DTLS_GCM
+  if (dtls_cipher_is_gcm(cipher)) {
+    ret = dtls_gcm_init(&ctx->gcm, key, keylen);
+    if (ret < 0) {
+      dtls_warn("cannot set gcm key\n");
+      goto error;
+    }
+
+    if (src != buf)
+      memmove(buf, src, length);
+    ret = dtls_gcm_encrypt_message(&ctx->gcm, nounce, buf, length, aad, la);
+    dtls_cipher_context_release();
+    return ret;
+  }
+#endif /* DTLS_GCM */
+#if !defined(DTLS_GCM) && !defined(DTLS_CHACHA20)
+  (void)cipher;
+#endif /* !DTLS_GCM && !DTLS_CHACHA20 */
 
   ret = rijndael_set_key_enc_only(&ctx->data.ctx, key, 8 * keylen);
   if (ret < 0) {
@@ -540,14 +1710,49 @@ error:
 }
 
 int 
-dtls_decrypt(const unsigned char *src, size_t length,
+dtls_decrypt(dtls_cipher_t cipher,
+	     const unsigned char *src, size_t length,
 	     unsigned char *buf,
 	     unsigned char *nounce,
 	     unsigned char *key, size_t keylen,
 	     const unsigned char *aad, size_t la)
 {
   int ret;
-  struct dtls_cipher_context_t *ctx = dtls_cipher_context_get();
+  struct dtls_cipher_context_t *ctx;
+
+#ifdef DTLS_CHACHA20
+  /* ChaCha20 needs no key setup and no shared context */
+  if (dtls_cipher_is_chacha20(cipher)) {
+    if (keylen != DTLS_CHACHA20_KEY_SIZE) {
+      dtls_warn("cannot set chacha20 key\n");
+      return -1;
+    }
+    if (src != buf)
+      memmove(buf, src, length);
+    return dtls_chacha20_poly1305_decrypt_message(key, nounce, buf, length,
+					     aad, la);
+  }
+#endif /* DTLS_CHACHA20 */
+
+  ctx = dtls_cipher_context_get();
+#ifdef DTLS_GCM
+  if (dtls_cipher_is_gcm(cipher)) {
+    ret = dtls_gcm_init(&ctx->gcm, key, keylen);
+    if (ret < 0) {
+      dtls_warn("cannot set gcm key\n");
+      goto error;
+    }
+
+    if (src != buf)
+      memmove(buf, src, length);
+    ret = dtls_gcm_decrypt_message(&ctx->gcm, nounce, buf, length, aad, la);
+    dtls_cipher_context_release();
+    return ret;
+  }
+#endif /* DTLS_GCM */
+#if !defined(DTLS_GCM) && !defined(DTLS_CHACHA20)
+  (void)cipher;
+#endif /* !DTLS_GCM && !DTLS_CHACHA20 */
 
   ret = rijndael_set_key_enc_only(&ctx->data.ctx, key, 8 * keylen);
   if (ret < 0) {
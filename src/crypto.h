@@ -29,21 +29,37 @@
 #include "numeric.h"
 #include "hmac.h"
 #include "ccm.h"
-
-/* TLS_PSK_WITH_AES_128_CCM_8 */
+#include "gcm.h"
+#include "chacha20poly1305.h"
+#ifdef DTLS_NTRU
+#include "ntru/ntru_kem.h"
+#endif /* DTLS_NTRU */
+
+/* TLS_PSK_WITH_AES_128_CCM_8, the AES_128_GCM_SHA256 suites use the
+ * same key block */
 #define DTLS_MAC_KEY_LENGTH    0
 #define DTLS_KEY_LENGTH        16 /* AES-128 */
 #define DTLS_BLK_LENGTH        16 /* AES-128 */
 #define DTLS_MAC_LENGTH        DTLS_HMAC_DIGEST_SIZE
 #define DTLS_IV_LENGTH         4  /* length of nonce_explicit */
 
+/* the CHACHA20_POLY1305_SHA256 suites, RFC 7905 */
+#define DTLS_CHACHA20_KEY_LENGTH DTLS_CHACHA20_KEY_SIZE
+#define DTLS_CHACHA20_IV_LENGTH  DTLS_CHACHA20_NONCE_SIZE /* fixed_iv */
+
 /** 
  * Maximum size of the generated keyblock. Note that MAX_KEYBLOCK_LENGTH must 
  * be large enough to hold the pre_master_secret, i.e. twice the length of the 
  * pre-shared key + 1.
  */
+#ifdef DTLS_CHACHA20
+#define MAX_KEYBLOCK_LENGTH  \
+  (2 * DTLS_MAC_KEY_LENGTH + 2 * DTLS_CHACHA20_KEY_LENGTH + \
+   2 * DTLS_CHACHA20_IV_LENGTH)
+#else /* DTLS_CHACHA20 */
 #define MAX_KEYBLOCK_LENGTH  \
   (2 * DTLS_MAC_KEY_LENGTH + 2 * DTLS_KEY_LENGTH + 2 * DTLS_IV_LENGTH)
+#endif /* DTLS_CHACHA20 */
 
 /** Length of DTLS master_secret */
 #define DTLS_MASTER_SECRET_LENGTH 48
@@ -53,7 +69,10 @@ typedef enum { AES128=0
 } dtls_crypto_alg;
 
 typedef enum {
-  DTLS_ECDH_CURVE_SECP256R1
+  DTLS_ECDH_CURVE_SECP256R1,
+  DTLS_ECDH_CURVE_X25519,	/**< key exchange only, see RFC 7748 */
+  DTLS_ECDH_CURVE_ED25519,	/**< signatures only, see RFC 8032 */
+  DTLS_ECDH_CURVE_SECP256R1_NTRU /**< secp256r1 combined with NTRU EES401EP2 */
 } dtls_ecdh_curve;
 
 /** Crypto context for TLS_PSK_WITH_AES_128_CCM_8 cipher suite. */
@@ -64,16 +83,106 @@ typedef struct {
 typedef struct dtls_cipher_context_t {
   /** numeric identifier of this cipher suite in host byte order. */
   aes128_ccm_t data;		/**< The crypto context */
+#ifdef DTLS_GCM
+  dtls_gcm_ctx gcm;		/**< context of the AES_128_GCM suites */
+#endif /* DTLS_GCM */
 } dtls_cipher_context_t;
 
+/** Returns true if @p Cipher is one of the AES_128_GCM_SHA256 suites. */
+#define dtls_cipher_is_gcm(Cipher)					\
+  ((Cipher) == TLS_PSK_WITH_AES_128_GCM_SHA256 ||			\
+   (Cipher) == TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256)
+
+/** Returns true if @p Cipher is one of the CHACHA20_POLY1305_SHA256 suites. */
+#define dtls_cipher_is_chacha20(Cipher)					\
+  ((Cipher) == TLS_PSK_WITH_CHACHA20_POLY1305_SHA256 ||			\
+   (Cipher) == TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256)
+
+/** Length of the authentication tag that dtls_encrypt() appends. */
+#define dtls_aead_tag_size(Cipher)					\
+  (dtls_cipher_is_gcm(Cipher) ? DTLS_GCM_TAG_SIZE			\
+   : dtls_cipher_is_chacha20(Cipher) ? DTLS_POLY1305_TAG_SIZE : 8)
+
+/**
+ * Length of the nonce_explicit in front of the ciphertext of a record.
+ * RFC 7905 derives the whole nonce from the sequence number instead.
+ */
+#define dtls_record_nonce_size(Cipher)					\
+  (dtls_cipher_is_chacha20(Cipher) ? 0 : 8)
+
 typedef struct {
+  dtls_ecdh_curve curve;	    /**< curve of the ephemeral keys */
+  dtls_ecdh_curve other_pub_curve; /**< curve of other_pub_x and other_pub_y */
+  unsigned int other_ecdsa:1;	    /**< peer accepts ecdsa with sha256 */
+  unsigned int other_ed25519:1;	    /**< peer accepts Ed25519 */
   uint8 own_eph_priv[32];
   uint8 other_eph_pub_x[32];
   uint8 other_eph_pub_y[32];
   uint8 other_pub_x[32];
   uint8 other_pub_y[32];
+#ifdef DTLS_NTRU
+  union {
+    NTRU_PRIVATE_KEY own_priv;	/**< ephemeral NTRU key of the server */
+    UINT16 ciphertext[NTRU_N];	/**< encapsulation sent by the client */
+  } ntru;
+  uint8 ntru_key[NTRU_KEY_LEN];	/**< secret shared through NTRU */
+#endif /* DTLS_NTRU */
 } dtls_handshake_parameters_ecdsa_t;
 
+/**
+ * Maximum number of CertificateVerify signatures that are collected
+ * before they are verified together, see dtls_ecdsa_batch_add().
+ */
+#ifndef DTLS_ECDSA_BATCH_SIZE
+#ifdef WITH_CONTIKI
+#define DTLS_ECDSA_BATCH_SIZE 1
+#else /* WITH_CONTIKI */
+#define DTLS_ECDSA_BATCH_SIZE 8
+#endif /* WITH_CONTIKI */
+#endif /* DTLS_ECDSA_BATCH_SIZE */
+
+/**
+ * Number of peer public keys for which the precomputed tables used to
+ * verify their signatures are kept. The tables depend on nothing but
+ * the public key, whether a key is accepted is always decided by the
+ * verify_ecdsa_key callback.
+ */
+#ifndef DTLS_ECDSA_KEY_CACHE_SIZE
+#ifdef WITH_CONTIKI
+#define DTLS_ECDSA_KEY_CACHE_SIZE 0
+#else /* WITH_CONTIKI */
+#define DTLS_ECDSA_KEY_CACHE_SIZE 64
+#endif /* WITH_CONTIKI */
+#endif /* DTLS_ECDSA_KEY_CACHE_SIZE */
+
+/**
+ * Maximum number of signing nonces that are precomputed for the private
+ * key that signed last, see dtls_ecdsa_sign_pool_configure(). The pool
+ * is left out if this is 0.
+ */
+#ifndef DTLS_ECDSA_SIGN_POOL_SIZE
+#ifdef WITH_CONTIKI
+#define DTLS_ECDSA_SIGN_POOL_SIZE 0
+#else /* WITH_CONTIKI */
+#define DTLS_ECDSA_SIGN_POOL_SIZE 64
+#endif /* WITH_CONTIKI */
+#endif /* DTLS_ECDSA_SIGN_POOL_SIZE */
+
+/**
+ * If not 0, the signing nonces can be computed by a background
+ * thread, with the SCHED_IDLE policy where it is available. The
+ * thread is only started once the application asks for it with
+ * dtls_ecdsa_sign_pool_configure(). Otherwise the application has to
+ * call dtls_ecdsa_sign_pool_refill() when it has time to spare.
+ */
+#ifndef DTLS_ECDSA_SIGN_POOL_THREAD
+#if defined(WITH_CONTIKI) || DTLS_ECDSA_SIGN_POOL_SIZE == 0
+#define DTLS_ECDSA_SIGN_POOL_THREAD 0
+#else /* WITH_CONTIKI */
+#define DTLS_ECDSA_SIGN_POOL_THREAD 1
+#endif /* WITH_CONTIKI */
+#endif /* DTLS_ECDSA_SIGN_POOL_THREAD */
+
 /* This is the maximal supported length of the psk client identity and psk
  * server identity hint */
 #define DTLS_PSK_MAX_CLIENT_IDENTITY_LEN   32
@@ -126,6 +235,11 @@ typedef struct {
   dtls_compression_t compression;		/**< compression method */
   dtls_cipher_t cipher;		/**< cipher type */
   unsigned int do_client_auth:1;
+  /* Written by whichever thread verifies the queue, so these are not
+   * bit-fields next to do_client_auth and only accessed with the queue
+   * locked, see dtls_ecdsa_batch_result(). */
+  int ecdsa_verify_pending;	/**< signature queued with dtls_ecdsa_batch_add() */
+  int ecdsa_verify_failed;	/**< result of the queued signature */
   union {
 #ifdef DTLS_ECC
     dtls_handshake_parameters_ecdsa_t ecdsa;
@@ -154,7 +268,7 @@ typedef struct {
 #define dtls_kb_client_write_key(Param, Role)				\
   (dtls_kb_server_mac_secret(Param, Role) + DTLS_MAC_KEY_LENGTH)
 #define dtls_kb_server_write_key(Param, Role)				\
-  (dtls_kb_client_write_key(Param, Role) + DTLS_KEY_LENGTH)
+  (dtls_kb_client_write_key(Param, Role) + dtls_kb_key_size(Param, Role))
 #define dtls_kb_remote_write_key(Param, Role)				\
   ((Role) == DTLS_SERVER						\
    ? dtls_kb_client_write_key(Param, Role)				\
@@ -163,11 +277,13 @@ typedef struct {
   ((Role) == DTLS_CLIENT						\
    ? dtls_kb_client_write_key(Param, Role)				\
    : dtls_kb_server_write_key(Param, Role))
-#define dtls_kb_key_size(Param, Role) DTLS_KEY_LENGTH
+#define dtls_kb_key_size(Param, Role)					\
+  (dtls_cipher_is_chacha20((Param)->cipher)				\
+   ? DTLS_CHACHA20_KEY_LENGTH : DTLS_KEY_LENGTH)
 #define dtls_kb_client_iv(Param, Role)					\
-  (dtls_kb_server_write_key(Param, Role) + DTLS_KEY_LENGTH)
+  (dtls_kb_server_write_key(Param, Role) + dtls_kb_key_size(Param, Role))
 #define dtls_kb_server_iv(Param, Role)					\
-  (dtls_kb_client_iv(Param, Role) + DTLS_IV_LENGTH)
+  (dtls_kb_client_iv(Param, Role) + dtls_kb_iv_size(Param, Role))
 #define dtls_kb_remote_iv(Param, Role)					\
   ((Role) == DTLS_SERVER						\
    ? dtls_kb_client_iv(Param, Role)					\
@@ -176,7 +292,9 @@ typedef struct {
   ((Role) == DTLS_CLIENT						\
    ? dtls_kb_client_iv(Param, Role)					\
    : dtls_kb_server_iv(Param, Role))
-#define dtls_kb_iv_size(Param, Role) DTLS_IV_LENGTH
+#define dtls_kb_iv_size(Param, Role)					\
+  (dtls_cipher_is_chacha20((Param)->cipher)				\
+   ? DTLS_CHACHA20_IV_LENGTH : DTLS_IV_LENGTH)
 
 #define dtls_kb_size(Param, Role)					\
   (2 * (dtls_kb_mac_secret_size(Param, Role) +				\
@@ -195,11 +313,10 @@ typedef struct {
  * \param keylen  Length of \p key.
  * \param seed    The seed. 
  * \param seedlen Length of \p seed.
- * \param buf     Output buffer where the result is XORed into
- *                The buffe must be capable to hold at least
+ * \param buf     Output buffer where the result is written to.
+ *                The buffer must be capable to hold at least
  *                \p buflen bytes.
- * \return The actual number of bytes written to \p buf or 0
- * on error.
+ * \return The actual number of bytes written to \p buf.
  */
 size_t dtls_p_hash(dtls_hashfunc_t h, 
 		   const unsigned char *key, size_t keylen,
@@ -219,6 +336,28 @@ size_t dtls_prf(const unsigned char *key, size_t keylen,
 		const unsigned char *random2, size_t random2len,
 		unsigned char *buf, size_t buflen);
 
+/**
+ * Derives the master secret and the key block of a session, see
+ * section 8.1 and 6.3 of RFC 5246. Each secret is hashed into an HMAC
+ * key state only once and all HMAC computations run on the stack.
+ * @p key_block may be the buffer that holds @p pre_master_secret.
+ *
+ * \param pre_master_secret The pre master secret.
+ * \param pre_master_len    Length of \p pre_master_secret.
+ * \param client_random     The client random, DTLS_RANDOM_LENGTH bytes.
+ * \param server_random     The server random, DTLS_RANDOM_LENGTH bytes.
+ * \param master_secret     Output buffer for DTLS_MASTER_SECRET_LENGTH
+ *                          bytes of master secret.
+ * \param key_block         Output buffer for the key block.
+ * \param key_block_len     Length of the key block.
+ */
+void dtls_key_schedule(const unsigned char *pre_master_secret,
+		       size_t pre_master_len,
+		       const unsigned char *client_random,
+		       const unsigned char *server_random,
+		       unsigned char *master_secret,
+		       unsigned char *key_block, size_t key_block_len);
+
 /**
  * Calculates MAC for record + cleartext packet and places the result
  * in \p buf. The given \p hmac_ctx must be initialized with the HMAC
@@ -250,7 +389,7 @@ void dtls_mac(dtls_hmac_context_t *hmac_ctx,
  * function returns a value less than zero on error or otherwise the
  * number of bytes written.
  *
- * \param ctx    The cipher context to use.
+ * \param cipher The cipher suite, which selects CCM, GCM or ChaCha20.
  * \param src    The data to encrypt.
  * \param length The actual size of of \p src.
  * \param buf    The result buffer. \p src and \p buf must not 
@@ -260,7 +399,8 @@ void dtls_mac(dtls_hmac_context_t *hmac_ctx,
  * \return The number of encrypted bytes on success, less than zero
  *         otherwise. 
  */
-int dtls_encrypt(const unsigned char *src, size_t length,
+int dtls_encrypt(dtls_cipher_t cipher,
+		 const unsigned char *src, size_t length,
 		 unsigned char *buf,
 		 unsigned char *nounce,
 		 unsigned char *key, size_t keylen,
@@ -275,7 +415,7 @@ int dtls_encrypt(const unsigned char *src, size_t length,
  * block have been processed. Unlike dtls_encrypt(), the source
  * and destination of dtls_decrypt() may overlap. 
  * 
- * \param ctx     The cipher context to use.
+ * \param cipher  The cipher suite, which selects CCM, GCM or ChaCha20.
  * \param src     The buffer to decrypt.
  * \param length  The length of the input buffer. 
  * \param buf     The result buffer.
@@ -284,7 +424,8 @@ int dtls_encrypt(const unsigned char *src, size_t length,
  * \return Less than zero on error, the number of decrypted bytes 
  *         otherwise.
  */
-int dtls_decrypt(const unsigned char *src, size_t length,
+int dtls_decrypt(dtls_cipher_t cipher,
+		 const unsigned char *src, size_t length,
 		 unsigned char *buf,
 		 unsigned char *nounce,
 		 unsigned char *key, size_t keylen,
@@ -314,15 +455,26 @@ int dtls_ecdh_pre_master_secret(unsigned char *priv_key,
                                 unsigned char *result,
                                 size_t result_len);
 
-void dtls_ecdsa_generate_key(unsigned char *priv_key,
-			     unsigned char *pub_key_x,
-			     unsigned char *pub_key_y,
-			     size_t key_size);
+/**
+ * Generates an ECDSA (or ECDH) key pair on secp256r1. Returns @c 0 on
+ * success, or a value less than zero if dtls_prng() failed.
+ */
+int dtls_ecdsa_generate_key(unsigned char *priv_key,
+			    unsigned char *pub_key_x,
+			    unsigned char *pub_key_y,
+			    size_t key_size);
 
 void dtls_ecdsa_create_sig_hash(const unsigned char *priv_key, size_t key_size,
 				const unsigned char *sign_hash, size_t sign_hash_size,
 				uint32_t point_r[9], uint32_t point_s[9]);
 
+/**
+ * Forgets the RFC 6979 state precomputed for the last private key
+ * that signed. Called by dtls_free_context(), and in the child after
+ * fork().
+ */
+void dtls_ecdsa_sign_cache_clear(void);
+
 void dtls_ecdsa_create_sig(const unsigned char *priv_key, size_t key_size,
 			   const unsigned char *client_random, size_t client_random_size,
 			   const unsigned char *server_random, size_t server_random_size,
@@ -341,6 +493,172 @@ int dtls_ecdsa_verify_sig(const unsigned char *pub_key_x,
 			  const unsigned char *keyx_params, size_t keyx_params_size,
 			  unsigned char *result_r, unsigned char *result_s);
 
+/**
+ * Queues a signature for verification with the next call of
+ * dtls_ecdsa_batch_verify(). The result is stored in the flags @c
+ * ecdsa_verify_pending and @c ecdsa_verify_failed of @p handshake,
+ * read it with dtls_ecdsa_batch_result().
+ * When the queue is full, all queued signatures are verified first.
+ * Signatures of a handshake that is released with dtls_handshake_free()
+ * are removed from the queue.
+ *
+ * @param handshake The handshake waiting for the result.
+ * @return 0 on success, a value less than zero on error.
+ */
+int dtls_ecdsa_batch_add(dtls_handshake_parameters_t *handshake,
+			 const unsigned char *pub_key_x,
+			 const unsigned char *pub_key_y, size_t key_size,
+			 const unsigned char *sign_hash, size_t sign_hash_size,
+			 unsigned char *result_r, unsigned char *result_s);
+
+/**
+ * Verifies all signatures queued with dtls_ecdsa_batch_add() together
+ * and stores the results in the respective handshakes. Only the
+ * inversions are shared, each signature is verified on its own, see
+ * ecc_ecdsa_validate_batch().
+ */
+void dtls_ecdsa_batch_verify(void);
+
+/**
+ * Returns the result of the signature queued for @p handshake, and
+ * verifies the queue first if it has not been verified yet. The queue
+ * may be verified by another thread at the same time, so the flags of
+ * the handshake must only be read this way.
+ *
+ * @return 0 if the signature is valid, a value less than zero if not.
+ */
+int dtls_ecdsa_batch_result(dtls_handshake_parameters_t *handshake);
+
+/**
+ * Removes all keys from the key cache, e.g. to release the memory of
+ * the tables of peers that will not come back.
+ */
+void dtls_ecdsa_key_cache_flush(void);
+
+/** Counters of the pool of signing nonces. */
+typedef struct {
+  int depth;			/**< configured number of nonces */
+  int available;		/**< nonces ready for the next signatures */
+  unsigned long hits;		/**< signatures made with a ready nonce */
+  unsigned long misses;		/**< signatures computed completely on demand */
+  unsigned long refilled;	/**< nonces computed in advance */
+} dtls_ecdsa_sign_pool_stats_t;
+
+/**
+ * Sets the number of nonces that are kept ready for signing and
+ * whether the background thread refills them (if compiled in with
+ * DTLS_ECDSA_SIGN_POOL_THREAD, off by default). @p depth is limited to
+ * DTLS_ECDSA_SIGN_POOL_SIZE, a depth of 0 disables the pool and all
+ * nonces are derived from the message as in RFC 6979.
+ *
+ * For a nonce from the pool, only s = k^-1 (e + r d) mod n is left to
+ * compute when the message is known. Such a nonce is derived from the
+ * SHA-256 hash of the private key and fresh output of dtls_prng(), so
+ * these signatures are not deterministic. The pool keeps only the hash,
+ * never the key itself.
+ */
+void dtls_ecdsa_sign_pool_configure(int depth, int use_thread);
+
+/**
+ * Assigns the pool to the private key @p priv_key before it signs for
+ * the first time. Otherwise the pool is assigned to the key of the
+ * first signature and the following signatures with other keys are
+ * misses. With @p priv_key NULL, the pool drops its nonces and is free
+ * for the next key that signs.
+ */
+void dtls_ecdsa_sign_pool_bind(const unsigned char *priv_key, size_t key_size);
+
+/**
+ * Computes up to @p max nonces for the pool if there is room.
+ *
+ * @return The number of nonces that have been added.
+ */
+int dtls_ecdsa_sign_pool_refill(int max);
+
+/** Copies the counters of the pool to @p stats. */
+void dtls_ecdsa_sign_pool_stats(dtls_ecdsa_sign_pool_stats_t *stats);
+
+/**
+ * Generates an ephemeral X25519 key pair, see RFC 7748. Returns @c 0
+ * on success, or a value less than zero if dtls_prng() failed.
+ */
+int dtls_x25519_generate_key(unsigned char *priv_key,
+			     unsigned char *pub_key);
+
+/**
+ * Computes the X25519 shared secret of @p priv_key and the public key
+ * @p pub_key of the other peer. Returns the length of @p result or a
+ * value less than zero when the shared secret is all zero.
+ */
+int dtls_x25519_pre_master_secret(const unsigned char *priv_key,
+				  const unsigned char *pub_key,
+				  unsigned char *result, size_t result_len);
+
+#ifdef DTLS_NTRU
+/**
+ * Generates an ephemeral NTRU EES401EP2 key pair. The public key is
+ * available as @p priv_key->pub. Returns @c 0 on success, or a value
+ * less than zero if dtls_prng() failed.
+ */
+int dtls_ntru_generate_key(NTRU_PRIVATE_KEY *priv_key);
+
+/**
+ * Encapsulates a fresh random secret to @p pub_key. The ciphertext
+ * is written to @p ciphertext and the secret of NTRU_KEY_LEN bytes to
+ * @p key. Returns @c 0 on success, or a value less than zero if
+ * dtls_prng() failed.
+ */
+int dtls_ntru_encaps(const NTRU_PUBLIC_KEY *pub_key,
+		     UINT16 *ciphertext, unsigned char *key);
+
+/**
+ * Recovers the secret of NTRU_KEY_LEN bytes encapsulated in @p
+ * ciphertext. An invalid ciphertext yields an unrelated pseudo-random
+ * secret, so the handshake fails at the Finished message.
+ */
+void dtls_ntru_decaps(const NTRU_PRIVATE_KEY *priv_key,
+		      const UINT16 *ciphertext, unsigned char *key);
+#endif /* DTLS_NTRU */
+
+/** Length of an Ed25519 signature */
+#define DTLS_ED25519_SIG_SIZE 64
+
+/**
+ * Computes the Ed25519 public key of the 32 byte private key @p priv_key.
+ */
+void dtls_ed25519_public_key(const unsigned char *priv_key,
+			     unsigned char *pub_key);
+
+/**
+ * Signs @p msg with the Ed25519 key pair @p priv_key and @p pub_key as
+ * done for the CertificateVerify message.
+ */
+void dtls_ed25519_create_sig_msg(const unsigned char *priv_key,
+				 const unsigned char *pub_key,
+				 const unsigned char *msg, size_t msg_size,
+				 unsigned char *sig);
+
+/**
+ * Signs the random values and the key exchange parameters as done for
+ * the ServerKeyExchange message.
+ */
+void dtls_ed25519_create_sig(const unsigned char *priv_key,
+			     const unsigned char *pub_key,
+			     const unsigned char *client_random, size_t client_random_size,
+			     const unsigned char *server_random, size_t server_random_size,
+			     const unsigned char *keyx_params, size_t keyx_params_size,
+			     unsigned char *sig);
+
+int dtls_ed25519_verify_sig_msg(const unsigned char *pub_key,
+				const unsigned char *msg, size_t msg_size,
+				const unsigned char *sig);
+
+int dtls_ed25519_verify_sig(const unsigned char *pub_key,
+			    const unsigned char *client_random, size_t client_random_size,
+			    const unsigned char *server_random, size_t server_random_size,
+			    const unsigned char *keyx_params, size_t keyx_params_size,
+			    const unsigned char *sig);
+
 int dtls_ec_key_from_uint32_asn1(const uint32_t *key, size_t key_size,
 				 unsigned char *buf);
 
@@ -59,6 +59,10 @@
 #  include "sha2/sha2.h"
 #endif
 
+#ifdef DTLS_ECC
+#  include "ecc/curve25519.h"
+#endif
+
 #define dtls_set_version(H,V) dtls_int_to_uint16((H)->version, (V))
 #define dtls_set_content_type(H,V) ((H)->content_type = (V) & 0xff)
 #define dtls_set_length(H,V)  ((H)->length = (V))
@@ -102,16 +106,44 @@
 #define DTLS_HS_LENGTH sizeof(dtls_handshake_header_t)
 #define DTLS_CH_LENGTH sizeof(dtls_client_hello_t) /* no variable length fields! */
 #define DTLS_COOKIE_LENGTH_MAX 32
-#define DTLS_CH_LENGTH_MAX sizeof(dtls_client_hello_t) + DTLS_COOKIE_LENGTH_MAX + 12 + 26
+#define DTLS_CH_LENGTH_MAX sizeof(dtls_client_hello_t) + DTLS_COOKIE_LENGTH_MAX + 20 + 40
 #define DTLS_HV_LENGTH sizeof(dtls_hello_verify_t)
 #define DTLS_SH_LENGTH (2 + DTLS_RANDOM_LENGTH + 1 + 2 + 1)
 #define DTLS_CE_LENGTH (3 + 3 + 27 + DTLS_EC_KEY_SIZE + DTLS_EC_KEY_SIZE)
 #define DTLS_SKEXEC_LENGTH (1 + 2 + 1 + 1 + DTLS_EC_KEY_SIZE + DTLS_EC_KEY_SIZE + 1 + 1 + 2 + 70)
+#define DTLS_SKEX25519_LENGTH_MIN (1 + 2 + 1 + CURVE25519_KEY_SIZE + 1 + 1 + 2 + 64)
 #define DTLS_SKEXECPSK_LENGTH_MIN 2
 #define DTLS_SKEXECPSK_LENGTH_MAX 2 + DTLS_PSK_MAX_CLIENT_IDENTITY_LEN
 #define DTLS_CKXPSK_LENGTH_MIN 2
 #define DTLS_CKXEC_LENGTH (1 + 1 + DTLS_EC_KEY_SIZE + DTLS_EC_KEY_SIZE)
+#define DTLS_CKX25519_LENGTH (1 + CURVE25519_KEY_SIZE)
 #define DTLS_CV_LENGTH (1 + 1 + 2 + 1 + 1 + 1 + 1 + DTLS_EC_KEY_SIZE + 1 + 1 + DTLS_EC_KEY_SIZE)
+#define DTLS_ED25519_SIG_ELEM_LENGTH (1 + 1 + 2 + DTLS_ED25519_SIG_SIZE)
+#ifdef DTLS_NTRU
+#if NTRU_PARAM_SET != 401
+/* TLS_EXT_ELLIPTIC_CURVES_SECP256R1_NTRU is defined for EES401EP2 only */
+#error "DTLS_NTRU requires NTRU_PARAM_SET 401"
+#endif
+/* public key and ciphertext with 11 bits per coefficient, see ntru_pack() */
+#define DTLS_NTRU_POLY_LENGTH NTRU_PACKED_LEN
+#define DTLS_NTRU_KEYX_LENGTH (2 + DTLS_NTRU_POLY_LENGTH)
+#define DTLS_CH_CURVES_LENGTH 6 /* secp256r1+NTRU, x25519, secp256r1 */
+#else /* DTLS_NTRU */
+#define DTLS_NTRU_KEYX_LENGTH 0
+#define DTLS_CH_CURVES_LENGTH 4 /* x25519, secp256r1 */
+#endif /* DTLS_NTRU */
+#ifdef DTLS_GCM
+#define DTLS_CH_GCM_LENGTH 2 /* AES_128_GCM_SHA256 */
+#else /* DTLS_GCM */
+#define DTLS_CH_GCM_LENGTH 0
+#endif /* DTLS_GCM */
+#ifdef DTLS_CHACHA20
+#define DTLS_CH_CHACHA20_LENGTH 2 /* CHACHA20_POLY1305_SHA256 */
+#else /* DTLS_CHACHA20 */
+#define DTLS_CH_CHACHA20_LENGTH 0
+#endif /* DTLS_CHACHA20 */
+/* cipher suites per key exchange, AES_128_CCM_8 is always offered */
+#define DTLS_CH_SUITES_LENGTH (2 + DTLS_CH_GCM_LENGTH + DTLS_CH_CHACHA20_LENGTH)
 #define DTLS_FIN_LENGTH 12
 
 #define HS_HDR_LENGTH  DTLS_RH_LENGTH + DTLS_HS_LENGTH
@@ -142,8 +174,6 @@
 #define PRF_LABEL(Label) prf_label_##Label
 #define PRF_LABEL_SIZE(Label) (sizeof(PRF_LABEL(Label)) - 1)
 
-static const unsigned char prf_label_master[] = "master secret";
-static const unsigned char prf_label_key[] = "key expansion";
 static const unsigned char prf_label_client[] = "client";
 static const unsigned char prf_label_server[] = "server";
 static const unsigned char prf_label_finished[] = " finished";
@@ -160,6 +190,15 @@ static const unsigned char cert_asn1_header[] = {
       0x03, 0x42, 0x00, /* BIT STRING, length 66 bytes, 0 bits unused */
          0x04 /* uncompressed, followed by the r und s values of the public key */
 };
+
+/* Subject Public Key of an Ed25519 key, see RFC 8410 */
+static const unsigned char cert_asn1_header_ed25519[] = {
+  0x30, 0x2A, /* SEQUENCE, length 42 bytes */
+    0x30, 0x05, /* SEQUENCE, length 5 bytes */
+      0x06, 0x03, /* OBJECT IDENTIFIER Ed25519 (1 3 101 112) */
+        0x2B, 0x65, 0x70,
+      0x03, 0x21, 0x00 /* BIT STRING, length 33 bytes, 0 bits unused */
+};
 #endif /* DTLS_ECC */
 
 #ifdef WITH_CONTIKI
@@ -307,14 +346,70 @@ dtls_get_cookie(uint8 *msg, size_t msglen, uint8 **cookie) {
   return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
 }
 
+/**
+ * Determines the parts of the Client Hello @p msg that are covered by
+ * the cookie: the @p head bytes after the handshake header (up to and
+ * including the session id), and the bytes from offset @p tail (i.e.
+ * after the cookie) to the end of the fragment.
+ */
+static int
+dtls_cookie_parts(uint8 *msg, size_t msglen, size_t *head, size_t *tail) {
+  size_t e;
+
+  e = sizeof(dtls_client_hello_t);
+  e += (*(msg + DTLS_HS_LENGTH + e) & 0xff) + sizeof(uint8);
+  if (e + DTLS_HS_LENGTH > msglen)
+    return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
+  *head = e;
+
+  /* skip cookie bytes and length byte */
+  e += *(uint8 *)(msg + DTLS_HS_LENGTH + e) & 0xff;
+  e += sizeof(uint8);
+  if (e + DTLS_HS_LENGTH > msglen)
+    return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
+  *tail = e;
+
+  return 0;
+}
+
+#if DTLS_COOKIE_BATCH > 1
+/** A cookie computed by dtls_handle_messages(). */
+struct dtls_cookie_batch_t {
+  const uint8 *msg;		/**< the Client Hello */
+  size_t msglen;		/**< its length */
+  unsigned char cookie[DTLS_HMAC_DIGEST_SIZE];
+};
+
+/**
+ * Copies the cookie of the Client Hello @p msg to @p buf and returns
+ * @c 1 if dtls_handle_messages() has computed it already, returns @c
+ * 0 otherwise.
+ */
+static int
+dtls_batched_cookie(dtls_context_t *ctx, const uint8 *msg, size_t msglen,
+		    unsigned char *buf) {
+  int i;
+
+  for (i = 0; i < ctx->cookie_batch_len; i++) {
+    if (ctx->cookie_batch[i].msg == msg && ctx->cookie_batch[i].msglen == msglen) {
+      memcpy(buf, ctx->cookie_batch[i].cookie, DTLS_HMAC_DIGEST_SIZE);
+      return 1;
+    }
+  }
+  return 0;
+}
+#else /* DTLS_COOKIE_BATCH > 1 */
+#define dtls_batched_cookie(ctx, msg, msglen, buf) 0
+#endif /* DTLS_COOKIE_BATCH > 1 */
+
 static int
 dtls_create_cookie(dtls_context_t *ctx, 
 		   session_t *session,
 		   uint8 *msg, size_t msglen,
 		   uint8 *cookie, int *clen) {
   unsigned char buf[DTLS_HMAC_MAX];
-  size_t e;
-  int len;
+  size_t head, tail;
+  int len, err;
 
   /* create cookie with HMAC-SHA256 over:
    * - SECRET
@@ -326,6 +421,12 @@ dtls_create_cookie(dtls_context_t *ctx,
    * - compression method
    */
 
+  /* the cookie may have been computed already by dtls_handle_messages() */
+  if (dtls_batched_cookie(ctx, msg, msglen, buf)) {
+    len = DTLS_HMAC_DIGEST_SIZE;
+    goto done;
+  }
+
   /* We use our own buffer as hmac_context instead of a dynamic buffer
    * created by dtls_hmac_new() to separate storage space for cookie
    * creation from storage that is used in real sessions. Note that
@@ -333,32 +434,26 @@ dtls_create_cookie(dtls_context_t *ctx,
    * implementation of dtls_hmac_context_new()). */
 
   dtls_hmac_context_t hmac_context;
+
+  err = dtls_cookie_parts(msg, msglen, &head, &tail);
+  if (err < 0)
+    return err;
+
   dtls_hmac_init(&hmac_context, ctx->cookie_secret, DTLS_COOKIE_SECRET_LENGTH);
 
   dtls_hmac_update(&hmac_context, 
 		   (unsigned char *)&session->addr, session->size);
 
   /* feed in the beginning of the Client Hello up to and including the
-     session id */
-  e = sizeof(dtls_client_hello_t);
-  e += (*(msg + DTLS_HS_LENGTH + e) & 0xff) + sizeof(uint8);
-  if (e + DTLS_HS_LENGTH > msglen)
-    return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
-
-  dtls_hmac_update(&hmac_context, msg + DTLS_HS_LENGTH, e);
-  
-  /* skip cookie bytes and length byte */
-  e += *(uint8 *)(msg + DTLS_HS_LENGTH + e) & 0xff;
-  e += sizeof(uint8);
-  if (e + DTLS_HS_LENGTH > msglen)
-    return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
-
+     session id, and everything after the cookie */
+  dtls_hmac_update(&hmac_context, msg + DTLS_HS_LENGTH, head);
   dtls_hmac_update(&hmac_context, 
-		   msg + DTLS_HS_LENGTH + e,
-		   dtls_get_fragment_length(DTLS_HANDSHAKE_HEADER(msg)) - e);
+		   msg + DTLS_HS_LENGTH + tail,
+		   dtls_get_fragment_length(DTLS_HANDSHAKE_HEADER(msg)) - tail);
 
   len = dtls_hmac_finalize(&hmac_context, buf);
 
+ done:
   if (len < *clen) {
     memset(cookie + len, 0, *clen - len);
     *clen = len;
@@ -494,6 +589,36 @@ static inline int is_tls_ecdhe_ecdsa_with_aes_128_ccm_8(dtls_cipher_t cipher)
 #endif /* DTLS_ECC */
 }
 
+/** returns true if the cipher matches TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256 */
+static inline int is_tls_ecdhe_ecdsa_with_aes_128_gcm_sha256(dtls_cipher_t cipher)
+{
+#if defined(DTLS_ECC) && defined(DTLS_GCM)
+  return cipher == TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256;
+#else
+  (void)cipher;
+  return 0;
+#endif /* DTLS_ECC && DTLS_GCM */
+}
+
+/** returns true if the cipher matches TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256 */
+static inline int is_tls_ecdhe_ecdsa_with_chacha20_poly1305_sha256(dtls_cipher_t cipher)
+{
+#if defined(DTLS_ECC) && defined(DTLS_CHACHA20)
+  return cipher == TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256;
+#else
+  (void)cipher;
+  return 0;
+#endif /* DTLS_ECC && DTLS_CHACHA20 */
+}
+
+/** returns true if the cipher uses the ECDHE_ECDSA key exchange */
+static inline int is_tls_ecdhe_ecdsa(dtls_cipher_t cipher)
+{
+  return is_tls_ecdhe_ecdsa_with_aes_128_ccm_8(cipher) ||
+    is_tls_ecdhe_ecdsa_with_aes_128_gcm_sha256(cipher) ||
+    is_tls_ecdhe_ecdsa_with_chacha20_poly1305_sha256(cipher);
+}
+
 /** returns true if the cipher matches TLS_PSK_WITH_AES_128_CCM_8 */
 static inline int is_tls_psk_with_aes_128_ccm_8(dtls_cipher_t cipher)
 {
@@ -504,6 +629,36 @@ static inline int is_tls_psk_with_aes_128_ccm_8(dtls_cipher_t cipher)
 #endif /* DTLS_PSK */
 }
 
+/** returns true if the cipher matches TLS_PSK_WITH_AES_128_GCM_SHA256 */
+static inline int is_tls_psk_with_aes_128_gcm_sha256(dtls_cipher_t cipher)
+{
+#if defined(DTLS_PSK) && defined(DTLS_GCM)
+  return cipher == TLS_PSK_WITH_AES_128_GCM_SHA256;
+#else
+  (void)cipher;
+  return 0;
+#endif /* DTLS_PSK && DTLS_GCM */
+}
+
+/** returns true if the cipher matches TLS_PSK_WITH_CHACHA20_POLY1305_SHA256 */
+static inline int is_tls_psk_with_chacha20_poly1305_sha256(dtls_cipher_t cipher)
+{
+#if defined(DTLS_PSK) && defined(DTLS_CHACHA20)
+  return cipher == TLS_PSK_WITH_CHACHA20_POLY1305_SHA256;
+#else
+  (void)cipher;
+  return 0;
+#endif /* DTLS_PSK && DTLS_CHACHA20 */
+}
+
+/** returns true if the cipher uses the PSK key exchange */
+static inline int is_tls_psk(dtls_cipher_t cipher)
+{
+  return is_tls_psk_with_aes_128_ccm_8(cipher) ||
+    is_tls_psk_with_aes_128_gcm_sha256(cipher) ||
+    is_tls_psk_with_chacha20_poly1305_sha256(cipher);
+}
+
 /** returns true if the application is configured for psk */
 static inline int is_psk_supported(dtls_context_t *ctx)
 {
@@ -527,6 +682,17 @@ static inline int is_ecdsa_supported(dtls_context_t *ctx, int is_client)
 #endif /* DTLS_ECC */
 }
 
+/** Returns true if the application accepts Ed25519 keys of the peer */
+static inline int is_ed25519_supported(dtls_context_t *ctx)
+{
+#ifdef DTLS_ECC
+  return ctx && ctx->h && ctx->h->verify_ed25519_key;
+#else
+  (void)ctx;
+  return 0;
+#endif /* DTLS_ECC */
+}
+
 /** Returns true if the application is configured for ecdhe_ecdsa with
   * client authentication */
 static inline int is_ecdsa_client_auth_supported(dtls_context_t *ctx)
@@ -555,8 +721,8 @@ known_cipher(dtls_context_t *ctx, dtls_cipher_t code, int is_client) {
 
   psk = is_psk_supported(ctx);
   ecdsa = is_ecdsa_supported(ctx, is_client);
-  return (psk && is_tls_psk_with_aes_128_ccm_8(code)) ||
-	 (ecdsa && is_tls_ecdhe_ecdsa_with_aes_128_ccm_8(code));
+  return (psk && is_tls_psk(code)) ||
+	 (ecdsa && is_tls_ecdhe_ecdsa(code));
 }
 
 /**
@@ -666,6 +832,10 @@ calculate_key_block(dtls_context_t *ctx,
   int pre_master_len = 0;
   dtls_security_parameters_t *security = dtls_security_params_next(peer);
   uint8 master_secret[DTLS_MASTER_SECRET_LENGTH];
+  int kb_size;
+#ifdef DTLS_NTRU
+  uint8 hybrid_pre_master[DTLS_EC_KEY_SIZE + NTRU_KEY_LEN];
+#endif /* DTLS_NTRU */
   (void)role; /* The macro dtls_kb_size() does not use role. */
 
   if (!security) {
@@ -676,7 +846,14 @@ calculate_key_block(dtls_context_t *ctx,
 
   switch (handshake->cipher) {
 #ifdef DTLS_PSK
-  case TLS_PSK_WITH_AES_128_CCM_8: {
+  case TLS_PSK_WITH_AES_128_CCM_8:
+#ifdef DTLS_GCM
+  case TLS_PSK_WITH_AES_128_GCM_SHA256:
+#endif /* DTLS_GCM */
+#ifdef DTLS_CHACHA20
+  case TLS_PSK_WITH_CHACHA20_POLY1305_SHA256:
+#endif /* DTLS_CHACHA20 */
+  {
     unsigned char psk[DTLS_PSK_MAX_KEY_LEN];
     int len;
 
@@ -705,7 +882,46 @@ calculate_key_block(dtls_context_t *ctx,
   }
 #endif /* DTLS_PSK */
 #ifdef DTLS_ECC
-  case TLS_ECDHE_ECDSA_WITH_AES_128_CCM_8: {
+  case TLS_ECDHE_ECDSA_WITH_AES_128_CCM_8:
+#ifdef DTLS_GCM
+  case TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256:
+#endif /* DTLS_GCM */
+#ifdef DTLS_CHACHA20
+  case TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256:
+#endif /* DTLS_CHACHA20 */
+  {
+    if (handshake->keyx.ecdsa.curve == DTLS_ECDH_CURVE_X25519) {
+      pre_master_len = dtls_x25519_pre_master_secret(handshake->keyx.ecdsa.own_eph_priv,
+						     handshake->keyx.ecdsa.other_eph_pub_x,
+						     pre_master_secret,
+						     MAX_KEYBLOCK_LENGTH);
+      if (pre_master_len < 0) {
+	dtls_alert("the x25519 shared secret is invalid\n");
+	return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
+      }
+      break;
+    }
+#ifdef DTLS_NTRU
+    if (handshake->keyx.ecdsa.curve == DTLS_ECDH_CURVE_SECP256R1_NTRU) {
+      /* The ECDH secret followed by the NTRU secret does not fit
+       * into the key_block. */
+      pre_master_secret = hybrid_pre_master;
+      pre_master_len = dtls_ecdh_pre_master_secret(handshake->keyx.ecdsa.own_eph_priv,
+						   handshake->keyx.ecdsa.other_eph_pub_x,
+						   handshake->keyx.ecdsa.other_eph_pub_y,
+						   sizeof(handshake->keyx.ecdsa.own_eph_priv),
+						   pre_master_secret,
+						   DTLS_EC_KEY_SIZE);
+      if (pre_master_len < 0) {
+	dtls_crit("the curve was too long, for the pre master secret\n");
+	return dtls_alert_fatal_create(DTLS_ALERT_INTERNAL_ERROR);
+      }
+      memcpy(pre_master_secret + pre_master_len,
+	     handshake->keyx.ecdsa.ntru_key, NTRU_KEY_LEN);
+      pre_master_len += NTRU_KEY_LEN;
+      break;
+    }
+#endif /* DTLS_NTRU */
     pre_master_len = dtls_ecdh_pre_master_secret(handshake->keyx.ecdsa.own_eph_priv,
 						 handshake->keyx.ecdsa.other_eph_pub_x,
 						 handshake->keyx.ecdsa.other_eph_pub_y,
@@ -737,6 +953,26 @@ calculate_key_block(dtls_context_t *ctx,
     /* fall through to default */
 #endif /* !DTLS_ECC */
 
+#if !defined(DTLS_PSK) || !defined(DTLS_GCM)
+  case TLS_PSK_WITH_AES_128_GCM_SHA256:
+    /* fall through to default */
+#endif /* !DTLS_PSK || !DTLS_GCM */
+
+#if !defined(DTLS_ECC) || !defined(DTLS_GCM)
+  case TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256:
+    /* fall through to default */
+#endif /* !DTLS_ECC || !DTLS_GCM */
+
+#if !defined(DTLS_PSK) || !defined(DTLS_CHACHA20)
+  case TLS_PSK_WITH_CHACHA20_POLY1305_SHA256:
+    /* fall through to default */
+#endif /* !DTLS_PSK || !DTLS_CHACHA20 */
+
+#if !defined(DTLS_ECC) || !defined(DTLS_CHACHA20)
+  case TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256:
+    /* fall through to default */
+#endif /* !DTLS_ECC || !DTLS_CHACHA20 */
+
   default:
     dtls_crit("calculate_key_block: unknown cipher %x04 \n", handshake->cipher);
     return dtls_alert_fatal_create(DTLS_ALERT_INTERNAL_ERROR);
@@ -746,31 +982,26 @@ calculate_key_block(dtls_context_t *ctx,
   dtls_debug_dump("server_random", handshake->tmp.random.server, DTLS_RANDOM_LENGTH);
   dtls_debug_dump("pre_master_secret", pre_master_secret, pre_master_len);
 
-  dtls_prf(pre_master_secret, pre_master_len,
-	   PRF_LABEL(master), PRF_LABEL_SIZE(master),
-	   handshake->tmp.random.client, DTLS_RANDOM_LENGTH,
-	   handshake->tmp.random.server, DTLS_RANDOM_LENGTH,
-	   master_secret,
-	   DTLS_MASTER_SECRET_LENGTH);
+  /* the layout of the key block depends on the cipher */
+  security->cipher = handshake->cipher;
+  kb_size = dtls_kb_size(security, role);
+  dtls_key_schedule(pre_master_secret, pre_master_len,
+		    handshake->tmp.random.client,
+		    handshake->tmp.random.server,
+		    master_secret,
+		    security->key_block, kb_size);
+
+  /* the key block has replaced the pre master secret stored there */
+  if (pre_master_secret != security->key_block)
+    memset(pre_master_secret, 0, pre_master_len);
+  else if (pre_master_len > kb_size)
+    memset(pre_master_secret + kb_size, 0, pre_master_len - kb_size);
 
   dtls_debug_dump("master_secret", master_secret, DTLS_MASTER_SECRET_LENGTH);
 
-  /* create key_block from master_secret
-   * key_block = PRF(master_secret,
-                    "key expansion" + tmp.random.server + tmp.random.client) */
-
-  dtls_prf(master_secret,
-	   DTLS_MASTER_SECRET_LENGTH,
-	   PRF_LABEL(key), PRF_LABEL_SIZE(key),
-	   handshake->tmp.random.server, DTLS_RANDOM_LENGTH,
-	   handshake->tmp.random.client, DTLS_RANDOM_LENGTH,
-	   security->key_block,
-	   dtls_kb_size(security, role));
-
   memcpy(handshake->tmp.master_secret, master_secret, DTLS_MASTER_SECRET_LENGTH);
   dtls_debug_keyblock(security);
 
-  security->cipher = handshake->cipher;
   security->compression = handshake->compression;
   security->rseq = 0;
 
@@ -778,7 +1009,8 @@ calculate_key_block(dtls_context_t *ctx,
 }
 
 /* TODO: add a generic method which iterates over a list and searches for a specific key */
-static int verify_ext_eliptic_curves(uint8 *data, size_t data_length) {
+static int verify_ext_eliptic_curves(uint8 *data, size_t data_length,
+				     dtls_ecdh_curve *curve) {
   int i, curve_name;
 
   /* length of curve list */
@@ -794,8 +1026,21 @@ static int verify_ext_eliptic_curves(uint8 *data, size_t data_length) {
     curve_name = dtls_uint16_to_int(data);
     data += sizeof(uint16);
 
-    if (curve_name == TLS_EXT_ELLIPTIC_CURVES_SECP256R1)
+    /* take the first one in the order of the client's preference */
+    if (curve_name == TLS_EXT_ELLIPTIC_CURVES_SECP256R1) {
+      *curve = DTLS_ECDH_CURVE_SECP256R1;
       return 0;
+    }
+    if (curve_name == TLS_EXT_ELLIPTIC_CURVES_X25519) {
+      *curve = DTLS_ECDH_CURVE_X25519;
+      return 0;
+    }
+#ifdef DTLS_NTRU
+    if (curve_name == TLS_EXT_ELLIPTIC_CURVES_SECP256R1_NTRU) {
+      *curve = DTLS_ECDH_CURVE_SECP256R1_NTRU;
+      return 0;
+    }
+#endif /* DTLS_NTRU */
   }
 
   dtls_warn("no supported elliptic curve found\n");
@@ -826,6 +1071,35 @@ static int verify_ext_cert_type(uint8 *data, size_t data_length) {
   return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
 }
 
+static int verify_ext_sig_hash_algo(uint8 *data, size_t data_length,
+				    int *ecdsa, int *ed25519) {
+  int i, hash_alg, sig_alg;
+
+  /* length of supported_signature_algorithms */
+  i = dtls_uint16_to_int(data);
+  data += sizeof(uint16);
+  if (i + sizeof(uint16) != data_length || i % sizeof(uint16)) {
+    dtls_warn("the list of the supported signature algorithms should be tls extension length - 2\n");
+    return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
+  }
+
+  for (; i > 0; i -= sizeof(uint16)) {
+    hash_alg = dtls_uint8_to_int(data);
+    data += sizeof(uint8);
+    sig_alg = dtls_uint8_to_int(data);
+    data += sizeof(uint8);
+
+    if (hash_alg == TLS_EXT_SIG_HASH_ALGO_SHA256 &&
+	sig_alg == TLS_EXT_SIG_HASH_ALGO_ECDSA)
+      *ecdsa = 1;
+    if (hash_alg == TLS_EXT_SIG_HASH_ALGO_INTRINSIC &&
+	sig_alg == TLS_EXT_SIG_HASH_ALGO_ED25519)
+      *ed25519 = 1;
+  }
+
+  return 0;
+}
+
 static int verify_ext_ec_point_formats(uint8 *data, size_t data_length) {
   int i, cert_type;
 
@@ -862,11 +1136,15 @@ dtls_check_tls_extension(dtls_peer_t *peer,
   int ext_client_cert_type = 0;
   int ext_server_cert_type = 0;
   int ext_ec_point_formats = 0;
+  int ext_sig_hash_algo = 0;
+  int sig_ecdsa = 0;
+  int sig_ed25519 = 0;
+  dtls_ecdh_curve curve = DTLS_ECDH_CURVE_SECP256R1;
   dtls_handshake_parameters_t *handshake = peer->handshake_params;
 
   if (data_length < sizeof(uint16)) { 
     /* no tls extensions specified */
-    if (is_tls_ecdhe_ecdsa_with_aes_128_ccm_8(handshake->cipher)) {
+    if (is_tls_ecdhe_ecdsa(handshake->cipher)) {
       goto error;
     }
     return 0;
@@ -901,7 +1179,12 @@ dtls_check_tls_extension(dtls_peer_t *peer,
     switch (i) {
       case TLS_EXT_ELLIPTIC_CURVES:
         ext_elliptic_curve = 1;
-        if (verify_ext_eliptic_curves(data, j))
+        if (verify_ext_eliptic_curves(data, j, &curve))
+          goto error;
+        break;
+      case TLS_EXT_SIG_HASH_ALGO:
+        ext_sig_hash_algo = 1;
+        if (verify_ext_sig_hash_algo(data, j, &sig_ecdsa, &sig_ed25519))
           goto error;
         break;
       case TLS_EXT_CLIENT_CERTIFICATE_TYPE:
@@ -942,13 +1225,19 @@ dtls_check_tls_extension(dtls_peer_t *peer,
     data += j;
     data_length -= j;
   }
-  if (is_tls_ecdhe_ecdsa_with_aes_128_ccm_8(handshake->cipher) && client_hello) {
+  if (is_tls_ecdhe_ecdsa(handshake->cipher) && client_hello) {
     if (!ext_elliptic_curve || !ext_client_cert_type || !ext_server_cert_type
 	|| !ext_ec_point_formats) {
       dtls_warn("not all required tls extensions found in client hello\n");
       goto error;
     }
-  } else if (is_tls_ecdhe_ecdsa_with_aes_128_ccm_8(handshake->cipher) && !client_hello) {
+#ifdef DTLS_ECC
+    /* without signature_algorithms only sha256 with ecdsa is used */
+    handshake->keyx.ecdsa.curve = curve;
+    handshake->keyx.ecdsa.other_ecdsa = sig_ecdsa || !ext_sig_hash_algo;
+    handshake->keyx.ecdsa.other_ed25519 = sig_ed25519;
+#endif /* DTLS_ECC */
+  } else if (is_tls_ecdhe_ecdsa(handshake->cipher) && !client_hello) {
     if (!ext_client_cert_type || !ext_server_cert_type) {
       dtls_warn("not all required tls extensions found in server hello\n");
       goto error;
@@ -1078,6 +1367,34 @@ error:
   }
 }
 
+#ifdef DTLS_NTRU
+/**
+ * Parses the NTRU ciphertext that follows the client's ephemeral point
+ * and recovers the encapsulated secret.
+ */
+static int
+check_client_keyexchange_ntru(dtls_handshake_parameters_t *handshake,
+			      uint8 *data) {
+  UINT16 ciphertext[NTRU_N];
+
+  if (dtls_uint16_to_int(data) != DTLS_NTRU_POLY_LENGTH) {
+    dtls_alert("expected %d bytes long NTRU ciphertext\n",
+	       DTLS_NTRU_POLY_LENGTH);
+    return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
+  }
+  data += sizeof(uint16);
+
+  if (!ntru_unpack(ciphertext, data)) {
+    dtls_alert("NTRU ciphertext is not encoded correctly\n");
+    return dtls_alert_fatal_create(DTLS_ALERT_ILLEGAL_PARAMETER);
+  }
+
+  dtls_ntru_decaps(&handshake->keyx.ecdsa.ntru.own_priv, ciphertext,
+		   handshake->keyx.ecdsa.ntru_key);
+  return 0;
+}
+#endif /* DTLS_NTRU */
+
 /**
  * Parse the ClientKeyExchange and update the internal handshake state with
  * the new data.
@@ -1088,7 +1405,23 @@ check_client_keyexchange(dtls_context_t *ctx,
 			 uint8 *data, size_t length) {
   (void)ctx;
 #ifdef DTLS_ECC
-  if (is_tls_ecdhe_ecdsa_with_aes_128_ccm_8(handshake->cipher)) {
+  if (is_tls_ecdhe_ecdsa(handshake->cipher) &&
+      handshake->keyx.ecdsa.curve == DTLS_ECDH_CURVE_X25519) {
+
+    if (length < DTLS_HS_LENGTH + DTLS_CKX25519_LENGTH) {
+      dtls_debug("The client key exchange is too short\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
+    }
+    data += DTLS_HS_LENGTH;
+
+    if (dtls_uint8_to_int(data) != CURVE25519_KEY_SIZE) {
+      dtls_alert("expected 32 bytes long public key\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
+    }
+    data += sizeof(uint8);
+
+    memcpy(handshake->keyx.ecdsa.other_eph_pub_x, data, CURVE25519_KEY_SIZE);
+  } else if (is_tls_ecdhe_ecdsa(handshake->cipher)) {
 
     if (length < DTLS_HS_LENGTH + DTLS_CKXEC_LENGTH) {
       dtls_debug("The client key exchange is too short\n");
@@ -1115,10 +1448,20 @@ check_client_keyexchange(dtls_context_t *ctx,
     memcpy(handshake->keyx.ecdsa.other_eph_pub_y, data,
 	   sizeof(handshake->keyx.ecdsa.other_eph_pub_y));
     data += sizeof(handshake->keyx.ecdsa.other_eph_pub_y);
+
+#ifdef DTLS_NTRU
+    if (handshake->keyx.ecdsa.curve == DTLS_ECDH_CURVE_SECP256R1_NTRU) {
+      if (length < DTLS_HS_LENGTH + DTLS_CKXEC_LENGTH + DTLS_NTRU_KEYX_LENGTH) {
+	dtls_debug("The client key exchange is too short\n");
+	return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
+      }
+      return check_client_keyexchange_ntru(handshake, data);
+    }
+#endif /* DTLS_NTRU */
   }
 #endif /* DTLS_ECC */
 #ifdef DTLS_PSK
-  if (is_tls_psk_with_aes_128_ccm_8(handshake->cipher)) {
+  if (is_tls_psk(handshake->cipher)) {
     int id_length;
 
     if (length < DTLS_HS_LENGTH + DTLS_CKXPSK_LENGTH_MIN) {
@@ -1149,8 +1492,42 @@ check_client_keyexchange(dtls_context_t *ctx,
 
 static inline void
 update_hs_hash(dtls_peer_t *peer, uint8 *data, size_t length) {
+  dtls_hs_state_t *state = &peer->handshake_params->hs_state;
+
   dtls_debug_dump("add MAC data", data, length);
-  dtls_hash_update(&peer->handshake_params->hs_state.hs_hash, data, length);
+  dtls_hash_update(&state->hs_hash, data, length);
+#if DTLS_HS_TRANSCRIPT_SIZE > 0
+  if (state->transcript_unused)
+    return;
+  if (!state->transcript) {
+    state->transcript = malloc(DTLS_HS_TRANSCRIPT_SIZE);
+    if (!state->transcript) {
+      dtls_warn("cannot allocate the handshake transcript\n");
+      state->transcript_unused = 1;
+      return;
+    }
+  }
+  if (state->transcript_length + length <= DTLS_HS_TRANSCRIPT_SIZE)
+    memcpy(state->transcript + state->transcript_length, data, length);
+  state->transcript_length += length;
+#endif /* DTLS_HS_TRANSCRIPT_SIZE */
+}
+
+/**
+ * Releases the handshake transcript once it is clear that no Ed25519
+ * CertificateVerify will be signed or checked in this handshake.
+ */
+static inline void
+drop_hs_transcript(dtls_peer_t *peer) {
+#if DTLS_HS_TRANSCRIPT_SIZE > 0
+  dtls_hs_state_t *state = &peer->handshake_params->hs_state;
+
+  free(state->transcript);
+  state->transcript = NULL;
+  state->transcript_unused = 1;
+#else /* DTLS_HS_TRANSCRIPT_SIZE */
+  (void)peer;
+#endif /* DTLS_HS_TRANSCRIPT_SIZE */
 }
 
 static void
@@ -1169,8 +1546,35 @@ clear_hs_hash(dtls_peer_t *peer) {
   assert(peer);
   dtls_debug("clear MAC\n");
   dtls_hash_init(&peer->handshake_params->hs_state.hs_hash);
+#if DTLS_HS_TRANSCRIPT_SIZE > 0
+  peer->handshake_params->hs_state.transcript_length = 0;
+  peer->handshake_params->hs_state.transcript_unused = 0;
+#endif /* DTLS_HS_TRANSCRIPT_SIZE */
 }
 
+#ifdef DTLS_ECC
+/**
+ * Returns all handshake messages added with update_hs_hash() or NULL
+ * if they do not fit into the transcript.
+ */
+static uint8 *
+get_hs_transcript(dtls_peer_t *peer, size_t *length) {
+#if DTLS_HS_TRANSCRIPT_SIZE > 0
+  dtls_hs_state_t *state = &peer->handshake_params->hs_state;
+
+  if (!state->transcript || state->transcript_unused ||
+      state->transcript_length > DTLS_HS_TRANSCRIPT_SIZE)
+    return NULL;
+  *length = state->transcript_length;
+  return state->transcript;
+#else /* DTLS_HS_TRANSCRIPT_SIZE */
+  (void)peer;
+  (void)length;
+  return NULL;
+#endif /* DTLS_HS_TRANSCRIPT_SIZE */
+}
+#endif /* DTLS_ECC */
+
 /** 
  * Checks if \p record + \p data contain a Finished message with valid
  * verify_data. 
@@ -1291,7 +1695,7 @@ dtls_prepare_record(dtls_peer_t *peer, dtls_security_parameters_t *security,
       p += data_len_array[i];
       res += data_len_array[i];
     }
-  } else { /* TLS_PSK_WITH_AES_128_CCM_8 or TLS_ECDHE_ECDSA_WITH_AES_128_CCM_8 */   
+  } else { /* one of the AES_128_CCM_8, AES_128_GCM or CHACHA20_POLY1305 suites */
     /** 
      * length of additional_data for the AEAD cipher which consists of
      * seq_num(2+6) + type(1) + version(2) + length(2)
@@ -1299,11 +1703,21 @@ dtls_prepare_record(dtls_peer_t *peer, dtls_security_parameters_t *security,
 #define A_DATA_LEN 13
     unsigned char nonce[DTLS_CCM_BLOCKSIZE];
     unsigned char A_DATA[A_DATA_LEN];
+    /* size of nonce_explicit, the ChaCha20 suites have none */
+    int explicit_len = dtls_record_nonce_size(security->cipher);
 
     if (is_tls_psk_with_aes_128_ccm_8(security->cipher)) {
       dtls_debug("dtls_prepare_record(): encrypt using TLS_PSK_WITH_AES_128_CCM_8\n");
+    } else if (is_tls_psk_with_aes_128_gcm_sha256(security->cipher)) {
+      dtls_debug("dtls_prepare_record(): encrypt using TLS_PSK_WITH_AES_128_GCM_SHA256\n");
     } else if (is_tls_ecdhe_ecdsa_with_aes_128_ccm_8(security->cipher)) {
       dtls_debug("dtls_prepare_record(): encrypt using TLS_ECDHE_ECDSA_WITH_AES_128_CCM_8\n");
+    } else if (is_tls_ecdhe_ecdsa_with_aes_128_gcm_sha256(security->cipher)) {
+      dtls_debug("dtls_prepare_record(): encrypt using TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256\n");
+    } else if (is_tls_psk_with_chacha20_poly1305_sha256(security->cipher)) {
+      dtls_debug("dtls_prepare_record(): encrypt using TLS_PSK_WITH_CHACHA20_POLY1305_SHA256\n");
+    } else if (is_tls_ecdhe_ecdsa_with_chacha20_poly1305_sha256(security->cipher)) {
+      dtls_debug("dtls_prepare_record(): encrypt using TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256\n");
     } else {
       dtls_debug("dtls_prepare_record(): encrypt using unknown cipher\n");
     }
@@ -1346,11 +1760,15 @@ dtls_prepare_record(dtls_peer_t *peer, dtls_security_parameters_t *security,
    	             case server:
    	               CCMServerNonce:
    	            } CCMNonceExample;
+
+       The ChaCha20-Poly1305 suites of RFC 7905 do not send a nonce.
+       It is the 12 bytes of the write IV xored with the 64-bit seq_num,
+       aligned to the right.
     */
 
-    memcpy(p, &DTLS_RECORD_HEADER(sendbuf)->epoch, 8);
-    p += 8;
-    res = 8;
+    memcpy(p, &DTLS_RECORD_HEADER(sendbuf)->epoch, explicit_len);
+    p += explicit_len;
+    res = explicit_len;
 
     for (i = 0; i < data_array_len; i++) {
       /* check the minimum that we need for packets that are not encrypted */
@@ -1364,10 +1782,19 @@ dtls_prepare_record(dtls_peer_t *peer, dtls_security_parameters_t *security,
       res += data_len_array[i];
     }
 
+    /* the encryption appends the authentication tag */
+    if (*rlen < res + DTLS_RH_LENGTH + dtls_aead_tag_size(security->cipher)) {
+      dtls_debug("dtls_prepare_record: send buffer too small\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_INTERNAL_ERROR);
+    }
+
     memset(nonce, 0, DTLS_CCM_BLOCKSIZE);
     memcpy(nonce, dtls_kb_local_iv(security, peer->role),
 	   dtls_kb_iv_size(security, peer->role));
-    memcpy(nonce + dtls_kb_iv_size(security, peer->role), start, 8); /* epoch + seq_num */
+    if (dtls_cipher_is_chacha20(security->cipher))
+      memxor(nonce + 4, (unsigned char *)&DTLS_RECORD_HEADER(sendbuf)->epoch, 8);
+    else
+      memcpy(nonce + dtls_kb_iv_size(security, peer->role), start, 8); /* epoch + seq_num */
 
     dtls_debug_dump("nonce:", nonce, DTLS_CCM_BLOCKSIZE);
     dtls_debug_dump("key:", dtls_kb_local_write_key(security, peer->role),
@@ -1380,17 +1807,18 @@ dtls_prepare_record(dtls_peer_t *peer, dtls_security_parameters_t *security,
      */
     memcpy(A_DATA, &DTLS_RECORD_HEADER(sendbuf)->epoch, 8); /* epoch and seq_num */
     memcpy(A_DATA + 8,  &DTLS_RECORD_HEADER(sendbuf)->content_type, 3); /* type and version */
-    dtls_int_to_uint16(A_DATA + 11, res - 8); /* length */
+    dtls_int_to_uint16(A_DATA + 11, res - explicit_len); /* length */
     
-    res = dtls_encrypt(start + 8, res - 8, start + 8, nonce,
-		       dtls_kb_local_write_key(security, peer->role),
+    res = dtls_encrypt(security->cipher, start + explicit_len,
+		       res - explicit_len, start + explicit_len,
+		       nonce, dtls_kb_local_write_key(security, peer->role),
 		       dtls_kb_key_size(security, peer->role),
 		       A_DATA, A_DATA_LEN);
 
     if (res < 0)
       return res;
 
-    res += 8;			/* increment res by size of nonce_explicit */
+    res += explicit_len;	/* increment res by size of nonce_explicit */
     dtls_debug_dump("message:", start, res);
   }
 
@@ -1648,7 +2076,7 @@ dtls_verify_peer(dtls_context_t *ctx,
   dtls_debug_dump("compare with cookie", cookie, len);
 
   /* check if cookies match */
-  if (len == DTLS_COOKIE_LENGTH && memcmp(cookie, mycookie, len) == 0) {
+  if (len == DTLS_COOKIE_LENGTH && equals(cookie, mycookie, len)) {
     dtls_debug("found matching cookie\n");
     return 0;
   }
@@ -1768,6 +2196,37 @@ dtls_check_ecdsa_signature_elem(uint8 *data, size_t data_length,
   return data - data_orig;
 }
 
+/**
+ * Checks the header of an Ed25519 signature element and sets @p sig
+ * to the 64 bytes of the signature. Returns the length of the element
+ * or a fatal alert.
+ */
+static int
+dtls_check_ed25519_signature_elem(uint8 *data, unsigned char **sig)
+{
+  if (dtls_uint8_to_int(data) != TLS_EXT_SIG_HASH_ALGO_INTRINSIC) {
+    dtls_alert("only intrinsic hash is supported with ed25519\n");
+    return dtls_alert_fatal_create(DTLS_ALERT_INSUFFICIENT_SECURITY);
+  }
+  data += sizeof(uint8);
+
+  if (dtls_uint8_to_int(data) != TLS_EXT_SIG_HASH_ALGO_ED25519) {
+    dtls_alert("only ed25519 signature is supported\n");
+    return dtls_alert_fatal_create(DTLS_ALERT_INSUFFICIENT_SECURITY);
+  }
+  data += sizeof(uint8);
+
+  if (dtls_uint16_to_int(data) != DTLS_ED25519_SIG_SIZE) {
+    dtls_alert("expected 64 bytes long ed25519 signature\n");
+    return dtls_alert_fatal_create(DTLS_ALERT_DECODE_ERROR);
+  }
+  data += sizeof(uint16);
+
+  *sig = data;
+
+  return DTLS_ED25519_SIG_ELEM_LENGTH;
+}
+
 static int
 check_client_certificate_verify(dtls_context_t *ctx, 
 				dtls_peer_t *peer,
@@ -1780,10 +2239,41 @@ check_client_certificate_verify(dtls_context_t *ctx,
   dtls_hash_ctx hs_hash;
   unsigned char sha256hash[DTLS_HMAC_DIGEST_SIZE];
 
-  assert(is_tls_ecdhe_ecdsa_with_aes_128_ccm_8(config->cipher));
+  assert(is_tls_ecdhe_ecdsa(config->cipher));
 
   data += DTLS_HS_LENGTH;
 
+  if (config->keyx.ecdsa.other_pub_curve == DTLS_ECDH_CURVE_ED25519) {
+    uint8 *transcript;
+    size_t transcript_length;
+
+    if (data_length < DTLS_HS_LENGTH + DTLS_ED25519_SIG_ELEM_LENGTH) {
+      dtls_alert("the packet length does not match the expected\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_DECODE_ERROR);
+    }
+
+    ret = dtls_check_ed25519_signature_elem(data, &result_r);
+    if (ret < 0) {
+      return ret;
+    }
+
+    /* Ed25519 signs the handshake messages themselves, not their hash */
+    transcript = get_hs_transcript(peer, &transcript_length);
+    if (!transcript) {
+      dtls_alert("the handshake messages do not fit into the transcript\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_INTERNAL_ERROR);
+    }
+
+    ret = dtls_ed25519_verify_sig_msg(config->keyx.ecdsa.other_pub_x,
+				      transcript, transcript_length,
+				      result_r);
+    if (ret < 0) {
+      dtls_alert("wrong signature\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
+    }
+    return 0;
+  }
+
   if (data_length < DTLS_HS_LENGTH + DTLS_CV_LENGTH) {
     dtls_alert("the packet length does not match the expected\n");
     return dtls_alert_fatal_create(DTLS_ALERT_DECODE_ERROR);
@@ -1800,13 +2290,27 @@ check_client_certificate_verify(dtls_context_t *ctx,
 
   dtls_hash_finalize(sha256hash, &hs_hash);
 
-  ret = dtls_ecdsa_verify_sig_hash(config->keyx.ecdsa.other_pub_x, config->keyx.ecdsa.other_pub_y,
-			    sizeof(config->keyx.ecdsa.other_pub_x),
-			    sha256hash, sizeof(sha256hash),
-			    result_r, result_s);
+  /* The signature is verified together with the signatures of other
+   * peers before the Finished message is answered, see
+   * check_client_certificate_verify_result(). */
+  ret = dtls_ecdsa_batch_add(config, config->keyx.ecdsa.other_pub_x,
+			     config->keyx.ecdsa.other_pub_y,
+			     sizeof(config->keyx.ecdsa.other_pub_x),
+			     sha256hash, sizeof(sha256hash),
+			     result_r, result_s);
 
   if (ret < 0) {
-    dtls_alert("wrong signature err: %i\n", ret);
+    dtls_alert("cannot queue signature err: %i\n", ret);
+    return dtls_alert_fatal_create(DTLS_ALERT_INTERNAL_ERROR);
+  }
+  return 0;
+}
+
+static int
+check_client_certificate_verify_result(dtls_peer_t *peer)
+{
+  if (dtls_ecdsa_batch_result(peer->handshake_params) < 0) {
+    dtls_alert("wrong signature\n");
     return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
   }
   return 0;
@@ -1826,7 +2330,7 @@ dtls_send_server_hello(dtls_context_t *ctx, dtls_peer_t *peer)
   dtls_handshake_parameters_t *handshake = peer->handshake_params;
   dtls_tick_t now;
 
-  ecdsa = is_tls_ecdhe_ecdsa_with_aes_128_ccm_8(handshake->cipher);
+  ecdsa = is_tls_ecdhe_ecdsa(handshake->cipher);
 
   extension_size = (ecdsa) ? 2 + 5 + 5 + 6 : 0;
 
@@ -1841,7 +2345,10 @@ dtls_send_server_hello(dtls_context_t *ctx, dtls_peer_t *peer)
    * followed by 28 bytes of generate random data. */
   dtls_ticks(&now);
   dtls_int_to_uint32(handshake->tmp.random.server, now / CLOCK_SECOND);
-  dtls_prng(handshake->tmp.random.server + 4, 28);
+  if (!dtls_prng(handshake->tmp.random.server + 4, 28)) {
+    dtls_alert("cannot create the server random\n");
+    return dtls_alert_fatal_create(DTLS_ALERT_INTERNAL_ERROR);
+  }
 
   memcpy(p, handshake->tmp.random.server, DTLS_RANDOM_LENGTH);
   p += DTLS_RANDOM_LENGTH;
@@ -1912,6 +2419,20 @@ dtls_send_server_hello(dtls_context_t *ctx, dtls_peer_t *peer)
 
 #ifdef DTLS_ECC
 #define DTLS_EC_SUBJECTPUBLICKEY_SIZE (2 * DTLS_EC_KEY_SIZE + sizeof(cert_asn1_header))
+#define DTLS_ED25519_SUBJECTPUBLICKEY_SIZE (DTLS_EC_KEY_SIZE + sizeof(cert_asn1_header_ed25519))
+
+/**
+ * Returns @c 1 if the peer announced that it accepts signatures made
+ * with @p key, @c 0 otherwise.
+ */
+static inline int
+is_ecdsa_key_accepted(dtls_handshake_parameters_t *handshake,
+		      const dtls_ecdsa_key_t *key)
+{
+  if (key->curve == DTLS_ECDH_CURVE_ED25519)
+    return handshake->keyx.ecdsa.other_ed25519;
+  return handshake->keyx.ecdsa.other_ecdsa;
+}
 
 static int
 dtls_send_certificate_ecdsa(dtls_context_t *ctx, dtls_peer_t *peer,
@@ -1925,6 +2446,21 @@ dtls_send_certificate_ecdsa(dtls_context_t *ctx, dtls_peer_t *peer,
    * Start message construction at beginning of buffer. */
   p = buf;
 
+  if (key->curve == DTLS_ECDH_CURVE_ED25519) {
+    /* length of this certificate */
+    dtls_int_to_uint24(p, DTLS_ED25519_SUBJECTPUBLICKEY_SIZE);
+    p += sizeof(uint24);
+
+    memcpy(p, &cert_asn1_header_ed25519, sizeof(cert_asn1_header_ed25519));
+    p += sizeof(cert_asn1_header_ed25519);
+
+    memcpy(p, key->pub_key_x, DTLS_EC_KEY_SIZE);
+    p += DTLS_EC_KEY_SIZE;
+
+    return dtls_send_handshake_msg(ctx, peer, DTLS_HT_CERTIFICATE,
+				   buf, p - buf);
+  }
+
   /* length of this certificate */
   dtls_int_to_uint24(p, DTLS_EC_SUBJECTPUBLICKEY_SIZE);
   p += sizeof(uint24);
@@ -2001,13 +2537,34 @@ dtls_add_ecdsa_signature_elem(uint8 *p, uint32_t *point_r, uint32_t *point_s)
   return p;
 }
 
+static uint8 *
+dtls_add_ed25519_signature_elem(uint8 *p, const unsigned char *sig)
+{
+  /* intrinsic */
+  dtls_int_to_uint8(p, TLS_EXT_SIG_HASH_ALGO_INTRINSIC);
+  p += sizeof(uint8);
+
+  /* ed25519 */
+  dtls_int_to_uint8(p, TLS_EXT_SIG_HASH_ALGO_ED25519);
+  p += sizeof(uint8);
+
+  /* length of signature */
+  dtls_int_to_uint16(p, DTLS_ED25519_SIG_SIZE);
+  p += sizeof(uint16);
+
+  memcpy(p, sig, DTLS_ED25519_SIG_SIZE);
+  p += DTLS_ED25519_SIG_SIZE;
+
+  return p;
+}
+
 static int
 dtls_send_server_key_exchange_ecdh(dtls_context_t *ctx, dtls_peer_t *peer,
 				   const dtls_ecdsa_key_t *key)
 {
   /* The ASN.1 Integer representation of an 32 byte unsigned int could be
    * 33 bytes long add space for that */
-  uint8 buf[DTLS_SKEXEC_LENGTH + 2];
+  uint8 buf[DTLS_SKEXEC_LENGTH + DTLS_NTRU_KEYX_LENGTH + 2];
   uint8 *p;
   uint8 *key_params;
   uint8 *ephemeral_pub_x;
@@ -2026,28 +2583,83 @@ dtls_send_server_key_exchange_ecdh(dtls_context_t *ctx, dtls_peer_t *peer,
   dtls_int_to_uint8(p, 3);
   p += sizeof(uint8);
 
-  /* NamedCurve namedcurve: secp256r1 */
-  dtls_int_to_uint16(p, TLS_EXT_ELLIPTIC_CURVES_SECP256R1);
-  p += sizeof(uint16);
+  if (config->keyx.ecdsa.curve == DTLS_ECDH_CURVE_X25519) {
+    /* NamedCurve namedcurve: x25519 */
+    dtls_int_to_uint16(p, TLS_EXT_ELLIPTIC_CURVES_X25519);
+    p += sizeof(uint16);
 
-  dtls_int_to_uint8(p, 1 + 2 * DTLS_EC_KEY_SIZE);
-  p += sizeof(uint8);
+    dtls_int_to_uint8(p, CURVE25519_KEY_SIZE);
+    p += sizeof(uint8);
 
-  /* This should be an uncompressed point, but I do not have access to the spec. */
-  dtls_int_to_uint8(p, 4);
-  p += sizeof(uint8);
+    if (dtls_x25519_generate_key(config->keyx.ecdsa.own_eph_priv, p) < 0) {
+      dtls_alert("cannot create the ephemeral key\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_INTERNAL_ERROR);
+    }
+    p += CURVE25519_KEY_SIZE;
+  } else {
+    /* NamedCurve namedcurve: secp256r1, possibly combined with NTRU */
+#ifdef DTLS_NTRU
+    if (config->keyx.ecdsa.curve == DTLS_ECDH_CURVE_SECP256R1_NTRU)
+      dtls_int_to_uint16(p, TLS_EXT_ELLIPTIC_CURVES_SECP256R1_NTRU);
+    else
+#endif /* DTLS_NTRU */
+      dtls_int_to_uint16(p, TLS_EXT_ELLIPTIC_CURVES_SECP256R1);
+    p += sizeof(uint16);
 
-  /* store the pointer to the x component of the pub key and make space */
-  ephemeral_pub_x = p;
-  p += DTLS_EC_KEY_SIZE;
+    dtls_int_to_uint8(p, 1 + 2 * DTLS_EC_KEY_SIZE);
+    p += sizeof(uint8);
 
-  /* store the pointer to the y component of the pub key and make space */
-  ephemeral_pub_y = p;
-  p += DTLS_EC_KEY_SIZE;
+    /* This should be an uncompressed point, but I do not have access to the spec. */
+    dtls_int_to_uint8(p, 4);
+    p += sizeof(uint8);
+
+    /* store the pointer to the x component of the pub key and make space */
+    ephemeral_pub_x = p;
+    p += DTLS_EC_KEY_SIZE;
 
-  dtls_ecdsa_generate_key(config->keyx.ecdsa.own_eph_priv,
-			  ephemeral_pub_x, ephemeral_pub_y,
-			  DTLS_EC_KEY_SIZE);
+    /* store the pointer to the y component of the pub key and make space */
+    ephemeral_pub_y = p;
+    p += DTLS_EC_KEY_SIZE;
+
+    if (dtls_ecdsa_generate_key(config->keyx.ecdsa.own_eph_priv,
+				ephemeral_pub_x, ephemeral_pub_y,
+				DTLS_EC_KEY_SIZE) < 0) {
+      dtls_alert("cannot create the ephemeral key\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_INTERNAL_ERROR);
+    }
+
+#ifdef DTLS_NTRU
+    /* The NTRU public key follows the point as opaque <1..2^16-1>. */
+    if (config->keyx.ecdsa.curve == DTLS_ECDH_CURVE_SECP256R1_NTRU) {
+      if (dtls_ntru_generate_key(&config->keyx.ecdsa.ntru.own_priv) < 0) {
+	dtls_alert("cannot create the NTRU key\n");
+	return dtls_alert_fatal_create(DTLS_ALERT_INTERNAL_ERROR);
+      }
+
+      dtls_int_to_uint16(p, DTLS_NTRU_POLY_LENGTH);
+      p += sizeof(uint16);
+
+      ntru_pack(p, config->keyx.ecdsa.ntru.own_priv.pub.h);
+      p += DTLS_NTRU_POLY_LENGTH;
+    }
+#endif /* DTLS_NTRU */
+  }
+
+  if (key->curve == DTLS_ECDH_CURVE_ED25519) {
+    unsigned char sig[DTLS_ED25519_SIG_SIZE];
+
+    dtls_ed25519_create_sig(key->priv_key, key->pub_key_x,
+			    config->tmp.random.client, DTLS_RANDOM_LENGTH,
+			    config->tmp.random.server, DTLS_RANDOM_LENGTH,
+			    key_params, p - key_params, sig);
+
+    p = dtls_add_ed25519_signature_elem(p, sig);
+
+    assert((size_t)(p - buf) <= sizeof(buf));
+
+    return dtls_send_handshake_msg(ctx, peer, DTLS_HT_SERVER_KEY_EXCHANGE,
+				   buf, p - buf);
+  }
 
   /* sign the ephemeral and its paramaters */
   dtls_ecdsa_create_sig(key->priv_key, DTLS_EC_KEY_SIZE,
@@ -2099,7 +2711,7 @@ dtls_send_server_key_exchange_psk(dtls_context_t *ctx, dtls_peer_t *peer,
 static int
 dtls_send_server_certificate_request(dtls_context_t *ctx, dtls_peer_t *peer)
 {
-  uint8 buf[8];
+  uint8 buf[10];
   uint8 *p;
 
   /* ServerHelloDone 
@@ -2116,8 +2728,24 @@ dtls_send_server_certificate_request(dtls_context_t *ctx, dtls_peer_t *peer)
   p += sizeof(uint8);
 
   /* supported_signature_algorithms */
-  dtls_int_to_uint16(p, 2);
-  p += sizeof(uint16);
+#if DTLS_HS_TRANSCRIPT_SIZE > 0
+  if (is_ed25519_supported(ctx)) {
+    dtls_int_to_uint16(p, 4);
+    p += sizeof(uint16);
+
+    /* intrinsic, the client signs the handshake messages themselves */
+    dtls_int_to_uint8(p, TLS_EXT_SIG_HASH_ALGO_INTRINSIC);
+    p += sizeof(uint8);
+
+    /* ed25519 */
+    dtls_int_to_uint8(p, TLS_EXT_SIG_HASH_ALGO_ED25519);
+    p += sizeof(uint8);
+  } else
+#endif /* DTLS_HS_TRANSCRIPT_SIZE */
+  {
+    dtls_int_to_uint16(p, 2);
+    p += sizeof(uint16);
+  }
 
   /* sha256 */
   dtls_int_to_uint8(p, TLS_EXT_SIG_HASH_ALGO_SHA256);
@@ -2163,7 +2791,7 @@ dtls_send_server_hello_msgs(dtls_context_t *ctx, dtls_peer_t *peer)
   }
 
 #ifdef DTLS_ECC
-  if (is_tls_ecdhe_ecdsa_with_aes_128_ccm_8(peer->handshake_params->cipher)) {
+  if (is_tls_ecdhe_ecdsa(peer->handshake_params->cipher)) {
     const dtls_ecdsa_key_t *ecdsa_key;
 
     res = CALL(ctx, get_ecdsa_key, &peer->session, &ecdsa_key);
@@ -2172,6 +2800,11 @@ dtls_send_server_hello_msgs(dtls_context_t *ctx, dtls_peer_t *peer)
       return res;
     }
 
+    if (!is_ecdsa_key_accepted(peer->handshake_params, ecdsa_key)) {
+      dtls_warn("the peer does not accept the signature algorithm of our key\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
+    }
+
     res = dtls_send_certificate_ecdsa(ctx, peer, ecdsa_key);
 
     if (res < 0) {
@@ -2186,7 +2819,7 @@ dtls_send_server_hello_msgs(dtls_context_t *ctx, dtls_peer_t *peer)
       return res;
     }
 
-    if (is_tls_ecdhe_ecdsa_with_aes_128_ccm_8(peer->handshake_params->cipher) &&
+    if (is_tls_ecdhe_ecdsa(peer->handshake_params->cipher) &&
 	is_ecdsa_client_auth_supported(ctx)) {
       res = dtls_send_server_certificate_request(ctx, peer);
 
@@ -2199,7 +2832,7 @@ dtls_send_server_hello_msgs(dtls_context_t *ctx, dtls_peer_t *peer)
 #endif /* DTLS_ECC */
 
 #ifdef DTLS_PSK
-  if (is_tls_psk_with_aes_128_ccm_8(peer->handshake_params->cipher)) {
+  if (is_tls_psk(peer->handshake_params->cipher)) {
     unsigned char psk_hint[DTLS_PSK_MAX_CLIENT_IDENTITY_LEN];
     int len;
 
@@ -2244,7 +2877,7 @@ dtls_send_ccs(dtls_context_t *ctx, dtls_peer_t *peer) {
 static int
 dtls_send_client_key_exchange(dtls_context_t *ctx, dtls_peer_t *peer)
 {
-  uint8 buf[DTLS_CKXEC_LENGTH];
+  uint8 buf[DTLS_CKXEC_LENGTH + DTLS_NTRU_KEYX_LENGTH];
   uint8 *p;
   dtls_handshake_parameters_t *handshake = peer->handshake_params;
 
@@ -2252,7 +2885,14 @@ dtls_send_client_key_exchange(dtls_context_t *ctx, dtls_peer_t *peer)
 
   switch (handshake->cipher) {
 #ifdef DTLS_PSK
-  case TLS_PSK_WITH_AES_128_CCM_8: {
+  case TLS_PSK_WITH_AES_128_CCM_8:
+#ifdef DTLS_GCM
+  case TLS_PSK_WITH_AES_128_GCM_SHA256:
+#endif /* DTLS_GCM */
+#ifdef DTLS_CHACHA20
+  case TLS_PSK_WITH_CHACHA20_POLY1305_SHA256:
+#endif /* DTLS_CHACHA20 */
+  {
     int len;
 
     len = CALL(ctx, get_psk_info, &peer->session, DTLS_PSK_IDENTITY,
@@ -2283,10 +2923,29 @@ dtls_send_client_key_exchange(dtls_context_t *ctx, dtls_peer_t *peer)
   }
 #endif /* DTLS_PSK */
 #ifdef DTLS_ECC
-  case TLS_ECDHE_ECDSA_WITH_AES_128_CCM_8: {
+  case TLS_ECDHE_ECDSA_WITH_AES_128_CCM_8:
+#ifdef DTLS_GCM
+  case TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256:
+#endif /* DTLS_GCM */
+#ifdef DTLS_CHACHA20
+  case TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256:
+#endif /* DTLS_CHACHA20 */
+  {
     uint8 *ephemeral_pub_x;
     uint8 *ephemeral_pub_y;
 
+    if (handshake->keyx.ecdsa.curve == DTLS_ECDH_CURVE_X25519) {
+      dtls_int_to_uint8(p, CURVE25519_KEY_SIZE);
+      p += sizeof(uint8);
+
+      if (dtls_x25519_generate_key(handshake->keyx.ecdsa.own_eph_priv, p) < 0) {
+	dtls_alert("cannot create the ephemeral key\n");
+	return dtls_alert_fatal_create(DTLS_ALERT_INTERNAL_ERROR);
+      }
+      p += CURVE25519_KEY_SIZE;
+      break;
+    }
+
     dtls_int_to_uint8(p, 1 + 2 * DTLS_EC_KEY_SIZE);
     p += sizeof(uint8);
 
@@ -2299,9 +2958,23 @@ dtls_send_client_key_exchange(dtls_context_t *ctx, dtls_peer_t *peer)
     ephemeral_pub_y = p;
     p += DTLS_EC_KEY_SIZE;
 
-    dtls_ecdsa_generate_key(peer->handshake_params->keyx.ecdsa.own_eph_priv,
-    			    ephemeral_pub_x, ephemeral_pub_y,
-    			    DTLS_EC_KEY_SIZE);
+    if (dtls_ecdsa_generate_key(peer->handshake_params->keyx.ecdsa.own_eph_priv,
+				ephemeral_pub_x, ephemeral_pub_y,
+				DTLS_EC_KEY_SIZE) < 0) {
+      dtls_alert("cannot create the ephemeral key\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_INTERNAL_ERROR);
+    }
+
+#ifdef DTLS_NTRU
+    /* the ciphertext was created in check_server_key_exchange_ecdsa() */
+    if (handshake->keyx.ecdsa.curve == DTLS_ECDH_CURVE_SECP256R1_NTRU) {
+      dtls_int_to_uint16(p, DTLS_NTRU_POLY_LENGTH);
+      p += sizeof(uint16);
+
+      ntru_pack(p, handshake->keyx.ecdsa.ntru.ciphertext);
+      p += DTLS_NTRU_POLY_LENGTH;
+    }
+#endif /* DTLS_NTRU */
 
     break;
   }
@@ -2325,6 +2998,26 @@ dtls_send_client_key_exchange(dtls_context_t *ctx, dtls_peer_t *peer)
     /* fall through to default */
 #endif /* !DTLS_ECC */
 
+#if !defined(DTLS_PSK) || !defined(DTLS_GCM)
+  case TLS_PSK_WITH_AES_128_GCM_SHA256:
+    /* fall through to default */
+#endif /* !DTLS_PSK || !DTLS_GCM */
+
+#if !defined(DTLS_ECC) || !defined(DTLS_GCM)
+  case TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256:
+    /* fall through to default */
+#endif /* !DTLS_ECC || !DTLS_GCM */
+
+#if !defined(DTLS_PSK) || !defined(DTLS_CHACHA20)
+  case TLS_PSK_WITH_CHACHA20_POLY1305_SHA256:
+    /* fall through to default */
+#endif /* !DTLS_PSK || !DTLS_CHACHA20 */
+
+#if !defined(DTLS_ECC) || !defined(DTLS_CHACHA20)
+  case TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256:
+    /* fall through to default */
+#endif /* !DTLS_ECC || !DTLS_CHACHA20 */
+
   default:
     dtls_crit("cipher %x04 not supported\n", handshake->cipher);
     return dtls_alert_fatal_create(DTLS_ALERT_INTERNAL_ERROR);
@@ -2355,6 +3048,29 @@ dtls_send_certificate_verify_ecdh(dtls_context_t *ctx, dtls_peer_t *peer,
    * Start message construction at beginning of buffer. */
   p = buf;
 
+  if (key->curve == DTLS_ECDH_CURVE_ED25519) {
+    unsigned char sig[DTLS_ED25519_SIG_SIZE];
+    uint8 *transcript;
+    size_t transcript_length;
+
+    /* Ed25519 signs the handshake messages themselves, not their hash */
+    transcript = get_hs_transcript(peer, &transcript_length);
+    if (!transcript) {
+      dtls_crit("the handshake messages do not fit into the transcript\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_INTERNAL_ERROR);
+    }
+
+    dtls_ed25519_create_sig_msg(key->priv_key, key->pub_key_x,
+				transcript, transcript_length, sig);
+
+    p = dtls_add_ed25519_signature_elem(p, sig);
+
+    assert((size_t)(p - buf) <= sizeof(buf));
+
+    return dtls_send_handshake_msg(ctx, peer, DTLS_HT_CERTIFICATE_VERIFY,
+				   buf, p - buf);
+  }
+
   copy_hs_hash(peer, &hs_hash);
 
   dtls_hash_finalize(sha256hash, &hs_hash);
@@ -2404,6 +3120,44 @@ dtls_send_finished(dtls_context_t *ctx, dtls_peer_t *peer,
 				 buf, p - buf);
 }
 
+/**
+ * Writes the cipher suites of one key exchange to @p p in the order of
+ * preference and returns the position after them. The server picks the
+ * first one it knows, so GCM comes first if the CPU has AES
+ * instructions and ChaCha20 otherwise.
+ */
+static uint8 *
+dtls_add_cipher_suites(uint8 *p, dtls_cipher_t gcm, dtls_cipher_t chacha20,
+		       dtls_cipher_t ccm_8) {
+#ifdef DTLS_CHACHA20
+  int chacha20_first = 1;
+
+#ifdef DTLS_GCM
+  chacha20_first = !dtls_gcm_accelerated();
+#endif /* DTLS_GCM */
+  if (chacha20_first) {
+    dtls_int_to_uint16(p, chacha20);
+    p += sizeof(uint16);
+  }
+#else /* DTLS_CHACHA20 */
+  (void)chacha20;
+#endif /* DTLS_CHACHA20 */
+#ifdef DTLS_GCM
+  dtls_int_to_uint16(p, gcm);
+  p += sizeof(uint16);
+#else /* DTLS_GCM */
+  (void)gcm;
+#endif /* DTLS_GCM */
+#ifdef DTLS_CHACHA20
+  if (!chacha20_first) {
+    dtls_int_to_uint16(p, chacha20);
+    p += sizeof(uint16);
+  }
+#endif /* DTLS_CHACHA20 */
+  dtls_int_to_uint16(p, ccm_8);
+  return p + sizeof(uint16);
+}
+
 static int
 dtls_send_client_hello(dtls_context_t *ctx, dtls_peer_t *peer,
                        uint8 cookie[], size_t cookie_length) {
@@ -2413,14 +3167,18 @@ dtls_send_client_hello(dtls_context_t *ctx, dtls_peer_t *peer,
   uint8_t extension_size;
   int psk;
   int ecdsa;
+  int ed25519;
   dtls_handshake_parameters_t *handshake = peer->handshake_params;
   dtls_tick_t now;
 
   psk = is_psk_supported(ctx);
   ecdsa = is_ecdsa_supported(ctx, 1);
+  ed25519 = is_ed25519_supported(ctx);
 
-  cipher_size = 2 + ((ecdsa) ? 2 : 0) + ((psk) ? 2 : 0);
-  extension_size = (ecdsa) ? 2 + 6 + 6 + 8 + 6: 0;
+  cipher_size = 2 + ((ecdsa) ? DTLS_CH_SUITES_LENGTH : 0) +
+    ((psk) ? DTLS_CH_SUITES_LENGTH : 0);
+  extension_size = (ecdsa) ? 2 + 6 + 6 + 6 + DTLS_CH_CURVES_LENGTH + 6 + 8 +
+    ((ed25519) ? 2 : 0) : 0;
 
   if (cipher_size == 0) {
     dtls_crit("no cipher callbacks implemented\n");
@@ -2439,8 +3197,11 @@ dtls_send_client_hello(dtls_context_t *ctx, dtls_peer_t *peer,
      * followed by 28 bytes of generate random data. */
     dtls_ticks(&now);
     dtls_int_to_uint32(handshake->tmp.random.client, now / CLOCK_SECOND);
-    dtls_prng(handshake->tmp.random.client + sizeof(uint32),
-         DTLS_RANDOM_LENGTH - sizeof(uint32));
+    if (!dtls_prng(handshake->tmp.random.client + sizeof(uint32),
+		   DTLS_RANDOM_LENGTH - sizeof(uint32))) {
+      dtls_alert("cannot create the client random\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_INTERNAL_ERROR);
+    }
   }
   /* we must use the same Client Random as for the previous request */
   memcpy(p, handshake->tmp.random.client, DTLS_RANDOM_LENGTH);
@@ -2462,14 +3223,14 @@ dtls_send_client_hello(dtls_context_t *ctx, dtls_peer_t *peer,
   dtls_int_to_uint16(p, cipher_size - 2);
   p += sizeof(uint16);
 
-  if (ecdsa) {
-    dtls_int_to_uint16(p, TLS_ECDHE_ECDSA_WITH_AES_128_CCM_8);
-    p += sizeof(uint16);
-  }
-  if (psk) {
-    dtls_int_to_uint16(p, TLS_PSK_WITH_AES_128_CCM_8);
-    p += sizeof(uint16);
-  }
+  if (ecdsa)
+    p = dtls_add_cipher_suites(p, TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256,
+			       TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256,
+			       TLS_ECDHE_ECDSA_WITH_AES_128_CCM_8);
+  if (psk)
+    p = dtls_add_cipher_suites(p, TLS_PSK_WITH_AES_128_GCM_SHA256,
+			       TLS_PSK_WITH_CHACHA20_POLY1305_SHA256,
+			       TLS_PSK_WITH_AES_128_CCM_8);
 
   /* compression method */
   dtls_int_to_uint8(p, 1);
@@ -2520,11 +3281,20 @@ dtls_send_client_hello(dtls_context_t *ctx, dtls_peer_t *peer,
     p += sizeof(uint16);
 
     /* length of this extension type */
-    dtls_int_to_uint16(p, 4);
+    dtls_int_to_uint16(p, 2 + DTLS_CH_CURVES_LENGTH);
     p += sizeof(uint16);
 
     /* length of the list */
-    dtls_int_to_uint16(p, 2);
+    dtls_int_to_uint16(p, DTLS_CH_CURVES_LENGTH);
+    p += sizeof(uint16);
+
+    /* in order of preference */
+#ifdef DTLS_NTRU
+    dtls_int_to_uint16(p, TLS_EXT_ELLIPTIC_CURVES_SECP256R1_NTRU);
+    p += sizeof(uint16);
+#endif /* DTLS_NTRU */
+
+    dtls_int_to_uint16(p, TLS_EXT_ELLIPTIC_CURVES_X25519);
     p += sizeof(uint16);
 
     dtls_int_to_uint16(p, TLS_EXT_ELLIPTIC_CURVES_SECP256R1);
@@ -2544,6 +3314,34 @@ dtls_send_client_hello(dtls_context_t *ctx, dtls_peer_t *peer,
 
     dtls_int_to_uint8(p, TLS_EXT_EC_POINT_FORMATS_UNCOMPRESSED);
     p += sizeof(uint8);
+
+    /* signature_algorithms */
+    dtls_int_to_uint16(p, TLS_EXT_SIG_HASH_ALGO);
+    p += sizeof(uint16);
+
+    /* length of this extension type */
+    dtls_int_to_uint16(p, (ed25519) ? 6 : 4);
+    p += sizeof(uint16);
+
+    /* length of the list */
+    dtls_int_to_uint16(p, (ed25519) ? 4 : 2);
+    p += sizeof(uint16);
+
+    if (ed25519) {
+      /* ed25519 */
+      dtls_int_to_uint8(p, TLS_EXT_SIG_HASH_ALGO_INTRINSIC);
+      p += sizeof(uint8);
+
+      dtls_int_to_uint8(p, TLS_EXT_SIG_HASH_ALGO_ED25519);
+      p += sizeof(uint8);
+    }
+
+    /* sha256 with ecdsa */
+    dtls_int_to_uint8(p, TLS_EXT_SIG_HASH_ALGO_SHA256);
+    p += sizeof(uint8);
+
+    dtls_int_to_uint8(p, TLS_EXT_SIG_HASH_ALGO_ECDSA);
+    p += sizeof(uint8);
   }
 
   assert((buf <= p) && ((unsigned int)(p - buf) <= sizeof(buf)));
@@ -2658,11 +3456,46 @@ check_server_certificate(dtls_context_t *ctx,
 
   update_hs_hash(peer, data, data_length);
 
-  assert(is_tls_ecdhe_ecdsa_with_aes_128_ccm_8(config->cipher));
+  assert(is_tls_ecdhe_ecdsa(config->cipher));
 
   data += DTLS_HS_LENGTH;
 
-  if (dtls_uint24_to_int(data) != DTLS_EC_SUBJECTPUBLICKEY_SIZE) {
+  if (data_length >= DTLS_HS_LENGTH + sizeof(uint24) +
+      DTLS_ED25519_SUBJECTPUBLICKEY_SIZE &&
+      dtls_uint24_to_int(data) == DTLS_ED25519_SUBJECTPUBLICKEY_SIZE) {
+    data += sizeof(uint24);
+
+    if (!is_ed25519_supported(ctx)) {
+      dtls_warn("Ed25519 keys are not accepted\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_UNSUPPORTED_CERTIFICATE);
+    }
+
+    if (memcmp(data, cert_asn1_header_ed25519,
+	       sizeof(cert_asn1_header_ed25519))) {
+      dtls_alert("got an unexpected Subject public key format\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_DECODE_ERROR);
+    }
+    data += sizeof(cert_asn1_header_ed25519);
+
+    config->keyx.ecdsa.other_pub_curve = DTLS_ECDH_CURVE_ED25519;
+    memcpy(config->keyx.ecdsa.other_pub_x, data,
+	   sizeof(config->keyx.ecdsa.other_pub_x));
+    memset(config->keyx.ecdsa.other_pub_y, 0,
+	   sizeof(config->keyx.ecdsa.other_pub_y));
+
+    err = CALL(ctx, verify_ed25519_key, &peer->session,
+	       config->keyx.ecdsa.other_pub_x,
+	       sizeof(config->keyx.ecdsa.other_pub_x));
+    if (err < 0) {
+      dtls_warn("The certificate was not accepted\n");
+      return err;
+    }
+    return 0;
+  }
+
+  if (data_length < DTLS_HS_LENGTH + sizeof(uint24) +
+      DTLS_EC_SUBJECTPUBLICKEY_SIZE ||
+      dtls_uint24_to_int(data) != DTLS_EC_SUBJECTPUBLICKEY_SIZE) {
     dtls_alert("expect length of %zu bytes for certificate\n",
 	       DTLS_EC_SUBJECTPUBLICKEY_SIZE);
     return dtls_alert_fatal_create(DTLS_ALERT_DECODE_ERROR);
@@ -2675,6 +3508,7 @@ check_server_certificate(dtls_context_t *ctx,
   }
   data += sizeof(cert_asn1_header);
 
+  config->keyx.ecdsa.other_pub_curve = DTLS_ECDH_CURVE_SECP256R1;
   memcpy(config->keyx.ecdsa.other_pub_x, data,
 	 sizeof(config->keyx.ecdsa.other_pub_x));
   data += sizeof(config->keyx.ecdsa.other_pub_x);
@@ -2705,14 +3539,19 @@ check_server_key_exchange_ecdsa(dtls_context_t *ctx,
   unsigned char *result_r;
   unsigned char *result_s;
   unsigned char *key_params;
+#ifdef DTLS_NTRU
+  NTRU_PUBLIC_KEY ntru_pub;
+  int i;
+#endif /* DTLS_NTRU */
 
   update_hs_hash(peer, data, data_length);
 
-  assert(is_tls_ecdhe_ecdsa_with_aes_128_ccm_8(config->cipher));
+  assert(is_tls_ecdhe_ecdsa(config->cipher));
 
   data += DTLS_HS_LENGTH;
+  data_length -= DTLS_HS_LENGTH;
 
-  if (data_length < DTLS_HS_LENGTH + DTLS_SKEXEC_LENGTH) {
+  if (data_length < DTLS_SKEX25519_LENGTH_MIN) {
     dtls_alert("the packet length does not match the expected\n");
     return dtls_alert_fatal_create(DTLS_ALERT_DECODE_ERROR);
   }
@@ -2725,54 +3564,143 @@ check_server_key_exchange_ecdsa(dtls_context_t *ctx,
   data += sizeof(uint8);
   data_length -= sizeof(uint8);
 
-  if (dtls_uint16_to_int(data) != TLS_EXT_ELLIPTIC_CURVES_SECP256R1) {
-    dtls_alert("secp256r1 supported\n");
-    return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
-  }
-  data += sizeof(uint16);
-  data_length -= sizeof(uint16);
+  switch (dtls_uint16_to_int(data)) {
+  case TLS_EXT_ELLIPTIC_CURVES_X25519:
+    config->keyx.ecdsa.curve = DTLS_ECDH_CURVE_X25519;
+    data += sizeof(uint16);
+    data_length -= sizeof(uint16);
+
+    if (dtls_uint8_to_int(data) != CURVE25519_KEY_SIZE) {
+      dtls_alert("expected 32 bytes long public key\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
+    }
+    data += sizeof(uint8);
+    data_length -= sizeof(uint8);
 
-  if (dtls_uint8_to_int(data) != 1 + 2 * DTLS_EC_KEY_SIZE) {
-    dtls_alert("expected 65 bytes long public point\n");
+    memcpy(config->keyx.ecdsa.other_eph_pub_x, data, CURVE25519_KEY_SIZE);
+    data += CURVE25519_KEY_SIZE;
+    data_length -= CURVE25519_KEY_SIZE;
+    break;
+#ifdef DTLS_NTRU
+  case TLS_EXT_ELLIPTIC_CURVES_SECP256R1_NTRU:
+#endif /* DTLS_NTRU */
+  case TLS_EXT_ELLIPTIC_CURVES_SECP256R1:
+    config->keyx.ecdsa.curve = DTLS_ECDH_CURVE_SECP256R1;
+#ifdef DTLS_NTRU
+    if (dtls_uint16_to_int(data) == TLS_EXT_ELLIPTIC_CURVES_SECP256R1_NTRU)
+      config->keyx.ecdsa.curve = DTLS_ECDH_CURVE_SECP256R1_NTRU;
+#endif /* DTLS_NTRU */
+    data += sizeof(uint16);
+    data_length -= sizeof(uint16);
+
+    if (data_length < 1 + 1 + 2 * DTLS_EC_KEY_SIZE) {
+      dtls_alert("the packet length does not match the expected\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_DECODE_ERROR);
+    }
+
+    if (dtls_uint8_to_int(data) != 1 + 2 * DTLS_EC_KEY_SIZE) {
+      dtls_alert("expected 65 bytes long public point\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
+    }
+    data += sizeof(uint8);
+    data_length -= sizeof(uint8);
+
+    if (dtls_uint8_to_int(data) != 4) {
+      dtls_alert("expected uncompressed public point\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_DECODE_ERROR);
+    }
+    data += sizeof(uint8);
+    data_length -= sizeof(uint8);
+
+    memcpy(config->keyx.ecdsa.other_eph_pub_x, data, sizeof(config->keyx.ecdsa.other_eph_pub_y));
+    data += sizeof(config->keyx.ecdsa.other_eph_pub_y);
+    data_length -= sizeof(config->keyx.ecdsa.other_eph_pub_y);
+
+    memcpy(config->keyx.ecdsa.other_eph_pub_y, data, sizeof(config->keyx.ecdsa.other_eph_pub_y));
+    data += sizeof(config->keyx.ecdsa.other_eph_pub_y);
+    data_length -= sizeof(config->keyx.ecdsa.other_eph_pub_y);
+
+#ifdef DTLS_NTRU
+    if (config->keyx.ecdsa.curve == DTLS_ECDH_CURVE_SECP256R1_NTRU) {
+      if (data_length < DTLS_NTRU_KEYX_LENGTH) {
+	dtls_alert("the packet length does not match the expected\n");
+	return dtls_alert_fatal_create(DTLS_ALERT_DECODE_ERROR);
+      }
+
+      if (dtls_uint16_to_int(data) != DTLS_NTRU_POLY_LENGTH) {
+	dtls_alert("expected %d bytes long NTRU public key\n",
+		   DTLS_NTRU_POLY_LENGTH);
+	return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
+      }
+      data += sizeof(uint16);
+      data_length -= sizeof(uint16);
+
+      if (!ntru_unpack(ntru_pub.h, data)) {
+	dtls_alert("NTRU public key is not encoded correctly\n");
+	return dtls_alert_fatal_create(DTLS_ALERT_ILLEGAL_PARAMETER);
+      }
+      /* ring_mul_sparse_ws() expects h[N + i] = h[i] */
+      for (i = NTRU_N; i < NTRU_ALEN; i++)
+	ntru_pub.h[i] = ntru_pub.h[i - NTRU_N];
+      data += DTLS_NTRU_POLY_LENGTH;
+      data_length -= DTLS_NTRU_POLY_LENGTH;
+    }
+#endif /* DTLS_NTRU */
+    break;
+  default:
+    dtls_alert("only secp256r1, x25519 and secp256r1+NTRU supported\n");
     return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
   }
-  data += sizeof(uint8);
-  data_length -= sizeof(uint8);
 
-  if (dtls_uint8_to_int(data) != 4) {
-    dtls_alert("expected uncompressed public point\n");
-    return dtls_alert_fatal_create(DTLS_ALERT_DECODE_ERROR);
-  }
-  data += sizeof(uint8);
-  data_length -= sizeof(uint8);
+  if (config->keyx.ecdsa.other_pub_curve == DTLS_ECDH_CURVE_ED25519) {
+    if (data_length < DTLS_ED25519_SIG_ELEM_LENGTH) {
+      dtls_alert("the packet length does not match the expected\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_DECODE_ERROR);
+    }
 
-  memcpy(config->keyx.ecdsa.other_eph_pub_x, data, sizeof(config->keyx.ecdsa.other_eph_pub_y));
-  data += sizeof(config->keyx.ecdsa.other_eph_pub_y);
-  data_length -= sizeof(config->keyx.ecdsa.other_eph_pub_y);
+    ret = dtls_check_ed25519_signature_elem(data, &result_r);
+    if (ret < 0) {
+      return ret;
+    }
 
-  memcpy(config->keyx.ecdsa.other_eph_pub_y, data, sizeof(config->keyx.ecdsa.other_eph_pub_y));
-  data += sizeof(config->keyx.ecdsa.other_eph_pub_y);
-  data_length -= sizeof(config->keyx.ecdsa.other_eph_pub_y);
+    ret = dtls_ed25519_verify_sig(config->keyx.ecdsa.other_pub_x,
+				  config->tmp.random.client, DTLS_RANDOM_LENGTH,
+				  config->tmp.random.server, DTLS_RANDOM_LENGTH,
+				  key_params, data - key_params,
+				  result_r);
+  } else {
+    if (data_length < DTLS_CV_LENGTH) {
+      dtls_alert("the packet length does not match the expected\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_DECODE_ERROR);
+    }
 
-  ret = dtls_check_ecdsa_signature_elem(data, data_length, &result_r, &result_s);
-  if (ret < 0) {
-    return ret;
-  }
-  data += ret;
-  data_length -= ret;
+    ret = dtls_check_ecdsa_signature_elem(data, data_length, &result_r, &result_s);
+    if (ret < 0) {
+      return ret;
+    }
 
-  ret = dtls_ecdsa_verify_sig(config->keyx.ecdsa.other_pub_x, config->keyx.ecdsa.other_pub_y,
-			    sizeof(config->keyx.ecdsa.other_pub_x),
-			    config->tmp.random.client, DTLS_RANDOM_LENGTH,
-			    config->tmp.random.server, DTLS_RANDOM_LENGTH,
-			    key_params,
-			    1 + 2 + 1 + 1 + (2 * DTLS_EC_KEY_SIZE),
-			    result_r, result_s);
+    ret = dtls_ecdsa_verify_sig(config->keyx.ecdsa.other_pub_x, config->keyx.ecdsa.other_pub_y,
+			      sizeof(config->keyx.ecdsa.other_pub_x),
+			      config->tmp.random.client, DTLS_RANDOM_LENGTH,
+			      config->tmp.random.server, DTLS_RANDOM_LENGTH,
+			      key_params, data - key_params,
+			      result_r, result_s);
+  }
 
   if (ret < 0) {
     dtls_alert("wrong signature\n");
     return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
   }
+
+#ifdef DTLS_NTRU
+  /* encapsulate only to a key that was signed by the server */
+  if (config->keyx.ecdsa.curve == DTLS_ECDH_CURVE_SECP256R1_NTRU
+      && dtls_ntru_encaps(&ntru_pub, config->keyx.ecdsa.ntru.ciphertext,
+			  config->keyx.ecdsa.ntru_key) < 0) {
+    dtls_alert("cannot encapsulate the NTRU secret\n");
+    return dtls_alert_fatal_create(DTLS_ALERT_INTERNAL_ERROR);
+  }
+#endif /* DTLS_NTRU */
   return 0;
 }
 #endif /* DTLS_ECC */
@@ -2789,7 +3717,7 @@ check_server_key_exchange_psk(dtls_context_t *ctx,
 
   update_hs_hash(peer, data, data_length);
 
-  assert(is_tls_psk_with_aes_128_ccm_8(config->cipher));
+  assert(is_tls_psk(config->cipher));
 
   data += DTLS_HS_LENGTH;
 
@@ -2825,13 +3753,12 @@ check_certificate_request(dtls_context_t *ctx,
 {
   unsigned int i;
   int auth_alg;
-  int sig_alg;
-  int hash_alg;
+  int other_ecdsa = 0, other_ed25519 = 0;
   (void)ctx;
 
   update_hs_hash(peer, data, data_length);
 
-  assert(is_tls_ecdhe_ecdsa_with_aes_128_ccm_8(peer->handshake_params->cipher));
+  assert(is_tls_ecdhe_ecdsa(peer->handshake_params->cipher));
 
   data += DTLS_HS_LENGTH;
 
@@ -2867,8 +3794,6 @@ check_certificate_request(dtls_context_t *ctx,
     return dtls_alert_fatal_create(DTLS_ALERT_DECODE_ERROR);
   }
 
-  hash_alg = 0;
-  sig_alg = 0;
   for (; i > 0 ; i -= sizeof(uint16)) {
     int current_hash_alg;
     int current_sig_alg;
@@ -2878,18 +3803,22 @@ check_certificate_request(dtls_context_t *ctx,
     current_sig_alg = dtls_uint8_to_int(data);
     data += sizeof(uint8);
 
-    if (current_hash_alg == TLS_EXT_SIG_HASH_ALGO_SHA256 && hash_alg == 0 && 
-        current_sig_alg == TLS_EXT_SIG_HASH_ALGO_ECDSA && sig_alg == 0) {
-      hash_alg = current_hash_alg;
-      sig_alg = current_sig_alg;
-    }
+    if (current_hash_alg == TLS_EXT_SIG_HASH_ALGO_SHA256 &&
+        current_sig_alg == TLS_EXT_SIG_HASH_ALGO_ECDSA)
+      other_ecdsa = 1;
+    if (current_hash_alg == TLS_EXT_SIG_HASH_ALGO_INTRINSIC &&
+        current_sig_alg == TLS_EXT_SIG_HASH_ALGO_ED25519)
+      other_ed25519 = 1;
   }
 
-  if (hash_alg != TLS_EXT_SIG_HASH_ALGO_SHA256 ||
-      sig_alg != TLS_EXT_SIG_HASH_ALGO_ECDSA) {
+  if (!other_ecdsa && !other_ed25519) {
     dtls_alert("no supported hash and signature algorithem\n");
     return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
   }
+#ifdef DTLS_ECC
+  peer->handshake_params->keyx.ecdsa.other_ecdsa = other_ecdsa;
+  peer->handshake_params->keyx.ecdsa.other_ed25519 = other_ed25519;
+#endif /* DTLS_ECC */
 
   /* common names are ignored */
 
@@ -2922,6 +3851,14 @@ check_server_hellodone(dtls_context_t *ctx,
       return res;
     }
 
+    if (ecdsa_key->curve != DTLS_ECDH_CURVE_ED25519)
+      drop_hs_transcript(peer);
+
+    if (!is_ecdsa_key_accepted(peer->handshake_params, ecdsa_key)) {
+      dtls_warn("the peer does not accept the signature algorithm of our key\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_HANDSHAKE_FAILURE);
+    }
+
     res = dtls_send_certificate_ecdsa(ctx, peer, ecdsa_key);
 
     if (res < 0) {
@@ -2950,6 +3887,7 @@ check_server_hellodone(dtls_context_t *ctx,
     }
   }
 #endif /* DTLS_ECC */
+  drop_hs_transcript(peer);
 
   res = calculate_key_block(ctx, handshake, peer,
 			    &peer->session, peer->role);
@@ -2989,7 +3927,7 @@ decrypt_verify(dtls_peer_t *peer, uint8 *packet, size_t length,
   if (security->cipher == TLS_NULL_WITH_NULL_NULL) {
     /* no cipher suite selected */
     return clen;
-  } else { /* TLS_PSK_WITH_AES_128_CCM_8 or TLS_ECDHE_ECDSA_WITH_AES_128_CCM_8 */
+  } else { /* one of the AES_128_CCM_8, AES_128_GCM or CHACHA20_POLY1305 suites */
     /** 
      * length of additional_data for the AEAD cipher which consists of
      * seq_num(2+6) + type(1) + version(2) + length(2)
@@ -2997,18 +3935,25 @@ decrypt_verify(dtls_peer_t *peer, uint8 *packet, size_t length,
 #define A_DATA_LEN 13
     unsigned char nonce[DTLS_CCM_BLOCKSIZE];
     unsigned char A_DATA[A_DATA_LEN];
+    int explicit_len = dtls_record_nonce_size(security->cipher);
 
-    if (clen < 16)		/* need at least IV and MAC */
+    /* need at least IV and MAC */
+    if (clen < explicit_len + (int)dtls_aead_tag_size(security->cipher))
       return -1;
 
     memset(nonce, 0, DTLS_CCM_BLOCKSIZE);
     memcpy(nonce, dtls_kb_remote_iv(security, peer->role),
 	   dtls_kb_iv_size(security, peer->role));
 
-    /* read epoch and seq_num from message */
-    memcpy(nonce + dtls_kb_iv_size(security, peer->role), *cleartext, 8);
-    *cleartext += 8;
-    clen -= 8;
+    if (dtls_cipher_is_chacha20(security->cipher)) {
+      /* RFC 7905: the write IV xored with epoch and seq_num of the header */
+      memxor(nonce + 4, (unsigned char *)&header->epoch, 8);
+    } else {
+      /* read epoch and seq_num from message */
+      memcpy(nonce + dtls_kb_iv_size(security, peer->role), *cleartext, 8);
+      *cleartext += 8;
+      clen -= 8;
+    }
 
     dtls_debug_dump("nonce", nonce, DTLS_CCM_BLOCKSIZE);
     dtls_debug_dump("key", dtls_kb_remote_write_key(security, peer->role),
@@ -3022,10 +3967,11 @@ decrypt_verify(dtls_peer_t *peer, uint8 *packet, size_t length,
      */
     memcpy(A_DATA, &DTLS_RECORD_HEADER(packet)->epoch, 8); /* epoch and seq_num */
     memcpy(A_DATA + 8,  &DTLS_RECORD_HEADER(packet)->content_type, 3); /* type and version */
-    dtls_int_to_uint16(A_DATA + 11, clen - 8); /* length without nonce_explicit */
+    /* length without nonce_explicit and MAC */
+    dtls_int_to_uint16(A_DATA + 11, clen - dtls_aead_tag_size(security->cipher));
 
-    clen = dtls_decrypt(*cleartext, clen, *cleartext, nonce,
-		       dtls_kb_remote_write_key(security, peer->role),
+    clen = dtls_decrypt(security->cipher, *cleartext, clen, *cleartext,
+		       nonce, dtls_kb_remote_write_key(security, peer->role),
 		       dtls_kb_key_size(security, peer->role),
 		       A_DATA, A_DATA_LEN);
     if (clen < 0)
@@ -3136,10 +4082,12 @@ handle_handshake_msg(dtls_context_t *ctx, dtls_peer_t *peer, session_t *session,
       dtls_warn("error in check_server_hello err: %i\n", err);
       return err;
     }
-    if (is_tls_ecdhe_ecdsa_with_aes_128_ccm_8(peer->handshake_params->cipher))
+    if (is_tls_ecdhe_ecdsa(peer->handshake_params->cipher)) {
       peer->state = DTLS_STATE_WAIT_SERVERCERTIFICATE;
-    else
+    } else {
       peer->state = DTLS_STATE_WAIT_SERVERHELLODONE;
+      drop_hs_transcript(peer);
+    }
     /* update_hs_hash(peer, data, data_length); */
 
     break;
@@ -3160,6 +4108,9 @@ handle_handshake_msg(dtls_context_t *ctx, dtls_peer_t *peer, session_t *session,
       peer->state = DTLS_STATE_WAIT_SERVERKEYEXCHANGE;
     } else if (role == DTLS_SERVER){
       peer->state = DTLS_STATE_WAIT_CLIENTKEYEXCHANGE;
+      if (peer->handshake_params->keyx.ecdsa.other_pub_curve !=
+	  DTLS_ECDH_CURVE_ED25519)
+	drop_hs_transcript(peer);
     }
     /* update_hs_hash(peer, data, data_length); */
 
@@ -3169,7 +4120,7 @@ handle_handshake_msg(dtls_context_t *ctx, dtls_peer_t *peer, session_t *session,
   case DTLS_HT_SERVER_KEY_EXCHANGE:
 
 #ifdef DTLS_ECC
-    if (is_tls_ecdhe_ecdsa_with_aes_128_ccm_8(peer->handshake_params->cipher)) {
+    if (is_tls_ecdhe_ecdsa(peer->handshake_params->cipher)) {
       if (state != DTLS_STATE_WAIT_SERVERKEYEXCHANGE) {
         return dtls_alert_fatal_create(DTLS_ALERT_UNEXPECTED_MESSAGE);
       }
@@ -3177,7 +4128,7 @@ handle_handshake_msg(dtls_context_t *ctx, dtls_peer_t *peer, session_t *session,
     }
 #endif /* DTLS_ECC */
 #ifdef DTLS_PSK
-    if (is_tls_psk_with_aes_128_ccm_8(peer->handshake_params->cipher)) {
+    if (is_tls_psk(peer->handshake_params->cipher)) {
       if (state != DTLS_STATE_WAIT_SERVERHELLODONE) {
         return dtls_alert_fatal_create(DTLS_ALERT_UNEXPECTED_MESSAGE);
       }
@@ -3231,6 +4182,14 @@ handle_handshake_msg(dtls_context_t *ctx, dtls_peer_t *peer, session_t *session,
       return dtls_alert_fatal_create(DTLS_ALERT_UNEXPECTED_MESSAGE);
     }
 
+#ifdef DTLS_ECC
+    err = check_client_certificate_verify_result(peer);
+    if (err < 0) {
+      dtls_warn("error in check_client_certificate_verify err: %i\n", err);
+      return err;
+    }
+#endif /* DTLS_ECC */
+
     err = check_finished(ctx, peer, data, data_length);
     if (err < 0) {
       dtls_warn("error in check_finished err: %i\n", err);
@@ -3282,7 +4241,7 @@ handle_handshake_msg(dtls_context_t *ctx, dtls_peer_t *peer, session_t *session,
     }
     update_hs_hash(peer, data, data_length);
 
-    if (is_tls_ecdhe_ecdsa_with_aes_128_ccm_8(peer->handshake_params->cipher) &&
+    if (is_tls_ecdhe_ecdsa(peer->handshake_params->cipher) &&
 	is_ecdsa_client_auth_supported(ctx))
       peer->state = DTLS_STATE_WAIT_CERTIFICATEVERIFY;
     else
@@ -3301,6 +4260,7 @@ handle_handshake_msg(dtls_context_t *ctx, dtls_peer_t *peer, session_t *session,
       dtls_warn("error in check_client_certificate_verify err: %i\n", err);
       return err;
     }
+    drop_hs_transcript(peer);
 
     update_hs_hash(peer, data, data_length);
     peer->state = DTLS_STATE_WAIT_CHANGECIPHERSPEC;
@@ -3405,11 +4365,13 @@ handle_handshake_msg(dtls_context_t *ctx, dtls_peer_t *peer, session_t *session,
     if (err < 0) {
       return err;
     }
-    if (is_tls_ecdhe_ecdsa_with_aes_128_ccm_8(peer->handshake_params->cipher) &&
-	is_ecdsa_client_auth_supported(ctx))
+    if (is_tls_ecdhe_ecdsa(peer->handshake_params->cipher) &&
+	is_ecdsa_client_auth_supported(ctx)) {
       peer->state = DTLS_STATE_WAIT_CLIENTCERTIFICATE;
-    else
+    } else {
       peer->state = DTLS_STATE_WAIT_CLIENTKEYEXCHANGE;
+      drop_hs_transcript(peer);
+    }
 
     /* after sending the ServerHelloDone, we expect the
      * ClientKeyExchange (possibly containing the PSK id),
@@ -3905,33 +4867,93 @@ dtls_handle_message(dtls_context_t *ctx,
   return 0;
 }
 
+int
+dtls_handle_messages(dtls_context_t *ctx, session_t *session[],
+		     uint8 *msg[], int msglen[], int n) {
+#if DTLS_COOKIE_BATCH > 1
+  struct dtls_cookie_batch_t batch[DTLS_COOKIE_BATCH];
+  uint8 input[DTLS_COOKIE_BATCH][DTLS_COOKIE_INPUT_MAX];
+  const unsigned char *in[DTLS_COOKIE_BATCH];
+  unsigned char *mac[DTLS_COOKIE_BATCH];
+  size_t inlen[DTLS_COOKIE_BATCH];
+  size_t head, tail, fraglen, data_length;
+  unsigned int rlen;
+  uint8 *data;
+  int m = 0;
+#endif /* DTLS_COOKIE_BATCH > 1 */
+  int i, err, res = 0;
+
+#if DTLS_COOKIE_BATCH > 1
+  /* Compute the cookies of the initial Client Hellos (epoch 0 from a
+   * session without peer) in one go, dtls_create_cookie() takes them
+   * from ctx->cookie_batch. Anything unusual, and Client Hellos
+   * larger than DTLS_COOKIE_INPUT_MAX, are left to
+   * dtls_create_cookie(), which does the same checks again. */
+  for (i = 0; i < n && m < DTLS_COOKIE_BATCH; i++) {
+    rlen = is_record(msg[i], msglen[i]);
+    if (rlen < DTLS_RH_LENGTH + DTLS_HS_LENGTH
+	|| msg[i][0] != DTLS_CT_HANDSHAKE
+	|| dtls_get_epoch(DTLS_RECORD_HEADER(msg[i])) != 0
+	|| dtls_get_peer(ctx, session[i]))
+      continue;
+
+    data = msg[i] + DTLS_RH_LENGTH;
+    data_length = rlen - DTLS_RH_LENGTH;
+    if (data[0] != DTLS_HT_CLIENT_HELLO
+	|| data_length < DTLS_HS_LENGTH + DTLS_CH_LENGTH + sizeof(uint8)
+	|| dtls_cookie_parts(data, data_length, &head, &tail) < 0)
+      continue;
+    fraglen = dtls_get_fragment_length(DTLS_HANDSHAKE_HEADER(data));
+    if (fraglen < tail || DTLS_HS_LENGTH + fraglen > data_length
+	|| session[i]->size + head + fraglen - tail > sizeof(input[m]))
+      continue;
+
+    memcpy(input[m], &session[i]->addr, session[i]->size);
+    inlen[m] = session[i]->size;
+    memcpy(input[m] + inlen[m], data + DTLS_HS_LENGTH, head);
+    inlen[m] += head;
+    memcpy(input[m] + inlen[m], data + DTLS_HS_LENGTH + tail, fraglen - tail);
+    inlen[m] += fraglen - tail;
+
+    batch[m].msg = data;
+    batch[m].msglen = data_length;
+    in[m] = input[m];
+    mac[m] = batch[m].cookie;
+    m++;
+  }
+  if (m > 0) {
+    dtls_debug("computing %d cookies at once\n", m);
+    dtls_hmac_mb(ctx->cookie_secret, DTLS_COOKIE_SECRET_LENGTH, m,
+		 in, inlen, mac);
+  }
+  ctx->cookie_batch = batch;
+  ctx->cookie_batch_len = m;
+#endif /* DTLS_COOKIE_BATCH > 1 */
+
+  for (i = 0; i < n; i++) {
+    err = dtls_handle_message(ctx, session[i], msg[i], msglen[i]);
+    if (err < 0)
+      res = err;
+  }
+
+#if DTLS_COOKIE_BATCH > 1
+  ctx->cookie_batch = NULL;
+  ctx->cookie_batch_len = 0;
+#endif /* DTLS_COOKIE_BATCH > 1 */
+  return res;
+}
+
 dtls_context_t *
 dtls_new_context(void *app_data) {
   dtls_context_t *c;
   dtls_tick_t now;
-#ifndef WITH_CONTIKI
-  FILE *urandom = fopen("/dev/urandom", "r");
-  unsigned char buf[sizeof(unsigned long)];
-#endif /* WITH_CONTIKI */
 
   dtls_ticks(&now);
 #ifdef WITH_CONTIKI
   /* FIXME: need something better to init PRNG here */
   dtls_prng_init(now);
-#else /* WITH_CONTIKI */
-  if (!urandom) {
-    dtls_emerg("cannot initialize PRNG\n");
-    return NULL;
-  }
-
-  if (fread(buf, 1, sizeof(buf), urandom) != sizeof(buf)) {
-    dtls_emerg("cannot initialize PRNG\n");
-    return NULL;
-  }
-
-  fclose(urandom);
-  dtls_prng_init((unsigned long)*buf);
 #endif /* WITH_CONTIKI */
+  /* elsewhere dtls_prng() seeds itself from the operating system */
 
   c = malloc_context();
   if (!c)
@@ -3986,6 +5008,9 @@ dtls_free_context(dtls_context_t *ctx) {
     }
   }
 
+#ifdef DTLS_ECC
+  dtls_ecdsa_sign_cache_clear();
+#endif /* DTLS_ECC */
   free_context(ctx);
 }
 
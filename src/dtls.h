@@ -50,6 +50,11 @@ typedef enum dtls_credentials_type_t {
   DTLS_PSK_HINT, DTLS_PSK_IDENTITY, DTLS_PSK_KEY
 } dtls_credentials_type_t;
 
+/**
+ * The key of the local peer. For DTLS_ECDH_CURVE_ED25519, priv_key is
+ * the 32 byte seed from RFC 8032, pub_key_x the encoded public key and
+ * pub_key_y is not used.
+ */
 typedef struct dtls_ecdsa_key_t {
   dtls_ecdh_curve curve;
   const unsigned char *priv_key;	/** < private key as bytes > */
@@ -188,6 +193,9 @@ typedef struct {
    * authentication. A server implementing this will request the
    * client to do DTLS client authentication.
    *
+   * This function is called on every handshake, also for keys whose
+   * tables are in the key cache (see DTLS_ECDSA_KEY_CACHE_SIZE).
+   *
    * @param ctx          The current dtls context.
    * @param session      The session where the key will be used.
    * @param other_pub_x  x component of the public key.
@@ -206,11 +214,50 @@ typedef struct {
 			  const unsigned char *other_pub_x,
 			  const unsigned char *other_pub_y,
 			  size_t key_size);
+
+  /**
+   * Called during handshake to check the peer's Ed25519 public key in
+   * this session, like verify_ecdsa_key. Ed25519 keys of the peer are
+   * only accepted, and only announced as accepted, if this is set.
+   * Ed25519 keys are not cached.
+   *
+   * @param ctx          The current dtls context.
+   * @param session      The session where the key will be used.
+   * @param other_pub    The public key.
+   * @param key_size     The size of @p other_pub.
+   * @return @c 0 if public key matches, or less than zero on error,
+   *         see verify_ecdsa_key.
+   */
+  int (*verify_ed25519_key)(struct dtls_context_t *ctx,
+			    const session_t *session,
+			    const unsigned char *other_pub,
+			    size_t key_size);
 #endif /* DTLS_ECC */
 } dtls_handler_t;
 
 struct netq_t;
 
+#ifndef DTLS_COOKIE_BATCH
+/**
+ * Maximum number of cookies computed at once by dtls_handle_messages(),
+ * at most DTLS_SHA256_MB_MAX. With 1, the messages are just passed to
+ * dtls_handle_message() one by one.
+ */
+#define DTLS_COOKIE_BATCH DTLS_SHA256_MB_MAX
+#endif /* DTLS_COOKIE_BATCH */
+
+#ifndef DTLS_COOKIE_INPUT_MAX
+/**
+ * Maximum size of the data covered by the cookie of a Client Hello in
+ * a batch of dtls_handle_messages(), i.e. the peer address and the
+ * Client Hello without cookie. The cookies of larger Client Hellos
+ * are computed one by one.
+ */
+#define DTLS_COOKIE_INPUT_MAX 256
+#endif /* DTLS_COOKIE_INPUT_MAX */
+
+struct dtls_cookie_batch_t;
+
 /** Holds global information of the DTLS engine. */
 typedef struct dtls_context_t {
   unsigned char cookie_secret[DTLS_COOKIE_SECRET_LENGTH];
@@ -228,6 +275,12 @@ typedef struct dtls_context_t {
   dtls_handler_t *h;		/**< callback handlers */
 
   unsigned char readbuf[DTLS_MAX_BUF];
+
+#if DTLS_COOKIE_BATCH > 1
+  /** cookies computed by dtls_handle_messages(), valid during the call */
+  const struct dtls_cookie_batch_t *cookie_batch;
+  int cookie_batch_len;		/**< number of valid cookie_batch entries */
+#endif /* DTLS_COOKIE_BATCH > 1 */
 } dtls_context_t;
 
 /** 
@@ -392,6 +445,25 @@ int dtls_record_read(dtls_state_t *state, uint8 *msg, int msglen);
 int dtls_handle_message(dtls_context_t *ctx, session_t *session,
 			uint8 *msg, int msglen);
 
+/**
+ * Handles @p n messages received in one go, e.g. all datagrams that
+ * are ready to be read. The result is the same as calling
+ * dtls_handle_message() for each of them, but the cookies of up to
+ * DTLS_COOKIE_BATCH initial Client Hellos are computed at once with
+ * the multi-buffer HMAC dtls_hmac_mb(), which is cheaper when a
+ * server is flooded with Client Hellos.
+ *
+ * @param ctx     The dtls context to use.
+ * @param session The sessions of the messages.
+ * @param msg     The received data.
+ * @param msglen  The actual lengths of the messages in @p msg.
+ * @param n       The number of messages.
+ * @return A value less than zero if handling one of the messages
+ *         failed, zero on success.
+ */
+int dtls_handle_messages(dtls_context_t *ctx, session_t *session[],
+			 uint8 *msg[], int msglen[], int n);
+
 /**
  * Check if @p session is associated with a peer object in @p context.
  * This function returns a pointer to the peer if found, NULL otherwise.
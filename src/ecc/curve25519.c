@@ -0,0 +1,761 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2011, 2012, 2013, 2014, 2015 Olaf Bergmann (TZI) and others.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v. 1.0 which accompanies this distribution.
+ *
+ * The Eclipse Public License is available at http://www.eclipse.org/legal/epl-v10.html
+ * and the Eclipse Distribution License is available at
+ * http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ *******************************************************************************/
+
+/*
+ * Arithmetic modulo p = 2^255 - 19 follows the usual unsaturated
+ * representation: limbs are not normalized after additions, the
+ * multiplication folds the upper half back with 2^255 = 19 and carries
+ * once. Only fieldToBytes() reduces completely.
+ *
+ * Ed25519 points use extended coordinates (X:Y:Z:T) with x = X/Z,
+ * y = Y/Z and T = XY/Z [0]. The unified addition law is complete on
+ * this curve, so the identity and doubling need no special cases.
+ *
+ * [0]: Hisil, Wong, Carter, Dawson: Twisted Edwards Curves Revisited
+ */
+
+#include <string.h>
+
+#include "curve25519.h"
+
+#ifdef __SIZEOF_INT128__
+#define FE_LIMBS 5
+typedef uint64_t limb_t;
+__extension__ typedef unsigned __int128 dlimb_t;
+#define limbBits(i) 51
+#define limbOffset(i) (51 * (i))
+#else /* __SIZEOF_INT128__ */
+#define FE_LIMBS 10
+typedef uint32_t limb_t;
+typedef uint64_t dlimb_t;
+#define limbBits(i) (26 - ((i) & 1))
+#define limbOffset(i) (25 * (i) + ((i) + 1) / 2)
+#endif /* __SIZEOF_INT128__ */
+
+#define limbMask(i) (((limb_t)1 << limbBits(i)) - 1)
+
+typedef limb_t fe[FE_LIMBS];
+
+typedef struct {
+	fe X;
+	fe Y;
+	fe Z;
+	fe T;
+} ge_t;
+
+/* -121665/121666 */
+static const uint8_t ed25519_d[32] = {
+	0xa3, 0x78, 0x59, 0x13, 0xca, 0x4d, 0xeb, 0x75, 0xab, 0xd8, 0x41, 0x41, 0x4d, 0x0a, 0x70, 0x00,
+	0x98, 0xe8, 0x79, 0x77, 0x79, 0x40, 0xc7, 0x8c, 0x73, 0xfe, 0x6f, 0x2b, 0xee, 0x6c, 0x03, 0x52};
+
+/* 2^((p-1)/4), a square root of -1 */
+static const uint8_t ed25519_sqrtm1[32] = {
+	0xb0, 0xa0, 0x0e, 0x4a, 0x27, 0x1b, 0xee, 0xc4, 0x78, 0xe4, 0x2f, 0xad, 0x06, 0x18, 0x43, 0x2f,
+	0xa7, 0xd7, 0xfb, 0x3d, 0x99, 0x00, 0x4d, 0x2b, 0x0b, 0xdf, 0xc1, 0x4f, 0x80, 0x24, 0x83, 0x2b};
+
+static const uint8_t ed25519_base_x[32] = {
+	0x1a, 0xd5, 0x25, 0x8f, 0x60, 0x2d, 0x56, 0xc9, 0xb2, 0xa7, 0x25, 0x95, 0x60, 0xc7, 0x2c, 0x69,
+	0x5c, 0xdc, 0xd6, 0xfd, 0x31, 0xe2, 0xa4, 0xc0, 0xfe, 0x53, 0x6e, 0xcd, 0xd3, 0x36, 0x69, 0x21};
+
+static const uint8_t ed25519_base_y[32] = {
+	0x58, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66,
+	0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66};
+
+/* the group order l = 2^252 + 27742317777372353535851937790883648493 */
+static const uint8_t ed25519_order[32] = {
+	0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10};
+
+static void fieldZero(fe h)
+{
+	memset(h, 0, sizeof(fe));
+}
+
+static void fieldOne(fe h)
+{
+	memset(h, 0, sizeof(fe));
+	h[0] = 1;
+}
+
+static void fieldCopy(fe h, const fe f)
+{
+	memcpy(h, f, sizeof(fe));
+}
+
+/* the top bit of s is ignored */
+static void fieldFromBytes(fe h, const uint8_t *s)
+{
+	int i, j;
+	uint64_t w;
+
+	for (i = 0; i < FE_LIMBS; i++) {
+		w = 0;
+		for (j = (limbOffset(i) + limbBits(i) - 1) / 8; j >= limbOffset(i) / 8; j--)
+			w = (w << 8) | s[j];
+		h[i] = (limb_t)(w >> (limbOffset(i) % 8)) & limbMask(i);
+	}
+}
+
+/* propagates the carries once, the result is below 2^255 + 2^(limbBits + 5) */
+static void fieldCarry(fe h)
+{
+	int i;
+	limb_t c;
+
+	for (i = 0; i < FE_LIMBS - 1; i++) {
+		c = h[i] >> limbBits(i);
+		h[i] &= limbMask(i);
+		h[i + 1] += c;
+	}
+	c = h[FE_LIMBS - 1] >> limbBits(FE_LIMBS - 1);
+	h[FE_LIMBS - 1] &= limbMask(FE_LIMBS - 1);
+	h[0] += 19 * c;
+}
+
+static void fieldToBytes(uint8_t *s, const fe f)
+{
+	fe h;
+	limb_t q;
+	int i, bit;
+
+	fieldCopy(h, f);
+	fieldCarry(h);
+	fieldCarry(h);
+
+	/* now h < 2^255, subtract p if h + 19 overflows 2^255 */
+	q = (h[0] + 19) >> limbBits(0);
+	for (i = 1; i < FE_LIMBS; i++)
+		q = (h[i] + q) >> limbBits(i);
+
+	h[0] += 19 * q;
+	for (i = 0; i < FE_LIMBS - 1; i++) {
+		h[i + 1] += h[i] >> limbBits(i);
+		h[i] &= limbMask(i);
+	}
+	h[FE_LIMBS - 1] &= limbMask(FE_LIMBS - 1);
+
+	memset(s, 0, 32);
+	for (i = 0; i < FE_LIMBS; i++) {
+		for (bit = 0; bit < limbBits(i); bit += 8 - (limbOffset(i) + bit) % 8) {
+			s[(limbOffset(i) + bit) / 8] |= (uint8_t)((h[i] >> bit) << ((limbOffset(i) + bit) % 8));
+		}
+	}
+}
+
+static void fieldAdd(fe h, const fe f, const fe g)
+{
+	int i;
+
+	for (i = 0; i < FE_LIMBS; i++)
+		h[i] = f[i] + g[i];
+}
+
+/* h = f - g + 4p, inputs may be unreduced by up to two additions */
+static void fieldSub(fe h, const fe f, const fe g)
+{
+	int i;
+
+	h[0] = f[0] + 4 * (limbMask(0) - 18) - g[0];
+	for (i = 1; i < FE_LIMBS; i++)
+		h[i] = f[i] + 4 * limbMask(i) - g[i];
+	fieldCarry(h);
+}
+
+static void fieldNeg(fe h, const fe f)
+{
+	fe zero;
+
+	fieldZero(zero);
+	fieldSub(h, zero, f);
+}
+
+static void fieldMultSmall(fe h, const fe f, uint32_t n)
+{
+	int i;
+	dlimb_t t;
+	limb_t c = 0;
+
+	for (i = 0; i < FE_LIMBS; i++) {
+		t = (dlimb_t)f[i] * n + c;
+		h[i] = (limb_t)t & limbMask(i);
+		c = (limb_t)(t >> limbBits(i));
+	}
+	t = (dlimb_t)h[0] + (dlimb_t)c * 19;
+	h[0] = (limb_t)t & limbMask(0);
+	h[1] += (limb_t)(t >> limbBits(0));
+}
+
+#if FE_LIMBS == 5
+static void fieldReduce(fe h, dlimb_t r0, dlimb_t r1, dlimb_t r2, dlimb_t r3, dlimb_t r4)
+{
+	dlimb_t t;
+
+	r1 += r0 >> 51;
+	h[0] = (limb_t)r0 & limbMask(0);
+	r2 += r1 >> 51;
+	h[1] = (limb_t)r1 & limbMask(1);
+	r3 += r2 >> 51;
+	h[2] = (limb_t)r2 & limbMask(2);
+	r4 += r3 >> 51;
+	h[3] = (limb_t)r3 & limbMask(3);
+	h[4] = (limb_t)r4 & limbMask(4);
+	t = (dlimb_t)h[0] + (r4 >> 51) * 19;
+	h[0] = (limb_t)t & limbMask(0);
+	h[1] += (limb_t)(t >> 51);
+}
+
+static void fieldMult(fe h, const fe f, const fe g)
+{
+	const limb_t g1_19 = 19 * g[1], g2_19 = 19 * g[2];
+	const limb_t g3_19 = 19 * g[3], g4_19 = 19 * g[4];
+	dlimb_t r0, r1, r2, r3, r4;
+
+	r0 = (dlimb_t)f[0] * g[0] + (dlimb_t)f[1] * g4_19 + (dlimb_t)f[2] * g3_19
+		+ (dlimb_t)f[3] * g2_19 + (dlimb_t)f[4] * g1_19;
+	r1 = (dlimb_t)f[0] * g[1] + (dlimb_t)f[1] * g[0] + (dlimb_t)f[2] * g4_19
+		+ (dlimb_t)f[3] * g3_19 + (dlimb_t)f[4] * g2_19;
+	r2 = (dlimb_t)f[0] * g[2] + (dlimb_t)f[1] * g[1] + (dlimb_t)f[2] * g[0]
+		+ (dlimb_t)f[3] * g4_19 + (dlimb_t)f[4] * g3_19;
+	r3 = (dlimb_t)f[0] * g[3] + (dlimb_t)f[1] * g[2] + (dlimb_t)f[2] * g[1]
+		+ (dlimb_t)f[3] * g[0] + (dlimb_t)f[4] * g4_19;
+	r4 = (dlimb_t)f[0] * g[4] + (dlimb_t)f[1] * g[3] + (dlimb_t)f[2] * g[2]
+		+ (dlimb_t)f[3] * g[1] + (dlimb_t)f[4] * g[0];
+
+	fieldReduce(h, r0, r1, r2, r3, r4);
+}
+
+/* the cross products appear twice, which saves 10 of the 25 multiplications */
+static void fieldSquare(fe h, const fe f)
+{
+	const limb_t d0 = 2 * f[0], d1 = 2 * f[1], d3 = 2 * f[3];
+	const limb_t f3_19 = 19 * f[3], f4_19 = 19 * f[4];
+	dlimb_t r0, r1, r2, r3, r4;
+
+	r0 = (dlimb_t)f[0] * f[0] + (dlimb_t)d1 * f4_19 + (dlimb_t)(2 * f[2]) * f3_19;
+	r1 = (dlimb_t)d0 * f[1] + (dlimb_t)(2 * f[2]) * f4_19 + (dlimb_t)f[3] * f3_19;
+	r2 = (dlimb_t)d0 * f[2] + (dlimb_t)f[1] * f[1] + (dlimb_t)d3 * f4_19;
+	r3 = (dlimb_t)d0 * f[3] + (dlimb_t)d1 * f[2] + (dlimb_t)f[4] * f4_19;
+	r4 = (dlimb_t)d0 * f[4] + (dlimb_t)d1 * f[3] + (dlimb_t)f[2] * f[2];
+
+	fieldReduce(h, r0, r1, r2, r3, r4);
+}
+#else /* FE_LIMBS == 5 */
+/*
+ * Limb i has the weight 2^ceil(25.5 i). The product of two odd limbs
+ * therefore has to be doubled and products at or above 2^255 are
+ * folded back with a factor of 19.
+ */
+static void fieldMult(fe h, const fe f, const fe g)
+{
+	dlimb_t r[FE_LIMBS];
+	limb_t g19[FE_LIMBS];
+	int i, j;
+
+	for (i = 0; i < FE_LIMBS; i++) {
+		r[i] = 0;
+		g19[i] = 19 * g[i];
+	}
+
+	for (i = 0; i < FE_LIMBS; i++) {
+		limb_t fi = f[i];
+		limb_t fi2 = (i & 1) ? 2 * fi : fi;
+
+		for (j = 0; j < FE_LIMBS - i; j++)
+			r[i + j] += (dlimb_t)((j & 1) ? fi2 : fi) * g[j];
+		for (; j < FE_LIMBS; j++)
+			r[i + j - FE_LIMBS] += (dlimb_t)((j & 1) ? fi2 : fi) * g19[j];
+	}
+
+	for (i = 0; i < FE_LIMBS - 1; i++) {
+		r[i + 1] += r[i] >> limbBits(i);
+		h[i] = (limb_t)r[i] & limbMask(i);
+	}
+	h[FE_LIMBS - 1] = (limb_t)r[FE_LIMBS - 1] & limbMask(FE_LIMBS - 1);
+	r[0] = (dlimb_t)h[0] + (r[FE_LIMBS - 1] >> limbBits(FE_LIMBS - 1)) * 19;
+	h[0] = (limb_t)r[0] & limbMask(0);
+	h[1] += (limb_t)(r[0] >> limbBits(0));
+}
+
+static void fieldSquare(fe h, const fe f)
+{
+	fieldMult(h, f, f);
+}
+#endif /* FE_LIMBS == 5 */
+
+static void fieldSquareN(fe h, const fe f, int n)
+{
+	fieldSquare(h, f);
+	while (--n)
+		fieldSquare(h, h);
+}
+
+/* swaps f and g if b is 1 without branching on b */
+static void fieldCSwap(fe f, fe g, limb_t b)
+{
+	limb_t mask = (limb_t)0 - b;
+	limb_t t;
+	int i;
+
+	for (i = 0; i < FE_LIMBS; i++) {
+		t = mask & (f[i] ^ g[i]);
+		f[i] ^= t;
+		g[i] ^= t;
+	}
+}
+
+/* sets f to g if b is 1 without branching on b */
+static void fieldCMove(fe f, const fe g, limb_t b)
+{
+	limb_t mask = (limb_t)0 - b;
+	int i;
+
+	for (i = 0; i < FE_LIMBS; i++)
+		f[i] ^= mask & (f[i] ^ g[i]);
+}
+
+static int fieldIsZero(const fe f)
+{
+	uint8_t s[32];
+	uint8_t r = 0;
+	int i;
+
+	fieldToBytes(s, f);
+	for (i = 0; i < 32; i++)
+		r |= s[i];
+	return r == 0;
+}
+
+static int fieldIsNegative(const fe f)
+{
+	uint8_t s[32];
+
+	fieldToBytes(s, f);
+	return s[0] & 1;
+}
+
+/* t1 = z^(2^250 - 1) and t0 = z^11 with 250 squarings and 11 multiplications */
+static void fieldPow250(fe t1, fe t0, const fe z)
+{
+	fe t2, t3;
+
+	fieldSquare(t0, z);			/* 2 */
+	fieldSquareN(t1, t0, 2);		/* 8 */
+	fieldMult(t1, z, t1);			/* 9 */
+	fieldMult(t0, t0, t1);			/* 11 */
+	fieldSquare(t2, t0);			/* 22 */
+	fieldMult(t1, t1, t2);			/* 2^5 - 1 */
+	fieldSquareN(t2, t1, 5);
+	fieldMult(t1, t2, t1);			/* 2^10 - 1 */
+	fieldSquareN(t2, t1, 10);
+	fieldMult(t2, t2, t1);			/* 2^20 - 1 */
+	fieldSquareN(t3, t2, 20);
+	fieldMult(t2, t3, t2);			/* 2^40 - 1 */
+	fieldSquareN(t2, t2, 10);
+	fieldMult(t1, t2, t1);			/* 2^50 - 1 */
+	fieldSquareN(t2, t1, 50);
+	fieldMult(t2, t2, t1);			/* 2^100 - 1 */
+	fieldSquareN(t3, t2, 100);
+	fieldMult(t2, t3, t2);			/* 2^200 - 1 */
+	fieldSquareN(t2, t2, 50);
+	fieldMult(t1, t2, t1);			/* 2^250 - 1 */
+}
+
+/* h = z^(p - 2) = z^(2^255 - 21) */
+static void fieldInv(fe h, const fe z)
+{
+	fe t0, t1;
+
+	fieldPow250(t1, t0, z);
+	fieldSquareN(t1, t1, 5);
+	fieldMult(h, t1, t0);
+}
+
+/* h = z^((p - 5) / 8) = z^(2^252 - 3) */
+static void fieldPow22523(fe h, const fe z)
+{
+	fe t0, t1;
+
+	fieldPow250(t1, t0, z);
+	fieldSquareN(t1, t1, 2);
+	fieldMult(h, t1, z);
+}
+
+int ecc_x25519(uint8_t *result, const uint8_t *scalar, const uint8_t *point)
+{
+	uint8_t k[32];
+	fe x1, x2, z2, x3, z3;
+	fe a, aa, b, bb, e, c, d;
+	limb_t swap = 0, bit;
+	uint8_t r = 0;
+	int t;
+
+	memcpy(k, scalar, sizeof(k));
+	k[0] &= 248;
+	k[31] &= 127;
+	k[31] |= 64;
+
+	fieldFromBytes(x1, point);
+	fieldOne(x2);
+	fieldZero(z2);
+	fieldCopy(x3, x1);
+	fieldOne(z3);
+
+	/* Montgomery ladder, RFC 7748 section 5 */
+	for (t = 254; t >= 0; t--) {
+		bit = (k[t >> 3] >> (t & 7)) & 1;
+		swap ^= bit;
+		fieldCSwap(x2, x3, swap);
+		fieldCSwap(z2, z3, swap);
+		swap = bit;
+
+		fieldAdd(a, x2, z2);
+		fieldSquare(aa, a);
+		fieldSub(b, x2, z2);
+		fieldSquare(bb, b);
+		fieldSub(e, aa, bb);
+		fieldAdd(c, x3, z3);
+		fieldSub(d, x3, z3);
+		fieldMult(d, d, a);		/* DA */
+		fieldMult(c, c, b);		/* CB */
+		fieldAdd(x3, d, c);
+		fieldSquare(x3, x3);
+		fieldSub(z3, d, c);
+		fieldSquare(z3, z3);
+		fieldMult(z3, z3, x1);
+		fieldMult(x2, aa, bb);
+		fieldMultSmall(z2, e, 121665);
+		fieldAdd(z2, z2, aa);
+		fieldMult(z2, z2, e);
+	}
+	fieldCSwap(x2, x3, swap);
+	fieldCSwap(z2, z3, swap);
+
+	fieldInv(z2, z2);
+	fieldMult(x2, x2, z2);
+	fieldToBytes(result, x2);
+
+	memset(k, 0, sizeof(k));
+
+	for (t = 0; t < 32; t++)
+		r |= result[t];
+	return r ? 0 : -1;
+}
+
+void ecc_x25519_base(uint8_t *result, const uint8_t *scalar)
+{
+	static const uint8_t base[32] = {9};
+
+	ecc_x25519(result, scalar, base);
+}
+
+static void ec_identity(ge_t *p)
+{
+	fieldZero(p->X);
+	fieldOne(p->Y);
+	fieldOne(p->Z);
+	fieldZero(p->T);
+}
+
+/* add-2008-hwcd-3, r may alias p or q */
+static void ec_add(ge_t *r, const ge_t *p, const ge_t *q, const fe d2)
+{
+	fe a, b, c, d, e, f, g, h;
+
+	fieldSub(a, p->Y, p->X);
+	fieldSub(b, q->Y, q->X);
+	fieldMult(a, a, b);
+	fieldAdd(b, p->Y, p->X);
+	fieldAdd(c, q->Y, q->X);
+	fieldMult(b, b, c);
+	fieldMult(c, p->T, q->T);
+	fieldMult(c, c, d2);
+	fieldMult(d, p->Z, q->Z);
+	fieldAdd(d, d, d);
+	fieldSub(e, b, a);
+	fieldSub(f, d, c);
+	fieldAdd(g, d, c);
+	fieldAdd(h, b, a);
+	fieldMult(r->X, e, f);
+	fieldMult(r->Y, g, h);
+	fieldMult(r->T, e, h);
+	fieldMult(r->Z, f, g);
+}
+
+/* dbl-2008-hwcd with a = -1, all signs of E, F, G and H flipped */
+static void ec_double(ge_t *r, const ge_t *p)
+{
+	fe a, b, c, e, f, g, h;
+
+	fieldSquare(a, p->X);
+	fieldSquare(b, p->Y);
+	fieldSquare(c, p->Z);
+	fieldAdd(c, c, c);
+	fieldAdd(h, a, b);
+	fieldAdd(e, p->X, p->Y);
+	fieldSquare(e, e);
+	fieldSub(e, h, e);
+	fieldSub(g, a, b);
+	fieldAdd(f, c, g);
+	fieldMult(r->X, e, f);
+	fieldMult(r->Y, g, h);
+	fieldMult(r->T, e, h);
+	fieldMult(r->Z, f, g);
+}
+
+static void ec_neg(ge_t *r, const ge_t *p)
+{
+	fieldNeg(r->X, p->X);
+	fieldCopy(r->Y, p->Y);
+	fieldCopy(r->Z, p->Z);
+	fieldNeg(r->T, p->T);
+}
+
+static void ec_base(ge_t *p)
+{
+	fieldFromBytes(p->X, ed25519_base_x);
+	fieldFromBytes(p->Y, ed25519_base_y);
+	fieldOne(p->Z);
+	fieldMult(p->T, p->X, p->Y);
+}
+
+static void ec_toBytes(uint8_t *s, const ge_t *p)
+{
+	fe recip, x, y;
+
+	fieldInv(recip, p->Z);
+	fieldMult(x, p->X, recip);
+	fieldMult(y, p->Y, recip);
+	fieldToBytes(s, y);
+	s[31] ^= fieldIsNegative(x) << 7;
+}
+
+/* RFC 8032 section 5.1.3, returns -1 if s is no valid point encoding */
+static int ec_fromBytes(ge_t *p, const uint8_t *s)
+{
+	uint8_t check[32];
+	fe u, v, v3, vxx, t;
+
+	fieldFromBytes(p->Y, s);
+	fieldToBytes(check, p->Y);
+	check[31] |= s[31] & 0x80;
+	if (memcmp(check, s, 32))
+		return -1;			/* y is not below p */
+
+	fieldOne(p->Z);
+	fieldSquare(u, p->Y);
+	fieldFromBytes(t, ed25519_d);
+	fieldMult(v, u, t);
+	fieldSub(u, u, p->Z);			/* u = y^2 - 1 */
+	fieldAdd(v, v, p->Z);			/* v = d y^2 + 1 */
+
+	/* x = u v^3 (u v^7)^((p - 5) / 8) */
+	fieldSquare(v3, v);
+	fieldMult(v3, v3, v);
+	fieldSquare(p->X, v3);
+	fieldMult(p->X, p->X, v);
+	fieldMult(p->X, p->X, u);
+	fieldPow22523(p->X, p->X);
+	fieldMult(p->X, p->X, v3);
+	fieldMult(p->X, p->X, u);
+
+	fieldSquare(vxx, p->X);
+	fieldMult(vxx, vxx, v);
+	fieldSub(t, vxx, u);
+	if (!fieldIsZero(t)) {
+		fieldAdd(t, vxx, u);
+		if (!fieldIsZero(t))
+			return -1;
+		fieldFromBytes(t, ed25519_sqrtm1);
+		fieldMult(p->X, p->X, t);
+	}
+
+	if (fieldIsNegative(p->X) != (s[31] >> 7)) {
+		if (fieldIsZero(p->X))
+			return -1;
+		fieldNeg(p->X, p->X);
+	}
+	fieldMult(p->T, p->X, p->Y);
+	return 0;
+}
+
+/* table[i] = i * p for i = 0, ..., 15 */
+static void ec_table(ge_t *table, const ge_t *p, const fe d2)
+{
+	int i;
+
+	ec_identity(&table[0]);
+	table[1] = *p;
+	for (i = 2; i < 16; i += 2) {
+		ec_double(&table[i], &table[i / 2]);
+		ec_add(&table[i + 1], &table[i], p, d2);
+	}
+}
+
+/* selects table[index] reading every entry */
+static void ec_select(ge_t *r, const ge_t *table, uint8_t index)
+{
+	limb_t b;
+	int i;
+
+	ec_identity(r);
+	for (i = 1; i < 16; i++) {
+		b = (limb_t)(((uint32_t)(index ^ i) - 1) >> 31);
+		fieldCMove(r->X, table[i].X, b);
+		fieldCMove(r->Y, table[i].Y, b);
+		fieldCMove(r->Z, table[i].Z, b);
+		fieldCMove(r->T, table[i].T, b);
+	}
+}
+
+static uint8_t scalarNibble(const uint8_t *s, int i)
+{
+	return (s[i >> 1] >> ((i & 1) << 2)) & 0x0f;
+}
+
+void ecc_ed25519_base_mult(uint8_t *result, const uint8_t *scalar)
+{
+	ge_t table[16];
+	ge_t q, t;
+	fe d2;
+	int i;
+
+	fieldFromBytes(d2, ed25519_d);
+	fieldAdd(d2, d2, d2);
+	ec_base(&q);
+	ec_table(table, &q, d2);
+
+	/* fixed 4 bit windows from the top */
+	ec_identity(&q);
+	for (i = 63; i >= 0; i--) {
+		ec_double(&q, &q);
+		ec_double(&q, &q);
+		ec_double(&q, &q);
+		ec_double(&q, &q);
+		ec_select(&t, table, scalarNibble(scalar, i));
+		ec_add(&q, &q, &t, d2);
+	}
+	ec_toBytes(result, &q);
+	memset(table, 0, sizeof(table));
+}
+
+/*
+ * Reduces x modulo the group order l with signed radix 2^8 digits.
+ * The top digits are folded with 2^252 = -(l - 2^252) mod l.
+ */
+static void scalarModOrder(uint8_t *result, int64_t *x)
+{
+	int64_t carry;
+	int i, j;
+
+	for (i = 63; i >= 32; i--) {
+		carry = 0;
+		for (j = i - 32; j < i - 12; j++) {
+			x[j] += carry - 16 * x[i] * ed25519_order[j - (i - 32)];
+			carry = (x[j] + 128) >> 8;
+			x[j] -= carry * 256;
+		}
+		x[j] += carry;
+		x[i] = 0;
+	}
+
+	carry = 0;
+	for (j = 0; j < 32; j++) {
+		x[j] += carry - (x[31] >> 4) * ed25519_order[j];
+		carry = x[j] >> 8;
+		x[j] &= 255;
+	}
+	for (j = 0; j < 32; j++)
+		x[j] -= carry * ed25519_order[j];
+	for (i = 0; i < 32; i++) {
+		x[i + 1] += x[i] >> 8;
+		result[i] = x[i] & 255;
+	}
+}
+
+void ecc_ed25519_reduce(uint8_t *result, const uint8_t *hash)
+{
+	int64_t x[64];
+	int i;
+
+	for (i = 0; i < 64; i++)
+		x[i] = hash[i];
+	scalarModOrder(result, x);
+}
+
+void ecc_ed25519_muladd(uint8_t *result, const uint8_t *a, const uint8_t *b, const uint8_t *c)
+{
+	int64_t x[64];
+	int i, j;
+
+	for (i = 0; i < 32; i++)
+		x[i] = c[i];
+	for (; i < 64; i++)
+		x[i] = 0;
+	for (i = 0; i < 32; i++)
+		for (j = 0; j < 32; j++)
+			x[i + j] += (int64_t)a[i] * b[j];
+	scalarModOrder(result, x);
+}
+
+/* returns 1 if s < l */
+static int scalarIsReduced(const uint8_t *s)
+{
+	int i;
+
+	for (i = 31; i >= 0; i--) {
+		if (s[i] < ed25519_order[i])
+			return 1;
+		if (s[i] > ed25519_order[i])
+			return 0;
+	}
+	return 0;
+}
+
+int ecc_ed25519_validate(const uint8_t *pub, const uint8_t *hash, const uint8_t *r, const uint8_t *s)
+{
+	ge_t table_b[16];
+	ge_t table_a[16];
+	ge_t q;
+	fe d2;
+	uint8_t k[32];
+	uint8_t check[32];
+	int i;
+
+	if (!scalarIsReduced(s))
+		return -1;
+	if (ec_fromBytes(&q, pub))
+		return -1;
+
+	ecc_ed25519_reduce(k, hash);
+
+	fieldFromBytes(d2, ed25519_d);
+	fieldAdd(d2, d2, d2);
+	ec_neg(&q, &q);
+	ec_table(table_a, &q, d2);
+	ec_base(&q);
+	ec_table(table_b, &q, d2);
+
+	/* s B - k A, everything is public here */
+	ec_identity(&q);
+	for (i = 63; i >= 0; i--) {
+		ec_double(&q, &q);
+		ec_double(&q, &q);
+		ec_double(&q, &q);
+		ec_double(&q, &q);
+		ec_add(&q, &q, &table_b[scalarNibble(s, i)], d2);
+		ec_add(&q, &q, &table_a[scalarNibble(k, i)], d2);
+	}
+	ec_toBytes(check, &q);
+
+	return memcmp(check, r, 32) ? -1 : 0;
+}
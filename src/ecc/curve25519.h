@@ -0,0 +1,59 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2011, 2012, 2013, 2014, 2015 Olaf Bergmann (TZI) and others.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v. 1.0 which accompanies this distribution.
+ *
+ * The Eclipse Public License is available at http://www.eclipse.org/legal/epl-v10.html
+ * and the Eclipse Distribution License is available at 
+ * http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ *******************************************************************************/
+
+/*
+ * X25519 (RFC 7748) and the group operations of Ed25519 (RFC 8032) on
+ * curve25519. All values are little endian byte strings of 32 bytes as
+ * they are sent on the wire. The SHA-512 hashing of Ed25519 is done by
+ * the caller, see dtls_ed25519_create_sig() in crypto.c.
+ *
+ * The field elements use five 51 bit limbs on compilers providing a 128
+ * bit integer type and ten limbs of alternating 26 and 25 bits on all
+ * others. Operations on secret data do not branch on it nor use it as
+ * memory index.
+ */
+
+#ifndef _ECC_CURVE25519_H_
+#define _ECC_CURVE25519_H_
+
+#include <inttypes.h>
+
+#define CURVE25519_KEY_SIZE 32
+
+/**
+ * Computes the X25519 function of @p scalar and the u-coordinate @p
+ * point. Returns -1 when the result is all zero, i.e. @p point was of
+ * small order, 0 otherwise.
+ */
+int ecc_x25519(uint8_t *result, const uint8_t *scalar, const uint8_t *point);
+
+/** Computes the X25519 public key of the private key @p scalar. */
+void ecc_x25519_base(uint8_t *result, const uint8_t *scalar);
+
+/** Stores the encoding of @p scalar times the Ed25519 base point. */
+void ecc_ed25519_base_mult(uint8_t *result, const uint8_t *scalar);
+
+/** Reduces the 64 byte number @p hash modulo the group order. */
+void ecc_ed25519_reduce(uint8_t *result, const uint8_t *hash);
+
+/** Computes @p a * @p b + @p c modulo the group order. */
+void ecc_ed25519_muladd(uint8_t *result, const uint8_t *a, const uint8_t *b, const uint8_t *c);
+
+/**
+ * Checks the Ed25519 signature (@p r, @p s) with the public key @p pub
+ * where @p hash is the 64 byte SHA-512 hash of r, pub and the message.
+ * Returns 0 if the signature is valid, -1 otherwise.
+ */
+int ecc_ed25519_validate(const uint8_t *pub, const uint8_t *hash, const uint8_t *r, const uint8_t *s);
+
+#endif /* _ECC_CURVE25519_H_ */
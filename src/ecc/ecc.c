@@ -90,20 +90,42 @@ static const uint32_t ecc_order_m[9] = {0xFC632551, 0xF3B9CAC2, 0xA7179E84, 0xBC
 					0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0xFFFFFFFF,
 					0x00000000};
 
-static const uint32_t ecc_order_r[8] = {0x039CDAAF, 0x0C46353D, 0x58E8617B, 0x43190552,
-					0x00000000, 0x00000000, 0xFFFFFFFF, 0x00000000};
-
 static const uint32_t ecc_order_mu[9] = {0xEEDF9BFE, 0x012FFD85, 0xDF1A6C21, 0x43190552,
 					 0xFFFFFFFF, 0xFFFFFFFE, 0xFFFFFFFF, 0x00000000,
 					 0x00000001};
 
 static const uint8_t ecc_order_k = 8;
 
+// ffffffff00000000ffffffffffffffffbce6faada7179e84f3b9cac2fc63254f
+// the exponent for the inversion modulo n
+static const uint32_t ecc_order_m_2[8] = {0xFC63254F, 0xF3B9CAC2, 0xA7179E84, 0xBCE6FAAD,
+					  0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0xFFFFFFFF};
+
 const uint32_t ecc_g_point_x[8] = { 0xD898C296, 0xF4A13945, 0x2DEB33A0, 0x77037D81,
 				    0x63A440F2, 0xF8BCE6E5, 0xE12C4247, 0x6B17D1F2};
 const uint32_t ecc_g_point_y[8] = { 0x37BF51F5, 0xCBB64068, 0x6B315ECE, 0x2BCE3357,
 				    0x7C0F9E16, 0x8EE7EB4A, 0xFE1A7F9B, 0x4FE342E2};
 
+/* odd multiples G, 3G, ..., 15G of the base point, see ecc_ec_precompute() */
+static const ecc_point_table_t ecc_g_table = {
+	{{0xD898C296, 0xF4A13945, 0x2DEB33A0, 0x77037D81, 0x63A440F2, 0xF8BCE6E5, 0xE12C4247, 0x6B17D1F2},
+	 {0xC6E7FD6C, 0xFB41661B, 0xEFADA985, 0xE6C6B721, 0x1D4BF165, 0xC8F7EF95, 0xA6330A44, 0x5ECBE4D1},
+	 {0xC3D033ED, 0x21554A0D, 0x1F5BE524, 0xEF8C82FD, 0x08668FDF, 0xD784C856, 0x515140D2, 0x51590B7A},
+	 {0x3187B2A3, 0x30062870, 0xA80FEF5B, 0x7EF9F8B8, 0x7C01FB60, 0x25BB3066, 0xA0BF7B46, 0x8E533B6F},
+	 {0x90949EE0, 0xD79E8A4B, 0x2C6DF8B3, 0x9E0ACB8C, 0x1D71F872, 0x878938D5, 0xFEDF0B71, 0xEA68D7B6},
+	 {0x74BC21D1, 0x433391D3, 0x255048BF, 0x16742ED0, 0xB0C21CDA, 0x0638379D, 0x883B4C59, 0x3ED113B7},
+	 {0x46072C01, 0x98E15D9D, 0x65EAD58A, 0x792E284B, 0xD85EE2FC, 0x61805DF2, 0xE0AC495A, 0x177C837A},
+	 {0xE59B9D5F, 0x63668C63, 0xDE3A0EF1, 0xAE03AF92, 0x99888265, 0xADFB3789, 0x971ABAE7, 0xF0454DC6}},
+	{{0x37BF51F5, 0xCBB64068, 0x6B315ECE, 0x2BCE3357, 0x7C0F9E16, 0x8EE7EB4A, 0xFE1A7F9B, 0x4FE342E2},
+	 {0xA27D5032, 0x9A79B127, 0x384FB83D, 0xD82AB036, 0x1A64A2EC, 0x374B06CE, 0x4998FF7E, 0x8734640C},
+	 {0xFDA16DA4, 0xD1D0BB44, 0xD4D80888, 0x0D012F00, 0xBF8A7926, 0x8AE1BF36, 0x904A727D, 0xE0C17DA8},
+	 {0xC1F400B4, 0xC55E1A86, 0xCB041B21, 0x53C73633, 0xA6F59000, 0x6D069F83, 0xE0331836, 0x73EB1DBD},
+	 {0x4DD048FA, 0xE85A224A, 0xA4DE823F, 0x4D714FEA, 0x4A8EA0C8, 0x87014A96, 0x72C9FCE7, 0x2A2744C9},
+	 {0xE82A3740, 0xE2F8EEFC, 0x5E9889DA, 0x090D04DA, 0xA4F4C68A, 0x24C843AF, 0xCCC4C8A2, 0x9099209A},
+	 {0xEFC7BFD8, 0x9C43BBE2, 0xA1FB4DF3, 0x26EE14C3, 0xB40F4E72, 0xA24091AD, 0x4EBEA558, 0x63BB58CD},
+	 {0x0D034F36, 0x47E59CDE, 0x75B5FA3F, 0x2A3B21CE, 0x1F9643E6, 0x4E6594E5, 0x592E2D1F, 0xB5B93EE3}}
+};
+
 
 static void setZero(uint32_t *A, const int length){
 	memset(A, 0x0, length * sizeof(uint32_t));
@@ -175,6 +197,35 @@ static int fieldMult(const uint32_t *x, const uint32_t *y, uint32_t *result, uin
 	return 0;
 }
 
+//finite Field squaring
+//every cross product x[i]*x[j] is only calculated once and added twice
+//result must have space for length * 2 values
+static void fieldSquare(const uint32_t *x, uint32_t *result, uint8_t length){
+	uint64_t acc = 0; //column sum
+	uint32_t over = 0; //carries out of the 64 bit column sum
+	uint64_t l;
+	int i, j, k;
+	for (k = 0; k < length * 2 - 1; k++){
+		i = k < length ? 0 : k - length + 1;
+		for (j = k - i; i < j; i++, j--){
+			l = (uint64_t)x[i]*(uint64_t)x[j];
+			over += l>>63;
+			l <<= 1;
+			acc += l;
+			over += acc < l;
+		}
+		if (i == j){
+			l = (uint64_t)x[i]*(uint64_t)x[i];
+			acc += l;
+			over += acc < l;
+		}
+		result[k] = acc&0xFFFFFFFF;
+		acc = (acc>>32) | ((uint64_t)over<<32);
+		over = 0;
+	}
+	result[length * 2 - 1] = acc&0xFFFFFFFF;
+}
+
 //TODO: maximum:
 //fffffffe00000002fffffffe0000000100000001fffffffe00000001fffffffe00000001fffffffefffffffffffffffffffffffe000000000000000000000001_16
 static void fieldModP(uint32_t *A, const uint32_t *B)
@@ -299,6 +350,8 @@ static void fieldModO(const uint32_t *A, uint32_t *result, uint8_t length) {
 		sub(result, ecc_order_m, result, 9);
 }
 
+#ifdef TEST_INCLUDE
+/* isOne() and rshift() are not needed for the inversion anymore, only the tests use them */
 static int isOne(const uint32_t* A){
 	uint8_t n; 
 	for(n=1;n<8;n++) 
@@ -310,6 +363,7 @@ static int isOne(const uint32_t* A){
 	else 
 		return 0;
 }
+#endif /* TEST_INCLUDE */
 
 static int isZero(const uint32_t* A){
 	uint8_t n, r=0;
@@ -319,6 +373,28 @@ static int isZero(const uint32_t* A){
 	return r==8;
 }
 
+/*
+ * Returns 0xFFFFFFFF if A is 0 and 0 otherwise, without a branch on A.
+ */
+static uint32_t ctIsZero(const uint32_t *A){
+	uint32_t r = 0;
+	uint8_t n;
+	for(n=0;n<8;n++)
+		r |= A[n];
+	return ((r | (0 - r)) >> 31) - 1;
+}
+
+/*
+ * Copies A to B if mask is 0xFFFFFFFF and leaves B unchanged if it is 0,
+ * without a branch on mask.
+ */
+static void ctCopy(const uint32_t *A, uint32_t *B, uint32_t mask){
+	uint8_t n;
+	for(n=0;n<8;n++)
+		B[n] ^= (A[n] ^ B[n]) & mask;
+}
+
+#ifdef TEST_INCLUDE
 static void rshift(uint32_t* A){
 	int n, i;
 	uint32_t nOld = 0;
@@ -329,83 +405,190 @@ static void rshift(uint32_t* A){
 		nOld = n;
 	}
 }
+#endif /* TEST_INCLUDE */
+
+/*
+ * result = A + B mod p, A and B must be smaller than p
+ */
+static void fieldAddModP(const uint32_t *A, const uint32_t *B, uint32_t *result){
+	fieldAdd(A, B, ecc_prime_r, result);
+	if(isGreater(result, ecc_prime_m, arrayLength) >= 0)
+		sub(result, ecc_prime_m, result, arrayLength);
+}
+
+/*
+ * result = A * B mod p
+ */
+static void fieldMultModP(const uint32_t *A, const uint32_t *B, uint32_t *result){
+	uint32_t tempD[16];
+	fieldMult(A, B, tempD, arrayLength);
+	fieldModP(result, tempD);
+}
+
+/*
+ * result = A^2 mod p
+ */
+static void fieldSquareModP(const uint32_t *A, uint32_t *result){
+	uint32_t tempD[16];
+	fieldSquare(A, tempD, arrayLength);
+	fieldModP(result, tempD);
+}
+
+/*
+ * Square A mod p n times, in place.
+ */
+static void fieldSquareNModP(uint32_t *A, uint8_t n){
+	while (n--)
+		fieldSquareModP(A, A);
+}
+
+/*
+ * Inverse A mod p and output to B.
+ *
+ * This calculates A^(p-2) with a fixed addition chain for the secp256r1
+ * prime (255 squarings and 12 multiplications). The sequence of operations
+ * does not depend on A, unlike the binary extended euclidean algorithm used
+ * before. A = 0 results in B = 0.
+ *
+ * p-2 = ffffffff 00000001 00000000 00000000 00000000 ffffffff ffffffff fffffffd
+ */
+static void fieldInvModP(const uint32_t *A, uint32_t *B){
+	uint32_t a[8], x2[8], x3[8], x6[8], x12[8], x15[8], x30[8], x32[8];
+	uint32_t t[8];
+
+	/* A and B could point to the same value */
+	copy(A, a, arrayLength);
+	copy(a, t, arrayLength);
+	fieldSquareNModP(t, 1);
+	fieldMultModP(t, a, x2);		/* x2 = A^(2^2-1) */
+	copy(x2, t, arrayLength);
+	fieldSquareNModP(t, 1);
+	fieldMultModP(t, a, x3);		/* x3 = A^(2^3-1) */
+	copy(x3, t, arrayLength);
+	fieldSquareNModP(t, 3);
+	fieldMultModP(t, x3, x6);		/* x6 = A^(2^6-1) */
+	copy(x6, t, arrayLength);
+	fieldSquareNModP(t, 6);
+	fieldMultModP(t, x6, x12);		/* x12 = A^(2^12-1) */
+	copy(x12, t, arrayLength);
+	fieldSquareNModP(t, 3);
+	fieldMultModP(t, x3, x15);		/* x15 = A^(2^15-1) */
+	copy(x15, t, arrayLength);
+	fieldSquareNModP(t, 15);
+	fieldMultModP(t, x15, x30);		/* x30 = A^(2^30-1) */
+	copy(x30, t, arrayLength);
+	fieldSquareNModP(t, 2);
+	fieldMultModP(t, x2, x32);		/* x32 = A^(2^32-1) */
+
+	copy(x32, t, arrayLength);
+	fieldSquareNModP(t, 32);
+	fieldMultModP(t, a, B);			/* ffffffff 00000001 */
+	fieldSquareNModP(B, 128);
+	fieldMultModP(B, x32, t);		/* ... 00000000 00000000 00000000 ffffffff */
+	fieldSquareNModP(t, 32);
+	fieldMultModP(t, x32, B);		/* ... ffffffff */
+	fieldSquareNModP(B, 30);
+	fieldMultModP(B, x30, t);		/* ... 3fffffff */
+	fieldSquareNModP(t, 2);
+	fieldMultModP(t, a, B);			/* ... fffffffd */
+}
 
-static int fieldAddAndDivide(const uint32_t *x, const uint32_t *modulus, const uint32_t *reducer, uint32_t* result){
-	uint32_t n = add(x, modulus, result, arrayLength);
-	rshift(result);
-	if(n){ //add prime if carry is still set!
-		result[7] |= 0x80000000;//add the carry
-		if (isGreater(result, modulus, arrayLength) == 1)
-		{
-			uint32_t tempas[8];
-			setZero(tempas, 8);
-			add(result, reducer, tempas, 8);
-			copy(tempas, result, arrayLength);
+/*
+ * Inverse A mod n (the order of the curve) and output to B.
+ *
+ * This calculates A^(n-2) with a fixed window of 4 bits. The exponent is a
+ * constant, so the sequence of operations does not depend on A.
+ */
+static void fieldInvModO(const uint32_t *A, uint32_t *B){
+	uint32_t table[15][9];	/* table[i] = A^(i+1) */
+	uint32_t tempD[16];
+	uint32_t r[9];
+	uint8_t i, w;
+	int n;
+
+	fieldModO(A, table[0], arrayLength);
+	for (i = 1; i < 15; i++) {
+		fieldMult(table[i - 1], table[0], tempD, arrayLength);
+		fieldModO(tempD, table[i], 16);
+	}
+
+	/* the most significant window of n-2 is 0xf */
+	copy(table[14], r, arrayLength);
+	for (n = 62; n >= 0; n--) {
+		for (i = 0; i < 4; i++) {
+			fieldSquare(r, tempD, arrayLength);
+			fieldModO(tempD, r, 16);
+		}
+		w = (ecc_order_m_2[n / 8] >> ((n % 8) * 4)) & 0xf;
+		if (w) {
+			fieldMult(r, table[w - 1], tempD, arrayLength);
+			fieldModO(tempD, r, 16);
 		}
-		
 	}
-	return 0;
+	copy(r, B, arrayLength);
 }
 
 /*
- * Inverse A and output to B
+ * result = A * B mod n
  */
-static void fieldInv(const uint32_t *A, const uint32_t *modulus, const uint32_t *reducer, uint32_t *B){
-	uint32_t u[8],v[8],x1[8],x2[8];
-	uint32_t tempm[8];
-	uint32_t tempm2[8];
-	setZero(tempm, 8);
-	setZero(tempm2, 8);
-	setZero(u, 8);
-	setZero(v, 8);
-
-	uint8_t t;
-	copy(A,u,arrayLength); 
-	copy(modulus,v,arrayLength); 
-	setZero(x1, 8);
-	setZero(x2, 8);
-	x1[0]=1; 
-	/* While u !=1 and v !=1 */ 
-	while ((isOne(u) || isOne(v))==0) {
-		while(!(u[0]&1)) { 					/* While u is even */
-			rshift(u); 						/* divide by 2 */
-			if (!(x1[0]&1))					/*ifx1iseven*/
-				rshift(x1);					/* Divide by 2 */
-			else {
-				fieldAddAndDivide(x1,modulus,reducer,tempm); /* tempm=x1+p */
-				copy(tempm,x1,arrayLength); 		/* x1=tempm */
-				//rshift(x1);					/* Divide by 2 */
-			}
-		} 
-		while(!(v[0]&1)) {					/* While v is even */
-			rshift(v); 						/* divide by 2 */ 
-			if (!(x2[0]&1))					/*ifx1iseven*/
-				rshift(x2); 				/* Divide by 2 */
-			else
-			{
-				fieldAddAndDivide(x2,modulus,reducer,tempm);	/* tempm=x1+p */
-				copy(tempm,x2,arrayLength); 			/* x1=tempm */ 
-				//rshift(x2);					/* Divide by 2 */
-			}
-			
-		} 
-		t=sub(u,v,tempm,arrayLength); 				/* tempm=u-v */
-		if (t==0) {							/* If u > 0 */
-			copy(tempm,u,arrayLength); 					/* u=u-v */
-			fieldSub(x1,x2,modulus,tempm); 			/* tempm=x1-x2 */
-			copy(tempm,x1,arrayLength);					/* x1=x1-x2 */
-		} else {
-			sub(v,u,tempm,arrayLength); 			/* tempm=v-u */
-			copy(tempm,v,arrayLength); 					/* v=v-u */
-			fieldSub(x2,x1,modulus,tempm); 			/* tempm=x2-x1 */
-			copy(tempm,x2,arrayLength);					/* x2=x2-x1 */
-		}
-	} 
-	if (isOne(u)) {
-		copy(x1,B,arrayLength); 
-	} else {
-		copy(x2,B,arrayLength);
+static void fieldMultModO(const uint32_t *A, const uint32_t *B, uint32_t *result){
+	uint32_t tempD[16];
+	uint32_t tempA[9];
+	fieldMult(A, B, tempD, arrayLength);
+	fieldModO(tempD, tempA, 16);
+	copy(tempA, result, arrayLength);
+}
+
+/*
+ * Inverse count values of A mod p or mod n (modulus is ecc_prime_m or
+ * ecc_order_m) at once and output them to B, A and B could point to the
+ * same array. Each value uses 8 array elements.
+ *
+ * This uses Montgomery's trick, so only one inversion and 3 * (count - 1)
+ * multiplications are needed for up to ECC_BATCH_MAX values, larger
+ * counts are done in groups of that size. A value of 0 results in 0 and
+ * does not affect the other values.
+ */
+static void fieldInvBatch(const uint32_t *A, uint32_t *B, uint8_t count, const uint32_t *modulus){
+	void (*mult)(const uint32_t *, const uint32_t *, uint32_t *);
+	uint32_t prefix[ECC_BATCH_MAX * 8];	/* prefix[i] = A[0] * ... * A[i] */
+	uint32_t inv[8];
+	uint32_t tempA[8];
+	uint32_t one[8];
+	int i;
+
+	if (!count)
+		return;
+	if (count > ECC_BATCH_MAX) {
+		fieldInvBatch(A, B, ECC_BATCH_MAX, modulus);
+		fieldInvBatch(&A[ECC_BATCH_MAX * 8], &B[ECC_BATCH_MAX * 8], count - ECC_BATCH_MAX, modulus);
+		return;
+	}
+
+	mult = modulus == ecc_order_m ? fieldMultModO : fieldMultModP;
+	setZero(one, 8);
+	one[0] = 0x00000001;
+
+	copy(isZero(A) ? one : A, prefix, arrayLength);
+	for (i = 1; i < count; i++)
+		mult(&prefix[(i - 1) * 8], isZero(&A[i * 8]) ? one : &A[i * 8], &prefix[i * 8]);
+
+	if (modulus == ecc_order_m)
+		fieldInvModO(&prefix[(count - 1) * 8], inv);
+	else
+		fieldInvModP(&prefix[(count - 1) * 8], inv);
+
+	for (i = count - 1; i > 0; i--) {
+		mult(inv, &prefix[(i - 1) * 8], tempA); //tempA = 1/A[i]
+		if (!isZero(&A[i * 8]))
+			mult(inv, &A[i * 8], inv);
+		else
+			setZero(tempA, 8);
+		copy(tempA, &B[i * 8], arrayLength);
 	}
+	if (isZero(A))
+		setZero(inv, 8);
+	copy(inv, B, arrayLength);
 }
 
 void static ec_double(const uint32_t *px, const uint32_t *py, uint32_t *Dx, uint32_t *Dy){
@@ -429,7 +612,7 @@ void static ec_double(const uint32_t *px, const uint32_t *py, uint32_t *Dx, uint
 	fieldMult(tempC, tempB, tempD, arrayLength);
 	fieldModP(tempA, tempD);//tempA = 3*(qx^2-1)
 	fieldAdd(py, py, ecc_prime_r, tempB); //tempB = 2*qy
-	fieldInv(tempB, ecc_prime_m, ecc_prime_r, tempC); //tempC = 1/(2*qy)
+	fieldInvModP(tempB, tempC); //tempC = 1/(2*qy)
 	fieldMult(tempA, tempC, tempD, arrayLength); //tempB = lambda = (3*(qx^2-1))/(2*qy)
 	fieldModP(tempB, tempD);
 
@@ -473,7 +656,7 @@ void static ec_add(const uint32_t *px, const uint32_t *py, const uint32_t *qx, c
 
 	fieldSub(py, qy, ecc_prime_m, tempA);
 	fieldSub(px, qx, ecc_prime_m, tempB);
-	fieldInv(tempB, ecc_prime_m, ecc_prime_r, tempB);
+	fieldInvModP(tempB, tempB);
 	fieldMult(tempA, tempB, tempD, arrayLength); 
 	fieldModP(tempC, tempD); //tempC = lambda
 
@@ -488,28 +671,312 @@ void static ec_add(const uint32_t *px, const uint32_t *py, const uint32_t *qx, c
 	fieldSub(tempC, qy, ecc_prime_m, Sy);
 }
 
-void ecc_ec_mult(const uint32_t *px, const uint32_t *py, const uint32_t *secret, uint32_t *resultx, uint32_t *resulty){
-	uint32_t Qx[8];
-	uint32_t Qy[8];
-	setZero(Qx, 8);
-	setZero(Qy, 8);
+/*
+ * Doubles the point (X, Y, Z) given in jacobian coordinates (x = X/Z^2,
+ * y = Y/Z^3), Z = 0 is the point at infinity. The output may point to the
+ * input values.
+ *
+ * see http://hyperelliptic.org/EFD/g1p/auto-shortw-jacobian-3.html#doubling-dbl-2001-b
+ */
+static void ec_double_jacobian(const uint32_t *X, const uint32_t *Y, const uint32_t *Z, uint32_t *X3, uint32_t *Y3, uint32_t *Z3){
+	uint32_t delta[8];
+	uint32_t gamma[8];
+	uint32_t beta[8];
+	uint32_t alpha[8];
+	uint32_t tempA[8];
+	uint32_t tempB[8];
+
+	/* no special case for the point at infinity, Z3 = 2*Y*Z is 0 again */
+	fieldSquareModP(Z, delta); //delta = Z^2
+	fieldSquareModP(Y, gamma); //gamma = Y^2
+	fieldMultModP(X, gamma, beta); //beta = X*gamma
+	fieldSub(X, delta, ecc_prime_m, tempA);
+	fieldAddModP(X, delta, tempB);
+	fieldMultModP(tempA, tempB, tempA); //(X-delta)*(X+delta)
+	fieldAddModP(tempA, tempA, alpha);
+	fieldAddModP(alpha, tempA, alpha); //alpha = 3*(X-delta)*(X+delta)
+
+	fieldAddModP(Y, Z, tempA);
+	fieldSquareModP(tempA, tempA);
+	fieldSub(tempA, gamma, ecc_prime_m, tempB);
+	fieldSub(tempB, delta, ecc_prime_m, Z3); //Z3 = (Y+Z)^2-gamma-delta
+
+	fieldAddModP(beta, beta, beta);
+	fieldAddModP(beta, beta, beta); //beta = 4*beta
+	fieldSquareModP(alpha, tempA);
+	fieldAddModP(beta, beta, tempB);
+	fieldSub(tempA, tempB, ecc_prime_m, X3); //X3 = alpha^2-8*beta
+
+	fieldSub(beta, X3, ecc_prime_m, tempA);
+	fieldMultModP(alpha, tempA, tempA); //alpha*(4*beta-X3)
+	fieldSquareModP(gamma, tempB);
+	fieldAddModP(tempB, tempB, tempB);
+	fieldAddModP(tempB, tempB, tempB);
+	fieldAddModP(tempB, tempB, tempB); //8*gamma^2
+	fieldSub(tempA, tempB, ecc_prime_m, Y3); //Y3 = alpha*(4*beta-X3)-8*gamma^2
+}
+
+/*
+ * The general case of ec_add_jacobian() with H = qx*Z^2-X and R = qy*Z^3-Y.
+ * H = 0 gives Z3 = 0, also if the points are equal. The output may point
+ * to X, Y and Z.
+ */
+static void ec_add_jacobian_hr(const uint32_t *X, const uint32_t *Y, const uint32_t *Z, const uint32_t *H, const uint32_t *R, uint32_t *X3, uint32_t *Y3, uint32_t *Z3){
+	uint32_t tempA[8];
+	uint32_t tempC[8];
+	uint32_t tempD[8];
+
+	fieldMultModP(Z, H, Z3); //Z3 = Z*H
+	fieldSquareModP(H, tempC);
+	fieldMultModP(tempC, H, tempD); //tempD = H^3
+	fieldMultModP(tempC, X, tempC); //tempC = X*H^2
+	fieldAddModP(tempC, tempC, tempA);
+	fieldSquareModP(R, X3);
+	fieldSub(X3, tempA, ecc_prime_m, X3);
+	fieldSub(X3, tempD, ecc_prime_m, X3); //X3 = R^2-2*X*H^2-H^3
+
+	fieldSub(tempC, X3, ecc_prime_m, tempC);
+	fieldMultModP(tempC, R, tempC);
+	fieldMultModP(tempD, Y, tempD);
+	fieldSub(tempC, tempD, ecc_prime_m, Y3); //Y3 = R*(X*H^2-X3)-Y*H^3
+}
+
+/*
+ * Adds the affine point (qx, qy) to the point (X, Y, Z) given in jacobian
+ * coordinates. The output may point to the input values.
+ *
+ * see http://hyperelliptic.org/EFD/g1p/auto-shortw-jacobian-3.html#addition-madd-2004-hmv
+ */
+static void ec_add_jacobian(const uint32_t *X, const uint32_t *Y, const uint32_t *Z, const uint32_t *qx, const uint32_t *qy, uint32_t *X3, uint32_t *Y3, uint32_t *Z3){
+	uint32_t tempA[8];
+	uint32_t tempB[8];
+	uint32_t tempC[8];
+
+	if(isZero(Z)){
+		copy(qx, X3, arrayLength);
+		copy(qy, Y3, arrayLength);
+		setZero(Z3, 8);
+		Z3[0] = 0x00000001;
+		return;
+	}
+
+	fieldSquareModP(Z, tempA);
+	fieldMultModP(tempA, Z, tempB);
+	fieldMultModP(tempA, qx, tempA);
+	fieldMultModP(tempB, qy, tempB);
+	fieldSub(tempA, X, ecc_prime_m, tempA); //tempA = H = qx*Z^2-X
+	fieldSub(tempB, Y, ecc_prime_m, tempB); //tempB = R = qy*Z^3-Y
+
+	if(isZero(tempA)){
+		if(isZero(tempB)){
+			setZero(tempC, 8);
+			tempC[0] = 0x00000001;
+			ec_double_jacobian(qx, qy, tempC, X3, Y3, Z3);
+		} else {
+			setZero(Z3, 8);
+		}
+		return;
+	}
 
-	uint32_t tempx[8];
-	uint32_t tempy[8];
+	ec_add_jacobian_hr(X, Y, Z, tempA, tempB, X3, Y3, Z3);
+}
 
+/*
+ * Like ec_add_jacobian(), but without branches on the values: the point
+ * at infinity is handled with masked copies. The output must not point
+ * to the input values.
+ *
+ * The case (X, Y, Z) = (qx, qy) is not handled and gives the point at
+ * infinity. In ec_mult_jacobian() the point is 2*m*(qx, qy) before the
+ * addition, so this cannot happen for secrets smaller than the order.
+ */
+static void ec_add_jacobian_ct(const uint32_t *X, const uint32_t *Y, const uint32_t *Z, const uint32_t *qx, const uint32_t *qy, uint32_t *X3, uint32_t *Y3, uint32_t *Z3){
+	uint32_t tempA[8];
+	uint32_t tempB[8];
+	uint32_t one[8];
+	uint32_t inf = ctIsZero(Z);
+
+	fieldSquareModP(Z, tempA);
+	fieldMultModP(tempA, Z, tempB);
+	fieldMultModP(tempA, qx, tempA);
+	fieldMultModP(tempB, qy, tempB);
+	fieldSub(tempA, X, ecc_prime_m, tempA); //tempA = H = qx*Z^2-X
+	fieldSub(tempB, Y, ecc_prime_m, tempB); //tempB = R = qy*Z^3-Y
+	ec_add_jacobian_hr(X, Y, Z, tempA, tempB, X3, Y3, Z3);
+
+	setZero(one, 8);
+	one[0] = 0x00000001;
+	ctCopy(qx, X3, inf);
+	ctCopy(qy, Y3, inf);
+	ctCopy(one, Z3, inf);
+}
+
+/*
+ * Converts the point (X, Y, Z) given in jacobian coordinates back to affine
+ * coordinates, the point at infinity is returned as (0, 0).
+ */
+static void ec_affine(const uint32_t *X, const uint32_t *Y, const uint32_t *Z, uint32_t *x, uint32_t *y){
+	uint32_t tempA[8];
+	uint32_t tempB[8];
+
+	if(isZero(Z)){
+		setZero(x, 8);
+		setZero(y, 8);
+		return;
+	}
+
+	fieldInvModP(Z, tempA);
+	fieldSquareModP(tempA, tempB);
+	fieldMultModP(X, tempB, x); //x = X/Z^2
+	fieldMultModP(tempB, tempA, tempB);
+	fieldMultModP(Y, tempB, y); //y = Y/Z^3
+}
+
+/*
+ * Calculates secret * (px, py), the result is given in jacobian coordinates.
+ *
+ * The point is doubled and added for every bit of the secret, and the sum
+ * is kept or dropped with a masked copy, so the sequence of operations and
+ * memory accesses does not depend on the secret. The field arithmetic
+ * below still has conditional reductions that depend on the values, so
+ * this is not completely constant-time.
+ */
+static void ec_mult_jacobian(const uint32_t *px, const uint32_t *py, const uint32_t *secret, uint32_t *X, uint32_t *Y, uint32_t *Z){
+	uint32_t tX[8];
+	uint32_t tY[8];
+	uint32_t tZ[8];
+	uint32_t bit;
 	int i;
+
+	setZero(X, 8);
+	setZero(Y, 8);
+	setZero(Z, 8);
+
+	if(isZero(px) && isZero(py))
+		return;
+
 	for (i = 256;i--;){
-		ec_double(Qx, Qy, tempx, tempy);
-		copy(tempx, Qx,arrayLength);
-		copy(tempy, Qy,arrayLength);
-		if (((secret[i / 32]) & ((uint32_t)1 << (i % 32)))) {
-			ec_add(Qx, Qy, px, py, tempx, tempy); //eccAdd
-			copy(tempx, Qx,arrayLength);
-			copy(tempy, Qy,arrayLength);
+		ec_double_jacobian(X, Y, Z, X, Y, Z);
+		ec_add_jacobian_ct(X, Y, Z, px, py, tX, tY, tZ);
+		bit = 0 - ((secret[i / 32] >> (i % 32)) & 1);
+		ctCopy(tX, X, bit);
+		ctCopy(tY, Y, bit);
+		ctCopy(tZ, Z, bit);
+	}
+}
+
+/*
+ * The point is kept in jacobian coordinates during the calculation, so only
+ * one inversion is needed at the end.
+ */
+void ecc_ec_mult(const uint32_t *px, const uint32_t *py, const uint32_t *secret, uint32_t *resultx, uint32_t *resulty){
+	uint32_t X[8];
+	uint32_t Y[8];
+	uint32_t Z[8];
+
+	ec_mult_jacobian(px, py, secret, X, Y, Z);
+	ec_affine(X, Y, Z, resultx, resulty);
+}
+
+/*
+ * Converts count points given in jacobian coordinates to affine
+ * coordinates in place with one inversion for all of them. X, Y and Z are
+ * arrays of count values with 8 elements each, the point at infinity is
+ * returned as (0, 0).
+ */
+static void ec_affine_batch(uint32_t *X, uint32_t *Y, uint32_t *Z, uint8_t count){
+	uint32_t tempA[8];
+	uint32_t tempB[8];
+	int i;
+
+	fieldInvBatch(Z, Z, count, ecc_prime_m);
+
+	for (i = 0; i < count; i++) {
+		/* the point at infinity has Z = 0 and also 1/Z = 0 here */
+		fieldSquareModP(&Z[i * 8], tempA);
+		fieldMultModP(tempA, &Z[i * 8], tempB);
+		fieldMultModP(&X[i * 8], tempA, &X[i * 8]); //x = X/Z^2
+		fieldMultModP(&Y[i * 8], tempB, &Y[i * 8]); //y = Y/Z^3
+	}
+}
+
+/*
+ * Calculates count scalar multiplications at once. px, py, secret,
+ * resultx and resulty are arrays of count values with 8 elements each.
+ * The results are converted to affine coordinates together, which needs
+ * only one inversion for every ECC_BATCH_MAX of them.
+ */
+void ecc_ec_mult_batch(const uint32_t *px, const uint32_t *py, const uint32_t *secret, uint32_t *resultx, uint32_t *resulty, uint8_t count){
+	uint32_t Z[ECC_BATCH_MAX * 8];
+	int i, n;
+
+	for (; count; count -= n) {
+		n = count < ECC_BATCH_MAX ? count : ECC_BATCH_MAX;
+
+		/* X and Y are stored in the result arrays until they are converted */
+		for (i = 0; i < n; i++)
+			ec_mult_jacobian(&px[i * 8], &py[i * 8], &secret[i * 8], &resultx[i * 8], &resulty[i * 8], &Z[i * 8]);
+		ec_affine_batch(resultx, resulty, Z, n);
+
+		px += n * 8;
+		py += n * 8;
+		secret += n * 8;
+		resultx += n * 8;
+		resulty += n * 8;
+	}
+}
+
+/* number of tables that ecc_ec_precompute() calculates together */
+#define ECC_PRECOMPUTE_MAX (ECC_BATCH_MAX / ECC_TABLE_SIZE > 0 ? ECC_BATCH_MAX / ECC_TABLE_SIZE : 1)
+
+/*
+ * Calculates the tables of odd multiples P, 3P, ..., 15P for count points
+ * at once. Two inversions are needed for every ECC_PRECOMPUTE_MAX of them.
+ */
+void ecc_ec_precompute(const uint32_t *px, const uint32_t *py, ecc_point_table_t *tables, uint8_t count){
+	uint32_t X[ECC_PRECOMPUTE_MAX * ECC_TABLE_SIZE * 8];
+	uint32_t Y[ECC_PRECOMPUTE_MAX * ECC_TABLE_SIZE * 8];
+	uint32_t Z[ECC_PRECOMPUTE_MAX * ECC_TABLE_SIZE * 8];
+	uint32_t one[8];
+	int i, j, n;
+
+	while (count > ECC_PRECOMPUTE_MAX) {
+		ecc_ec_precompute(px, py, tables, ECC_PRECOMPUTE_MAX);
+		px += ECC_PRECOMPUTE_MAX * 8;
+		py += ECC_PRECOMPUTE_MAX * 8;
+		tables += ECC_PRECOMPUTE_MAX;
+		count -= ECC_PRECOMPUTE_MAX;
+	}
+	if (!count)
+		return;
+
+	setZero(one, 8);
+	one[0] = 0x00000001;
+
+	/* the affine 2P are stored in the first slot of every table */
+	for (i = 0; i < count; i++)
+		ec_double_jacobian(&px[i * 8], &py[i * 8], one, &X[i * 8], &Y[i * 8], &Z[i * 8]);
+	ec_affine_batch(X, Y, Z, count);
+	for (i = 0; i < count; i++) {
+		copy(&X[i * 8], tables[i].x[0], arrayLength);
+		copy(&Y[i * 8], tables[i].y[0], arrayLength);
+	}
+
+	for (i = 0; i < count; i++) {
+		n = i * ECC_TABLE_SIZE * 8;
+		copy(&px[i * 8], &X[n], arrayLength);
+		copy(&py[i * 8], &Y[n], arrayLength);
+		copy(one, &Z[n], arrayLength);
+		for (j = 1; j < ECC_TABLE_SIZE; j++, n += 8)
+			ec_add_jacobian(&X[n], &Y[n], &Z[n], tables[i].x[0], tables[i].y[0], &X[n + 8], &Y[n + 8], &Z[n + 8]);
+	}
+	ec_affine_batch(X, Y, Z, count * ECC_TABLE_SIZE);
+	for (i = 0; i < count; i++) {
+		for (j = 0; j < ECC_TABLE_SIZE; j++) {
+			copy(&X[(i * ECC_TABLE_SIZE + j) * 8], tables[i].x[j], arrayLength);
+			copy(&Y[(i * ECC_TABLE_SIZE + j) * 8], tables[i].y[j], arrayLength);
 		}
 	}
-	copy(Qx, resultx,arrayLength);
-	copy(Qy, resulty,arrayLength);
 }
 
 /**
@@ -534,8 +1001,8 @@ void ecc_ec_mult(const uint32_t *px, const uint32_t *py, const uint32_t *secret,
 int ecc_ecdsa_sign(const uint32_t *d, const uint32_t *e, const uint32_t *k, uint32_t *r, uint32_t *s)
 {
 	uint32_t tmp1[16];
-	uint32_t tmp2[9];
-	uint32_t tmp3[9];
+	uint32_t kinv[8];
+	int ret;
 
 	if (isZero(k))
 		return -1;
@@ -550,6 +1017,69 @@ int ecc_ecdsa_sign(const uint32_t *d, const uint32_t *e, const uint32_t *k, uint
 	if (isZero(r))
 		return -1;
 
+	// 6. k^{-1}
+	fieldInvModO(k, kinv);
+
+	ret = ecc_ecdsa_sign_presigned(d, e, kinv, r, s);
+	setZero(kinv, 8);
+	return ret;
+}
+
+/**
+ * Calculate the part of count ecdsa signatures which does not depend on
+ * the message, the nonces could be computed in advance.
+ *
+ * input:
+ *  k: count nonces in [1, n - 1], 8 elements each
+ *
+ * output:
+ *  kinv: k^{-1} \pmod{n} for each nonce
+ *  r: r value of the signature for each nonce, 0 if the nonce must not
+ *     be used
+ */
+void ecc_ecdsa_presign_batch(const uint32_t *k, uint32_t *kinv, uint32_t *r, uint8_t count)
+{
+	uint32_t Y[ECC_BATCH_MAX * 8];
+	uint32_t Z[ECC_BATCH_MAX * 8];
+	int i;
+
+	while (count > ECC_BATCH_MAX) {
+		ecc_ecdsa_presign_batch(k, kinv, r, ECC_BATCH_MAX);
+		k += ECC_BATCH_MAX * 8;
+		kinv += ECC_BATCH_MAX * 8;
+		r += ECC_BATCH_MAX * 8;
+		count -= ECC_BATCH_MAX;
+	}
+	if (!count)
+		return;
+
+	// 4. (x_1, y_1) = k * G, converted to affine coordinates together
+	for (i = 0; i < count; i++)
+		ec_mult_jacobian(ecc_g_point_x, ecc_g_point_y, &k[i * 8], &r[i * 8], &Y[i * 8], &Z[i * 8]);
+	ec_affine_batch(r, Y, Z, count);
+
+	// 5. r = x_1 \pmod{n}
+	for (i = 0; i < count; i++)
+		fieldModO(&r[i * 8], &r[i * 8], 8);
+
+	// 6. k^{-1} for all nonces with one inversion
+	fieldInvBatch(k, kinv, count, ecc_order_m);
+}
+
+/**
+ * Complete an ecdsa signature with the values computed by
+ * ecc_ecdsa_presign_batch(), only two multiplications mod n are left.
+ *
+ * return:
+ *   0: everything is ok
+ *  -1: s is 0, try again with a different nonce.
+ */
+int ecc_ecdsa_sign_presigned(const uint32_t *d, const uint32_t *e, const uint32_t *kinv, const uint32_t *r, uint32_t *s)
+{
+	uint32_t tmp1[16];
+	uint32_t tmp2[9];
+	uint32_t tmp3[9];
+
 	// 6. Calculate s = k^{-1}(z + r d_A) \pmod{n}.
 	// 6. r * d
 	fieldMult(r, d, tmp1, arrayLength);
@@ -559,11 +1089,8 @@ int ecc_ecdsa_sign(const uint32_t *d, const uint32_t *e, const uint32_t *k, uint
 	tmp1[8] = add(e, tmp2, tmp1, 8);
 	fieldModO(tmp1, tmp3, 9);
 
-	// 6. k^{-1}
-	fieldInv(k, ecc_order_m, ecc_order_r, tmp2);
-
 	// 6. (k^{-1}) (z + (r d))
-	fieldMult(tmp2, tmp3, tmp1, arrayLength);
+	fieldMult(kinv, tmp3, tmp1, arrayLength);
 	fieldModO(tmp1, s, 16);
 
 	// 6. If s = 0, go back to step 3.
@@ -573,6 +1100,82 @@ int ecc_ecdsa_sign(const uint32_t *d, const uint32_t *e, const uint32_t *k, uint
 	return 0;
 }
 
+/*
+ * Calculates the width-5 non-adjacent form of k, every non-zero digit is
+ * odd and in [-15, 15] and followed by at least four zero digits. naf must
+ * have space for 257 digits, the number of digits is returned.
+ */
+static int ec_wnaf(const uint32_t *k, int8_t *naf){
+	uint32_t d[9];
+	uint32_t digit[9];
+	int i, n = 0, v;
+
+	copy(k, d, arrayLength);
+	d[8] = 0;
+	setZero(digit, 9);
+
+	while (!isZero(d) || d[8]) {
+		v = 0;
+		if (d[0] & 1) {
+			v = d[0] & 0x1F;
+			if (v & 0x10)
+				v -= 0x20;
+			digit[0] = v > 0 ? v : -v;
+			if (v > 0)
+				sub(d, digit, d, 9);
+			else
+				add(d, digit, d, 9);
+		}
+		naf[n++] = v;
+		for (i = 0; i < 8; i++)
+			d[i] = d[i] >> 1 | d[i + 1] << 31;
+		d[8] >>= 1;
+	}
+	return n;
+}
+
+/*
+ * Adds digit * P to (X, Y, Z), where digit is an odd wNAF digit and the
+ * table contains the odd multiples of P.
+ */
+static void ec_add_table(uint32_t *X, uint32_t *Y, uint32_t *Z, const ecc_point_table_t *table, int8_t digit){
+	uint32_t negy[8];
+
+	if (digit > 0) {
+		ec_add_jacobian(X, Y, Z, table->x[digit / 2], table->y[digit / 2], X, Y, Z);
+	} else {
+		sub(ecc_prime_m, table->y[-digit / 2], negy, arrayLength);
+		ec_add_jacobian(X, Y, Z, table->x[-digit / 2], negy, X, Y, Z);
+	}
+}
+
+/*
+ * Calculates u1 * G + u2 * Q in jacobian coordinates, with the table of
+ * odd multiples of Q. Both scalars are processed together in width-5 NAF
+ * (Straus's algorithm), so the doublings are shared and only about one
+ * addition per 6 bits is needed for each scalar.
+ */
+static void ec_mult_twin_jacobian(const uint32_t *u1, const uint32_t *u2, const ecc_point_table_t *q, uint32_t *X, uint32_t *Y, uint32_t *Z){
+	int8_t naf1[257];
+	int8_t naf2[257];
+	int len1, len2, i;
+
+	len1 = ec_wnaf(u1, naf1);
+	len2 = ec_wnaf(u2, naf2);
+
+	setZero(X, 8);
+	setZero(Y, 8);
+	setZero(Z, 8);
+
+	for (i = len1 > len2 ? len1 : len2; i--;) {
+		ec_double_jacobian(X, Y, Z, X, Y, Z);
+		if (i < len1 && naf1[i])
+			ec_add_table(X, Y, Z, &ecc_g_table, naf1[i]);
+		if (i < len2 && naf2[i])
+			ec_add_table(X, Y, Z, q, naf2[i]);
+	}
+}
+
 /**
  * Verifies a ecdsa signature.
  *
@@ -592,40 +1195,111 @@ int ecc_ecdsa_sign(const uint32_t *d, const uint32_t *e, const uint32_t *k, uint
  */
 int ecc_ecdsa_validate(const uint32_t *x, const uint32_t *y, const uint32_t *e, const uint32_t *r, const uint32_t *s)
 {
-	uint32_t w[8];
-	uint32_t tmp[16];
-	uint32_t u1[9];
-	uint32_t u2[9];
-	uint32_t tmp1_x[8];
-	uint32_t tmp1_y[8];
-	uint32_t tmp2_x[8];
-	uint32_t tmp2_y[8];
-	uint32_t tmp3_x[8];
-	uint32_t tmp3_y[8];
+	ecc_point_table_t table;
+	int result;
 
-	// 3. Calculate w = s^{-1} \pmod{n}
-	fieldInv(s, ecc_order_m, ecc_order_r, w);
+	ecc_ec_precompute(x, y, &table, 1);
+	return ecc_ecdsa_validate_batch(&table, e, r, s, &result, 1);
+}
 
-	// 4. Calculate u_1 = zw \pmod{n}
-	fieldMult(e, w, tmp, arrayLength);
-	fieldModO(tmp, u1, 16);
+/**
+ * Verifies count ecdsa signatures at once.
+ *
+ * The public keys are given as tables of their odd multiples, see
+ * ecc_ec_precompute(), so the tables of known keys can be reused. The
+ * inversions of all s values are done together with Montgomery's trick,
+ * one inversion for every ECC_BATCH_MAX signatures.
+ * u_1 * G + u_2 * Q_A is calculated with Straus's algorithm and compared
+ * to r in jacobian coordinates, so no further inversion is needed.
+ *
+ * Every signature is still checked on its own and gets its own result.
+ * A randomized linear combination of all equations would be faster, but
+ * needs the point R of each signature and a signature carries only its
+ * x coordinate r.
+ *
+ * input:
+ *  q: count tables of the public keys
+ *  e, r, s: arrays of count values as for ecc_ecdsa_validate()
+ *
+ * output:
+ *  result: count results, 0 if the signature is ok and -1 if not
+ *
+ * return:
+ *  0: all signatures are ok
+ *  -1: at least one signature is invalid, see result
+ */
+int ecc_ecdsa_validate_batch(const ecc_point_table_t *q, const uint32_t *e, const uint32_t *r, const uint32_t *s, int *result, uint8_t count)
+{
+	uint32_t w[ECC_BATCH_MAX * 8];
+	uint32_t u1[8];
+	uint32_t u2[8];
+	uint32_t X[8];
+	uint32_t Y[8];
+	uint32_t Z[8];
+	uint32_t tempA[8];
+	uint32_t tempB[8];
+	int i, ret = 0;
+
+	while (count > ECC_BATCH_MAX) {
+		if (ecc_ecdsa_validate_batch(q, e, r, s, result, ECC_BATCH_MAX))
+			ret = -1;
+		q += ECC_BATCH_MAX;
+		e += ECC_BATCH_MAX * 8;
+		r += ECC_BATCH_MAX * 8;
+		s += ECC_BATCH_MAX * 8;
+		result += ECC_BATCH_MAX;
+		count -= ECC_BATCH_MAX;
+	}
 
-	// 4. Calculate u_2 = rw \pmod{n}
-	fieldMult(r, w, tmp, arrayLength);
-	fieldModO(tmp, u2, 16);
+	for (i = 0; i < count; i++) {
+		// 1. Verify that r and s are integers in [1, n-1].
+		result[i] = isZero(&r[i * 8]) || isZero(&s[i * 8]) ||
+			isGreater(&r[i * 8], ecc_order_m, arrayLength) >= 0 ||
+			isGreater(&s[i * 8], ecc_order_m, arrayLength) >= 0 ? -1 : 0;
+		if (result[i])
+			setZero(&w[i * 8], 8);
+		else
+			copy(&s[i * 8], &w[i * 8], arrayLength);
+	}
 
-	// 5. Calculate the curve point (x_1, y_1) = u_1 * G + u_2 * Q_A.
-	// tmp1 = u_1 * G
-	ecc_ec_mult(ecc_g_point_x, ecc_g_point_y, u1, tmp1_x, tmp1_y);
+	// 3. Calculate w = s^{-1} \pmod{n}
+	fieldInvBatch(w, w, count, ecc_order_m);
 
-	// tmp2 = u_2 * Q_A
-	ecc_ec_mult(x, y, u2, tmp2_x, tmp2_y);
+	for (i = 0; i < count; i++) {
+		if (result[i]) {
+			ret = -1;
+			continue;
+		}
 
-	// tmp3 = tmp1 + tmp2
-	ec_add(tmp1_x, tmp1_y, tmp2_x, tmp2_y, tmp3_x, tmp3_y);
-	// TODO: this u_1 * G + u_2 * Q_A  could be optimiced with Straus's algorithm.
+		// 4. Calculate u_1 = zw \pmod{n}
+		fieldMultModO(&e[i * 8], &w[i * 8], u1);
+
+		// 4. Calculate u_2 = rw \pmod{n}
+		fieldMultModO(&r[i * 8], &w[i * 8], u2);
+
+		// 5. Calculate the curve point (x_1, y_1) = u_1 * G + u_2 * Q_A.
+		ec_mult_twin_jacobian(u1, u2, &q[i], X, Y, Z);
+
+		// 6. The signature is valid if r = x_1 \pmod{n}, with x_1 = X/Z^2
+		// this means X = r Z^2 or X = (r + n) Z^2 if r + n < p.
+		result[i] = -1;
+		if (!isZero(Z)) {
+			fieldSquareModP(Z, tempA);
+			fieldMultModP(&r[i * 8], tempA, tempB);
+			if (isSame(tempB, X, arrayLength)) {
+				result[i] = 0;
+			} else if (!add(&r[i * 8], ecc_order_m, tempB, arrayLength) &&
+				   isGreater(tempB, ecc_prime_m, arrayLength) < 0) {
+				fieldMultModP(tempB, tempA, tempB);
+				if (isSame(tempB, X, arrayLength))
+					result[i] = 0;
+			}
+		}
+		if (result[i])
+			ret = -1;
+	}
 
-	return isSame(tmp3_x, r, arrayLength) ? 0 : -1;
+	return ret;
 }
 
 int ecc_is_valid_key(const uint32_t * priv_key)
@@ -668,7 +1342,20 @@ void ecc_fieldModO(const uint32_t *A, uint32_t *result, uint8_t length)
 }
 void ecc_fieldInv(const uint32_t *A, const uint32_t *modulus, const uint32_t *reducer, uint32_t *B)
 {
-	fieldInv(A, modulus, reducer, B);
+	(void)reducer;
+	if (isSame(modulus, ecc_order_m, arrayLength)) {
+		fieldInvModO(A, B);
+	} else {
+		fieldInvModP(A, B);
+	}
+}
+void ecc_fieldSquare(const uint32_t *x, uint32_t *result, uint8_t length)
+{
+	fieldSquare(x, result, length);
+}
+void ecc_fieldInvBatch(const uint32_t *A, uint32_t *B, uint8_t count)
+{
+	fieldInvBatch(A, B, count, ecc_prime_m);
 }
 void ecc_copy(const uint32_t *from, uint32_t *to, uint8_t length)
 {
@@ -40,17 +40,40 @@
 #define keyLengthInBytes 32
 #define arrayLength 8
 
+/* number of odd multiples P, 3P, ..., 15P in a precomputed table */
+#define ECC_TABLE_SIZE 8
+
+/* largest group of values that share one inversion in the batch
+ * functions, this bounds their stack usage */
+#ifndef ECC_BATCH_MAX
+#define ECC_BATCH_MAX 16
+#endif
+
+typedef struct {
+	uint32_t x[ECC_TABLE_SIZE][8];
+	uint32_t y[ECC_TABLE_SIZE][8];
+} ecc_point_table_t;
+
 extern const uint32_t ecc_g_point_x[8];
 extern const uint32_t ecc_g_point_y[8];
 
 //ec Functions
 void ecc_ec_mult(const uint32_t *px, const uint32_t *py, const uint32_t *secret, uint32_t *resultx, uint32_t *resulty);
 
+void ecc_ec_mult_batch(const uint32_t *px, const uint32_t *py, const uint32_t *secret, uint32_t *resultx, uint32_t *resulty, uint8_t count);
+void ecc_ec_precompute(const uint32_t *px, const uint32_t *py, ecc_point_table_t *tables, uint8_t count);
+
 static inline void ecc_ecdh(const uint32_t *px, const uint32_t *py, const uint32_t *secret, uint32_t *resultx, uint32_t *resulty) {
 	ecc_ec_mult(px, py, secret, resultx, resulty);
 }
+static inline void ecc_ecdh_batch(const uint32_t *px, const uint32_t *py, const uint32_t *secret, uint32_t *resultx, uint32_t *resulty, uint8_t count) {
+	ecc_ec_mult_batch(px, py, secret, resultx, resulty, count);
+}
 int ecc_ecdsa_validate(const uint32_t *x, const uint32_t *y, const uint32_t *e, const uint32_t *r, const uint32_t *s);
+int ecc_ecdsa_validate_batch(const ecc_point_table_t *q, const uint32_t *e, const uint32_t *r, const uint32_t *s, int *result, uint8_t count);
 int ecc_ecdsa_sign(const uint32_t *d, const uint32_t *e, const uint32_t *k, uint32_t *r, uint32_t *s);
+void ecc_ecdsa_presign_batch(const uint32_t *k, uint32_t *kinv, uint32_t *r, uint8_t count);
+int ecc_ecdsa_sign_presigned(const uint32_t *d, const uint32_t *e, const uint32_t *kinv, const uint32_t *r, uint32_t *s);
 
 int ecc_is_valid_key(const uint32_t * priv_key);
 static inline void ecc_gen_pub_key(const uint32_t *priv_key, uint32_t *pub_x, uint32_t *pub_y)
@@ -74,6 +97,8 @@ int ecc_fieldMult(const uint32_t *x, const uint32_t *y, uint32_t *result, uint8_
 void ecc_fieldModP(uint32_t *A, const uint32_t *B);
 void ecc_fieldModO(const uint32_t *A, uint32_t *result, uint8_t length);
 void ecc_fieldInv(const uint32_t *A, const uint32_t *modulus, const uint32_t *reducer, uint32_t *B);
+void ecc_fieldSquare(const uint32_t *x, uint32_t *result, uint8_t length);
+void ecc_fieldInvBatch(const uint32_t *A, uint32_t *B, uint8_t count);
 
 //simple functions to work with the big numbers
 void ecc_copy(const uint32_t *from, uint32_t *to, uint8_t length);
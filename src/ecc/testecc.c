@@ -167,6 +167,34 @@ void eccdhTest(){
 
 }
 
+void multBatchTest(){
+	uint32_t px[3 * 8];
+	uint32_t py[3 * 8];
+	uint32_t secrets[3 * 8];
+	uint32_t resultx[3 * 8];
+	uint32_t resulty[3 * 8];
+	uint32_t tempx[8];
+	uint32_t tempy[8];
+	int i;
+
+	for (i = 0; i < 3; i++) {
+		ecc_copy(BasePointx, &px[i * 8], arrayLength);
+		ecc_copy(BasePointy, &py[i * 8], arrayLength);
+		ecc_setRandom(&secrets[i * 8]);
+	}
+	ecc_copy(Sx, &px[8], arrayLength);
+	ecc_copy(Sy, &py[8], arrayLength);
+	ecc_copy(secret, &secrets[8], arrayLength);
+	ecc_ec_mult_batch(px, py, secrets, resultx, resulty, 3);
+	assert(ecc_isSame(&resultx[8], resultMultx, arrayLength));
+	assert(ecc_isSame(&resulty[8], resultMulty, arrayLength));
+	for (i = 0; i < 3; i++) {
+		ecc_ec_mult(&px[i * 8], &py[i * 8], &secrets[i * 8], tempx, tempy);
+		assert(ecc_isSame(&resultx[i * 8], tempx, arrayLength));
+		assert(ecc_isSame(&resulty[i * 8], tempy, arrayLength));
+	}
+}
+
 void ecdsaTest() {
 	int ret __attribute__((unused));
 	uint32_t tempx[9];
@@ -194,6 +222,104 @@ void ecdsaTest() {
 	assert(!ret);
 }
 
+void precomputeTest(){
+	ecc_point_table_t table;
+	uint32_t multiple[8];
+	uint32_t tempx[8];
+	uint32_t tempy[8];
+	int i;
+
+	ecc_ec_precompute(Sx, Sy, &table, 1);
+	for (i = 0; i < ECC_TABLE_SIZE; i++) {
+		ecc_setZero(multiple, 8);
+		multiple[0] = 2 * i + 1;
+		ecc_ec_mult(Sx, Sy, multiple, tempx, tempy);
+		assert(ecc_isSame(table.x[i], tempx, arrayLength));
+		assert(ecc_isSame(table.y[i], tempy, arrayLength));
+	}
+}
+
+void ecdsaBatchTest() {
+	int ret __attribute__((unused));
+	int result[3];
+	uint32_t priv[8];
+	uint32_t rand[8];
+	uint32_t pub_x[3 * 8];
+	uint32_t pub_y[3 * 8];
+	uint32_t hash[3 * 8];
+	uint32_t r[3 * 9];
+	uint32_t s[3 * 9];
+	uint32_t sig_r[3 * 8];
+	uint32_t sig_s[3 * 8];
+	ecc_point_table_t tables[3];
+	int i;
+
+	for (i = 0; i < 3; i++) {
+		ecc_setRandom(priv);
+		ecc_setRandom(&hash[i * 8]);
+		ecc_ec_mult(BasePointx, BasePointy, priv, &pub_x[i * 8], &pub_y[i * 8]);
+		do {
+			ecc_setRandom(rand);
+		} while (ecc_ecdsa_sign(priv, &hash[i * 8], rand, &r[i * 9], &s[i * 9]));
+		ecc_copy(&r[i * 9], &sig_r[i * 8], arrayLength);
+		ecc_copy(&s[i * 9], &sig_s[i * 8], arrayLength);
+	}
+	ecc_ec_precompute(pub_x, pub_y, tables, 3);
+
+	ret = ecc_ecdsa_validate_batch(tables, hash, sig_r, sig_s, result, 3);
+	assert(!ret);
+	assert(!result[0] && !result[1] && !result[2]);
+
+	/* a wrong hash only invalidates its own signature */
+	hash[8] ^= 1;
+	ret = ecc_ecdsa_validate_batch(tables, hash, sig_r, sig_s, result, 3);
+	assert(ret == -1);
+	assert(!result[0] && result[1] == -1 && !result[2]);
+
+	/* s = 0 */
+	ecc_setZero(&sig_s[16], 8);
+	ret = ecc_ecdsa_validate_batch(tables, hash, sig_r, sig_s, result, 3);
+	assert(ret == -1);
+	assert(!result[0] && result[1] == -1 && result[2] == -1);
+}
+
+/* more signatures than share one inversion, see ECC_BATCH_MAX */
+void ecdsaLargeBatchTest() {
+	int ret __attribute__((unused));
+	int result[ECC_BATCH_MAX + 3];
+	uint32_t priv[8];
+	uint32_t rand[8];
+	uint32_t pub_x[(ECC_BATCH_MAX + 3) * 8];
+	uint32_t pub_y[(ECC_BATCH_MAX + 3) * 8];
+	uint32_t hash[(ECC_BATCH_MAX + 3) * 8];
+	uint32_t r[9];
+	uint32_t s[9];
+	uint32_t sig_r[(ECC_BATCH_MAX + 3) * 8];
+	uint32_t sig_s[(ECC_BATCH_MAX + 3) * 8];
+	ecc_point_table_t tables[ECC_BATCH_MAX + 3];
+	int i;
+
+	for (i = 0; i < ECC_BATCH_MAX + 3; i++) {
+		ecc_setRandom(priv);
+		ecc_setRandom(&hash[i * 8]);
+		ecc_ec_mult(BasePointx, BasePointy, priv, &pub_x[i * 8], &pub_y[i * 8]);
+		do {
+			ecc_setRandom(rand);
+		} while (ecc_ecdsa_sign(priv, &hash[i * 8], rand, r, s));
+		ecc_copy(r, &sig_r[i * 8], arrayLength);
+		ecc_copy(s, &sig_s[i * 8], arrayLength);
+	}
+	ecc_ec_precompute(pub_x, pub_y, tables, ECC_BATCH_MAX + 3);
+
+	/* one wrong hash in each group */
+	hash[1 * 8] ^= 1;
+	hash[(ECC_BATCH_MAX + 1) * 8] ^= 1;
+	ret = ecc_ecdsa_validate_batch(tables, hash, sig_r, sig_s, result, ECC_BATCH_MAX + 3);
+	assert(ret == -1);
+	for (i = 0; i < ECC_BATCH_MAX + 3; i++)
+		assert(result[i] == (i == 1 || i == ECC_BATCH_MAX + 1 ? -1 : 0));
+}
+
 #ifdef CONTIKI
 PROCESS(ecc_test, "ECC test");
 AUTOSTART_PROCESSES(&ecc_test);
@@ -206,7 +332,11 @@ PROCESS_THREAD(ecc_test, ev, d)
 	doubleTest();
 	multTest();
 	eccdhTest();
+	multBatchTest();
+	precomputeTest();
 	ecdsaTest();
+	ecdsaBatchTest();
+	ecdsaLargeBatchTest();
 	printf("%s\n", "All Tests successful.");
 
 	PROCESS_END();
@@ -219,7 +349,11 @@ int main(int argc, char const *argv[])
 	doubleTest();
 	multTest();
 	eccdhTest();
+	multBatchTest();
+	precomputeTest();
 	ecdsaTest();
+	ecdsaBatchTest();
+	ecdsaLargeBatchTest();
 	printf("%s\n", "All Tests successful.");
 	return 0;
 }
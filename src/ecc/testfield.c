@@ -94,6 +94,8 @@ uint32_t resultQuadMod[16] = {	0x00000004,0x00000000,0x00000000,0xFFFFFFFC,
 uint32_t resultFullMod[8] = { 	0x00000002,0x00000000,0xFFFFFFFF,0xFFFFFFFD,
 								0xFFFFFFFE,0xFFFFFFFF,0xFFFFFFFF,0x00000002};
 
+static const uint32_t order[8] = {0xFC632551, 0xF3B9CAC2, 0xA7179E84, 0xBCE6FAAD,
+					0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0xFFFFFFFF};
 static const uint32_t orderMinusOne[8] = {0xFC632550, 0xF3B9CAC2, 0xA7179E84, 0xBCE6FAAD,
 					0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0xFFFFFFFF};
 static const uint32_t orderResultDoubleMod[8] = {0xFC63254F, 0xF3B9CAC2, 0xA7179E84, 0xBCE6FAAD, 0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0xFFFFFFFF};
@@ -114,7 +116,7 @@ void fieldAddTest(){
 	ecc_fieldAdd(one, one, ecc_prime_r, temp);
 	assert(ecc_isSame(temp, two, arrayLength));
 	nullEverything();
-	ecc_add(full, one, temp, 32);
+	ecc_add(full, one, temp, arrayLength);
 	assert(ecc_isSame(null, temp, arrayLength));
 	nullEverything();
 	ecc_fieldAdd(full, one, ecc_prime_r, temp);
@@ -152,6 +154,19 @@ void fieldMultTest(){
 	assert(ecc_isSame(temp, one, arrayLength));
 }
 
+void fieldSquareTest(){
+	uint32_t square[16];
+	ecc_fieldSquare(two, temp2, arrayLength);
+	assert(ecc_isSame(temp2, four64, arrayLength * 2));
+	nullEverything();
+	ecc_fieldSquare(primeMinusOne, temp2, arrayLength);
+	assert(ecc_isSame(temp2, resultQuadMod, arrayLength * 2));
+	nullEverything();
+	ecc_fieldSquare(full, square, arrayLength);
+	ecc_fieldMult(full, full, temp2, arrayLength);
+	assert(ecc_isSame(temp2, square, arrayLength * 2));
+}
+
 void fieldModPTest(){
 	ecc_fieldMult(primeMinusOne, primeMinusOne, temp2, arrayLength);
 	ecc_fieldModP(temp, temp2);
@@ -230,6 +245,56 @@ void fieldInvTest(){
 	ecc_fieldMult(temp, primeMinusOne, temp2, arrayLength);
 	ecc_fieldModP(temp, temp2);
 	assert(ecc_isSame(one, temp, arrayLength));
+	nullEverything();
+	ecc_fieldInv(two, order, NULL, temp);
+	ecc_fieldMult(temp, two, temp2, arrayLength);
+	ecc_fieldModO(temp2, temp2, arrayLength * 2);
+	assert(ecc_isSame(one, temp2, arrayLength));
+	nullEverything();
+	ecc_fieldInv(orderMinusOne, order, NULL, temp);
+	assert(ecc_isSame(orderMinusOne, temp, arrayLength));
+}
+
+void fieldInvBatchTest(){
+	uint32_t values[4 * 8];
+	uint32_t inv[4 * 8];
+	int i;
+
+	ecc_copy(two, &values[0], arrayLength);
+	ecc_copy(null, &values[8], arrayLength);
+	ecc_copy(three, &values[16], arrayLength);
+	ecc_copy(primeMinusOne, &values[24], arrayLength);
+	ecc_fieldInvBatch(values, inv, 4);
+	for (i = 0; i < 4; i++) {
+		nullEverything();
+		if (i == 1) {
+			assert(ecc_isSame(null, &inv[i * 8], arrayLength));
+			continue;
+		}
+		ecc_fieldInv(&values[i * 8], ecc_prime_m, ecc_prime_r, temp);
+		assert(ecc_isSame(temp, &inv[i * 8], arrayLength));
+	}
+	/* in place */
+	ecc_fieldInvBatch(values, values, 4);
+	assert(ecc_isSame(inv, values, 4 * arrayLength));
+}
+
+/* more values than fit into one group of ECC_BATCH_MAX */
+void fieldInvBatchLargeTest(){
+	uint32_t values[(ECC_BATCH_MAX + 3) * 8];
+	uint32_t inv[(ECC_BATCH_MAX + 3) * 8];
+	int i;
+
+	for (i = 0; i < ECC_BATCH_MAX + 3; i++) {
+		ecc_copy(primeMinusOne, &values[i * 8], arrayLength);
+		values[i * 8] -= 3 * i;
+	}
+	ecc_fieldInvBatch(values, inv, ECC_BATCH_MAX + 3);
+	for (i = 0; i < ECC_BATCH_MAX + 3; i++) {
+		nullEverything();
+		ecc_fieldInv(&values[i * 8], ecc_prime_m, ecc_prime_r, temp);
+		assert(ecc_isSame(temp, &inv[i * 8], arrayLength));
+	}
 }
 
 // void randomStuff(){
@@ -252,12 +317,18 @@ PROCESS_THREAD(ecc_field_test, ev, d)
 	nullEverything();
 	fieldMultTest();
 	nullEverything();
+	fieldSquareTest();
+	nullEverything();
 	fieldModPTest();
 	nullEverything();
 	fieldModOTest();
 	nullEverything();
 	fieldInvTest();
 	nullEverything();
+	fieldInvBatchTest();
+	nullEverything();
+	fieldInvBatchLargeTest();
+	nullEverything();
 	//rShiftTest();
 	//isOneTest();
 	printf("%s\n", "All Tests succesfull!");
@@ -276,12 +347,18 @@ int main(int argc, char const *argv[])
 	nullEverything();
 	fieldMultTest();
 	nullEverything();
+	fieldSquareTest();
+	nullEverything();
 	fieldModPTest();
 	nullEverything();
 	fieldModOTest();
 	nullEverything();
 	fieldInvTest();
 	nullEverything();
+	fieldInvBatchTest();
+	nullEverything();
+	fieldInvBatchLargeTest();
+	nullEverything();
 	//rShiftTest();
 	//isOneTest();
 	printf("%s\n", "All Tests succesfull!");
@@ -0,0 +1,285 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2011, 2012, 2013, 2014, 2015 Olaf Bergmann (TZI) and others.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v. 1.0 which accompanies this distribution.
+ *
+ * The Eclipse Public License is available at http://www.eclipse.org/legal/epl-v10.html
+ * and the Eclipse Distribution License is available at
+ * http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ *******************************************************************************/
+
+/*
+ * AES-128-GCM as used by the GCM cipher suites of RFC 5288 (12 byte
+ * nonce, 16 byte tag). The portable GHASH multiplies by H with the
+ * 4-bit tables of Shoup's method: the multiples 0 * H to 15 * H are
+ * computed by dtls_gcm_init(), and the reduction of the four bits
+ * shifted out in each step is looked up in last4[]. On x86 the CTR
+ * encryption and GHASH of gcm_x86.c are used instead if the CPU has
+ * AES-NI and PCLMULQDQ.
+ */
+
+#include <string.h>
+
+#include "tinydtls.h"
+#include "gcm.h"
+
+static int gcm_impl = -1;
+
+int
+dtls_gcm_select(int impl) {
+  int best = DTLS_GCM_C;
+
+#ifdef GCM_X86
+  if (dtls_gcm_clmul_supported())
+    best = DTLS_GCM_CLMUL;
+#endif /* GCM_X86 */
+  if (impl > best || impl < DTLS_GCM_C)
+    impl = best;
+
+  gcm_impl = impl;
+  return impl;
+}
+
+int
+dtls_gcm_accelerated(void) {
+  if (gcm_impl < 0)
+    dtls_gcm_select(DTLS_GCM_BEST);
+  return gcm_impl != DTLS_GCM_C;
+}
+
+static inline uint64_t
+get_be64(const unsigned char *p) {
+  return ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48)
+    | ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32)
+    | ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16)
+    | ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+}
+
+static inline void
+put_be64(unsigned char *p, uint64_t v) {
+  int i;
+
+  for (i = 7; i >= 0; i--, v >>= 8)
+    p[i] = v & 0xff;
+}
+
+int
+dtls_gcm_init(dtls_gcm_ctx *ctx, const unsigned char *key, size_t keylen) {
+  unsigned char h[DTLS_GCM_BLOCKSIZE];
+  uint64_t vh, vl, t;
+  int i, j;
+
+  if (keylen != 16)
+    return -1;
+  if (gcm_impl < 0)
+    dtls_gcm_select(DTLS_GCM_BEST);
+
+#ifdef GCM_X86
+  ctx->clmul = gcm_impl == DTLS_GCM_CLMUL;
+  if (ctx->clmul) {
+    dtls_gcm_init_x86(ctx, key);
+    return 0;
+  }
+#endif /* GCM_X86 */
+
+  if (rijndael_set_key_enc_only(&ctx->aes, key, 8 * keylen) < 0)
+    return -1;
+
+  /* H = E(K, 0^128) */
+  memset(h, 0, sizeof(h));
+  rijndael_encrypt(&ctx->aes, h, h);
+  vh = get_be64(h);
+  vl = get_be64(h + 8);
+
+  /* 8 * H is H itself, as GCM numbers the bits from the left */
+  ctx->hh[0] = 0;
+  ctx->hl[0] = 0;
+  ctx->hh[8] = vh;
+  ctx->hl[8] = vl;
+  for (i = 4; i > 0; i >>= 1) {
+    t = (vl & 1) * 0xe1000000U;
+    vl = (vh << 63) | (vl >> 1);
+    vh = (vh >> 1) ^ (t << 32);
+    ctx->hh[i] = vh;
+    ctx->hl[i] = vl;
+  }
+  for (i = 2; i <= 8; i *= 2) {
+    for (j = 1; j < i; j++) {
+      ctx->hh[i + j] = ctx->hh[i] ^ ctx->hh[j];
+      ctx->hl[i + j] = ctx->hl[i] ^ ctx->hl[j];
+    }
+  }
+
+  memset(h, 0, sizeof(h));
+  return 0;
+}
+
+/* reduction of the four bits shifted out of the product in one step */
+static const uint16_t last4[16] = {
+  0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+  0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+/** y = y * H */
+static void
+gcm_mult(const dtls_gcm_ctx *ctx, unsigned char y[DTLS_GCM_BLOCKSIZE]) {
+  uint64_t zh, zl;
+  unsigned int lo, hi, rem;
+  int i;
+
+  lo = y[15] & 0x0f;
+  zh = ctx->hh[lo];
+  zl = ctx->hl[lo];
+
+  for (i = 15; i >= 0; i--) {
+    lo = y[i] & 0x0f;
+    hi = y[i] >> 4;
+
+    if (i != 15) {
+      rem = zl & 0x0f;
+      zl = (zh << 60) | (zl >> 4);
+      zh = (zh >> 4) ^ ((uint64_t)last4[rem] << 48) ^ ctx->hh[lo];
+      zl ^= ctx->hl[lo];
+    }
+
+    rem = zl & 0x0f;
+    zl = (zh << 60) | (zl >> 4);
+    zh = (zh >> 4) ^ ((uint64_t)last4[rem] << 48) ^ ctx->hh[hi];
+    zl ^= ctx->hl[hi];
+  }
+
+  put_be64(y, zh);
+  put_be64(y + 8, zl);
+}
+
+/**
+ * Adds @p len bytes of @p data to the GHASH state @p y. The last block
+ * is padded with zeros.
+ */
+static void
+gcm_ghash(const dtls_gcm_ctx *ctx, unsigned char y[DTLS_GCM_BLOCKSIZE],
+	  const unsigned char *data, size_t len) {
+  size_t i, n;
+
+#ifdef GCM_X86
+  if (ctx->clmul) {
+    dtls_gcm_ghash_x86(ctx, y, data, len);
+    return;
+  }
+#endif /* GCM_X86 */
+
+  while (len > 0) {
+    n = len < DTLS_GCM_BLOCKSIZE ? len : DTLS_GCM_BLOCKSIZE;
+    for (i = 0; i < n; i++)
+      y[i] ^= data[i];
+    gcm_mult(ctx, y);
+    data += n;
+    len -= n;
+  }
+}
+
+/** Encrypts @p msg in counter mode starting with the counter block @p ctr. */
+static void
+gcm_ctr(const dtls_gcm_ctx *ctx, const unsigned char ctr[DTLS_GCM_BLOCKSIZE],
+	unsigned char *msg, size_t len) {
+  unsigned char cb[DTLS_GCM_BLOCKSIZE], s[DTLS_GCM_BLOCKSIZE];
+  size_t i, n;
+
+#ifdef GCM_X86
+  if (ctx->clmul) {
+    dtls_gcm_ctr_x86(ctx, ctr, msg, len);
+    return;
+  }
+#endif /* GCM_X86 */
+
+  memcpy(cb, ctr, sizeof(cb));
+  while (len > 0) {
+    rijndael_encrypt((rijndael_ctx *)&ctx->aes, cb, s);
+    n = len < DTLS_GCM_BLOCKSIZE ? len : DTLS_GCM_BLOCKSIZE;
+    for (i = 0; i < n; i++)
+      msg[i] ^= s[i];
+    msg += n;
+    len -= n;
+
+    /* inc32: the last four bytes are a big-endian counter */
+    for (i = DTLS_GCM_BLOCKSIZE - 1; i >= 12 && ++cb[i] == 0; i--)
+      ;
+  }
+  memset(s, 0, sizeof(s));
+}
+
+/** Computes the tag of the ciphertext @p c, @p j0 is the first counter block. */
+static void
+gcm_tag(const dtls_gcm_ctx *ctx, const unsigned char j0[DTLS_GCM_BLOCKSIZE],
+	const unsigned char *c, size_t lc,
+	const unsigned char *aad, size_t la,
+	unsigned char tag[DTLS_GCM_TAG_SIZE]) {
+  unsigned char y[DTLS_GCM_BLOCKSIZE], lengths[DTLS_GCM_BLOCKSIZE];
+
+  memset(y, 0, sizeof(y));
+  gcm_ghash(ctx, y, aad, la);
+  gcm_ghash(ctx, y, c, lc);
+  put_be64(lengths, (uint64_t)la * 8);
+  put_be64(lengths + 8, (uint64_t)lc * 8);
+  gcm_ghash(ctx, y, lengths, sizeof(lengths));
+
+  /* T = E(K, J0) xor GHASH */
+  memcpy(tag, y, DTLS_GCM_TAG_SIZE);
+  gcm_ctr(ctx, j0, tag, DTLS_GCM_TAG_SIZE);
+}
+
+static inline void
+gcm_j0(const unsigned char nonce[DTLS_GCM_NONCE_SIZE],
+       unsigned char j0[DTLS_GCM_BLOCKSIZE]) {
+  memcpy(j0, nonce, DTLS_GCM_NONCE_SIZE);
+  j0[12] = 0;
+  j0[13] = 0;
+  j0[14] = 0;
+  j0[15] = 1;
+}
+
+long int
+dtls_gcm_encrypt_message(const dtls_gcm_ctx *ctx,
+			 const unsigned char nonce[DTLS_GCM_NONCE_SIZE],
+			 unsigned char *msg, size_t lm,
+			 const unsigned char *aad, size_t la) {
+  unsigned char j0[DTLS_GCM_BLOCKSIZE];
+
+  gcm_j0(nonce, j0);
+  j0[DTLS_GCM_BLOCKSIZE - 1] = 2;
+  gcm_ctr(ctx, j0, msg, lm);
+
+  j0[DTLS_GCM_BLOCKSIZE - 1] = 1;
+  gcm_tag(ctx, j0, msg, lm, aad, la, msg + lm);
+
+  return lm + DTLS_GCM_TAG_SIZE;
+}
+
+long int
+dtls_gcm_decrypt_message(const dtls_gcm_ctx *ctx,
+			 const unsigned char nonce[DTLS_GCM_NONCE_SIZE],
+			 unsigned char *msg, size_t lm,
+			 const unsigned char *aad, size_t la) {
+  unsigned char j0[DTLS_GCM_BLOCKSIZE], tag[DTLS_GCM_TAG_SIZE];
+  unsigned char diff = 0;
+  int i;
+
+  if (lm < DTLS_GCM_TAG_SIZE)
+    return -1;
+  lm -= DTLS_GCM_TAG_SIZE;
+
+  /* the ciphertext is authenticated before it is decrypted */
+  gcm_j0(nonce, j0);
+  gcm_tag(ctx, j0, msg, lm, aad, la, tag);
+  for (i = 0; i < DTLS_GCM_TAG_SIZE; i++)
+    diff |= tag[i] ^ msg[lm + i];
+  if (diff != 0)
+    return -1;
+
+  j0[DTLS_GCM_BLOCKSIZE - 1] = 2;
+  gcm_ctr(ctx, j0, msg, lm);
+  return lm;
+}
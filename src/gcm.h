@@ -0,0 +1,119 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2011, 2012, 2013, 2014, 2015 Olaf Bergmann (TZI) and others.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v. 1.0 which accompanies this distribution.
+ *
+ * The Eclipse Public License is available at http://www.eclipse.org/legal/epl-v10.html
+ * and the Eclipse Distribution License is available at
+ * http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ *******************************************************************************/
+
+#ifndef _DTLS_GCM_H_
+#define _DTLS_GCM_H_
+
+#include <stdint.h>
+
+#include "aes/rijndael.h"
+
+/* implementation of the Galois/Counter Mode, NIST SP 800-38D */
+
+#define DTLS_GCM_BLOCKSIZE  16	/**< size of AES and GHASH blocks */
+#define DTLS_GCM_TAG_SIZE   16	/**< size of the authentication tag */
+#define DTLS_GCM_NONCE_SIZE 12	/**< size of the nonce */
+
+/*
+ * With GCC or Clang on x86, AES-128-GCM uses AES-NI and PCLMULQDQ if the
+ * CPU has them, otherwise AES from rijndael.c and a GHASH with tables of
+ * the multiples of H. dtls_gcm_select() chooses the implementation used
+ * by the following calls of dtls_gcm_init(), e.g. to compare both.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GCM_X86
+#endif
+#define DTLS_GCM_C	0
+#define DTLS_GCM_CLMUL	1
+#define DTLS_GCM_BEST	2
+
+/** Key dependent state of AES-128-GCM. */
+typedef struct {
+  rijndael_ctx aes;		/**< AES-128 encryption context */
+  uint64_t hl[16];		/**< i * H, low 64 bits */
+  uint64_t hh[16];		/**< i * H, high 64 bits */
+#ifdef GCM_X86
+  int clmul;			/**< use AES-NI and PCLMULQDQ */
+  unsigned char rk[11 * DTLS_GCM_BLOCKSIZE]; /**< AES-NI round keys */
+  unsigned char hpow[4][DTLS_GCM_BLOCKSIZE]; /**< H^1 to H^4, byte-reversed */
+#endif /* GCM_X86 */
+} dtls_gcm_ctx;
+
+/**
+ * Selects the implementation for the contexts initialized from now on.
+ * Returns the selected implementation, which is @p impl or the best one
+ * available if that is not supported.
+ */
+int dtls_gcm_select(int impl);
+
+/**
+ * Returns 1 if GCM uses the AES and carry-less multiplication
+ * instructions of the CPU, 0 for the portable implementation, which is
+ * slower and has table lookups that depend on the key.
+ */
+int dtls_gcm_accelerated(void);
+
+#ifdef GCM_X86
+/* the backend of gcm_x86.c, used by gcm.c */
+int dtls_gcm_clmul_supported(void);
+void dtls_gcm_init_x86(dtls_gcm_ctx *ctx, const unsigned char *key);
+void dtls_gcm_ctr_x86(const dtls_gcm_ctx *ctx,
+		      const unsigned char ctr[DTLS_GCM_BLOCKSIZE],
+		      unsigned char *msg, size_t len);
+void dtls_gcm_ghash_x86(const dtls_gcm_ctx *ctx,
+			unsigned char y[DTLS_GCM_BLOCKSIZE],
+			const unsigned char *data, size_t len);
+#endif /* GCM_X86 */
+
+/**
+ * Initializes @p ctx with the AES-128 key @p key.
+ *
+ * \return 0 on success, -1 if @p keylen is not 16.
+ */
+int dtls_gcm_init(dtls_gcm_ctx *ctx, const unsigned char *key, size_t keylen);
+
+/**
+ * Authenticates and encrypts a message using AES in GCM mode.
+ *
+ * \param ctx   The context initialized with dtls_gcm_init().
+ * \param nonce The nonce of \c DTLS_GCM_NONCE_SIZE bytes.
+ * \param msg   The message to encrypt in place. The tag of \c
+ *              DTLS_GCM_TAG_SIZE bytes is appended, so the buffer must
+ *              be at least \p lm + \c DTLS_GCM_TAG_SIZE bytes large.
+ * \param lm    The length of \p msg.
+ * \param aad   The additional authentication data (can be \c NULL if
+ *              \p la is zero).
+ * \param la    The number of additional authentication octets.
+ * \return The length of the ciphertext including the tag.
+ */
+long int
+dtls_gcm_encrypt_message(const dtls_gcm_ctx *ctx,
+			 const unsigned char nonce[DTLS_GCM_NONCE_SIZE],
+			 unsigned char *msg, size_t lm,
+			 const unsigned char *aad, size_t la);
+
+/**
+ * Verifies and decrypts a message that has been encrypted with
+ * dtls_gcm_encrypt_message(). \p msg is ciphertext followed by the tag
+ * and is decrypted in place, after the tag has been verified.
+ *
+ * \return The length of the cleartext, or -1 if the tag is not valid.
+ *         \p msg is left unchanged in that case.
+ */
+long int
+dtls_gcm_decrypt_message(const dtls_gcm_ctx *ctx,
+			 const unsigned char nonce[DTLS_GCM_NONCE_SIZE],
+			 unsigned char *msg, size_t lm,
+			 const unsigned char *aad, size_t la);
+
+#endif /* _DTLS_GCM_H_ */
@@ -0,0 +1,287 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2011, 2012, 2013, 2014, 2015 Olaf Bergmann (TZI) and others.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v. 1.0 which accompanies this distribution.
+ *
+ * The Eclipse Public License is available at http://www.eclipse.org/legal/epl-v10.html
+ * and the Eclipse Distribution License is available at
+ * http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ *******************************************************************************/
+
+/*
+ * AES-128-GCM backend for x86 with AES-NI and PCLMULQDQ, selected at
+ * run time by dtls_gcm_select() (see gcm.h):
+ *
+ * - CTR: four counter blocks are encrypted at once, so that the
+ *   aesenc instructions of independent blocks overlap. The counter is
+ *   kept with its last word byte-swapped, so that it can be incremented
+ *   with _mm_add_epi32().
+ *
+ * - GHASH: the blocks and the powers of H are byte-reversed, which turns
+ *   the bit order of GCM into that of carry-less multiplication shifted
+ *   by one bit (Gueron and Kounavis, "Intel Carry-Less Multiplication
+ *   Instruction and its Usage for Computing the GCM Mode"). Four blocks
+ *   are multiplied by H^4, H^3, H^2 and H and the products are summed
+ *   before they are reduced once.
+ */
+
+#include <string.h>
+
+#include "gcm.h"
+
+#ifdef GCM_X86
+
+#include <immintrin.h>
+
+#define GCM_TARGET __attribute__((target("aes,pclmul,ssse3")))
+
+int dtls_gcm_clmul_supported(void) {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("aes") && __builtin_cpu_supports("pclmul")
+    && __builtin_cpu_supports("ssse3");
+}
+
+/*** AES-128: *********************************************************/
+
+GCM_TARGET
+static inline __m128i aes128_expand(__m128i key, __m128i gen) {
+  gen = _mm_shuffle_epi32(gen, 0xff);
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  return _mm_xor_si128(key, gen);
+}
+
+/* the round constant must be an immediate */
+#define AES128_ROUND_KEY(rk, i, rcon)					\
+  rk[i] = aes128_expand(rk[i - 1], _mm_aeskeygenassist_si128(rk[i - 1], rcon))
+
+GCM_TARGET
+static inline __m128i aes128_encrypt(const __m128i *rk, __m128i b) {
+  int i;
+
+  b = _mm_xor_si128(b, rk[0]);
+  for (i = 1; i < 10; i++)
+    b = _mm_aesenc_si128(b, rk[i]);
+  return _mm_aesenclast_si128(b, rk[10]);
+}
+
+/*** GHASH: ***********************************************************/
+
+/** The 256-bit carry-less product of @p a and @p b in @p lo and @p hi. */
+GCM_TARGET
+static inline void clmul(__m128i a, __m128i b, __m128i *lo, __m128i *hi) {
+  __m128i mid;
+
+  *lo = _mm_clmulepi64_si128(a, b, 0x00);
+  *hi = _mm_clmulepi64_si128(a, b, 0x11);
+  mid = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10),
+		      _mm_clmulepi64_si128(a, b, 0x01));
+  *lo = _mm_xor_si128(*lo, _mm_slli_si128(mid, 8));
+  *hi = _mm_xor_si128(*hi, _mm_srli_si128(mid, 8));
+}
+
+/**
+ * Reduces the product @p lo, @p hi of two byte-reversed field elements
+ * modulo x^128 + x^7 + x^2 + x + 1, after shifting it left by one bit
+ * to account for the reflected bit order.
+ */
+GCM_TARGET
+static inline __m128i reduce(__m128i lo, __m128i hi) {
+  __m128i t1, t2, t3;
+
+  /* shift the 256-bit product left by one bit */
+  t1 = _mm_srli_epi32(lo, 31);
+  t2 = _mm_srli_epi32(hi, 31);
+  lo = _mm_slli_epi32(lo, 1);
+  hi = _mm_slli_epi32(hi, 1);
+  t3 = _mm_srli_si128(t1, 12);
+  t2 = _mm_slli_si128(t2, 4);
+  t1 = _mm_slli_si128(t1, 4);
+  lo = _mm_or_si128(lo, t1);
+  hi = _mm_or_si128(hi, t2);
+  hi = _mm_or_si128(hi, t3);
+
+  /* first phase of the reduction */
+  t1 = _mm_slli_epi32(lo, 31);
+  t2 = _mm_slli_epi32(lo, 30);
+  t3 = _mm_slli_epi32(lo, 25);
+  t1 = _mm_xor_si128(t1, t2);
+  t1 = _mm_xor_si128(t1, t3);
+  t2 = _mm_srli_si128(t1, 4);
+  t1 = _mm_slli_si128(t1, 12);
+  lo = _mm_xor_si128(lo, t1);
+
+  /* second phase */
+  t1 = _mm_srli_epi32(lo, 1);
+  t3 = _mm_srli_epi32(lo, 2);
+  t1 = _mm_xor_si128(t1, t3);
+  t3 = _mm_srli_epi32(lo, 7);
+  t1 = _mm_xor_si128(t1, t3);
+  t1 = _mm_xor_si128(t1, t2);
+  lo = _mm_xor_si128(lo, t1);
+  return _mm_xor_si128(hi, lo);
+}
+
+GCM_TARGET
+static inline __m128i gfmul(__m128i a, __m128i b) {
+  __m128i lo, hi;
+
+  clmul(a, b, &lo, &hi);
+  return reduce(lo, hi);
+}
+
+GCM_TARGET
+static inline __m128i bswap128(__m128i x) {
+  return _mm_shuffle_epi8(x, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9,
+					  10, 11, 12, 13, 14, 15));
+}
+
+/*** Interface of gcm.c: **********************************************/
+
+GCM_TARGET
+void dtls_gcm_init_x86(dtls_gcm_ctx *ctx, const unsigned char *key) {
+  __m128i rk[11], h, hp;
+  int i;
+
+  rk[0] = _mm_loadu_si128((const __m128i *)key);
+  AES128_ROUND_KEY(rk, 1, 0x01);
+  AES128_ROUND_KEY(rk, 2, 0x02);
+  AES128_ROUND_KEY(rk, 3, 0x04);
+  AES128_ROUND_KEY(rk, 4, 0x08);
+  AES128_ROUND_KEY(rk, 5, 0x10);
+  AES128_ROUND_KEY(rk, 6, 0x20);
+  AES128_ROUND_KEY(rk, 7, 0x40);
+  AES128_ROUND_KEY(rk, 8, 0x80);
+  AES128_ROUND_KEY(rk, 9, 0x1b);
+  AES128_ROUND_KEY(rk, 10, 0x36);
+  for (i = 0; i < 11; i++)
+    _mm_storeu_si128((__m128i *)(ctx->rk + 16 * i), rk[i]);
+
+  h = bswap128(aes128_encrypt(rk, _mm_setzero_si128()));
+  hp = h;
+  for (i = 0; i < 4; i++) {
+    _mm_storeu_si128((__m128i *)ctx->hpow[i], hp);
+    hp = gfmul(hp, h);
+  }
+}
+
+GCM_TARGET
+void dtls_gcm_ctr_x86(const dtls_gcm_ctx *ctx,
+		      const unsigned char ctr[DTLS_GCM_BLOCKSIZE],
+		      unsigned char *msg, size_t len) {
+  /* swaps the bytes of the last word, the big-endian counter */
+  const __m128i swap = _mm_set_epi8(12, 13, 14, 15, 11, 10, 9, 8,
+				    7, 6, 5, 4, 3, 2, 1, 0);
+  const __m128i one = _mm_set_epi32(1, 0, 0, 0);
+  __m128i rk[11], cb, b0, b1, b2, b3;
+  unsigned char last[DTLS_GCM_BLOCKSIZE];
+  size_t i;
+  int r;
+
+  for (r = 0; r < 11; r++)
+    rk[r] = _mm_loadu_si128((const __m128i *)(ctx->rk + 16 * r));
+  cb = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)ctr), swap);
+
+  for (; len >= 4 * DTLS_GCM_BLOCKSIZE; len -= 4 * DTLS_GCM_BLOCKSIZE) {
+    b0 = _mm_xor_si128(_mm_shuffle_epi8(cb, swap), rk[0]);
+    cb = _mm_add_epi32(cb, one);
+    b1 = _mm_xor_si128(_mm_shuffle_epi8(cb, swap), rk[0]);
+    cb = _mm_add_epi32(cb, one);
+    b2 = _mm_xor_si128(_mm_shuffle_epi8(cb, swap), rk[0]);
+    cb = _mm_add_epi32(cb, one);
+    b3 = _mm_xor_si128(_mm_shuffle_epi8(cb, swap), rk[0]);
+    cb = _mm_add_epi32(cb, one);
+    for (r = 1; r < 10; r++) {
+      b0 = _mm_aesenc_si128(b0, rk[r]);
+      b1 = _mm_aesenc_si128(b1, rk[r]);
+      b2 = _mm_aesenc_si128(b2, rk[r]);
+      b3 = _mm_aesenc_si128(b3, rk[r]);
+    }
+    b0 = _mm_aesenclast_si128(b0, rk[10]);
+    b1 = _mm_aesenclast_si128(b1, rk[10]);
+    b2 = _mm_aesenclast_si128(b2, rk[10]);
+    b3 = _mm_aesenclast_si128(b3, rk[10]);
+
+    b0 = _mm_xor_si128(b0, _mm_loadu_si128((const __m128i *)msg));
+    b1 = _mm_xor_si128(b1, _mm_loadu_si128((const __m128i *)(msg + 16)));
+    b2 = _mm_xor_si128(b2, _mm_loadu_si128((const __m128i *)(msg + 32)));
+    b3 = _mm_xor_si128(b3, _mm_loadu_si128((const __m128i *)(msg + 48)));
+    _mm_storeu_si128((__m128i *)msg, b0);
+    _mm_storeu_si128((__m128i *)(msg + 16), b1);
+    _mm_storeu_si128((__m128i *)(msg + 32), b2);
+    _mm_storeu_si128((__m128i *)(msg + 48), b3);
+    msg += 4 * DTLS_GCM_BLOCKSIZE;
+  }
+
+  for (; len >= DTLS_GCM_BLOCKSIZE; len -= DTLS_GCM_BLOCKSIZE) {
+    b0 = aes128_encrypt(rk, _mm_shuffle_epi8(cb, swap));
+    cb = _mm_add_epi32(cb, one);
+    b0 = _mm_xor_si128(b0, _mm_loadu_si128((const __m128i *)msg));
+    _mm_storeu_si128((__m128i *)msg, b0);
+    msg += DTLS_GCM_BLOCKSIZE;
+  }
+
+  if (len > 0) {
+    b0 = aes128_encrypt(rk, _mm_shuffle_epi8(cb, swap));
+    _mm_storeu_si128((__m128i *)last, b0);
+    for (i = 0; i < len; i++)
+      msg[i] ^= last[i];
+    memset(last, 0, sizeof(last));
+  }
+}
+
+GCM_TARGET
+void dtls_gcm_ghash_x86(const dtls_gcm_ctx *ctx,
+			unsigned char y[DTLS_GCM_BLOCKSIZE],
+			const unsigned char *data, size_t len) {
+  __m128i h1, h2, h3, h4, x, lo, hi, l, h;
+  unsigned char last[DTLS_GCM_BLOCKSIZE];
+
+  h1 = _mm_loadu_si128((const __m128i *)ctx->hpow[0]);
+  h2 = _mm_loadu_si128((const __m128i *)ctx->hpow[1]);
+  h3 = _mm_loadu_si128((const __m128i *)ctx->hpow[2]);
+  h4 = _mm_loadu_si128((const __m128i *)ctx->hpow[3]);
+  x = bswap128(_mm_loadu_si128((const __m128i *)y));
+
+  /* ((((x + d0) H + d1) H + d2) H + d3) H
+   *   = (x + d0) H^4 + d1 H^3 + d2 H^2 + d3 H */
+  for (; len >= 4 * DTLS_GCM_BLOCKSIZE; len -= 4 * DTLS_GCM_BLOCKSIZE) {
+    x = _mm_xor_si128(x, bswap128(_mm_loadu_si128((const __m128i *)data)));
+    clmul(x, h4, &lo, &hi);
+    x = bswap128(_mm_loadu_si128((const __m128i *)(data + 16)));
+    clmul(x, h3, &l, &h);
+    lo = _mm_xor_si128(lo, l);
+    hi = _mm_xor_si128(hi, h);
+    x = bswap128(_mm_loadu_si128((const __m128i *)(data + 32)));
+    clmul(x, h2, &l, &h);
+    lo = _mm_xor_si128(lo, l);
+    hi = _mm_xor_si128(hi, h);
+    x = bswap128(_mm_loadu_si128((const __m128i *)(data + 48)));
+    clmul(x, h1, &l, &h);
+    lo = _mm_xor_si128(lo, l);
+    hi = _mm_xor_si128(hi, h);
+    x = reduce(lo, hi);
+    data += 4 * DTLS_GCM_BLOCKSIZE;
+  }
+
+  for (; len >= DTLS_GCM_BLOCKSIZE; len -= DTLS_GCM_BLOCKSIZE) {
+    x = _mm_xor_si128(x, bswap128(_mm_loadu_si128((const __m128i *)data)));
+    x = gfmul(x, h1);
+    data += DTLS_GCM_BLOCKSIZE;
+  }
+
+  if (len > 0) {
+    memset(last, 0, sizeof(last));
+    memcpy(last, data, len);
+    x = _mm_xor_si128(x, bswap128(_mm_loadu_si128((const __m128i *)last)));
+    x = gfmul(x, h1);
+  }
+
+  _mm_storeu_si128((__m128i *)y, bswap128(x));
+}
+
+#endif /* GCM_X86 */
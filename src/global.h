@@ -19,7 +19,11 @@
 #define _DTLS_GLOBAL_H_
 
 #include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif /* __SSE2__ */
 
 #include "tinydtls.h"
 
@@ -65,8 +69,12 @@ typedef unsigned char uint48[6];
 /** Known cipher suites.*/
 typedef enum { 
   TLS_NULL_WITH_NULL_NULL = 0x0000,   /**< NULL cipher  */
+  TLS_PSK_WITH_AES_128_GCM_SHA256 = 0x00A8, /**< see RFC 5487 */
+  TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256 = 0xC02B, /**< see RFC 5289 */
   TLS_PSK_WITH_AES_128_CCM_8 = 0xC0A8, /**< see RFC 6655 */
-  TLS_ECDHE_ECDSA_WITH_AES_128_CCM_8 = 0xC0AE /**< see RFC 7251 */
+  TLS_ECDHE_ECDSA_WITH_AES_128_CCM_8 = 0xC0AE, /**< see RFC 7251 */
+  TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256 = 0xCCA9, /**< see RFC 7905 */
+  TLS_PSK_WITH_CHACHA20_POLY1305_SHA256 = 0xCCAB /**< see RFC 7905 */
 } dtls_cipher_t;
 
 /** Known compression suites.*/
@@ -84,6 +92,8 @@ typedef enum {
 #define TLS_CERT_TYPE_RAW_PUBLIC_KEY	2 /* see RFC 7250 */
 
 #define TLS_EXT_ELLIPTIC_CURVES_SECP256R1	23 /* see RFC 4492 */
+#define TLS_EXT_ELLIPTIC_CURVES_X25519		29 /* see RFC 8422 */
+#define TLS_EXT_ELLIPTIC_CURVES_SECP256R1_NTRU	0xFE01 /* ecdhe_private_use */
 
 #define TLS_EXT_EC_POINT_FORMATS_UNCOMPRESSED	0 /* see RFC 4492 */
 
@@ -93,12 +103,35 @@ typedef enum {
 
 #define TLS_EXT_SIG_HASH_ALGO_SHA256		4 /* see RFC 5246 */
 #define TLS_EXT_SIG_HASH_ALGO_ECDSA		3 /* see RFC 5246 */
+#define TLS_EXT_SIG_HASH_ALGO_INTRINSIC		8 /* see RFC 8422 */
+#define TLS_EXT_SIG_HASH_ALGO_ED25519		7 /* see RFC 8422 */
+
+/*
+ * memxor() and equals() work on 16 bytes at a time with SSE2 and on
+ * machine words otherwise, the remaining bytes are done one by one.
+ * The buffers need not be aligned: the words are accessed with
+ * memcpy(), which the compiler turns into single loads and stores.
+ */
 
 /** 
- * XORs \p n bytes byte-by-byte starting at \p y to the memory area
- * starting at \p x. */
+ * XORs \p n bytes starting at \p y to the memory area starting at
+ * \p x. */
 static inline void
 memxor(unsigned char *x, const unsigned char *y, size_t n) {
+  size_t wx, wy;
+
+#ifdef __SSE2__
+  for (; n >= 16; n -= 16, x += 16, y += 16)
+    _mm_storeu_si128((__m128i *)x,
+		     _mm_xor_si128(_mm_loadu_si128((const __m128i *)x),
+				   _mm_loadu_si128((const __m128i *)y)));
+#endif /* __SSE2__ */
+  for (; n >= sizeof(wx); n -= sizeof(wx), x += sizeof(wx), y += sizeof(wx)) {
+    memcpy(&wx, x, sizeof(wx));
+    memcpy(&wy, y, sizeof(wy));
+    wx ^= wy;
+    memcpy(x, &wx, sizeof(wx));
+  }
   while(n--) {
     *x ^= *y;
     x++; y++;
@@ -116,12 +149,27 @@ memxor(unsigned char *x, const unsigned char *y, size_t n) {
  * \return \c 1 if \p a and \p b are equal, \c 0 otherwise.
  */
 static inline int
-equals(unsigned char *a, unsigned char *b, size_t len) {
-  int result = 1;
+equals(const unsigned char *a, const unsigned char *b, size_t len) {
+  size_t wa, wb, diff = 0;
+
+#ifdef __SSE2__
+  __m128i d = _mm_setzero_si128();
+
+  for (; len >= 16; len -= 16, a += 16, b += 16)
+    d = _mm_or_si128(d, _mm_xor_si128(_mm_loadu_si128((const __m128i *)a),
+				      _mm_loadu_si128((const __m128i *)b)));
+  /* one bit for each byte of d that is not zero */
+  diff = _mm_movemask_epi8(_mm_cmpeq_epi8(d, _mm_setzero_si128())) ^ 0xffff;
+#endif /* __SSE2__ */
+  for (; len >= sizeof(wa); len -= sizeof(wa), a += sizeof(wa), b += sizeof(wa)) {
+    memcpy(&wa, a, sizeof(wa));
+    memcpy(&wb, b, sizeof(wb));
+    diff |= wa ^ wb;
+  }
   while (len--) {
-    result &= (*a++ == *b++);
+    diff |= *a++ ^ *b++;
   }
-  return result;
+  return diff == 0;
 }
 
 #ifdef HAVE_FLS
@@ -86,7 +86,7 @@ dtls_hmac_new(const unsigned char *key, size_t klen) {
 
 void
 dtls_hmac_init(dtls_hmac_context_t *ctx, const unsigned char *key, size_t klen) {
-  int i;
+  unsigned char pad[DTLS_HMAC_BLOCKSIZE];
 
   assert(ctx);
 
@@ -100,15 +100,15 @@ dtls_hmac_init(dtls_hmac_context_t *ctx, const unsigned char *key, size_t klen)
     memcpy(ctx->pad, key, klen);
 
   /* create ipad: */
-  for (i=0; i < DTLS_HMAC_BLOCKSIZE; ++i)
-    ctx->pad[i] ^= 0x36;
+  memset(pad, 0x36, DTLS_HMAC_BLOCKSIZE);
+  memxor(ctx->pad, pad, DTLS_HMAC_BLOCKSIZE);
 
   dtls_hash_init(&ctx->data);
   dtls_hmac_update(ctx, ctx->pad, DTLS_HMAC_BLOCKSIZE);
 
   /* create opad by xor-ing pad[i] with 0x36 ^ 0x5C: */
-  for (i=0; i < DTLS_HMAC_BLOCKSIZE; ++i)
-    ctx->pad[i] ^= 0x6A;
+  memset(pad, 0x6A, DTLS_HMAC_BLOCKSIZE);
+  memxor(ctx->pad, pad, DTLS_HMAC_BLOCKSIZE);
 }
 
 void
@@ -136,6 +136,64 @@ dtls_hmac_finalize(dtls_hmac_context_t *ctx, unsigned char *result) {
   return len;
 }
 
+void
+dtls_hmac_key_init(dtls_hmac_key_t *hkey,
+		   const unsigned char *key, size_t klen) {
+  dtls_hmac_context_t ctx;
+
+  /* ctx.data holds the hashed ipad, ctx.pad the opad */
+  dtls_hmac_init(&ctx, key, klen);
+  hkey->inner = ctx.data;
+  dtls_hash_init(&hkey->outer);
+  dtls_hash_update(&hkey->outer, ctx.pad, DTLS_HMAC_BLOCKSIZE);
+  memset(&ctx, 0, sizeof(ctx));
+}
+
+void
+dtls_hmac_key_finalize(const dtls_hmac_key_t *hkey, dtls_hash_ctx *ctx,
+		       unsigned char *result) {
+  unsigned char buf[DTLS_HMAC_DIGEST_SIZE];
+  dtls_hash_ctx outer = hkey->outer;
+
+  dtls_hash_finalize(buf, ctx);
+  dtls_hash_update(&outer, buf, DTLS_HMAC_DIGEST_SIZE);
+  dtls_hash_finalize(result, &outer);
+}
+
+#ifdef WITH_SHA256
+void
+dtls_hmac_mb(const unsigned char *key, size_t klen, int n,
+	     const unsigned char *const msg[], const size_t len[],
+	     unsigned char *const mac[]) {
+  dtls_hmac_context_t ctx;
+  dtls_sha256_ctx opad;
+  unsigned char inner[DTLS_SHA256_MB_MAX][DTLS_HMAC_DIGEST_SIZE];
+  const unsigned char *imsg[DTLS_SHA256_MB_MAX];
+  unsigned char *idig[DTLS_SHA256_MB_MAX];
+  size_t ilen[DTLS_SHA256_MB_MAX];
+  int i;
+
+  assert(n <= DTLS_SHA256_MB_MAX);
+
+  /* ctx.data holds the hashed ipad, ctx.pad the opad */
+  dtls_hmac_init(&ctx, key, klen);
+  dtls_sha256_init(&opad);
+  dtls_sha256_update(&opad, ctx.pad, DTLS_HMAC_BLOCKSIZE);
+
+  for (i = 0; i < n; i++) {
+    imsg[i] = inner[i];
+    idig[i] = inner[i];
+    ilen[i] = DTLS_HMAC_DIGEST_SIZE;
+  }
+  dtls_sha256_mb(&ctx.data, n, msg, len, idig);
+  dtls_sha256_mb(&opad, n, imsg, ilen, mac);
+
+  memset(&ctx, 0, sizeof(ctx));
+  memset(&opad, 0, sizeof(opad));
+  memset(inner, 0, sizeof(inner));
+}
+#endif /* WITH_SHA256 */
+
 #ifdef HMAC_TEST
 #include <stdio.h>
 
@@ -137,6 +137,69 @@ void dtls_hmac_update(dtls_hmac_context_t *ctx,
  */
 int dtls_hmac_finalize(dtls_hmac_context_t *ctx, unsigned char *result);
 
+/**
+ * An HMAC key prepared for any number of MACs: the hash states after
+ * the ipad and after the opad block. Unlike dtls_hmac_context_t, it is
+ * not changed when a MAC is computed, so the pads are hashed only once
+ * per key.
+ */
+typedef struct {
+  dtls_hash_ctx inner;		/**< hash state after the ipad */
+  dtls_hash_ctx outer;		/**< hash state after the opad */
+} dtls_hmac_key_t;
+
+/**
+ * Prepares @p hkey for MACs with the secret @p key.
+ *
+ * @param hkey   The key state to initialize.
+ * @param key    The secret key.
+ * @param klen   The length of @p key.
+ */
+void dtls_hmac_key_init(dtls_hmac_key_t *hkey,
+			const unsigned char *key, size_t klen);
+
+/**
+ * Starts a MAC with @p hkey. The message is added to @p ctx with
+ * dtls_hash_update() and the MAC is completed with
+ * dtls_hmac_key_finalize().
+ */
+static inline void
+dtls_hmac_key_start(const dtls_hmac_key_t *hkey, dtls_hash_ctx *ctx) {
+  *ctx = hkey->inner;
+}
+
+/**
+ * Completes the MAC started with dtls_hmac_key_start() and writes
+ * DTLS_HMAC_DIGEST_SIZE bytes to @p result. @p result may be the
+ * message that has been added to @p ctx.
+ *
+ * @param hkey   The key state the MAC was started with.
+ * @param ctx    The hash of the message.
+ * @param result Output buffer of at least DTLS_HMAC_DIGEST_SIZE bytes.
+ */
+void dtls_hmac_key_finalize(const dtls_hmac_key_t *hkey, dtls_hash_ctx *ctx,
+			    unsigned char *result);
+
+#ifdef WITH_SHA256
+/**
+ * Computes the HMAC-SHA-256 of @p n independent messages under the
+ * same key with dtls_sha256_mb(), i.e. up to DTLS_SHA256_MB_MAX
+ * messages are hashed at once. The ipad and opad blocks are hashed
+ * only once for all messages.
+ *
+ * @param key    The secret key.
+ * @param klen   The length of @p key.
+ * @param n      The number of messages, at most DTLS_SHA256_MB_MAX.
+ * @param msg    The messages.
+ * @param len    The lengths of the messages.
+ * @param mac    Output buffers of DTLS_HMAC_DIGEST_SIZE bytes each
+ *               where the MAC of @p msg[i] is written to @p mac[i].
+ */
+void dtls_hmac_mb(const unsigned char *key, size_t klen, int n,
+		  const unsigned char *const msg[], const size_t len[],
+		  unsigned char *const mac[]);
+#endif /* WITH_SHA256 */
+
 /**@}*/
 
 #endif /* _DTLS_HMAC_H_ */
@@ -25,12 +25,50 @@
 
 #include "typedefs.h"
 
-// prototypes of Assembler functions
+// prototypes of Assembler functions; on platforms without Assembler code
+// the portable C99 functions of ring_arith.c are used instead
 
+#if defined(__AVR__) || defined(__MSP430__)
 extern void ring_mul_cfadd(UINT16 *r, const UINT16 *a, UINT16 *b, int alen, 
                            int blen);
 extern void ring_mul_cfsub(UINT16 *r, const UINT16 *a, UINT16 *b, int alen,
                            int blen);
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+// on x86 the SSE2 or AVX2 functions of ring_arith_x86.c are selected at run
+// time according to the capabilities of the CPU, see ring_mul_select()
+#define RING_MUL_X86
+#define RING_MUL_C99  0
+#define RING_MUL_SSE2 1
+#define RING_MUL_AVX2 2
+#define RING_MUL_BEST 3
+void ring_mul_cfadd(UINT16 *r, const UINT16 *a, UINT16 *b, int alen, 
+                    int blen);
+void ring_mul_cfsub(UINT16 *r, const UINT16 *a, UINT16 *b, int alen,
+                    int blen);
+void ring_mul_dense(UINT16 *r, const UINT16 *a, const UINT16 *b, int N,
+                    UINT16 *tmp);
+void ring_mul_cfadd_ct(UINT16 *r, const UINT16 *a, const UINT16 *b, int alen,
+                       int blen, UINT16 *tmp);
+void ring_mul_cfsub_ct(UINT16 *r, const UINT16 *a, const UINT16 *b, int alen,
+                       int blen, UINT16 *tmp);
+int ring_mul_select(int impl);
+#else
+#define ring_mul_cfadd ring_mul_cfadd_c99
+#define ring_mul_cfsub ring_mul_cfsub_c99
+#endif
+
+// the dense multiplication and the constant-time kernels are only available
+// in C99 and for x86
+#ifndef RING_MUL_X86
+#define ring_mul_dense ring_mul_dense_c99
+#define ring_mul_cfadd_ct ring_mul_cfadd_ct_c99
+#define ring_mul_cfsub_ct ring_mul_cfsub_ct_c99
+#endif
+
+#if defined(__AVR__)
 extern UINT16 int16_mod3(UINT16 a);
+#else
+#define int16_mod3 int16_mod3_c99
+#endif
 
 #endif
@@ -0,0 +1,398 @@
+///////////////////////////////////////////////////////////////////////////////
+// kernel_test.c: Test vectors and cycle counts of the NTRU/SHA256 kernels.  //
+// Written for tinydtls on top of the QUASIKOM ring arithmetic (project      //
+// repository <https://www.github.com/grojoh/quasikom/>), not part of a      //
+// QUASIKOM release.                                                         //
+// License: GPLv3 (see LICENSE file), like the QUASIKOM code it builds on.   //
+// Copyright (C) 2026 the tinydtls contributors.                             //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "asmfncts.h"
+#include "ring_arith.h"
+#include "testvec.h"
+
+// the rolled and the unrolled C version of the SHA256 compression function
+// are static, so sha256.c is included instead of linked
+#define SHA256_ALL_KERNELS
+#include "sha256.c"
+
+// the same holds for the MGF1 stream of the key encapsulation
+#include "ntru_kem.c"
+
+#ifdef RING_MUL_X86
+#include <x86intrin.h>
+#define TIME_UNIT "cycles"
+#else
+#define TIME_UNIT "ns"
+#endif
+
+
+static const UINT16 a401[408] = { A401COEFFS };
+static const UINT16 b401[44] = { B401COEFFS };
+static const UINT16 c401[401] = { C401COEFFS };
+
+// operands of the measured kernels; a is a401 extended to N+7 coefficients
+// (i.e. a[401..407] = a[0..6]) and b401 has d1 = d2 = 8 and d3 = 6
+
+static const SPARSE_POLY b = { b401, 16, 16, 12 };
+static UINT16 a[408], r[408], d[401];
+static UINT16 ws[RING_MUL_SPARSE_WS_SIZE(408, 8)/sizeof(UINT16)];
+static UINT16 ws_ct[RING_MUL_SPARSE_CT_WS_SIZE(408)/sizeof(UINT16)];
+static UINT16 tmp_dense[RING_MUL_DENSE_TMP_LEN(401)];
+static uint32_t hval[8];
+static uint8_t block[64];
+static volatile UINT16 sink;
+
+
+// Time stamp in clock cycles on x86 (the time-stamp counter runs at the
+// nominal frequency of the CPU) and in nanoseconds on other platforms.
+
+static double timestamp(void)
+{
+#ifdef RING_MUL_X86
+  return (double) __rdtsc();
+#else
+  return 1e9*clock()/CLOCKS_PER_SEC;
+#endif
+}
+
+
+// Average time of iter calls of fn, whereby the minimum of 16 runs is taken
+// to filter out interrupts and the first run with cold caches.
+
+static double per_call(void (*fn)(void), int iter)
+{
+  double t, best = 0;
+  int i, j;
+
+  for (j = 0; j < 16; j ++)
+  {
+    t = timestamp();
+    for (i = 0; i < iter; i ++) fn();
+    t = (timestamp() - t)/iter;
+    if (j == 0 || t < best) best = t;
+  }
+
+  return best;
+}
+
+
+static void run_ring_mul(void)
+{
+  ring_mul_sparse_ws(r, a, &b, 408, 2048, ws);
+}
+
+
+static void run_ring_mul_ct(void)
+{
+  ring_mul_sparse_ct_ws(r, a, &b, 408, 2048, ws_ct);
+}
+
+
+static void run_ring_mul_dense(void)
+{
+  ring_mul_dense(d, a401, c401, 401, tmp_dense);
+}
+
+
+// 1024 reductions per call, since a single one takes only a few cycles
+
+static void run_mod3(void)
+{
+  UINT16 x, s = 0;
+
+  for (x = 0; x < 1024; x ++) s += int16_mod3(61*x);
+  sink = s;
+}
+
+
+static void run_sha256_rolled(void)
+{
+  sha256_compress_c99(hval, block);
+}
+
+
+static void run_sha256_unrolled(void)
+{
+  sha256_compress_unrolled(hval, block);
+}
+
+
+// sha256_compress maps to dtls_sha256_compress of sha2/sha2.c, which is
+// also used by the DTLS code (see sha256.c)
+
+static void run_sha256_dtls(void)
+{
+  sha256_compress(hval, block);
+}
+
+
+// Compares the first N coefficients of r, reduced modulo 2048, with the
+// expected result; the kernels leave the reduction to the caller.
+
+static int check(const char *name, const UINT16 *r, const UINT16 *expected,
+                 int N)
+{
+  int i;
+
+  for (i = 0; i < N; i ++)
+  {
+    if ((r[i] & 0x07FF) != (expected[i] & 0x07FF))
+    {
+      printf("  %s: FAILED at coefficient %i\n", name, i);
+      return 1;
+    }
+  }
+  printf("  %s: ok\n", name);
+
+  return 0;
+}
+
+
+// c = a*(b1*b2 + b3) of test/testvec.txt with the selected kernels, and the
+// dense multiplication compared with the C99 version; each kernel is timed
+// after it passed the test.
+
+static int test_ring_mul(void)
+{
+  UINT16 t[401];
+  int err = 0;
+
+  run_ring_mul();
+  err += check("ring_mul_sparse", r, c401, 401);
+  printf("  ring_mul_sparse: %.0f %s\n", per_call(run_ring_mul, 100),
+         TIME_UNIT);
+  run_ring_mul_ct();
+  err += check("ring_mul_sparse_ct", r, c401, 401);
+  printf("  ring_mul_sparse_ct: %.0f %s\n", per_call(run_ring_mul_ct, 100),
+         TIME_UNIT);
+  run_ring_mul_dense();
+  ring_mul_dense_c99(t, a401, c401, 401, tmp_dense);
+  err += check("ring_mul_dense", d, t, 401);
+  printf("  ring_mul_dense: %.0f %s\n", per_call(run_ring_mul_dense, 10),
+         TIME_UNIT);
+
+  return err;
+}
+
+
+// int16_mod3() is checked for all 2^16 inputs against a counter modulo 3.
+
+static int test_mod3(void)
+{
+  UINT32 a;
+  UINT16 m = 0;
+  int err = 0;
+
+  for (a = 0; a < 65536; a ++)
+  {
+    if (int16_mod3((UINT16) a) != m) err ++;
+    m = (m == 2) ? 0 : m + 1;
+  }
+  printf("  int16_mod3 (all 2^16 inputs): %s\n", err ? "FAILED" : "ok");
+
+  return err;
+}
+
+
+// Pads the message msg (at most 119 characters) to one or two blocks as
+// specified in FIPS 180-4 Sect 5.1.1 and returns the number of blocks.
+
+static int pad_message(uint8_t *m, const char *msg)
+{
+  int len = (int) strlen(msg), nblk = (len + 8)/64 + 1;
+
+  memset(m, 0, 64*nblk);
+  memcpy(m, msg, len);
+  m[len] = 0x80;
+  m[64*nblk-2] = (uint8_t) ((8*len) >> 8);
+  m[64*nblk-1] = (uint8_t) (8*len);
+
+  return nblk;
+}
+
+
+// The one-block and two-block examples of FIPS 180-4 (see also the "abc"
+// vectors in sha2/testvectors), followed by a chain of 1000 blocks that
+// must give the same hash value for the rolled and unrolled version and the
+// compression function of the DTLS code.
+
+static int test_sha256(void)
+{
+  static const char *msg[2] = { "abc",
+    "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq" };
+  static const uint32_t digest[2][8] = {
+    { 0xBA7816BFUL, 0x8F01CFEAUL, 0x414140DEUL, 0x5DAE2223UL,
+      0xB00361A3UL, 0x96177A9CUL, 0xB410FF61UL, 0xF20015ADUL },
+    { 0x248D6A61UL, 0xD20638B8UL, 0xE5C02693UL, 0x0C3E6039UL,
+      0xA33CE459UL, 0x64FF2167UL, 0xF6ECEDD4UL, 0x19DB06C1UL } };
+  sha256_context_t ctx;
+  uint32_t h1[8], h2[8], h3[8];
+  uint8_t m[128];
+  int i, j, nblk, err = 0;
+
+  for (i = 0; i < 2; i ++)
+  {
+    nblk = pad_message(m, msg[i]);
+    sha256_init(&ctx);
+    memcpy(h1, ctx.hval, sizeof(h1));
+    memcpy(h2, ctx.hval, sizeof(h2));
+    memcpy(h3, ctx.hval, sizeof(h3));
+    for (j = 0; j < nblk; j ++)
+    {
+      sha256_compress_c99(h1, &(m[64*j]));
+      sha256_compress_unrolled(h2, &(m[64*j]));
+      sha256_compress(h3, &(m[64*j]));
+    }
+    if (memcmp(h1, digest[i], sizeof(h1))) err ++;
+    if (memcmp(h2, digest[i], sizeof(h2))) err ++;
+    if (memcmp(h3, digest[i], sizeof(h3))) err ++;
+  }
+  for (i = 0; i < 1000; i ++)
+  {
+    for (j = 0; j < 64; j ++) m[j] = (uint8_t) (i + 7*j + (h1[j&7] >> 24));
+    sha256_compress_c99(h1, m);
+    sha256_compress_unrolled(h2, m);
+    sha256_compress(h3, m);
+  }
+  if (memcmp(h1, h2, sizeof(h1)) || memcmp(h1, h3, sizeof(h1))) err ++;
+  printf("  sha256_compress (rolled, unrolled and DTLS): %s\n",
+         err ? "FAILED" : "ok");
+
+  return err;
+}
+
+
+// The MGF1 stream with the prepared last block (see stream_prepare()) and
+// with the generic path that finalizes a copy of the context must both give
+// SHA256(domain || seed || counter) for all counters. The seed lengths cover
+// both sides of the largest one for which the counter and the padding fit
+// into the last block, and seeds of one or more complete blocks.
+
+static int test_mgf1(void)
+{
+  static const int lens[] = { 0, 1, 31, 32, 50, 51, 52, 55, 56, 63, 64, 100,
+                              114, 115, 128, 200 };
+  NTRU_STREAM fast, slow;
+  sha256_context_t ctx;
+  UINT8 seed[200], ref[32], cnt[4], domain;
+  int i, j, k, fast_used = 0, err = 0;
+
+  for (i = 0; i < (int) (sizeof(lens)/sizeof(lens[0])); i ++)
+  {
+    for (domain = 0; domain < 3; domain ++)
+    {
+      for (j = 0; j < lens[i]; j ++) seed[j] = (UINT8) (domain + 13*j + i);
+      stream_init(&fast, domain);
+      stream_absorb(&fast, seed, lens[i]);
+      slow = fast;
+      slow.cpos = -1;
+      for (k = 0; k < 4*32; k ++)
+      {
+        if ((k & 31) == 0)
+        {
+          cnt[0] = cnt[1] = cnt[2] = 0; cnt[3] = (UINT8) (k >> 5);
+          sha256_init(&ctx);
+          sha256_update(&ctx, &domain, 1);
+          sha256_update(&ctx, seed, lens[i]);
+          sha256_update(&ctx, cnt, 4);
+          sha256_final(&ctx, ref);
+        }
+        if (stream_byte(&fast) != ref[k & 31]) err ++;
+        if (stream_byte(&slow) != ref[k & 31]) err ++;
+      }
+      if (fast.cpos >= 0) fast_used ++;
+    }
+  }
+  // the prepared block must have been used for the short seeds
+  if (fast_used == 0) err ++;
+  printf("  MGF1 stream (prepared block and generic path): %s\n",
+         err ? "FAILED" : "ok");
+
+  return err;
+}
+
+
+int main(void)
+{
+  int i, err = 0;
+  double t;
+
+  for (i = 0; i < 401; i ++) a[i] = a401[i];
+  for (i = 0; i < 7; i ++) a[401+i] = a[i];
+
+  printf("int16_mod3, SHA256:\n");
+  err += test_mod3();
+  err += test_sha256();
+  err += test_mgf1();
+  printf("  int16_mod3: %.2f %s\n", per_call(run_mod3, 64)/1024, TIME_UNIT);
+  t = per_call(run_sha256_rolled, 1000);
+  printf("  sha256_compress (rolled): %.0f %s (%.1f per byte)\n", t,
+         TIME_UNIT, t/64);
+  t = per_call(run_sha256_unrolled, 1000);
+  printf("  sha256_compress (unrolled): %.0f %s (%.1f per byte)\n", t,
+         TIME_UNIT, t/64);
+#ifdef SHA2_X86
+  {
+    // the DTLS backends; SSE2 is the C version for a single message
+    const char *names[] = { "C", "SSE2", "AVX2", "SHA-NI" };
+    int impl;
+
+    for (impl = DTLS_SHA256_C; impl <= DTLS_SHA256_SHANI; impl ++)
+    {
+      if (impl == DTLS_SHA256_SSE2 || dtls_sha256_select(impl) != impl)
+        continue;
+      err += test_sha256();
+      t = per_call(run_sha256_dtls, 1000);
+      printf("  sha256_compress (DTLS, %s): %.0f %s (%.1f per byte)\n",
+             names[impl], t, TIME_UNIT, t/64);
+    }
+    dtls_sha256_select(DTLS_SHA256_BEST);
+  }
+#else
+  t = per_call(run_sha256_dtls, 1000);
+  printf("  sha256_compress (DTLS): %.0f %s (%.1f per byte)\n", t,
+         TIME_UNIT, t/64);
+#endif
+
+#ifdef RING_MUL_X86
+  {
+    const char *names[] = { "C99", "SSE2", "AVX2" };
+    int impl;
+
+    for (impl = RING_MUL_C99; impl <= RING_MUL_AVX2; impl ++)
+    {
+      if (ring_mul_select(impl) != impl)
+      {
+        printf("%s: not supported by this CPU\n", names[impl]);
+        continue;
+      }
+      printf("%s:\n", names[impl]);
+      err += test_ring_mul();
+    }
+    ring_mul_select(RING_MUL_BEST);
+  }
+#else
+  printf("C99:\n");
+  err += test_ring_mul();
+#endif
+
+  printf("%s\n", err ? "Tests FAILED." : "All Tests successful.");
+
+  return err ? 1 : 0;
+}
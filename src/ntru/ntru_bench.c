@@ -0,0 +1,268 @@
+///////////////////////////////////////////////////////////////////////////////
+// ntru_bench.c: Test and benchmark of the NTRU key encapsulation.           //
+// Written for tinydtls on top of the QUASIKOM ring arithmetic (project      //
+// repository <https://www.github.com/grojoh/quasikom/>), not part of a      //
+// QUASIKOM release.                                                         //
+// License: GPLv3 (see LICENSE file), like the QUASIKOM code it builds on.   //
+// Copyright (C) 2026 the tinydtls contributors.                             //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "asmfncts.h"
+#include "ring_arith.h"
+#include "ntru_kem.h"
+
+
+// The seeds are derived from a counter so that the results are reproducible;
+// an application has to use a cryptographically secure random source.
+
+static void make_seed(UINT8 *seed, UINT32 cnt)
+{
+  int i;
+
+  for (i = 0; i < NTRU_SEED_LEN; i ++) seed[i] = (UINT8) (cnt >> (8*(i & 3)));
+}
+
+
+// The index generation must yield 2*d distinct indices < N for each factor
+// of the product-form private key F = F1*F2 + F3.
+
+static int test_indices(const NTRU_PRIVATE_KEY *priv)
+{
+  const int len[3] = { 2*NTRU_DF1, 2*NTRU_DF2, 2*NTRU_DF3 };
+  const UINT16 *idx = priv->f_indices;
+  int i, j, k, err = 0;
+
+  for (k = 0; k < 3; idx += len[k++])
+  {
+    for (i = 0; i < len[k]; i ++)
+    {
+      if (idx[i] >= NTRU_N) err ++;
+      for (j = 0; j < i; j ++) if (idx[j] == idx[i]) err ++;
+    }
+  }
+  printf("index generation: %s\n", err ? "FAILED" : "ok");
+
+  return err;
+}
+
+
+static int test_kem(const NTRU_PRIVATE_KEY *priv, const NTRU_PUBLIC_KEY *pub)
+{
+  UINT16 c[NTRU_N];
+  UINT8 seed[NTRU_SEED_LEN], key1[NTRU_KEY_LEN], key2[NTRU_KEY_LEN];
+  int i, err = 0;
+
+  for (i = 0; i < 100; i ++)
+  {
+    make_seed(seed, 1000 + i);
+    ntru_encaps(c, key1, pub, seed);
+    ntru_decaps(key2, priv, c);
+    if (memcmp(key1, key2, NTRU_KEY_LEN)) err ++;
+    // a modified ciphertext yields another key, the same one every time
+    c[i] ^= 1;
+    ntru_decaps(key2, priv, c);
+    if (!memcmp(key1, key2, NTRU_KEY_LEN)) err ++;
+    ntru_decaps(key1, priv, c);
+    if (memcmp(key1, key2, NTRU_KEY_LEN)) err ++;
+  }
+  printf("encaps/decaps: %s\n", err ? "FAILED" : "ok");
+
+  return err;
+}
+
+
+// Round trip of the packing of the public key and of ciphertexts; besides,
+// an encoding with non-zero padding bits must be rejected and every packed
+// string (with zero padding) must survive unpack/pack unchanged.
+
+static int test_pack(const NTRU_PUBLIC_KEY *pub)
+{
+  UINT16 c[NTRU_N], c2[NTRU_N];
+  UINT8 seed[NTRU_SEED_LEN], key[NTRU_KEY_LEN];
+  UINT8 buf[NTRU_PACKED_LEN], buf2[NTRU_PACKED_LEN];
+  int i, j, err = 0;
+
+  ntru_pack(buf, pub->h);
+  if (!ntru_unpack(c2, buf) || memcmp(c2, pub->h, sizeof(c2))) err ++;
+  for (i = 0; i < 10; i ++)
+  {
+    make_seed(seed, 2000 + i);
+    ntru_encaps(c, key, pub, seed);
+    ntru_pack(buf, c);
+    if (!ntru_unpack(c2, buf) || memcmp(c, c2, sizeof(c))) err ++;
+    // arbitrary bytes with zero padding
+    for (j = 0; j < NTRU_PACKED_LEN; j ++) buf[j] = (UINT8) (37*i + 101*j);
+    buf[NTRU_PACKED_LEN-1] &= (UINT8) (0xFF << ((8 - NTRU_N*NTRU_Q_BITS) & 7));
+    if (!ntru_unpack(c2, buf)) err ++;
+    ntru_pack(buf2, c2);
+    if (memcmp(buf, buf2, NTRU_PACKED_LEN)) err ++;
+  }
+  if ((NTRU_N*NTRU_Q_BITS) & 7)
+  {
+    buf[NTRU_PACKED_LEN-1] |= 1;
+    if (ntru_unpack(c2, buf)) err ++;
+  }
+  printf("pack/unpack (%i bytes): %s\n", NTRU_PACKED_LEN, err ? "FAILED" : "ok");
+
+  return err;
+}
+
+
+// Speed of ring_mul_sparse_ws() with the private key as second operand,
+// which is the dominant operation of the decapsulation. The indices of the
+// private key are used directly since they are not modified.
+
+static double bench_ring_mul(const NTRU_PRIVATE_KEY *priv)
+{
+  SPARSE_POLY F = { priv->f_indices, 2*NTRU_DF1, 2*NTRU_DF2, 2*NTRU_DF3 };
+  UINT16 r[NTRU_ALEN];
+  UINT16 ws[RING_MUL_SPARSE_WS_SIZE(NTRU_ALEN, NTRU_SPARSE_LEN/2) / \
+            sizeof(UINT16)];
+  clock_t start;
+  double secs;
+  long n = 0;
+
+  start = clock();
+  do
+  {
+    ring_mul_sparse_ws(r, priv->pub.h, &F, NTRU_ALEN, NTRU_Q, ws);
+    n ++;
+  } while ((secs = (double) (clock() - start)/CLOCKS_PER_SEC) < 1.0);
+
+  return n/secs;
+}
+
+
+// Speed of the constant-time multiplication ring_mul_sparse_ct_ws() with
+// the private key as second operand.
+
+static double bench_ring_mul_ct(const NTRU_PRIVATE_KEY *priv)
+{
+  SPARSE_POLY F = { priv->f_indices, 2*NTRU_DF1, 2*NTRU_DF2, 2*NTRU_DF3 };
+  UINT16 r[NTRU_ALEN];
+  UINT16 ws[RING_MUL_SPARSE_CT_WS_SIZE(NTRU_ALEN)/sizeof(UINT16)];
+  clock_t start;
+  double secs;
+  long n = 0;
+
+  start = clock();
+  do
+  {
+    ring_mul_sparse_ct_ws(r, priv->pub.h, &F, NTRU_ALEN, NTRU_Q, ws);
+    n ++;
+  } while ((secs = (double) (clock() - start)/CLOCKS_PER_SEC) < 1.0);
+
+  return n/secs;
+}
+
+
+int main(void)
+{
+  NTRU_PRIVATE_KEY priv;
+  NTRU_PUBLIC_KEY pub;
+  UINT16 c[NTRU_N];
+  UINT8 seed[NTRU_SEED_LEN], key[NTRU_KEY_LEN], packed[NTRU_PACKED_LEN];
+  clock_t start;
+  double secs;
+  long n;
+  int err = 0;
+
+  printf("parameter set: %s\n", NTRU_PARAM_NAME);
+  // average over the keys generated in one second; the key of the last seed
+  // is used for the remaining tests
+  n = 0;
+  start = clock();
+  do
+  {
+    make_seed(seed, n);
+    if (!ntru_keygen(&priv, &pub, seed))
+    {
+      printf("keygen: FAILED\n");
+      return 1;
+    }
+    n ++;
+  } while ((secs = (double) (clock() - start)/CLOCKS_PER_SEC) < 1.0);
+  printf("keygen: %.3f ms\n", 1000.0*secs/n);
+
+  err += test_indices(&priv);
+  err += test_kem(&priv, &pub);
+  err += test_pack(&pub);
+
+  n = 0;
+  start = clock();
+  do
+  {
+    make_seed(seed, n);
+    ntru_encaps(c, key, &pub, seed);
+    n ++;
+  } while ((secs = (double) (clock() - start)/CLOCKS_PER_SEC) < 1.0);
+  printf("encaps: %.0f ops/s\n", n/secs);
+
+  n = 0;
+  start = clock();
+  do
+  {
+    ntru_decaps(key, &priv, c);
+    n ++;
+  } while ((secs = (double) (clock() - start)/CLOCKS_PER_SEC) < 1.0);
+  printf("decaps: %.0f ops/s\n", n/secs);
+
+  n = 0;
+  start = clock();
+  do
+  {
+    ntru_pack(packed, c);
+    n ++;
+  } while ((secs = (double) (clock() - start)/CLOCKS_PER_SEC) < 1.0);
+  printf("pack: %.0f ops/s (%.0f MB/s)\n", n/secs,
+         n*(double) NTRU_PACKED_LEN/(1e6*secs));
+
+  n = 0;
+  start = clock();
+  do
+  {
+    if (!ntru_unpack(c, packed)) err ++;
+    n ++;
+  } while ((secs = (double) (clock() - start)/CLOCKS_PER_SEC) < 1.0);
+  printf("unpack: %.0f ops/s (%.0f MB/s)\n", n/secs,
+         n*(double) NTRU_PACKED_LEN/(1e6*secs));
+
+#ifdef RING_MUL_X86
+  {
+    const char *names[] = { "C99", "SSE2", "AVX2" };
+    int impl;
+
+    // all kernels supported by the CPU, then switch back to the best one
+    for (impl = RING_MUL_C99; impl <= RING_MUL_AVX2; impl ++)
+    {
+      if (ring_mul_select(impl) != impl) continue;
+      printf("ring_mul_sparse (%s): %.0f ops/s\n", names[impl],
+             bench_ring_mul(&priv));
+      printf("ring_mul_sparse_ct (%s): %.0f ops/s\n", names[impl],
+             bench_ring_mul_ct(&priv));
+    }
+    ring_mul_select(RING_MUL_BEST);
+  }
+#else
+  printf("ring_mul_sparse: %.0f ops/s\n", bench_ring_mul(&priv));
+  printf("ring_mul_sparse_ct: %.0f ops/s\n", bench_ring_mul_ct(&priv));
+#endif
+
+  printf("%s\n", err ? "Tests FAILED." : "All Tests successful.");
+
+  return err ? 1 : 0;
+}
@@ -0,0 +1,577 @@
+///////////////////////////////////////////////////////////////////////////////
+// ntru_kem.c: NTRUEncrypt key encapsulation for product-form parameter sets.//
+// Written for tinydtls on top of the QUASIKOM ring arithmetic (project      //
+// repository <https://www.github.com/grojoh/quasikom/>), not part of a      //
+// QUASIKOM release.                                                         //
+// License: GPLv3 (see LICENSE file), like the QUASIKOM code it builds on.   //
+// Copyright (C) 2026 the tinydtls contributors.                             //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// The key encapsulation mechanism (KEM) implemented in this file follows the
+// usual construction of a KEM from a deterministic public-key encryption. To
+// encapsulate a key, a random ternary message polynomial m(X) with at least
+// dm0 coefficients equal to -1, 0, and +1 is generated. The blinding poly-
+// nomial r(X) in product form is derived from m(X) and the first coeffs of
+// the public key h(X) by hashing, and the ciphertext is c = r*h + m mod q.
+// The shared key is the hash of m(X). Decapsulation computes a = f*c mod q,
+// where f = 1 + 3*F, which yields m(X) after center-lifting the coefficients
+// of a(X) and reducing them modulo 3. Thereafter, r(X) is derived again from
+// m(X) and the ciphertext is recomputed. If it does not match the received
+// one, decapsulation returns a pseudo-random key derived from the ciphertext
+// and a secret value z of the private key (implicit rejection), so that an
+// invalid ciphertext only shows up later as a wrong key. Both the multipli-
+// cation r*h in encapsulation and the multiplication F*c in decapsulation
+// use ring_mul_sparse_ws(). All random and pseudo-random data is generated
+// from caller-provided seeds by SHA256 in counter mode, which means that the
+// functions in this file are deterministic.
+
+
+#include <string.h>
+#include "asmfncts.h"
+#include "ring_arith.h"
+#include "sha256.h"
+#include "ntru_kem.h"
+
+
+// domain separation of the different uses of SHA256
+
+#define NTRU_DOMAIN_F   0x00  // generation of the private key F
+#define NTRU_DOMAIN_G   0x01  // generation of the polynomial g
+#define NTRU_DOMAIN_M   0x02  // generation of the message m
+#define NTRU_DOMAIN_R   0x03  // generation of the blinding polynomial r
+#define NTRU_DOMAIN_KEY 0x04  // derivation of the shared key
+#define NTRU_DOMAIN_Z   0x05  // generation of the rejection secret z
+#define NTRU_DOMAIN_REJ 0x06  // derivation of the key of a rejected ciphertext
+
+// center-lifting: a + q/2 + NTRU_MOD3_ADJ is congruent to a modulo 3
+#define NTRU_MOD3_ADJ ((3 - (NTRU_Q/2) % 3) % 3)
+
+// largest multiple of N that fits into NTRU_C bits, i.e. 2^c - (2^c mod N)
+#define NTRU_INDEX_LIMIT ((1 << NTRU_C) - ((1 << NTRU_C) % NTRU_N))
+
+// workspace of ring_mul_sparse_ws() in UINT16 elements for the product-form
+// polynomials F and r (no factor has more than NTRU_SPARSE_LEN/2 coefficients
+// equal to +1) and for the polynomial g with NTRU_DG such coefficients
+#define NTRU_WS_LEN \
+  (RING_MUL_SPARSE_WS_SIZE(NTRU_ALEN, NTRU_SPARSE_LEN/2)/sizeof(UINT16))
+#define NTRU_WS_LEN_G \
+  (RING_MUL_SPARSE_WS_SIZE(NTRU_ALEN, NTRU_DG)/sizeof(UINT16))
+
+// workspace of the multiplications with a secret polynomial, i.e. F*c in
+// decapsulation and r*h in encrypt()
+#ifdef NTRU_CONST_TIME
+#define NTRU_WS_LEN_CT \
+  (RING_MUL_SPARSE_CT_WS_SIZE(NTRU_ALEN)/sizeof(UINT16))
+#else
+#define NTRU_WS_LEN_CT NTRU_WS_LEN
+#endif
+
+// number of coefficients of the public key h that are hashed together with
+// m to obtain the blinding polynomial r (corresponds to "hTrunc" in EESS #1)
+#define NTRU_HTRUNC_LEN 16
+
+
+// struct for a stream of pseudo-random bytes generated by SHA256 in counter
+// mode (i.e. MGF1 of PKCS #1 with seed = domain || absorbed data); the
+// context "base" contains the already absorbed seed
+
+typedef struct ntru_stream {
+  sha256_context_t base;  // SHA256 context after absorbing the seed
+  UINT8 block[64];        // padded last block of seed || counter
+  UINT8 buf[32];          // current block of pseudo-random bytes
+  UINT32 counter;         // number of the next block
+  UINT32 bits;            // bit buffer of the index generation function
+  int nbits;              // number of unused bits in the bit buffer
+  int pos;                // position of the next byte in buf
+  int cpos;               // position of the counter in block (see below)
+} NTRU_STREAM;
+
+
+static void stream_init(NTRU_STREAM *st, UINT8 domain)
+{
+  sha256_init(&st->base);
+  sha256_update(&st->base, &domain, 1);
+  st->counter = 0;
+  st->nbits = 0;
+  st->pos = sizeof(st->buf);
+  st->cpos = -2;
+}
+
+
+static void stream_absorb(NTRU_STREAM *st, const void *data, size_t len)
+{
+  sha256_update(&st->base, data, len);
+}
+
+
+// When the remaining bytes of the seed, the 4-byte counter, and the padding
+// fit into a single block (which is the case for all seeds of the KEM), the
+// last block is prepared once and each output block needs just one call of
+// the compression function, without copying and finalizing a context. The
+// counter is then located at block[cpos]; cpos = -1 means it does not fit
+// and cpos = -2 that the block has not been prepared yet.
+
+static void stream_prepare(NTRU_STREAM *st)
+{
+  int i, n = st->base.mbytes;
+  UINT64 len = st->base.length + 32;  // length in bits including counter
+
+  if (n > 51)
+  {
+    st->cpos = -1;
+    return;
+  }
+  memcpy(st->block, st->base.mbuf, n);
+  st->block[n+4] = 0x80;
+  memset(&st->block[n+5], 0, 51 - n);
+  for (i = 0; i < 8; i ++) st->block[56+i] = (UINT8) (len >> (56 - 8*i));
+  st->cpos = n;
+}
+
+
+static void stream_refill(NTRU_STREAM *st)
+{
+  sha256_context_t ctx;
+  UINT32 hval[8];
+  UINT8 cnt[4];
+  int i;
+
+  cnt[0] = (UINT8) (st->counter >> 24); cnt[1] = (UINT8) (st->counter >> 16);
+  cnt[2] = (UINT8) (st->counter >> 8);  cnt[3] = (UINT8) st->counter;
+  if (st->cpos == -2) stream_prepare(st);
+
+  if (st->cpos >= 0)
+  {
+    memcpy(&st->block[st->cpos], cnt, 4);
+    memcpy(hval, st->base.hval, sizeof(hval));
+    sha256_compress_block(hval, st->block);
+    for (i = 0; i < 32; i ++)
+      st->buf[i] = (UINT8) (hval[i >> 2] >> (24 - 8*(i & 3)));
+  }
+  else
+  {
+    ctx = st->base;
+    sha256_update(&ctx, cnt, 4);
+    sha256_final(&ctx, st->buf);
+  }
+  st->counter ++;
+  st->pos = 0;
+}
+
+
+static UINT8 stream_byte(NTRU_STREAM *st)
+{
+  if (st->pos == sizeof(st->buf)) stream_refill(st);
+
+  return st->buf[st->pos++];
+}
+
+
+// Index generation function IGF-2 of EESS #1: the stream is consumed as a
+// string of bits (most significant bit of each byte first), and each index
+// candidate consists of the next NTRU_C bits. Candidates >= NTRU_INDEX_LIMIT
+// are rejected, the others are reduced modulo N.
+
+static UINT16 igf_next(NTRU_STREAM *st)
+{
+  UINT16 v;
+
+  do
+  {
+    while (st->nbits < NTRU_C)
+    {
+      st->bits = (st->bits << 8) | stream_byte(st);
+      st->nbits += 8;
+    }
+    st->nbits -= NTRU_C;
+    v = (UINT16) ((st->bits >> st->nbits) & ((1 << NTRU_C) - 1));
+  } while (v >= NTRU_INDEX_LIMIT);
+
+  return v % NTRU_N;
+}
+
+
+// Generation of the indices of a sparse ternary polynomial with d coeffs of
+// +1 and d coeffs of -1. The first d indices written to idx belong to the +1
+// coefficients, the following d indices to the -1 coefficients. Indices that
+// are already used by the polynomial are discarded, which is detected with a
+// bitmap of N bits instead of comparing each new index with all previous
+// ones; the bitmap has (at most) 93 bytes and fits into two cache lines.
+
+static void gen_indices(UINT16 *idx, int d, NTRU_STREAM *st)
+{
+  UINT8 used[(NTRU_N+7)/8];
+  int i = 0;
+  UINT16 v;
+
+  memset(used, 0, sizeof(used));
+  while (i < 2*d)
+  {
+    v = igf_next(st);
+    if (used[v >> 3] & (1 << (v & 7))) continue;
+    used[v >> 3] |= (UINT8) (1 << (v & 7));
+    idx[i++] = v;
+  }
+
+  memset(used, 0, sizeof(used));
+}
+
+
+// Generation of a product-form polynomial F = F1*F2 + F3 with the weights
+// NTRU_DF1, NTRU_DF2, NTRU_DF3 of the parameter set; the same weights are
+// used for the private key F and for the blinding polynomial r.
+
+static void gen_product_form(UINT16 *idx, SPARSE_POLY *p, NTRU_STREAM *st)
+{
+  gen_indices(idx, NTRU_DF1, st);
+  gen_indices(idx + 2*NTRU_DF1, NTRU_DF2, st);
+  gen_indices(idx + 2*(NTRU_DF1 + NTRU_DF2), NTRU_DF3, st);
+  p->indices = idx;
+  p->p1i_len = 2*NTRU_DF1;
+  p->p2i_len = 2*NTRU_DF2;
+  p->p3i_len = 2*NTRU_DF3;
+}
+
+
+// Generation of the ternary message polynomial m with coefficients in {0, 1,
+// 2}, whereby 2 represents -1, with the trit generation function MGF-TP-1 of
+// EESS #1. Every byte < 243 = 3^5 of the stream yields five coeffs; the
+// polynomial is generated again if it has less than dm0 coefficients of -1,
+// 0, or +1 (EESS #1 requires this to exclude weak messages). In decaps(), m
+// is secret, so the coeffs are counted with their bits instead of indexing
+// a table with them, and the result is computed without branches.
+
+static int check_dm0(const UINT8 *m)
+{
+  UINT32 cnt0, cnt1 = 0, cnt2 = 0, ok;
+  int i;
+
+  for (i = 0; i < NTRU_N; i ++)
+  {
+    cnt1 += m[i] & 1;
+    cnt2 += m[i] >> 1;
+  }
+  cnt0 = NTRU_N - cnt1 - cnt2;
+
+  // the top bit of cnt - dm0 is set iff cnt < dm0
+  ok = (cnt0 - NTRU_DM0) | (cnt1 - NTRU_DM0) | (cnt2 - NTRU_DM0);
+  return (int) ((ok >> 31) ^ 1);
+}
+
+
+static void gen_message(UINT8 *m, NTRU_STREAM *st)
+{
+  int i, j;
+  UINT8 v;
+
+  do
+  {
+    i = 0;
+    while (i < NTRU_N)
+    {
+      v = stream_byte(st);
+      if (v >= 243) continue;
+      for (j = 0; (j < 5) && (i < NTRU_N); j ++, v /= 3) m[i++] = v % 3;
+    }
+  } while (!check_dm0(m));
+}
+
+
+// Computation of the ciphertext c = r*h + m mod q with the blinding poly r
+// derived from m and the first coefficients of h.
+
+static void encrypt(UINT16 *c, const UINT8 *m, const NTRU_PUBLIC_KEY *pub)
+{
+  NTRU_STREAM st;
+  UINT16 r_indices[NTRU_SPARSE_LEN], t[NTRU_ALEN], ws[NTRU_WS_LEN_CT];
+  UINT8 htrunc[2*NTRU_HTRUNC_LEN];
+  SPARSE_POLY r;
+  int i;
+
+  // the coefficients of h are hashed in little-endian byte order
+  for (i = 0; i < NTRU_HTRUNC_LEN; i ++)
+  {
+    htrunc[2*i] = (UINT8) pub->h[i];
+    htrunc[2*i+1] = (UINT8) (pub->h[i] >> 8);
+  }
+
+  stream_init(&st, NTRU_DOMAIN_R);
+  stream_absorb(&st, m, NTRU_N);
+  stream_absorb(&st, htrunc, sizeof(htrunc));
+  gen_product_form(r_indices, &r, &st);
+
+  // r is derived from the message, which is secret in both encapsulation
+  // and the re-encryption check of decapsulation
+#ifdef NTRU_CONST_TIME
+  ring_mul_sparse_ct_ws(t, pub->h, &r, NTRU_ALEN, NTRU_Q, ws);
+#else
+  ring_mul_sparse_ws(t, pub->h, &r, NTRU_ALEN, NTRU_Q, ws);
+#endif
+
+  // m[i] = 2 represents -1, which is 2047 modulo q
+  for (i = 0; i < NTRU_N; i ++)
+    c[i] = (t[i] + m[i] - ((m[i] >> 1) * 3)) & (NTRU_Q-1);
+}
+
+
+static void derive_key(UINT8 *key, const UINT8 *m)
+{
+  sha256_context_t ctx;
+  UINT8 domain = NTRU_DOMAIN_KEY;
+
+  sha256_init(&ctx);
+  sha256_update(&ctx, &domain, 1);
+  sha256_update(&ctx, m, NTRU_N);
+  sha256_final(&ctx, key);
+}
+
+
+// Key returned for a ciphertext c that fails the re-encryption check, i.e.
+// the hash of the secret z and c. The key never leaves the decapsulating
+// host, so the coefficients of c are hashed in their native byte order.
+
+static void derive_reject_key(UINT8 *key, const UINT8 *z, const UINT16 *c)
+{
+  sha256_context_t ctx;
+  UINT8 domain = NTRU_DOMAIN_REJ;
+
+  sha256_init(&ctx);
+  sha256_update(&ctx, &domain, 1);
+  sha256_update(&ctx, z, NTRU_SEED_LEN);
+  sha256_update(&ctx, c, NTRU_N*sizeof(UINT16));
+  sha256_final(&ctx, key);
+}
+
+
+// Key generation: the private key is f = 1 + 3*F with F in product form and
+// the public key is h = 3*g*f^-1 mod q, whereby g is a sparse polynomial with
+// dg coefficients of +1 and dg coefficients of -1. The seed must consist of
+// NTRU_SEED_LEN random bytes. In the (very unlikely) case that f is not in-
+// vertible, F is generated again from the stream. Returns 1 on success.
+
+int ntru_keygen(NTRU_PRIVATE_KEY *priv, NTRU_PUBLIC_KEY *pub,
+                const UINT8 *seed)
+{
+  NTRU_STREAM st;
+  SPARSE_POLY F, g;
+  UINT16 g_indices[2*NTRU_DG];
+  UINT16 one[NTRU_ALEN], f[NTRU_ALEN], fq[NTRU_ALEN], t[NTRU_ALEN];
+  UINT16 ws[NTRU_WS_LEN_G];
+  UINT32 inv_ws[RING_INV_Q_WS_SIZE(NTRU_N)/sizeof(UINT32)];
+  int i, attempts = 0;
+
+  // one(X) = 1, extended to N+7 coefficients for ring_mul_sparse_ws()
+  for (i = 0; i < NTRU_ALEN; i ++) one[i] = 0;
+  one[0] = one[NTRU_N] = 1;
+
+  stream_init(&st, NTRU_DOMAIN_F);
+  stream_absorb(&st, seed, NTRU_SEED_LEN);
+  do
+  {
+    if (attempts++ == 8) return 0;
+    gen_product_form(priv->f_indices, &F, &st);
+    // f = 1 + 3*F mod q
+    ring_mul_sparse_ws(f, one, &F, NTRU_ALEN, NTRU_Q, ws);
+    for (i = 0; i < NTRU_N; i ++) f[i] = (3*f[i]) & (NTRU_Q-1);
+    f[0] = (f[0] + 1) & (NTRU_Q-1);
+  } while (!ring_inv_q(fq, f, NTRU_N, NTRU_Q, inv_ws));
+
+  stream_init(&st, NTRU_DOMAIN_G);
+  stream_absorb(&st, seed, NTRU_SEED_LEN);
+  gen_indices(g_indices, NTRU_DG, &st);
+  g.indices = g_indices;
+  g.p1i_len = g.p2i_len = 0;
+  g.p3i_len = 2*NTRU_DG;
+
+  // h = 3*g*fq mod q
+  for (i = 0; i < 7; i ++) fq[NTRU_N+i] = fq[i];
+  ring_mul_sparse_ws(t, fq, &g, NTRU_ALEN, NTRU_Q, ws);
+  for (i = 0; i < NTRU_N; i ++) pub->h[i] = (3*t[i]) & (NTRU_Q-1);
+  for (i = 0; i < 7; i ++) pub->h[NTRU_N+i] = pub->h[i];
+
+  priv->pub = *pub;
+
+  // z = hash of the seed, used for the implicit rejection in ntru_decaps()
+  stream_init(&st, NTRU_DOMAIN_Z);
+  stream_absorb(&st, seed, NTRU_SEED_LEN);
+  for (i = 0; i < NTRU_SEED_LEN; i ++) priv->z[i] = stream_byte(&st);
+
+  return 1;
+}
+
+
+// Encapsulation: generates a ciphertext c of N coefficients and a shared key
+// of NTRU_KEY_LEN bytes for the public key pub. The seed must consist of
+// NTRU_SEED_LEN random bytes.
+
+void ntru_encaps(UINT16 *c, UINT8 *key, const NTRU_PUBLIC_KEY *pub,
+                 const UINT8 *seed)
+{
+  NTRU_STREAM st;
+  UINT8 m[NTRU_N];
+
+  stream_init(&st, NTRU_DOMAIN_M);
+  stream_absorb(&st, seed, NTRU_SEED_LEN);
+  gen_message(m, &st);
+
+  encrypt(c, m, pub);
+  derive_key(key, m);
+
+  memset(m, 0, sizeof(m));
+}
+
+
+// Decapsulation: recovers the shared key from the ciphertext c of N coeffs.
+// If the ciphertext is not valid, the key is derived from z and c instead.
+// Both keys are computed and one of them is selected with a mask, so that
+// the timing does not reveal which case occurred.
+
+void ntru_decaps(UINT8 *key, const NTRU_PRIVATE_KEY *priv, const UINT16 *c)
+{
+  SPARSE_POLY F = { priv->f_indices, 2*NTRU_DF1, 2*NTRU_DF2, 2*NTRU_DF3 };
+  UINT16 ce[NTRU_ALEN], t[NTRU_ALEN], ws[NTRU_WS_LEN_CT], a, diff = 0;
+  UINT8 m[NTRU_N], rkey[NTRU_KEY_LEN], mask;
+  int i;
+
+  // c extended to N+7 coefficients for ring_mul_sparse_ws()
+  for (i = 0; i < NTRU_N; i ++) ce[i] = c[i] & (NTRU_Q-1);
+  for (i = 0; i < 7; i ++) ce[NTRU_N+i] = ce[i];
+
+  // a = f*c = c + 3*F*c mod q
+#ifdef NTRU_CONST_TIME
+  ring_mul_sparse_ct_ws(t, ce, &F, NTRU_ALEN, NTRU_Q, ws);
+#else
+  ring_mul_sparse_ws(t, ce, &F, NTRU_ALEN, NTRU_Q, ws);
+#endif
+  for (i = 0; i < NTRU_N; i ++)
+  {
+    // a + q/2 with a in [-q/2, q/2-1]
+    a = (ce[i] + 3*t[i] + NTRU_Q/2) & (NTRU_Q-1);
+    // for q = 2048, 1024 + 2 = 3*342, so the sum is congruent to a modulo 3
+    m[i] = (UINT8) int16_mod3(a + NTRU_MOD3_ADJ);
+  }
+
+  // re-encryption check
+  encrypt(t, m, &priv->pub);
+  for (i = 0; i < NTRU_N; i ++) diff |= t[i] ^ ce[i];
+  // mask = 0xFF if the ciphertext is valid and 0 otherwise, the top bit of
+  // diff - 1 is set iff diff = 0
+  mask = (UINT8) -((((UINT32) diff - 1) >> 31) & check_dm0(m));
+
+  derive_key(key, m);
+  derive_reject_key(rkey, priv->z, ce);
+  for (i = 0; i < NTRU_KEY_LEN; i ++)
+    key[i] = (key[i] & mask) | (rkey[i] & ~mask);
+
+  memset(m, 0, sizeof(m));
+  memset(rkey, 0, sizeof(rkey));
+}
+
+
+// Serialization of a polynomial with N coefficients modulo q (public key h
+// or ciphertext c) as a string of N*NTRU_Q_BITS bits, whereby each coeff is
+// written with the most significant bit first and the last byte is padded
+// with 0 bits. Groups of 8 coefficients correspond to exactly NTRU_Q_BITS
+// bytes; they are combined into two 64-bit words of 4 coefficients each, so
+// that the bytes can be written without a loop over the individual bits.
+// Only the last N mod 8 coefficients are processed one by one.
+
+#define NTRU_Q_MASK  ((1U << NTRU_Q_BITS) - 1)
+#define NTRU_HALF    (4*NTRU_Q_BITS)  // bits of 4 coefficients
+
+static void pack8(UINT8 *out, const UINT16 *c)
+{
+  UINT64 hi = 0, lo = 0;
+  int i;
+
+  for (i = 0; i < 4; i ++)
+  {
+    hi = (hi << NTRU_Q_BITS) | (c[i] & NTRU_Q_MASK);
+    lo = (lo << NTRU_Q_BITS) | (c[4+i] & NTRU_Q_MASK);
+  }
+  for (i = 0; i < NTRU_HALF/8; i ++)
+    *out++ = (UINT8) (hi >> (NTRU_HALF - 8*(i+1)));
+#if (NTRU_HALF & 7)
+  // NTRU_Q_BITS is odd, i.e. the halves share the byte in the middle
+  *out++ = (UINT8) ((hi << 4) | (lo >> (NTRU_HALF - 4)));
+  for (i = 0; i < NTRU_HALF/8; i ++)
+    *out++ = (UINT8) (lo >> (NTRU_HALF - 4 - 8*(i+1)));
+#else
+  for (i = 0; i < NTRU_HALF/8; i ++)
+    *out++ = (UINT8) (lo >> (NTRU_HALF - 8*(i+1)));
+#endif
+}
+
+
+static void unpack8(UINT16 *c, const UINT8 *in)
+{
+  UINT64 hi = 0, lo = 0;
+  int i;
+
+  for (i = 0; i < NTRU_HALF/8; i ++) hi = (hi << 8) | *in++;
+#if (NTRU_HALF & 7)
+  hi = (hi << 4) | (*in >> 4);
+  lo = *in++ & 0x0F;
+#endif
+  for (i = 0; i < NTRU_HALF/8; i ++) lo = (lo << 8) | *in++;
+  for (i = 0; i < 4; i ++)
+  {
+    c[i] = (UINT16) (hi >> (NTRU_Q_BITS*(3-i))) & NTRU_Q_MASK;
+    c[4+i] = (UINT16) (lo >> (NTRU_Q_BITS*(3-i))) & NTRU_Q_MASK;
+  }
+}
+
+
+// Packs the N coefficients of poly (reduced modulo q) into NTRU_PACKED_LEN
+// bytes.
+
+void ntru_pack(UINT8 *out, const UINT16 *poly)
+{
+  UINT32 acc = 0;
+  int i, nbits = 0;
+
+  for (i = 0; i+8 <= NTRU_N; i += 8, out += NTRU_Q_BITS) pack8(out, &poly[i]);
+  for (; i < NTRU_N; i ++)
+  {
+    acc = (acc << NTRU_Q_BITS) | (poly[i] & NTRU_Q_MASK);
+    for (nbits += NTRU_Q_BITS; nbits >= 8; nbits -= 8)
+      *out++ = (UINT8) (acc >> (nbits - 8));
+  }
+  if (nbits > 0) *out = (UINT8) (acc << (8 - nbits));
+}
+
+
+// Unpacks NTRU_PACKED_LEN bytes into the N coefficients of poly. Returns 1
+// on success and 0 if the padding bits are not 0, so that every polynomial
+// has exactly one valid encoding.
+
+int ntru_unpack(UINT16 *poly, const UINT8 *in)
+{
+  UINT32 acc = 0;
+  int i, nbits = 0;
+
+  for (i = 0; i+8 <= NTRU_N; i += 8, in += NTRU_Q_BITS) unpack8(&poly[i], in);
+  for (; i < NTRU_N; i ++)
+  {
+    while (nbits < NTRU_Q_BITS)
+    {
+      acc = (acc << 8) | *in++;
+      nbits += 8;
+    }
+    nbits -= NTRU_Q_BITS;
+    poly[i] = (UINT16) (acc >> nbits) & NTRU_Q_MASK;
+  }
+
+  return (acc & ((1U << nbits) - 1)) == 0;
+}
@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////////////////////
+// ntru_kem.h: NTRUEncrypt key encapsulation for product-form parameter sets.//
+// Written for tinydtls on top of the QUASIKOM ring arithmetic (project      //
+// repository <https://www.github.com/grojoh/quasikom/>), not part of a      //
+// QUASIKOM release.                                                         //
+// License: GPLv3 (see LICENSE file), like the QUASIKOM code it builds on.   //
+// Copyright (C) 2026 the tinydtls contributors.                             //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _NTRU_KEM_H
+#define _NTRU_KEM_H
+
+#include "typedefs.h"
+
+// The parameter set is selected at compile time by defining NTRU_PARAM_SET
+// as the ring degree N of one of the product-form parameter sets of EESS #1
+// v3.1, i.e. 401 (EES401EP2, the default), 443 (EES443EP1), 587 (EES587EP1)
+// or 743 (EES743EP1). All arrays of the KEM then have a constant size. The
+// ring arithmetic takes N and q as arguments; its kernels process 8 (or 16)
+// coefficients per pass for any N.
+
+#ifndef NTRU_PARAM_SET
+#define NTRU_PARAM_SET 401
+#endif
+
+#if NTRU_PARAM_SET == 401
+#define NTRU_PARAM_NAME "EES401EP2"
+#define NTRU_N      401  // ring degree
+#define NTRU_Q      2048 // modulus q
+#define NTRU_Q_BITS 11   // log2(q), i.e. coefficients have 11 bits
+#define NTRU_DF1    8    // number of +1 (and of -1) coefficients in F1
+#define NTRU_DF2    8    // number of +1 (and of -1) coefficients in F2
+#define NTRU_DF3    6    // number of +1 (and of -1) coefficients in F3
+#define NTRU_DG     133  // number of +1 (and of -1) coefficients in g
+#define NTRU_DM0    101  // minimum number of -1, 0, and +1 coeffs in m
+#define NTRU_C      11   // number of bits used to generate an index
+#elif NTRU_PARAM_SET == 443
+#define NTRU_PARAM_NAME "EES443EP1"
+#define NTRU_N      443
+#define NTRU_Q      2048
+#define NTRU_Q_BITS 11
+#define NTRU_DF1    9
+#define NTRU_DF2    8
+#define NTRU_DF3    5
+#define NTRU_DG     148
+#define NTRU_DM0    115
+#define NTRU_C      9
+#elif NTRU_PARAM_SET == 587
+#define NTRU_PARAM_NAME "EES587EP1"
+#define NTRU_N      587
+#define NTRU_Q      2048
+#define NTRU_Q_BITS 11
+#define NTRU_DF1    10
+#define NTRU_DF2    10
+#define NTRU_DF3    8
+#define NTRU_DG     196
+#define NTRU_DM0    157
+#define NTRU_C      11
+#elif NTRU_PARAM_SET == 743
+#define NTRU_PARAM_NAME "EES743EP1"
+#define NTRU_N      743
+#define NTRU_Q      2048
+#define NTRU_Q_BITS 11
+#define NTRU_DF1    11
+#define NTRU_DF2    11
+#define NTRU_DF3    15
+#define NTRU_DG     247
+#define NTRU_DM0    204
+#define NTRU_C      13
+#else
+#error "NTRU_PARAM_SET must be 401, 443, 587, or 743"
+#endif
+
+// If NTRU_CONST_TIME is defined, all multiplications with a secret sparse
+// polynomial, i.e. F*c in decapsulation and r*h in encapsulation and in the
+// re-encryption check, use the constant-time ring_mul_sparse_ct_ws(), so that
+// neither the private key nor the message leaks through the data cache on a
+// shared host. The multiplication itself is 4.7 to 14 times slower than with
+// ring_mul_sparse_ws(), decapsulation about 3.3 (EES401EP2) to 4 (EES743EP1)
+// times (see ntru_bench). It is off by default, since the TLS key exchange
+// uses ephemeral keys; ./configure --enable-ntru-const-time turns it on.
+
+// N+7 elements as required by ring_mul_sparse_ws()
+#define NTRU_ALEN (NTRU_N + 7)
+
+// length of the index array of a product-form polynomial F = F1*F2 + F3
+#define NTRU_SPARSE_LEN (2*(NTRU_DF1 + NTRU_DF2 + NTRU_DF3))
+
+// length in bytes of a public key or ciphertext packed by ntru_pack(), i.e.
+// N coefficients of NTRU_Q_BITS bits each (552 bytes for EES401EP2)
+#define NTRU_PACKED_LEN ((NTRU_N*NTRU_Q_BITS + 7)/8)
+
+#define NTRU_SEED_LEN 32  // length of the random seeds in bytes
+#define NTRU_KEY_LEN  32  // length of the shared secret in bytes
+
+// The public key h = 3*g/f mod q, extended to N+7 coefficients with h[N+i]
+// = h[i] so that it can be used directly as operand of ring_mul_sparse_ws().
+
+typedef struct ntru_public_key {
+  UINT16 h[NTRU_ALEN];
+} NTRU_PUBLIC_KEY;
+
+// The private key f = 1 + 3*F is stored as the indices of F in product form.
+// The public key is needed for the re-encryption check in ntru_decaps() and
+// the secret z for the key that it returns when the check fails.
+
+typedef struct ntru_private_key {
+  UINT16 f_indices[NTRU_SPARSE_LEN];
+  NTRU_PUBLIC_KEY pub;
+  UINT8 z[NTRU_SEED_LEN];
+} NTRU_PRIVATE_KEY;
+
+// function prototypes
+
+int ntru_keygen(NTRU_PRIVATE_KEY *priv, NTRU_PUBLIC_KEY *pub,
+                const UINT8 *seed);
+void ntru_encaps(UINT16 *c, UINT8 *key, const NTRU_PUBLIC_KEY *pub,
+                 const UINT8 *seed);
+void ntru_decaps(UINT8 *key, const NTRU_PRIVATE_KEY *priv, const UINT16 *c);
+void ntru_pack(UINT8 *out, const UINT16 *poly);
+int ntru_unpack(UINT16 *poly, const UINT8 *in);
+
+#endif
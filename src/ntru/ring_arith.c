@@ -89,18 +89,37 @@ void ring_mul_cfsub_c99(UINT16 *r, const UINT16 *a, UINT16 *b, int alen,
 }
 
 
+// Reduction of a 16-bit integer modulo 3. This is the portable counterpart
+// of the Assembler function int16_mod3() in avrasm/mod3.S. Since 3 is a
+// constant, compilers replace the division by a multiplication, i.e. the
+// execution time does not depend on a.
+
+UINT16 int16_mod3_c99(UINT16 a)
+{
+  return a % 3;
+}
+
+
 // Multiplication of a polynomial a(X) of degree N-1 by a sparse polynimial
 // b(X) in product form, i.e. b(X) = b1(X)*b2(X) + b3(X). The multiplication
 // is a "convolution" performed in the ring (Z/qZ)[X]/(X^N - 1). This function
 // corresponds to the function ntru_ring_mult_product_indices() of the NTRU
-// reference implementation on Github.
+// reference implementation on Github. It works for any N (alen = N+7), any
+// weights of b1, b2, b3, and any power of two q <= 2^16; the kernels always
+// process 8 (or 16) coefficients per pass, independent of the parameters.
+// The temporary polynomial and the copies of the indices, which the kernels
+// overwrite, are kept in the workspace ws of ring_mul_sparse_ws_size() bytes
+// provided by the caller, so that the indices of b remain unchanged and the
+// function does not allocate any memory on the stack.
 
-void ring_mul_sparse(UINT16 *r, const UINT16 *a, const SPARSE_POLY *b, \
-                     int alen)
+void ring_mul_sparse_ws(UINT16 *r, const UINT16 *a, const SPARSE_POLY *b, \
+                        int alen, UINT16 q, void *ws)
 {
   int j = 0, rlen = 8*(alen>>3);  // rlen must be >= N and a multiple of 8
-  int i, blen, bmax = (MAX(MAX(b->p1i_len, b->p2i_len), b->p3i_len)) >> 1;
-  UINT16 rtmp[rlen], btmp[bmax];
+  int i, blen;
+  // rtmp is the first operand of the second multiplication and needs alen
+  // elements, which is more than rlen when N+7 is not a multiple of 8
+  UINT16 *rtmp = (UINT16 *) ws, *btmp = rtmp + RING_MUL_SPARSE_RTMP_LEN(alen);
   
   // initialize r and rtmp
   for (i = 0; i < rlen; i ++) r[i] = rtmp[i] = 0;
@@ -127,8 +146,294 @@ void ring_mul_sparse(UINT16 *r, const UINT16 *a, const SPARSE_POLY *b, \
   for (i = 0; i < blen; i ++) btmp[i] = b->indices[j++];
   ring_mul_cfsub(r, a, btmp, alen, blen);
   
-  // reduce the coefficients of r modulo 2048
-  for (i = 0; i < alen-7; i ++) r[i] &= 0x07FF;
+  // reduce the coefficients of r modulo q
+  for (i = 0; i < alen-7; i ++) r[i] &= q-1;
+}
+
+
+// Size of the workspace in bytes that ring_mul_sparse_ws() requires for a
+// multiplication with alen = N+7 and the sparse polynomial b.
+
+size_t ring_mul_sparse_ws_size(int alen, const SPARSE_POLY *b)
+{
+  int bmax = (MAX(MAX(b->p1i_len, b->p2i_len), b->p3i_len)) >> 1;
+  
+  return RING_MUL_SPARSE_WS_SIZE(alen, bmax);
+}
+
+
+// Rotation of a polynomial a(X) of degree N-1 by idx positions, i.e. the
+// result is a(X)*X^idx mod (X^N - 1), with a "barrel shifter." In step k,
+// the intermediate result is rotated by 2^k positions if bit k of idx is set
+// and left unchanged otherwise, whereby the selection is done with a mask
+// instead of a branch. Hence, the sequence of memory accesses and operations
+// only depends on N, but not on idx. The array tmp must have space for 2*N
+// coefficients; the returned pointer refers to one of its two halves (or to
+// a when N = 1).
+
+static const UINT16 *ring_rotate_ct(UINT16 *tmp, const UINT16 *a, UINT16 idx,
+                                    int N)
+{
+  const UINT16 *src = a;
+  UINT16 *dst = tmp, mask;
+  int i, s;
+
+  for (s = 1; s < N; s <<= 1)
+  {
+    mask = (UINT16) (0 - (idx & 1));
+    for (i = 0; i < s; i ++) dst[i] = src[i] ^ ((src[i] ^ src[N-s+i]) & mask);
+    for (i = s; i < N; i ++) dst[i] = src[i] ^ ((src[i] ^ src[i-s]) & mask);
+    idx >>= 1;
+    src = dst;
+    dst = (dst == tmp) ? tmp + N : tmp;
+  }
+
+  return src;
+}
+
+
+// Constant-time counterparts of ring_mul_cfadd_c99() and ring_mul_cfsub_c99()
+// for secret indices such as those of the private key. The kernels above load
+// a[idx] from secret positions idx, which can leak the indices through the
+// data cache when other processes run on the same CPU. Here, a is rotated by
+// each index with ring_rotate_ct() and the result is added to (subtracted
+// from) r[0], ..., r[8*(alen>>3)-1]. The array b is not modified and tmp must
+// have RING_MUL_CT_TMP_LEN(alen) elements (the C99 version uses only 2*N).
+
+void ring_mul_cfadd_ct_c99(UINT16 *r, const UINT16 *a, const UINT16 *b,
+                           int alen, int blen, UINT16 *tmp)
+{
+  int N = alen-7, loop_cnt = 8*(alen>>3), i, j;
+  const UINT16 *ar;
+
+  for (j = 0; j < blen; j ++)
+  {
+    ar = ring_rotate_ct(tmp, a, b[j], N);
+    for (i = 0; i < N; i ++) r[i] += ar[i];
+    for (i = N; i < loop_cnt; i ++) r[i] += ar[i-N];
+  }
+}
+
+
+void ring_mul_cfsub_ct_c99(UINT16 *r, const UINT16 *a, const UINT16 *b,
+                           int alen, int blen, UINT16 *tmp)
+{
+  int N = alen-7, loop_cnt = 8*(alen>>3), i, j;
+  const UINT16 *ar;
+
+  for (j = 0; j < blen; j ++)
+  {
+    ar = ring_rotate_ct(tmp, a, b[j], N);
+    for (i = 0; i < N; i ++) r[i] -= ar[i];
+    for (i = N; i < loop_cnt; i ++) r[i] -= ar[i-N];
+  }
+}
+
+
+// Constant-time version of ring_mul_sparse_ws(). The execution time and the
+// memory access pattern only depend on alen and the number of indices of
+// b1, b2, and b3, but not on their values. The workspace ws must have a size
+// of RING_MUL_SPARSE_CT_WS_SIZE(alen) bytes. This function is considerably
+// slower than ring_mul_sparse_ws() and should be used when the indices of b
+// are a long-term secret and the code runs on a shared (multi-tenant) host.
+
+void ring_mul_sparse_ct_ws(UINT16 *r, const UINT16 *a, const SPARSE_POLY *b, \
+                           int alen, UINT16 q, void *ws)
+{
+  int rlen = 8*(alen>>3);  // rlen must be >= N and a multiple of 8
+  int i, blen;
+  const UINT16 *idx = b->indices;
+  UINT16 *rtmp = (UINT16 *) ws, *tmp = rtmp + RING_MUL_SPARSE_RTMP_LEN(alen);
+
+  // initialize r and rtmp
+  for (i = 0; i < rlen; i ++) r[i] = rtmp[i] = 0;
+
+  // first multiplication: rtmp = a*b1
+  blen = b->p1i_len >> 1;
+  ring_mul_cfadd_ct(rtmp, a, idx, alen, blen, tmp);
+  ring_mul_cfsub_ct(rtmp, a, idx + blen, alen, blen, tmp);
+  idx += 2*blen;
+
+  // second multiplication: r = rtmp*b2 = a*b1*b2
+  blen = b->p2i_len >> 1;
+  ring_mul_cfadd_ct(r, rtmp, idx, alen, blen, tmp);
+  ring_mul_cfsub_ct(r, rtmp, idx + blen, alen, blen, tmp);
+  idx += 2*blen;
+
+  // third multiplication: r = r + a*b3 = a*(b1*b2 + b3)
+  blen = b->p3i_len >> 1;
+  ring_mul_cfadd_ct(r, a, idx, alen, blen, tmp);
+  ring_mul_cfsub_ct(r, a, idx + blen, alen, blen, tmp);
+
+  // reduce the coefficients of r modulo q
+  for (i = 0; i < alen-7; i ++) r[i] &= q-1;
+}
+
+
+// Multiplication of two dense polynomials a(X) and b(X) of degree N-1 in the
+// ring (Z/2^16Z)[X]/(X^N - 1) using the schoolbook method. The result can be
+// reduced modulo any power of two q <= 2^16 by masking the coefficients. The
+// arrays a, b, and r must contain (at least) N elements and r must not be
+// the same array as a or b. This function is only used in key generation,
+// where one of the operands is not sparse. The array tmp must have
+// RING_MUL_DENSE_TMP_LEN(N) elements (the C99 version does not use it).
+
+void ring_mul_dense_c99(UINT16 *r, const UINT16 *a, const UINT16 *b, int N,
+                        UINT16 *tmp)
+{
+  int i, j, k;
+  
+  (void) tmp;
+  
+  for (i = 0; i < N; i ++) r[i] = 0;
+  
+  for (i = 0; i < N; i ++)
+  {
+    k = i;
+    for (j = 0; j < N; j ++)
+    {
+      r[k] += a[i]*b[j];
+      k = (k == N-1) ? 0 : k+1;
+    }
+  }
+}
+
+
+// Arithmetic for polynomials over GF(2) that are packed into 32-bit words,
+// i.e. coefficient i is bit (i & 31) of word i >> 5. The shift amount s of
+// the following functions must be in the range [1, 31].
+
+// number of 32-bit words for a polynomial with n coefficients
+#define POLY2_WORDS(n) (((n) + 31) >> 5)
+
+// Extraction of s bits starting at bit position pos
+static UINT32 poly2_bits(const UINT32 *a, int pos, int s)
+{
+  int w = pos >> 5, off = pos & 31;
+  UINT32 v = a[w] >> off;
+  
+  if (off + s > 32) v |= a[w+1] << (32 - off);
+  
+  return v & ((1UL << s) - 1);
+}
+
+
+// a(X) = a(X)/X^s for a polynomial of nw words whose s lowest bits are 0
+static void poly2_shr(UINT32 *a, int nw, int s)
+{
+  int i;
+  
+  for (i = 0; i < nw-1; i ++) a[i] = (a[i] >> s) | (a[i+1] << (32 - s));
+  a[nw-1] >>= s;
+}
+
+
+// a(X) = a(X)*X^s mod (X^N - 1) for a polynomial of N coefficients
+static void poly2_rotl(UINT32 *a, int N, int s)
+{
+  int i, nw = POLY2_WORDS(N);
+  UINT32 top = poly2_bits(a, N-s, s);
+  
+  for (i = nw-1; i > 0; i --) a[i] = (a[i] << s) | (a[i-1] >> (32 - s));
+  a[0] = (a[0] << s) | top;
+  if (N & 31) a[nw-1] &= (1UL << (N & 31)) - 1;
+}
+
+
+// degree of a polynomial (-1 for the zero polynomial), starting the search
+// at the coefficient d, which must be >= the actual degree
+static int poly2_degree(const UINT32 *a, int d)
+{
+  int w = d >> 5;
+  UINT32 v = a[w] & (0xFFFFFFFFUL >> (31 - (d & 31)));
+  
+  while (v == 0)
+  {
+    if (w-- == 0) return -1;
+    v = a[w];
+  }
+  for (d = 31; (v >> d) == 0; d --);
+  
+  return 32*w + d;
+}
+
+
+// Inversion of a polynomial f(X) of degree N-1 in the ring (Z/qZ)[X]/(X^N-1)
+// where q is a power of two <= 2^16. First the inverse modulo 2 is computed
+// with the "almost inverse" algorithm of NTRU Technical Report #14 and then
+// lifted to an inverse modulo q by Newton iterations b = b*(2 - f*b), each of
+// which doubles the number of correct bits (2, 4, 8, 16), until it is at
+// least log2(q). The polynomials of the almost inverse algorithm are packed
+// into 32-bit words, so that adding g to f (and c to b) takes N/32 XORs and
+// all zero coefficients at the bottom of f are removed with a single shift.
+// Since b and c are only needed modulo X^N - 1, they are multiplied by X^s
+// with a rotation. The function returns 0 if f(X) is not invertible modulo
+// 2, and 1 otherwise. The inverse modulo 3 is not needed for NTRU keys in
+// product form since f = 1 + 3*F is always 1 modulo 3. The four packed poly-
+// nomials, two temporary polynomials for the Newton iterations, and the
+// array tmp of ring_mul_dense() are kept in the workspace ws of
+// RING_INV_Q_WS_SIZE(N) bytes, which must be aligned to four bytes.
+
+int ring_inv_q(UINT16 *r, const UINT16 *f, int N, UINT16 q, void *ws)
+{
+  int nw = POLY2_WORDS(N+1);  // f and g have up to N+1 coefficients
+  UINT32 *fp = (UINT32 *) ws, *gp = fp + nw, *bp = gp + nw, *cp = bp + nw;
+  UINT32 *tp, prec;
+  UINT16 *t = (UINT16 *) (cp + nw), *u = t + N, *tmp = u + N;
+  int i, s, k = 0, df, dg = N, dt;
+  
+  // f = f mod 2, g = X^N - 1 = X^N + 1 mod 2, b = 1, c = 0
+  for (i = 0; i < nw; i ++) fp[i] = gp[i] = bp[i] = cp[i] = 0;
+  for (i = 0; i < N; i ++) fp[i >> 5] |= (UINT32) (f[i] & 1) << (i & 31);
+  gp[0] = bp[0] = 1;
+  gp[N >> 5] |= 1UL << (N & 31);
+  df = poly2_degree(fp, N);
+  
+  while (1)
+  {
+    if (df < 0) return 0;  // f(X) has a common factor with X^N - 1
+    // divide f by X^s and multiply c by X^s until the constant term of f is 1
+    while ((fp[0] & 1) == 0)
+    {
+      for (s = 1; (s < 31) && (((fp[0] >> s) & 1) == 0); s ++);
+      poly2_shr(fp, POLY2_WORDS(df+1), s);
+      poly2_rotl(cp, N, s);
+      df -= s;
+      k += s;
+    }
+    if (df == 0) break;  // f = 1, i.e. b(X) = X^k * f(X)^-1 mod 2
+    if (df < dg)
+    {
+      tp = fp; fp = gp; gp = tp; tp = bp; bp = cp; cp = tp;
+      dt = df; df = dg; dg = dt;
+    }
+    for (i = 0; i <= (dg >> 5); i ++) fp[i] ^= gp[i];
+    for (i = 0; i < nw; i ++) bp[i] ^= cp[i];
+    df = poly2_degree(fp, df);
+  }
+  
+  // r = X^-k * b(X) mod (X^N - 1)
+  k %= N;
+  for (i = 0; i < N; i ++)
+  {
+    s = (i+k < N) ? i+k : i+k-N;
+    r[i] = (bp[s >> 5] >> (s & 31)) & 1;
+  }
+  
+  // Newton iteration: r = r*(2 - f*r) until r is correct modulo q
+  for (prec = 2; prec < q; prec *= prec)  // r is correct modulo prec
+  {
+    ring_mul_dense(t, f, r, N, tmp);
+    for (i = 0; i < N; i ++) t[i] = -t[i];
+    t[0] += 2;
+    ring_mul_dense(u, r, t, N, tmp);
+    for (i = 0; i < N; i ++) r[i] = u[i];
+  }
+  
+  // reduce the coefficients of r modulo q
+  for (i = 0; i < N; i ++) r[i] &= q-1;
+  
+  return 1;
 }
 
 
@@ -163,7 +468,6 @@ void test_ring_mul_11(void)
 void test_ring_mul_401(void)
 {
   int i, N = 401, alen = 408;  // our implementation requires alen = N+7
-  int rlen = 408;              // rlen must be >= N and a multiple of eight
   UINT16 a401[408] = { A401COEFFS };  // A401COEFFS is defined in testvec.h
   UINT16 b401[44] = { B401COEFFS };   // B401COEFFS is defined in testvec.h
   // The polynomial b is a sparse polynomial in "product form," which means it
@@ -171,12 +475,13 @@ void test_ring_mul_401(void)
   // coefficients (namely eight +1 and eight -1 coefficients), while b3 has 12
   // non-zero coefficients, half of which are +1 and the other half are -1.
   SPARSE_POLY b = { &(b401[0]), 16, 16, 12 };
-  UINT16 r[rlen];
+  UINT16 r[408];  // r must have >= N elements and a multiple of eight
+  UINT16 ws[RING_MUL_SPARSE_WS_SIZE(408, 8)/sizeof(UINT16)];
   
   // our implementation requires the array A to have a length of N+7 elements,
   // whereby A[N] = A[0], A[N+1] = A[1], ..., and A[N+6] = A[6].
   for (i = 0; i < 7; i ++) a401[(alen-7)+i] = a401[i];  
-  ring_mul_sparse(r, a401, &b, alen);
+  ring_mul_sparse_ws(r, a401, &b, alen, 2048, ws);
   
   printf("r = { ");
   for (i = 0; i < N-1; i ++) printf("%03x, ", r[i]);
@@ -23,23 +23,72 @@
 #ifndef _RING_ARITH_H
 #define _RING_ARITH_H
 
+#include <stddef.h>
 #include "typedefs.h"
 
 // struct for sparse polynomial in product form (i.e. p = p1*p2 + p3)
 
 typedef struct sparse_polynomial {
-  UINT16 *indices;  // indices of non-zero coeffs (for all three polynomials)
+  const UINT16 *indices;  // indices of non-zero coeffs (all three polys)
   UINT16 p1i_len;   // number of +1 or -1 coefficients in polynomial p1
   UINT16 p2i_len;   // number of +1 or -1 coefficients in polynomial p2
   UINT16 p3i_len;   // number of +1 or -1 coefficients in polynomial p3
 } SPARSE_POLY;
 
+// Size in bytes of the workspace of ring_mul_sparse_ws() for alen = N+7 and
+// a sparse polynomial whose largest factor has bmax coefficients equal to +1
+// (and to -1), i.e. bmax = max(p1i_len, p2i_len, p3i_len)/2. The workspace
+// holds a temporary polynomial of alen coefficients, rounded up to a multiple
+// of 16 so that the copy of the indices behind it stays 32-byte aligned, if
+// the workspace is. The same size is returned by ring_mul_sparse_ws_size().
+
+#define RING_MUL_SPARSE_RTMP_LEN(alen) (((alen) + 15) & ~15)
+#define RING_MUL_SPARSE_WS_SIZE(alen, bmax) \
+  ((RING_MUL_SPARSE_RTMP_LEN(alen) + (bmax))*sizeof(UINT16))
+
+// Number of elements of the array tmp of the constant-time kernels, i.e.
+// three buffers with space for the vector loads and stores beyond a[N-1],
+// and size in bytes of the workspace of ring_mul_sparse_ct_ws(), which holds
+// the temporary polynomial and the array tmp.
+
+#define RING_MUL_CT_TMP_LEN(alen) (3*(RING_MUL_SPARSE_RTMP_LEN(alen) + 16))
+#define RING_MUL_SPARSE_CT_WS_SIZE(alen) \
+  ((RING_MUL_SPARSE_RTMP_LEN(alen) + RING_MUL_CT_TMP_LEN(alen)) * \
+   sizeof(UINT16))
+
+// Number of elements of the array tmp of ring_mul_dense(), i.e. the operand
+// b extended to 2N+16 coefficients and the result rounded up to a multiple
+// of 16 coefficients.
+
+#define RING_MUL_DENSE_TMP_LEN(N) (2*(N) + 16 + (((N) + 15) & ~15))
+
+// Size in bytes of the workspace of ring_inv_q(), i.e. four polynomials mod
+// 2 with N+1 coefficients packed into 32-bit words, two polynomials with N
+// coefficients, and the array tmp of ring_mul_dense().
+
+#define RING_INV_Q_WS_SIZE(N) \
+  (4*(((N) + 32) >> 5)*sizeof(UINT32) + \
+   (2*(N) + RING_MUL_DENSE_TMP_LEN(N))*sizeof(UINT16))
+
 // function prototypes
 
 void ring_mul_cfadd_c99(UINT16 *r, const UINT16 *a, UINT16 *b, int alen,
                         int blen);
 void ring_mul_cfsub_c99(UINT16 *r, const UINT16 *a, UINT16 *b, int alen,
                         int blen);
+UINT16 int16_mod3_c99(UINT16 a);
+void ring_mul_sparse_ws(UINT16 *r, const UINT16 *a, const SPARSE_POLY *b,
+                        int alen, UINT16 q, void *ws);
+size_t ring_mul_sparse_ws_size(int alen, const SPARSE_POLY *b);
+void ring_mul_cfadd_ct_c99(UINT16 *r, const UINT16 *a, const UINT16 *b,
+                           int alen, int blen, UINT16 *tmp);
+void ring_mul_cfsub_ct_c99(UINT16 *r, const UINT16 *a, const UINT16 *b,
+                           int alen, int blen, UINT16 *tmp);
+void ring_mul_sparse_ct_ws(UINT16 *r, const UINT16 *a, const SPARSE_POLY *b,
+                           int alen, UINT16 q, void *ws);
+void ring_mul_dense_c99(UINT16 *r, const UINT16 *a, const UINT16 *b, int N,
+                        UINT16 *tmp);
+int ring_inv_q(UINT16 *r, const UINT16 *f, int N, UINT16 q, void *ws);
 void test_ring_mul_11(void);
 void test_ring_mul_401(void);
 
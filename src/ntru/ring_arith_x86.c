@@ -0,0 +1,451 @@
+///////////////////////////////////////////////////////////////////////////////
+// ring_arith_x86.c: SSE2 and AVX2 versions of the convolution kernels.      //
+// Written for tinydtls on top of the QUASIKOM ring arithmetic (project      //
+// repository <https://www.github.com/grojoh/quasikom/>), not part of a      //
+// QUASIKOM release.                                                         //
+// License: GPLv3 (see LICENSE file), like the QUASIKOM code it builds on.   //
+// Copyright (C) 2026 the tinydtls contributors.                             //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "asmfncts.h"
+#include "ring_arith.h"
+
+#ifdef RING_MUL_X86
+
+#include <immintrin.h>
+
+
+// The kernels compute the same result as ring_mul_cfadd_c99() and
+// ring_mul_cfsub_c99(), i.e. r[i] = r[i] +/- sum of a[(i-b[j]) mod N] for
+// 0 <= i < 8*(alen>>3), but they add up 8 (SSE2) or 16 (AVX2) coefficients
+// in the lanes of a vector register instead of 8 scalar registers. As in
+// the C99 version, the array b is overwritten.
+
+__attribute__((target("sse2")))
+static void ring_mul_cf_sse2(UINT16 *r, const UINT16 *a, UINT16 *b, int alen,
+                             int blen, int neg)
+{
+  int N = alen-7, loop_cnt = 8*(alen>>3), i, j;
+  __m128i sum;
+  UINT16 idx;
+
+  for (j = 0; j < blen; j ++) b[j] = (b[j] == 0) ? 0 : N - b[j];
+
+  for (i = 0; i < loop_cnt; i += 8)
+  {
+    sum = _mm_setzero_si128();
+    for (j = 0; j < blen; j ++)
+    {
+      idx = b[j];
+      sum = _mm_add_epi16(sum, _mm_loadu_si128((const __m128i *) &a[idx]));
+      idx += 8;
+      b[j] = (idx >= N) ? (idx - N) : idx;
+    }
+    if (neg) sum = _mm_sub_epi16(_mm_loadu_si128((__m128i *) &r[i]), sum);
+    else sum = _mm_add_epi16(_mm_loadu_si128((__m128i *) &r[i]), sum);
+    _mm_storeu_si128((__m128i *) &r[i], sum);
+  }
+}
+
+
+// A 16-coefficient load of the AVX2 kernel starting at a[idx] would reach
+// a[idx+15], but the caller only provides a[0], ..., a[N+6]. Therefore, the
+// two halves are loaded separately from a[idx] and a[(idx+8) mod N] when idx
+// exceeds N-9. The last 8 coefficients (if any) are processed with a 128-bit
+// vector like in the SSE2 kernel.
+
+__attribute__((target("avx2")))
+static __m256i load_cyclic_avx2(const UINT16 *a, int N, UINT16 idx)
+{
+  UINT16 idx2 = idx + 8;
+  __m128i lo, hi;
+
+  if (idx + 9 <= N) return _mm256_loadu_si256((const __m256i *) &a[idx]);
+  lo = _mm_loadu_si128((const __m128i *) &a[idx]);
+  if (idx2 >= N) idx2 -= N;
+  hi = _mm_loadu_si128((const __m128i *) &a[idx2]);
+
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+
+__attribute__((target("avx2")))
+static void ring_mul_cf_avx2(UINT16 *r, const UINT16 *a, UINT16 *b, int alen,
+                             int blen, int neg)
+{
+  int N = alen-7, loop_cnt = 8*(alen>>3), i, j;
+  __m256i sum, rv;
+  __m128i sum8;
+  UINT16 idx;
+
+  for (j = 0; j < blen; j ++) b[j] = (b[j] == 0) ? 0 : N - b[j];
+
+  for (i = 0; i+16 <= loop_cnt; i += 16)
+  {
+    sum = _mm256_setzero_si256();
+    for (j = 0; j < blen; j ++)
+    {
+      idx = b[j];
+      sum = _mm256_add_epi16(sum, load_cyclic_avx2(a, N, idx));
+      idx += 16;
+      while (idx >= N) idx -= N;
+      b[j] = idx;
+    }
+    rv = _mm256_loadu_si256((__m256i *) &r[i]);
+    sum = neg ? _mm256_sub_epi16(rv, sum) : _mm256_add_epi16(rv, sum);
+    _mm256_storeu_si256((__m256i *) &r[i], sum);
+  }
+
+  if (i < loop_cnt)
+  {
+    sum8 = _mm_setzero_si128();
+    for (j = 0; j < blen; j ++)
+      sum8 = _mm_add_epi16(sum8, _mm_loadu_si128((const __m128i *) &a[b[j]]));
+    if (neg) sum8 = _mm_sub_epi16(_mm_loadu_si128((__m128i *) &r[i]), sum8);
+    else sum8 = _mm_add_epi16(_mm_loadu_si128((__m128i *) &r[i]), sum8);
+    _mm_storeu_si128((__m128i *) &r[i], sum8);
+  }
+}
+
+
+// Constant-time kernels, see ring_mul_cfadd_ct_c99(). The operand a is first
+// copied into the first buffer of tmp so that the vector loads beyond a[N-1]
+// stay within the workspace. Then, for each index b[j], a is rotated in
+// ceil(log2(N)) steps, whereby step k selects either the previous result or
+// its rotation by s = 2^k positions with a mask derived from bit k of b[j].
+// The loads and stores of a step can exceed the N coefficients of a buffer
+// by up to 15 elements, which RING_MUL_CT_TMP_LEN() takes into account; the
+// garbage stored there is never used. Finally, the rotation is extended to
+// N+7 coefficients and added to (or subtracted from) r.
+
+__attribute__((target("sse2")))
+static void ring_mul_cf_ct_sse2(UINT16 *r, const UINT16 *a, const UINT16 *b,
+                                int alen, int blen, UINT16 *tmp, int neg)
+{
+  int N = alen-7, loop_cnt = 8*(alen>>3), blk = RING_MUL_CT_TMP_LEN(alen)/3;
+  UINT16 *src, *dst, *buf[2] = { tmp + blk, tmp + 2*blk };
+  __m128i x, y, m, rv;
+  int i, j, s, k;
+
+  for (i = 0; i < N; i ++) tmp[i] = a[i];
+
+  for (j = 0; j < blen; j ++)
+  {
+    src = tmp;
+    for (s = 1, k = 0; s < N; s <<= 1, k ++)
+    {
+      dst = buf[k & 1];
+      m = _mm_set1_epi16((short) (0 - ((b[j] >> k) & 1)));
+      for (i = 0; i < s; i += 8)
+      {
+        x = _mm_loadu_si128((const __m128i *) &src[i]);
+        y = _mm_loadu_si128((const __m128i *) &src[N-s+i]);
+        y = _mm_and_si128(_mm_xor_si128(x, y), m);
+        _mm_storeu_si128((__m128i *) &dst[i], _mm_xor_si128(x, y));
+      }
+      for (i = s; i < N; i += 8)
+      {
+        x = _mm_loadu_si128((const __m128i *) &src[i]);
+        y = _mm_loadu_si128((const __m128i *) &src[i-s]);
+        y = _mm_and_si128(_mm_xor_si128(x, y), m);
+        _mm_storeu_si128((__m128i *) &dst[i], _mm_xor_si128(x, y));
+      }
+      src = dst;
+    }
+    for (i = 0; i < 7; i ++) src[N+i] = src[i];
+    for (i = 0; i < loop_cnt; i += 8)
+    {
+      x = _mm_loadu_si128((const __m128i *) &src[i]);
+      rv = _mm_loadu_si128((__m128i *) &r[i]);
+      rv = neg ? _mm_sub_epi16(rv, x) : _mm_add_epi16(rv, x);
+      _mm_storeu_si128((__m128i *) &r[i], rv);
+    }
+  }
+}
+
+
+__attribute__((target("avx2")))
+static void ring_mul_cf_ct_avx2(UINT16 *r, const UINT16 *a, const UINT16 *b,
+                                int alen, int blen, UINT16 *tmp, int neg)
+{
+  int N = alen-7, loop_cnt = 8*(alen>>3), blk = RING_MUL_CT_TMP_LEN(alen)/3;
+  UINT16 *src, *dst, *buf[2] = { tmp + blk, tmp + 2*blk };
+  __m256i x, y, m, rv;
+  __m128i x8, rv8;
+  int i, j, s, k;
+
+  for (i = 0; i < N; i ++) tmp[i] = a[i];
+
+  for (j = 0; j < blen; j ++)
+  {
+    src = tmp;
+    for (s = 1, k = 0; s < N; s <<= 1, k ++)
+    {
+      dst = buf[k & 1];
+      m = _mm256_set1_epi16((short) (0 - ((b[j] >> k) & 1)));
+      for (i = 0; i < s; i += 16)
+      {
+        x = _mm256_loadu_si256((const __m256i *) &src[i]);
+        y = _mm256_loadu_si256((const __m256i *) &src[N-s+i]);
+        y = _mm256_and_si256(_mm256_xor_si256(x, y), m);
+        _mm256_storeu_si256((__m256i *) &dst[i], _mm256_xor_si256(x, y));
+      }
+      for (i = s; i < N; i += 16)
+      {
+        x = _mm256_loadu_si256((const __m256i *) &src[i]);
+        y = _mm256_loadu_si256((const __m256i *) &src[i-s]);
+        y = _mm256_and_si256(_mm256_xor_si256(x, y), m);
+        _mm256_storeu_si256((__m256i *) &dst[i], _mm256_xor_si256(x, y));
+      }
+      src = dst;
+    }
+    for (i = 0; i < 7; i ++) src[N+i] = src[i];
+    for (i = 0; i+16 <= loop_cnt; i += 16)
+    {
+      x = _mm256_loadu_si256((const __m256i *) &src[i]);
+      rv = _mm256_loadu_si256((__m256i *) &r[i]);
+      rv = neg ? _mm256_sub_epi16(rv, x) : _mm256_add_epi16(rv, x);
+      _mm256_storeu_si256((__m256i *) &r[i], rv);
+    }
+    if (i < loop_cnt)
+    {
+      x8 = _mm_loadu_si128((const __m128i *) &src[i]);
+      rv8 = _mm_loadu_si128((__m128i *) &r[i]);
+      rv8 = neg ? _mm_sub_epi16(rv8, x8) : _mm_add_epi16(rv8, x8);
+      _mm_storeu_si128((__m128i *) &r[i], rv8);
+    }
+  }
+}
+
+
+static void ring_mul_cfadd_ct_sse2(UINT16 *r, const UINT16 *a,
+                                   const UINT16 *b, int alen, int blen,
+                                   UINT16 *tmp)
+{
+  ring_mul_cf_ct_sse2(r, a, b, alen, blen, tmp, 0);
+}
+
+
+static void ring_mul_cfsub_ct_sse2(UINT16 *r, const UINT16 *a,
+                                   const UINT16 *b, int alen, int blen,
+                                   UINT16 *tmp)
+{
+  ring_mul_cf_ct_sse2(r, a, b, alen, blen, tmp, 1);
+}
+
+
+static void ring_mul_cfadd_ct_avx2(UINT16 *r, const UINT16 *a,
+                                   const UINT16 *b, int alen, int blen,
+                                   UINT16 *tmp)
+{
+  ring_mul_cf_ct_avx2(r, a, b, alen, blen, tmp, 0);
+}
+
+
+static void ring_mul_cfsub_ct_avx2(UINT16 *r, const UINT16 *a,
+                                   const UINT16 *b, int alen, int blen,
+                                   UINT16 *tmp)
+{
+  ring_mul_cf_ct_avx2(r, a, b, alen, blen, tmp, 1);
+}
+
+
+// Dense multiplication for key generation, see ring_mul_dense_c99(). The
+// operand b is extended to bx[t] = b[t mod N] for 0 <= t < 2N+16, so that
+// r[i] = sum of a[j]*bx[N+i-j] over 0 <= j < N, and 8 (SSE2) or 16 (AVX2)
+// consecutive coefficients of r are accumulated in a vector register. bx and
+// the result rx, rounded up to a multiple of 16 coefficients, are kept in
+// the array tmp of RING_MUL_DENSE_TMP_LEN(N) elements.
+
+__attribute__((target("sse2")))
+static void ring_mul_dense_sse2(UINT16 *r, const UINT16 *a, const UINT16 *b,
+                                int N, UINT16 *tmp)
+{
+  int rlen = (N + 15) & ~15, i, j;
+  UINT16 *bx = tmp, *rx = tmp + 2*N+16;
+  __m128i acc;
+
+  for (i = 0; i < 2*N+16; i ++) bx[i] = b[i % N];
+
+  for (i = 0; i < rlen; i += 8)
+  {
+    acc = _mm_setzero_si128();
+    for (j = 0; j < N; j ++)
+      acc = _mm_add_epi16(acc, _mm_mullo_epi16(_mm_set1_epi16((short) a[j]),
+            _mm_loadu_si128((const __m128i *) &bx[N+i-j])));
+    _mm_storeu_si128((__m128i *) &rx[i], acc);
+  }
+  for (i = 0; i < N; i ++) r[i] = rx[i];
+}
+
+
+__attribute__((target("avx2")))
+static void ring_mul_dense_avx2(UINT16 *r, const UINT16 *a, const UINT16 *b,
+                                int N, UINT16 *tmp)
+{
+  int rlen = (N + 15) & ~15, i, j;
+  UINT16 *bx = tmp, *rx = tmp + 2*N+16;
+  __m256i acc;
+
+  for (i = 0; i < 2*N+16; i ++) bx[i] = b[i % N];
+
+  for (i = 0; i < rlen; i += 16)
+  {
+    acc = _mm256_setzero_si256();
+    for (j = 0; j < N; j ++)
+      acc = _mm256_add_epi16(acc,
+            _mm256_mullo_epi16(_mm256_set1_epi16((short) a[j]),
+            _mm256_loadu_si256((const __m256i *) &bx[N+i-j])));
+    _mm256_storeu_si256((__m256i *) &rx[i], acc);
+  }
+  for (i = 0; i < N; i ++) r[i] = rx[i];
+}
+
+
+static void ring_mul_cfadd_sse2(UINT16 *r, const UINT16 *a, UINT16 *b,
+                                int alen, int blen)
+{
+  ring_mul_cf_sse2(r, a, b, alen, blen, 0);
+}
+
+
+static void ring_mul_cfsub_sse2(UINT16 *r, const UINT16 *a, UINT16 *b,
+                                int alen, int blen)
+{
+  ring_mul_cf_sse2(r, a, b, alen, blen, 1);
+}
+
+
+static void ring_mul_cfadd_avx2(UINT16 *r, const UINT16 *a, UINT16 *b,
+                                int alen, int blen)
+{
+  ring_mul_cf_avx2(r, a, b, alen, blen, 0);
+}
+
+
+static void ring_mul_cfsub_avx2(UINT16 *r, const UINT16 *a, UINT16 *b,
+                                int alen, int blen)
+{
+  ring_mul_cf_avx2(r, a, b, alen, blen, 1);
+}
+
+
+// Pointers to the selected kernels; they are set by ring_mul_select(), which
+// ring_mul_init() calls before main(). Setting them lazily on the first call
+// would be a data race when several threads start to use the kernels.
+
+typedef void (*RING_MUL_CF)(UINT16 *r, const UINT16 *a, UINT16 *b, int alen,
+                            int blen);
+
+typedef void (*RING_MUL_CF_CT)(UINT16 *r, const UINT16 *a, const UINT16 *b,
+                               int alen, int blen, UINT16 *tmp);
+typedef void (*RING_MUL_DENSE)(UINT16 *r, const UINT16 *a, const UINT16 *b,
+                               int N, UINT16 *tmp);
+
+static RING_MUL_CF cfadd_fn, cfsub_fn;
+static RING_MUL_CF_CT cfadd_ct_fn, cfsub_ct_fn;
+static RING_MUL_DENSE dense_fn;
+
+
+// Selects the kernels used by ring_mul_cfadd() and ring_mul_cfsub(). The
+// argument impl is one of RING_MUL_C99, RING_MUL_SSE2, RING_MUL_AVX2, or
+// RING_MUL_BEST. If the CPU does not support the requested instruction set,
+// the best supported one is used instead. The return value is the selected
+// implementation, so that the test program can run all of them. It must not
+// be called while other threads use the kernels.
+
+int ring_mul_select(int impl)
+{
+  int best = RING_MUL_C99;
+
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse2")) best = RING_MUL_SSE2;
+  if (__builtin_cpu_supports("avx2")) best = RING_MUL_AVX2;
+  if (impl > best) impl = best;
+
+  switch (impl)
+  {
+    case RING_MUL_AVX2:
+      dense_fn = ring_mul_dense_avx2;
+      cfsub_ct_fn = ring_mul_cfsub_ct_avx2;
+      cfadd_ct_fn = ring_mul_cfadd_ct_avx2;
+      cfsub_fn = ring_mul_cfsub_avx2;
+      cfadd_fn = ring_mul_cfadd_avx2;
+      break;
+    case RING_MUL_SSE2:
+      dense_fn = ring_mul_dense_sse2;
+      cfsub_ct_fn = ring_mul_cfsub_ct_sse2;
+      cfadd_ct_fn = ring_mul_cfadd_ct_sse2;
+      cfsub_fn = ring_mul_cfsub_sse2;
+      cfadd_fn = ring_mul_cfadd_sse2;
+      break;
+    default:
+      impl = RING_MUL_C99;
+      dense_fn = ring_mul_dense_c99;
+      cfsub_ct_fn = ring_mul_cfsub_ct_c99;
+      cfadd_ct_fn = ring_mul_cfadd_ct_c99;
+      cfsub_fn = ring_mul_cfsub_c99;
+      cfadd_fn = ring_mul_cfadd_c99;
+  }
+
+  return impl;
+}
+
+
+__attribute__((constructor)) static void ring_mul_init(void)
+{
+  ring_mul_select(RING_MUL_BEST);
+}
+
+
+void ring_mul_cfadd(UINT16 *r, const UINT16 *a, UINT16 *b, int alen,
+                    int blen)
+{
+  cfadd_fn(r, a, b, alen, blen);
+}
+
+
+void ring_mul_cfsub(UINT16 *r, const UINT16 *a, UINT16 *b, int alen,
+                    int blen)
+{
+  cfsub_fn(r, a, b, alen, blen);
+}
+
+
+void ring_mul_dense(UINT16 *r, const UINT16 *a, const UINT16 *b, int N,
+                    UINT16 *tmp)
+{
+  dense_fn(r, a, b, N, tmp);
+}
+
+
+void ring_mul_cfadd_ct(UINT16 *r, const UINT16 *a, const UINT16 *b, int alen,
+                       int blen, UINT16 *tmp)
+{
+  cfadd_ct_fn(r, a, b, alen, blen, tmp);
+}
+
+
+void ring_mul_cfsub_ct(UINT16 *r, const UINT16 *a, const UINT16 *b, int alen,
+                       int blen, UINT16 *tmp)
+{
+  cfsub_ct_fn(r, a, b, alen, blen, tmp);
+}
+
+#else
+
+// ISO C does not allow an empty translation unit
+typedef int RING_ARITH_X86_UNUSED;
+
+#endif
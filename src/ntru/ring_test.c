@@ -0,0 +1,263 @@
+///////////////////////////////////////////////////////////////////////////////
+// ring_test.c: Test of the ring arithmetic against the known test vectors.  //
+// Written for tinydtls on top of the QUASIKOM ring arithmetic (project      //
+// repository <https://www.github.com/grojoh/quasikom/>), not part of a      //
+// QUASIKOM release.                                                         //
+// License: GPLv3 (see LICENSE file), like the QUASIKOM code it builds on.   //
+// Copyright (C) 2026 the tinydtls contributors.                             //
+// ------------------------------------------------------------------------- //
+// This program is free software: you can redistribute it and/or modify it   //
+// under the terms of the GNU General Public License as published by the     //
+// Free Software Foundation, either version 3 of the License, or (at your    //
+// option) any later version. This program is distributed in the hope that   //
+// it will be useful, but WITHOUT ANY WARRANTY; without even the implied     //
+// warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the  //
+// GNU General Public License for more details. You should have received a   //
+// copy of the GNU General Public License along with this program. If not,   //
+// see <http://www.gnu.org/licenses/>.                                       //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <stdio.h>
+#include <string.h>
+#include "asmfncts.h"
+#include "ring_arith.h"
+#include "testvec.h"
+
+
+static const UINT16 a401[408] = { A401COEFFS };
+static const UINT16 b401[44] = { B401COEFFS };
+static const UINT16 t401b1[401] = { T401B1COEFFS };
+static const UINT16 t401b1b2[401] = { T401B1B2COEFFS };
+static const UINT16 t401b3[401] = { T401B3COEFFS };
+static const UINT16 c401[401] = { C401COEFFS };
+static const UINT16 e11[11] = { E11COEFFS };
+static const UINT16 b443[44] = { B443COEFFS };
+static const UINT16 c443[443] = { C443COEFFS };
+static const UINT16 b587[56] = { B587COEFFS };
+static const UINT16 c587[587] = { C587COEFFS };
+static const UINT16 b743[74] = { B743COEFFS };
+static const UINT16 c743[743] = { C743COEFFS };
+
+
+// Compares the first N coefficients of r, reduced modulo q, with the
+// expected result and prints the outcome.
+
+static int check(const char *name, const UINT16 *r, const UINT16 *expected,
+                 int N, UINT16 q)
+{
+  int i;
+
+  for (i = 0; i < N; i ++)
+  {
+    if ((r[i] & (q-1)) != expected[i])
+    {
+      printf("  %s: FAILED at coefficient %i\n", name, i);
+      return 1;
+    }
+  }
+  printf("  %s: ok\n", name);
+
+  return 0;
+}
+
+
+// r = a*b with the +1 indices b[0..len-1] and the -1 indices b[len..2len-1]
+// of a sparse polynomial b; a has N coefficients and is extended to N+7
+
+static void mul_cf(UINT16 *r, const UINT16 *a, const UINT16 *b, int len)
+{
+  UINT16 ax[408], btmp[16];
+  int i;
+
+  for (i = 0; i < 401; i ++) ax[i] = a[i];
+  for (i = 0; i < 7; i ++) ax[401+i] = ax[i];
+  for (i = 0; i < 408; i ++) r[i] = 0;
+  for (i = 0; i < len; i ++) btmp[i] = b[i];
+  ring_mul_cfadd(r, ax, btmp, 408, len);
+  for (i = 0; i < len; i ++) btmp[i] = b[len+i];
+  ring_mul_cfsub(r, ax, btmp, 408, len);
+}
+
+
+// ring_mul_sparse_ws() must leave the indices of the sparse polynomial b
+// unchanged, so that e.g. the private key can be passed without a copy
+
+static int check_indices(const char *name, const SPARSE_POLY *b,
+                         const UINT16 *expected)
+{
+  int len = b->p1i_len + b->p2i_len + b->p3i_len;
+
+  if (memcmp(b->indices, expected, len*sizeof(UINT16)) != 0)
+  {
+    printf("  %s: indices of b modified\n", name);
+    return 1;
+  }
+
+  return 0;
+}
+
+
+// c = a*(b1*b2 + b3) with the constant-time multiplication; a has N+7
+// coefficients and b contains the indices of b1, b2, and b3
+
+static int test_ring_mul_ct(const char *name, const UINT16 *a, int N,
+                            const UINT16 *bidx, int d1, int d2, int d3,
+                            const UINT16 *c)
+{
+  UINT16 r[N+7], ws[RING_MUL_SPARSE_CT_WS_SIZE(N+7)/sizeof(UINT16)];
+  SPARSE_POLY b = { bidx, 2*d1, 2*d2, 2*d3 };
+
+  ring_mul_sparse_ct_ws(r, a, &b, N+7, 2048, ws);
+
+  return check(name, r, c, N, 2048);
+}
+
+
+static int test_ring_mul(void)
+{
+  // toy example of test/magma.txt, see test_ring_mul_11() in ring_arith.c
+  UINT16 h11[18] = { 8, 25, 22, 20, 12, 24, 15, 19, 12, 19, 16, 8, 25, 22, \
+                     20, 12, 24, 15 };
+  UINT16 r11[11] = { 2, 3, 4, 0, 5, 7 };
+  UINT16 m11[11] = { -1, 0, 0, 1, -1, 0, 0, 0, -1, 1, 1 };
+  UINT16 a[408], bcopy[44], r[408], tmp[RING_MUL_CT_TMP_LEN(18)];
+  UINT16 ws[RING_MUL_SPARSE_WS_SIZE(408, 8)/sizeof(UINT16)];
+  SPARSE_POLY b = { bcopy, 16, 16, 12 };
+  int i, err = 0;
+
+  for (i = 0; i < 16; i ++) r[i] = 0;
+  ring_mul_cfadd_ct(r, h11, &(r11[0]), 18, 3, tmp);
+  ring_mul_cfsub_ct(r, h11, &(r11[3]), 18, 3, tmp);
+  for (i = 0; i < 11; i ++) r[i] += m11[i];
+  err += check("e = r*h + m (N = 11, constant time)", r, e11, 11, 32);
+
+  for (i = 0; i < 16; i ++) r[i] = 0;
+  ring_mul_cfadd(r, h11, &(r11[0]), 18, 3);
+  ring_mul_cfsub(r, h11, &(r11[3]), 18, 3);
+  for (i = 0; i < 11; i ++) r[i] += m11[i];
+  err += check("e = r*h + m (N = 11)", r, e11, 11, 32);
+
+  mul_cf(r, a401, &(b401[0]), 8);
+  err += check("t2 = a*b1", r, t401b1, 401, 2048);
+  mul_cf(r, t401b1, &(b401[16]), 8);
+  err += check("t2 = (a*b1)*b2", r, t401b1b2, 401, 2048);
+  mul_cf(r, a401, &(b401[32]), 6);
+  err += check("t = a*b3", r, t401b3, 401, 2048);
+
+  for (i = 0; i < 401; i ++) a[i] = a401[i];
+  for (i = 0; i < 7; i ++) a[401+i] = a[i];
+  for (i = 0; i < 44; i ++) bcopy[i] = b401[i];
+  ring_mul_sparse_ws(r, a, &b, 408, 2048, ws);
+  err += check("c = a*(b1*b2 + b3)", r, c401, 401, 2048);
+  err += check_indices("c = a*(b1*b2 + b3)", &b, b401);
+  err += test_ring_mul_ct("c = a*(b1*b2 + b3) (constant time)", a, 401, \
+                          b401, 8, 8, 6, c401);
+
+  return err;
+}
+
+
+// c = a*(b1*b2 + b3) for the larger parameter sets, where b1, b2, and b3
+// have d1, d2, and d3 coefficients equal to +1 (and to -1), respectively
+
+static int test_ring_mul_param(const char *name, int N, const UINT16 *bidx,
+                               int d1, int d2, int d3, const UINT16 *c)
+{
+  UINT16 a[N+7], bcopy[2*(d1+d2+d3)], r[N+7];
+  SPARSE_POLY b = { bcopy, 2*d1, 2*d2, 2*d3 };
+  UINT16 ws[ring_mul_sparse_ws_size(N+7, &b)/sizeof(UINT16)];
+  int i;
+
+  for (i = 0; i < N; i ++) a[i] = (UINT16) ((7*i*i + 3*i + 1) & 0x07FF);
+  for (i = 0; i < 7; i ++) a[N+i] = a[i];
+  for (i = 0; i < 2*(d1+d2+d3); i ++) bcopy[i] = bidx[i];
+  ring_mul_sparse_ws(r, a, &b, N+7, 2048, ws);
+
+  return check(name, r, c, N, 2048) + check_indices(name, &b, bidx) + \
+         test_ring_mul_ct("constant time", a, N, bidx, d1, d2, d3, c);
+}
+
+
+// Inversion of f = 1 + 3*b mod q, where b = b1*b2 + b3 is given by its
+// indices like the private key; the result must satisfy f*r = 1 mod q. The
+// dense multiplication of the selected implementation is compared with the
+// C99 version, and 1 + X must be rejected since it is not invertible.
+
+static int test_ring_inv(const char *name, int N, const UINT16 *bidx,
+                         int d1, int d2, int d3)
+{
+  UINT16 one[N+7], f[N+7], r[N], t[N], u[N], tmp[RING_MUL_DENSE_TMP_LEN(N)];
+  UINT32 ws[RING_INV_Q_WS_SIZE(N)/sizeof(UINT32)];
+  SPARSE_POLY b = { bidx, 2*d1, 2*d2, 2*d3 };
+  int i, err = 0;
+
+  for (i = 0; i < N+7; i ++) one[i] = 0;
+  one[0] = one[N] = 1;
+  ring_mul_sparse_ws(f, one, &b, N+7, 2048, ws);
+  for (i = 0; i < N; i ++) f[i] = (3*f[i] + (i == 0)) & 0x07FF;
+
+  if (!ring_inv_q(r, f, N, 2048, ws))
+  {
+    printf("  %s: FAILED (not invertible)\n", name);
+    return 1;
+  }
+  ring_mul_dense_c99(t, f, r, N, tmp);
+  for (i = 0; i < N; i ++) err |= (t[i] & 0x07FF) != (i == 0);
+  ring_mul_dense(u, f, r, N, tmp);
+  for (i = 0; i < N; i ++) err |= t[i] != u[i];
+  f[0] = f[1] = 1;
+  for (i = 2; i < N; i ++) f[i] = 0;
+  err |= ring_inv_q(r, f, N, 2048, ws);
+  printf("  %s: %s\n", name, err ? "FAILED" : "ok");
+
+  return err;
+}
+
+
+static int test_ring_mul_all(void)
+{
+  int err = test_ring_mul();
+
+  err += test_ring_inv("f*r = 1 mod q (N = 401)", 401, b401, 8, 8, 6);
+  err += test_ring_inv("f*r = 1 mod q (N = 443)", 443, b443, 9, 8, 5);
+  err += test_ring_inv("f*r = 1 mod q (N = 587)", 587, b587, 10, 10, 8);
+  err += test_ring_inv("f*r = 1 mod q (N = 743)", 743, b743, 11, 11, 15);
+
+  err += test_ring_mul_param("c = a*(b1*b2 + b3) (EES443EP1)", 443, b443, \
+                             9, 8, 5, c443);
+  err += test_ring_mul_param("c = a*(b1*b2 + b3) (EES587EP1)", 587, b587, \
+                             10, 10, 8, c587);
+  err += test_ring_mul_param("c = a*(b1*b2 + b3) (EES743EP1)", 743, b743, \
+                             11, 11, 15, c743);
+
+  return err;
+}
+
+
+int main(void)
+{
+  int err = 0;
+
+#ifdef RING_MUL_X86
+  const char *names[] = { "C99", "SSE2", "AVX2" };
+  int impl;
+
+  for (impl = RING_MUL_C99; impl <= RING_MUL_AVX2; impl ++)
+  {
+    if (ring_mul_select(impl) != impl)
+    {
+      printf("%s: not supported by this CPU\n", names[impl]);
+      continue;
+    }
+    printf("%s:\n", names[impl]);
+    err += test_ring_mul_all();
+  }
+#else
+  err += test_ring_mul_all();
+#endif
+
+  printf("%s\n", err ? "Tests FAILED." : "All Tests successful.");
+
+  return err ? 1 : 0;
+}
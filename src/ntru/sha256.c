@@ -66,8 +66,11 @@
 #include "sha256.h"
 #include "config.h"
 
-// AVRSHA_USE_ASM is defined (or not defined) in config.h
-#ifdef AVRSHA_USE_ASM
+// AVRSHA_USE_ASM is defined (or not defined) in config.h; SHA256_DTLS is set
+// in the Makefile when the NTRU code is built together with tinydtls
+#ifdef SHA256_DTLS
+#include "sha2/sha2.h"
+#elif defined(AVRSHA_USE_ASM)
 extern void sha256_compress_avr(uint32_t *hval, const uint8_t *m);
 #endif
 
@@ -117,6 +120,10 @@ typedef union
 // Constant to determine the host byte-order
 static const word32_t is_little_endian = { 1 };
 
+// The round constants and bytes_to_word() are only needed by the C versions
+// of the compression function
+#if !defined(SHA256_DTLS) || defined(SHA256_ALL_KERNELS)
+
 // Round constants as specified in FIPS180-4 Sect 4.4.2
 static const uint32_t k[64] = {
   0x428A2F98UL, 0x71374491UL, 0xB5C0FBCFUL, 0xE9B5DBA5UL,
@@ -163,6 +170,8 @@ static uint32_t bytes_to_word(const uint8_t *byte_array)
   return temp.w;
 }
 
+#endif
+
 
 static void word_to_bytes(uint8_t *byte_array, uint32_t word)
 {
@@ -200,6 +209,29 @@ void sha256_init(sha256_context_t *ctx)
 }
 
 
+// To switch between ASM and C version of sha256_compress
+// AVRSHA_USE_ASM is defined (or not defined) in config.h; the unrolled C
+// version is about 1.5 times faster on 32 and 64-bit processors, but has a
+// larger code size, so SHA256_SMALL selects the rolled version instead.
+// SHA256_DTLS uses the compression function of sha2/sha2.c, which is shared
+// with the DTLS code and picks the fastest version of the platform, i.e. the
+// SHA extensions or AVX2 on x86 (at run time) and the ASM version on AVR.
+#ifdef SHA256_DTLS  // use dtls_sha256_compress of sha2/sha2.c
+#define sha256_compress(hval, m) dtls_sha256_compress((hval), (m), 1)
+#elif defined(AVRSHA_USE_ASM)  // use ASM version of sha256_compress
+#define sha256_compress sha256_compress_avr
+#elif defined(SHA256_SMALL)  // use rolled C version of sha256_compress
+#define sha256_compress sha256_compress_c99
+#else  // use unrolled C version of sha256_compress
+#define sha256_compress sha256_compress_unrolled
+#endif
+
+// SHA256_ALL_KERNELS compiles both C versions, so that kernel_test.c (which
+// includes this file) can check them against each other and count cycles
+
+
+#if !defined(AVRSHA_USE_ASM) && (defined(SHA256_ALL_KERNELS) || \
+    (!defined(SHA256_DTLS) && defined(SHA256_SMALL)))
 static void sha256_compress_c99(uint32_t *hval, const uint8_t *m)
 {
   int i, j = 8;
@@ -226,15 +258,18 @@ static void sha256_compress_c99(uint32_t *hval, const uint8_t *m)
     s[j+3] = s[j+3] + t1;
     s[--j] = t1 + t2;
     if (j == 0) { j = 8; memcpy(&(s[8]), s, 32); }
-    // printf("i = %02d: %08x%08x%08x%08x%08x%08x%08x%08x\n", i, \
+    // printf("i = %02d: %08x%08x%08x%08x%08x%08x%08x%08x\n", i,
     //   s[j], s[j+1], s[j+2], s[j+3], s[j+4], s[j+5], s[j+6], s[j+7]);
   }
   
   // 5th loop: Add the 8 state-words to the current (intermediate) hash value
   for (i = 0; i < 8; i ++) hval[i] += s[i];
 }
+#endif
 
 
+#if !defined(AVRSHA_USE_ASM) && (defined(SHA256_ALL_KERNELS) || \
+    (!defined(SHA256_DTLS) && !defined(SHA256_SMALL)))
 static void sha256_compress_unrolled(uint32_t *hval, const uint8_t *m)
 {
   int i;
@@ -267,15 +302,17 @@ static void sha256_compress_unrolled(uint32_t *hval, const uint8_t *m)
   hval[0] += a; hval[1] += b; hval[2] += c; hval[3] += d;
   hval[4] += e; hval[5] += f; hval[6] += g; hval[7] += h;
 }
+#endif
 
 
-// To switch between ASM and C version of sha256_compress
-// AVRSHA_USE_ASM is defined (or not defined) in config.h
-#ifdef AVRSHA_USE_ASM  // use ASM version of sha256_compress
-#define sha256_compress sha256_compress_avr
-#else  // use C version of sha256_compress
-#define sha256_compress sha256_compress_c99
-#endif
+// Compression of a single 64-byte block m; the caller is responsible for
+// the padding. This allows to hash many messages with a common prefix (e.g.
+// a seed followed by a counter) without copying the context each time.
+
+void sha256_compress_block(uint32_t *hval, const uint8_t *m)
+{
+  sha256_compress(hval, m);
+}
 
 
 void sha256_update(sha256_context_t *ctx, const void *data, size_t dlen)
@@ -48,6 +48,9 @@ void sha256_init(sha256_context_t *ctx);
 void sha256_update(sha256_context_t *ctx, const void *data, size_t dlen);
 void sha256_final(sha256_context_t *ctx, uint8_t *hashval);
 
+// Compression function (the caller has to pad the message)
+void sha256_compress_block(uint32_t *hval, const uint8_t *m);
+
 // High-level API
 void sha256_hash(uint8_t *hashval, const void *data, size_t dlen);
 
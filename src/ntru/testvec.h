@@ -65,5 +65,402 @@
 0x0B4, 0x064, 0x032, 0x01F, 0x12A, 0x074,               \
 0x039, 0x105, 0x152, 0x179, 0x027, 0x0C7
 
+// The following results are taken from test/testvec.txt, they are reduced
+// modulo 2048: T401B1COEFFS = a*b1, T401B1B2COEFFS = (a*b1)*b2, T401B3COEFFS
+// = a*b3, and C401COEFFS = a*(b1*b2 + b3).
+
+#define T401B1COEFFS \
+0x001, 0x000, 0x001, 0x001, 0x002, 0x7FE, 0x7FC, 0x000, 0x000, 0x7FE, \
+0x002, 0x001, 0x000, 0x001, 0x7FF, 0x7FF, 0x7FF, 0x000, 0x001, 0x7FE, \
+0x001, 0x000, 0x001, 0x000, 0x7FF, 0x7FD, 0x000, 0x004, 0x7FC, 0x7FE, \
+0x005, 0x005, 0x000, 0x7FB, 0x000, 0x7FD, 0x7FC, 0x003, 0x000, 0x000, \
+0x000, 0x7FD, 0x7FF, 0x7FF, 0x7FE, 0x7FE, 0x7FE, 0x7FF, 0x001, 0x7FE, \
+0x000, 0x000, 0x001, 0x000, 0x7FF, 0x000, 0x7FF, 0x7FD, 0x7FE, 0x002, \
+0x7FE, 0x001, 0x7FE, 0x7FF, 0x000, 0x003, 0x7FF, 0x002, 0x7FF, 0x000, \
+0x002, 0x7FD, 0x7FC, 0x7FF, 0x003, 0x002, 0x7FC, 0x7FD, 0x003, 0x002, \
+0x7FD, 0x7FE, 0x001, 0x7FF, 0x7FE, 0x7FF, 0x001, 0x001, 0x7FF, 0x001, \
+0x001, 0x001, 0x7FD, 0x002, 0x7FF, 0x000, 0x000, 0x001, 0x7FD, 0x000, \
+0x7FE, 0x7FF, 0x001, 0x7FF, 0x7FD, 0x000, 0x7FD, 0x003, 0x001, 0x000, \
+0x7FE, 0x003, 0x7FF, 0x7FD, 0x000, 0x002, 0x7FE, 0x7FD, 0x000, 0x001, \
+0x002, 0x001, 0x002, 0x7FD, 0x7FE, 0x001, 0x7FF, 0x000, 0x001, 0x7FC, \
+0x001, 0x7FF, 0x001, 0x001, 0x001, 0x7FD, 0x002, 0x000, 0x7FE, 0x001, \
+0x7FE, 0x002, 0x7FB, 0x7FF, 0x000, 0x000, 0x7FF, 0x7FF, 0x002, 0x7FD, \
+0x002, 0x000, 0x7FF, 0x001, 0x001, 0x000, 0x7FF, 0x7FC, 0x002, 0x004, \
+0x003, 0x7FE, 0x001, 0x002, 0x7FE, 0x7FF, 0x003, 0x7FF, 0x000, 0x7FE, \
+0x002, 0x002, 0x001, 0x7FE, 0x001, 0x001, 0x7FE, 0x001, 0x000, 0x7FB, \
+0x7FF, 0x001, 0x002, 0x7FF, 0x003, 0x001, 0x000, 0x7FD, 0x000, 0x001, \
+0x7FE, 0x7FB, 0x7FD, 0x002, 0x7FD, 0x002, 0x7FF, 0x002, 0x004, 0x001, \
+0x001, 0x7FE, 0x001, 0x7FF, 0x7FF, 0x7FF, 0x005, 0x7FF, 0x7FE, 0x003, \
+0x000, 0x001, 0x002, 0x001, 0x7FE, 0x001, 0x7FE, 0x000, 0x002, 0x001, \
+0x7FE, 0x001, 0x7FE, 0x003, 0x004, 0x7FF, 0x003, 0x003, 0x7FE, 0x000, \
+0x7FF, 0x7FD, 0x7FF, 0x002, 0x7FF, 0x003, 0x003, 0x7FE, 0x7FD, 0x000, \
+0x000, 0x002, 0x7FF, 0x7FF, 0x7FF, 0x005, 0x003, 0x7FE, 0x001, 0x001, \
+0x000, 0x7FE, 0x001, 0x002, 0x000, 0x001, 0x7FE, 0x7FE, 0x000, 0x7FE, \
+0x7FF, 0x7FE, 0x002, 0x7FF, 0x7FD, 0x003, 0x7FF, 0x001, 0x002, 0x003, \
+0x000, 0x7FF, 0x003, 0x001, 0x7FF, 0x000, 0x002, 0x7FE, 0x000, 0x002, \
+0x000, 0x003, 0x001, 0x001, 0x000, 0x002, 0x001, 0x000, 0x001, 0x000, \
+0x004, 0x7FE, 0x000, 0x000, 0x7FF, 0x7FF, 0x002, 0x000, 0x002, 0x001, \
+0x001, 0x7FE, 0x000, 0x003, 0x004, 0x000, 0x7FF, 0x000, 0x001, 0x000, \
+0x000, 0x000, 0x001, 0x003, 0x001, 0x7FD, 0x001, 0x004, 0x001, 0x001, \
+0x001, 0x002, 0x7FE, 0x7FF, 0x7FF, 0x7FF, 0x002, 0x7FB, 0x000, 0x7FE, \
+0x001, 0x003, 0x001, 0x7FE, 0x7FE, 0x7FF, 0x7FE, 0x7FE, 0x003, 0x002, \
+0x005, 0x000, 0x002, 0x7FE, 0x7FF, 0x7FA, 0x001, 0x003, 0x001, 0x7FE, \
+0x7FF, 0x003, 0x7FF, 0x000, 0x7FE, 0x002, 0x7FF, 0x001, 0x7FF, 0x001, \
+0x003, 0x001, 0x000, 0x7FE, 0x000, 0x002, 0x002, 0x7FD, 0x7FF, 0x001, \
+0x000, 0x7FF, 0x001, 0x7FF, 0x001, 0x001, 0x004, 0x000, 0x001, 0x7FE, \
+0x001, 0x003, 0x000, 0x000, 0x001, 0x7FF, 0x7FE, 0x001, 0x7FF, 0x000, \
+0x7FF, 0x002, 0x000, 0x000, 0x000, 0x000, 0x7FE, 0x7FF, 0x7FE, 0x7FF, \
+0x003
+
+#define T401B1B2COEFFS \
+0x002, 0x004, 0x7FE, 0x003, 0x001, 0x00C, 0x002, 0x000, 0x7F3, 0x7F5, \
+0x7FA, 0x008, 0x7F3, 0x7FD, 0x007, 0x7F9, 0x7F6, 0x7FA, 0x7FC, 0x7FB, \
+0x012, 0x7ED, 0x7F8, 0x003, 0x002, 0x006, 0x002, 0x7FB, 0x7F7, 0x7F8, \
+0x7F7, 0x005, 0x00A, 0x7F8, 0x004, 0x008, 0x7F8, 0x7F8, 0x7F9, 0x7F5, \
+0x7FE, 0x009, 0x7FD, 0x7FB, 0x005, 0x7FE, 0x7F7, 0x00A, 0x00B, 0x008, \
+0x004, 0x7E9, 0x002, 0x7F8, 0x009, 0x7EC, 0x7FB, 0x7FF, 0x002, 0x7FD, \
+0x7F3, 0x00C, 0x7F9, 0x7FC, 0x7F9, 0x7F2, 0x007, 0x00F, 0x009, 0x002, \
+0x000, 0x007, 0x001, 0x7F9, 0x000, 0x00A, 0x004, 0x006, 0x00B, 0x7F8, \
+0x7FC, 0x7FF, 0x7ED, 0x7FE, 0x007, 0x003, 0x007, 0x006, 0x004, 0x009, \
+0x00B, 0x7F3, 0x7FA, 0x003, 0x7FF, 0x004, 0x00D, 0x000, 0x005, 0x001, \
+0x7F6, 0x002, 0x002, 0x7F9, 0x002, 0x008, 0x7FA, 0x006, 0x007, 0x001, \
+0x7F3, 0x004, 0x006, 0x00A, 0x7FC, 0x005, 0x003, 0x006, 0x000, 0x005, \
+0x003, 0x004, 0x7FF, 0x7F2, 0x001, 0x016, 0x7FD, 0x7F7, 0x7F8, 0x005, \
+0x7F9, 0x7F3, 0x003, 0x003, 0x007, 0x7F6, 0x7F7, 0x00C, 0x006, 0x007, \
+0x7FD, 0x7FD, 0x7FC, 0x7FE, 0x7F9, 0x7F8, 0x004, 0x012, 0x7FC, 0x001, \
+0x000, 0x007, 0x007, 0x7FD, 0x7FB, 0x005, 0x00E, 0x7FA, 0x7F8, 0x00B, \
+0x00A, 0x7FE, 0x7FF, 0x004, 0x00C, 0x001, 0x7EE, 0x7F6, 0x00B, 0x005, \
+0x006, 0x7FB, 0x7EF, 0x005, 0x008, 0x002, 0x004, 0x008, 0x004, 0x7FF, \
+0x005, 0x005, 0x00A, 0x007, 0x003, 0x007, 0x009, 0x7FB, 0x7FD, 0x005, \
+0x00D, 0x000, 0x00A, 0x7FC, 0x7FB, 0x003, 0x7F5, 0x007, 0x002, 0x002, \
+0x7F5, 0x006, 0x005, 0x008, 0x006, 0x7F6, 0x004, 0x7FF, 0x005, 0x7FC, \
+0x001, 0x7F7, 0x014, 0x007, 0x7FE, 0x7F5, 0x005, 0x002, 0x7F9, 0x001, \
+0x007, 0x7FF, 0x003, 0x004, 0x7FB, 0x00A, 0x002, 0x009, 0x7F3, 0x008, \
+0x7FC, 0x004, 0x000, 0x7F7, 0x7FC, 0x003, 0x7FF, 0x7FC, 0x7FF, 0x005, \
+0x001, 0x002, 0x7F9, 0x001, 0x007, 0x7F9, 0x003, 0x006, 0x003, 0x7FF, \
+0x7EF, 0x7FA, 0x7FF, 0x00E, 0x005, 0x001, 0x7FA, 0x7FA, 0x7FE, 0x005, \
+0x7FB, 0x004, 0x7FC, 0x7FA, 0x001, 0x00C, 0x000, 0x001, 0x7FF, 0x7FA, \
+0x00A, 0x000, 0x005, 0x7FE, 0x00A, 0x000, 0x7FC, 0x005, 0x7F7, 0x7FF, \
+0x7FA, 0x7FE, 0x7FC, 0x013, 0x005, 0x7F8, 0x7EE, 0x008, 0x7FF, 0x7F6, \
+0x004, 0x004, 0x00D, 0x007, 0x7FE, 0x7FD, 0x007, 0x009, 0x7F7, 0x000, \
+0x000, 0x7F9, 0x001, 0x001, 0x003, 0x7FF, 0x7FD, 0x7FB, 0x003, 0x7FB, \
+0x009, 0x007, 0x7FB, 0x7FB, 0x002, 0x002, 0x7F6, 0x7FF, 0x7FA, 0x004, \
+0x000, 0x003, 0x7F8, 0x7F6, 0x7FE, 0x7F6, 0x7F2, 0x004, 0x008, 0x004, \
+0x000, 0x007, 0x7FE, 0x7F8, 0x000, 0x7FC, 0x003, 0x001, 0x7ED, 0x7FA, \
+0x010, 0x004, 0x7FC, 0x001, 0x7FF, 0x7F8, 0x7FD, 0x7F2, 0x004, 0x7FE, \
+0x7F6, 0x7FC, 0x7F3, 0x003, 0x7FF, 0x007, 0x7F0, 0x008, 0x004, 0x7F8, \
+0x00C, 0x7F7, 0x000, 0x012, 0x7F3, 0x7F4, 0x000, 0x008, 0x7FD, 0x007, \
+0x7FB, 0x7F7, 0x006, 0x7F7, 0x005, 0x00A, 0x000, 0x7F8, 0x004, 0x7F5, \
+0x003, 0x005, 0x006, 0x7F7, 0x000, 0x005, 0x7FD, 0x7FB, 0x003, 0x7FF, \
+0x7F7, 0x7F9, 0x7FE, 0x002, 0x004, 0x005, 0x7F2, 0x009, 0x007, 0x004, \
+0x7F9
+
+#define T401B3COEFFS \
+0x000, 0x002, 0x7FE, 0x7FF, 0x7FD, 0x002, 0x001, 0x001, 0x000, 0x002, \
+0x001, 0x000, 0x000, 0x7FE, 0x001, 0x000, 0x7FD, 0x002, 0x7FE, 0x002, \
+0x000, 0x001, 0x7FF, 0x002, 0x001, 0x000, 0x7FE, 0x001, 0x000, 0x7FE, \
+0x000, 0x001, 0x002, 0x002, 0x001, 0x7FF, 0x7FD, 0x003, 0x001, 0x001, \
+0x001, 0x001, 0x7FF, 0x001, 0x000, 0x000, 0x000, 0x002, 0x7FF, 0x000, \
+0x005, 0x7FE, 0x7FE, 0x7FF, 0x7FD, 0x7FF, 0x7FF, 0x7FD, 0x000, 0x002, \
+0x002, 0x002, 0x001, 0x7FE, 0x7FE, 0x001, 0x001, 0x7FF, 0x000, 0x000, \
+0x000, 0x000, 0x001, 0x7FD, 0x001, 0x7FF, 0x001, 0x001, 0x000, 0x7FF, \
+0x001, 0x000, 0x002, 0x001, 0x001, 0x002, 0x005, 0x7FF, 0x000, 0x7FF, \
+0x003, 0x7FF, 0x7FD, 0x7FE, 0x001, 0x000, 0x003, 0x002, 0x7FD, 0x000, \
+0x000, 0x7FF, 0x002, 0x000, 0x7FD, 0x001, 0x002, 0x000, 0x7FE, 0x003, \
+0x7FF, 0x000, 0x001, 0x002, 0x002, 0x000, 0x7FE, 0x7FF, 0x000, 0x000, \
+0x7FC, 0x7FE, 0x000, 0x001, 0x003, 0x000, 0x000, 0x000, 0x001, 0x001, \
+0x001, 0x7FD, 0x7FE, 0x7FF, 0x000, 0x003, 0x000, 0x7FF, 0x000, 0x001, \
+0x7FF, 0x7FF, 0x7FC, 0x7FE, 0x7FE, 0x000, 0x002, 0x000, 0x000, 0x7FF, \
+0x001, 0x001, 0x001, 0x004, 0x001, 0x7FE, 0x001, 0x002, 0x7FF, 0x7FF, \
+0x000, 0x7FE, 0x7FD, 0x000, 0x7FF, 0x003, 0x001, 0x003, 0x000, 0x7FE, \
+0x003, 0x7FE, 0x7FE, 0x7FD, 0x000, 0x7FF, 0x000, 0x000, 0x000, 0x000, \
+0x001, 0x001, 0x000, 0x7FE, 0x000, 0x7FE, 0x000, 0x005, 0x7FE, 0x7FF, \
+0x001, 0x000, 0x7FF, 0x7FF, 0x7FF, 0x000, 0x000, 0x001, 0x000, 0x003, \
+0x002, 0x000, 0x001, 0x002, 0x001, 0x7FD, 0x7FF, 0x7FA, 0x001, 0x000, \
+0x7FE, 0x7FD, 0x7FF, 0x000, 0x000, 0x003, 0x002, 0x003, 0x7FE, 0x003, \
+0x001, 0x7FF, 0x000, 0x000, 0x7FF, 0x7FF, 0x000, 0x7FE, 0x7FF, 0x7FF, \
+0x002, 0x001, 0x7FF, 0x001, 0x7FE, 0x001, 0x002, 0x000, 0x001, 0x7FD, \
+0x7FE, 0x7FF, 0x001, 0x7FF, 0x002, 0x7FE, 0x7FD, 0x000, 0x002, 0x7FD, \
+0x000, 0x001, 0x7FD, 0x000, 0x001, 0x000, 0x001, 0x7FE, 0x001, 0x000, \
+0x004, 0x7FE, 0x002, 0x001, 0x7FE, 0x001, 0x001, 0x000, 0x000, 0x7FF, \
+0x7FD, 0x7FF, 0x005, 0x7FD, 0x7FE, 0x000, 0x7FE, 0x000, 0x7FF, 0x000, \
+0x7FD, 0x001, 0x7FF, 0x000, 0x7FF, 0x002, 0x002, 0x000, 0x001, 0x7FE, \
+0x001, 0x7FF, 0x000, 0x7FF, 0x000, 0x004, 0x001, 0x7FE, 0x7FE, 0x002, \
+0x003, 0x7FF, 0x7FE, 0x7FE, 0x001, 0x7FF, 0x002, 0x7FE, 0x001, 0x000, \
+0x001, 0x000, 0x000, 0x003, 0x000, 0x7FF, 0x7FF, 0x002, 0x7FF, 0x7FE, \
+0x7FF, 0x7FF, 0x000, 0x000, 0x7FF, 0x7FD, 0x7FF, 0x7FE, 0x001, 0x002, \
+0x7FF, 0x001, 0x003, 0x003, 0x7FF, 0x7FF, 0x7FD, 0x7FD, 0x000, 0x7FD, \
+0x000, 0x000, 0x000, 0x000, 0x000, 0x001, 0x7FE, 0x001, 0x002, 0x000, \
+0x001, 0x001, 0x001, 0x7FF, 0x7FA, 0x7FF, 0x002, 0x7FF, 0x002, 0x002, \
+0x7FF, 0x002, 0x7FF, 0x000, 0x000, 0x001, 0x001, 0x000, 0x000, 0x7FF, \
+0x002, 0x000, 0x000, 0x7FE, 0x7FF, 0x003, 0x004, 0x7FF, 0x7FF, 0x004, \
+0x004, 0x002, 0x000, 0x7FF, 0x7FE, 0x001, 0x000, 0x7FE, 0x000, 0x7FD, \
+0x000, 0x000, 0x000, 0x000, 0x000, 0x001, 0x000, 0x004, 0x000, 0x000, \
+0x7FF
+
+#define C401COEFFS \
+0x002, 0x006, 0x7FC, 0x002, 0x7FE, 0x00E, 0x003, 0x001, 0x7F3, 0x7F7, \
+0x7FB, 0x008, 0x7F3, 0x7FB, 0x008, 0x7F9, 0x7F3, 0x7FC, 0x7FA, 0x7FD, \
+0x012, 0x7EE, 0x7F7, 0x005, 0x003, 0x006, 0x000, 0x7FC, 0x7F7, 0x7F6, \
+0x7F7, 0x006, 0x00C, 0x7FA, 0x005, 0x007, 0x7F5, 0x7FB, 0x7FA, 0x7F6, \
+0x7FF, 0x00A, 0x7FC, 0x7FC, 0x005, 0x7FE, 0x7F7, 0x00C, 0x00A, 0x008, \
+0x009, 0x7E7, 0x000, 0x7F7, 0x006, 0x7EB, 0x7FA, 0x7FC, 0x002, 0x7FF, \
+0x7F5, 0x00E, 0x7FA, 0x7FA, 0x7F7, 0x7F3, 0x008, 0x00E, 0x009, 0x002, \
+0x000, 0x007, 0x002, 0x7F6, 0x001, 0x009, 0x005, 0x007, 0x00B, 0x7F7, \
+0x7FD, 0x7FF, 0x7EF, 0x7FF, 0x008, 0x005, 0x00C, 0x005, 0x004, 0x008, \
+0x00E, 0x7F2, 0x7F7, 0x001, 0x000, 0x004, 0x010, 0x002, 0x002, 0x001, \
+0x7F6, 0x001, 0x004, 0x7F9, 0x7FF, 0x009, 0x7FC, 0x006, 0x005, 0x004, \
+0x7F2, 0x004, 0x007, 0x00C, 0x7FE, 0x005, 0x001, 0x005, 0x000, 0x005, \
+0x7FF, 0x002, 0x7FF, 0x7F3, 0x004, 0x016, 0x7FD, 0x7F7, 0x7F9, 0x006, \
+0x7FA, 0x7F0, 0x001, 0x002, 0x007, 0x7F9, 0x7F7, 0x00B, 0x006, 0x008, \
+0x7FC, 0x7FC, 0x7F8, 0x7FC, 0x7F7, 0x7F8, 0x006, 0x012, 0x7FC, 0x000, \
+0x001, 0x008, 0x008, 0x001, 0x7FC, 0x003, 0x00F, 0x7FC, 0x7F7, 0x00A, \
+0x00A, 0x7FC, 0x7FC, 0x004, 0x00B, 0x004, 0x7EF, 0x7F9, 0x00B, 0x003, \
+0x009, 0x7F9, 0x7ED, 0x002, 0x008, 0x001, 0x004, 0x008, 0x004, 0x7FF, \
+0x006, 0x006, 0x00A, 0x005, 0x003, 0x005, 0x009, 0x000, 0x7FB, 0x004, \
+0x00E, 0x000, 0x009, 0x7FB, 0x7FA, 0x003, 0x7F5, 0x008, 0x002, 0x005, \
+0x7F7, 0x006, 0x006, 0x00A, 0x007, 0x7F3, 0x003, 0x7F9, 0x006, 0x7FC, \
+0x7FF, 0x7F4, 0x013, 0x007, 0x7FE, 0x7F8, 0x007, 0x005, 0x7F7, 0x004, \
+0x008, 0x7FE, 0x003, 0x004, 0x7FA, 0x009, 0x002, 0x007, 0x7F2, 0x007, \
+0x7FE, 0x005, 0x7FF, 0x7F8, 0x7FA, 0x004, 0x001, 0x7FC, 0x000, 0x002, \
+0x7FF, 0x001, 0x7FA, 0x000, 0x009, 0x7F7, 0x000, 0x006, 0x005, 0x7FC, \
+0x7EF, 0x7FB, 0x7FC, 0x00E, 0x006, 0x001, 0x7FB, 0x7F8, 0x7FF, 0x005, \
+0x7FF, 0x002, 0x7FE, 0x7FB, 0x7FF, 0x00D, 0x001, 0x001, 0x7FF, 0x7F9, \
+0x007, 0x7FF, 0x00A, 0x7FB, 0x008, 0x000, 0x7FA, 0x005, 0x7F6, 0x7FF, \
+0x7F7, 0x7FF, 0x7FB, 0x013, 0x004, 0x7FA, 0x7F0, 0x008, 0x000, 0x7F4, \
+0x005, 0x003, 0x00D, 0x006, 0x7FE, 0x001, 0x008, 0x007, 0x7F5, 0x002, \
+0x003, 0x7F8, 0x7FF, 0x7FF, 0x004, 0x7FE, 0x7FF, 0x7F9, 0x004, 0x7FB, \
+0x00A, 0x007, 0x7FB, 0x7FE, 0x002, 0x001, 0x7F5, 0x001, 0x7F9, 0x002, \
+0x7FF, 0x002, 0x7F8, 0x7F6, 0x7FD, 0x7F3, 0x7F1, 0x002, 0x009, 0x006, \
+0x7FF, 0x008, 0x001, 0x7FB, 0x7FF, 0x7FB, 0x000, 0x7FE, 0x7ED, 0x7F7, \
+0x010, 0x004, 0x7FC, 0x001, 0x7FF, 0x7F9, 0x7FB, 0x7F3, 0x006, 0x7FE, \
+0x7F7, 0x7FD, 0x7F4, 0x002, 0x7F9, 0x006, 0x7F2, 0x007, 0x006, 0x7FA, \
+0x00B, 0x7F9, 0x7FF, 0x012, 0x7F3, 0x7F5, 0x001, 0x008, 0x7FD, 0x006, \
+0x7FD, 0x7F7, 0x006, 0x7F5, 0x004, 0x00D, 0x004, 0x7F7, 0x003, 0x7F9, \
+0x007, 0x007, 0x006, 0x7F6, 0x7FE, 0x006, 0x7FD, 0x7F9, 0x003, 0x7FC, \
+0x7F7, 0x7F9, 0x7FE, 0x002, 0x004, 0x006, 0x7F2, 0x00D, 0x007, 0x004, \
+0x7F8
+
+// Ciphertext e = r*h + m mod (X^11 - 1) of the toy example in test/magma.txt
+// with N = 11 and q = 32, see test_ring_mul_11().
+
+#define E11COEFFS 14, 11, 26, 24, 14, 16, 30, 7, 25, 6, 19
+
+// Test vectors for EES443EP1, EES587EP1, and EES743EP1, generated with an
+// independent implementation of the product-form multiplication. The dense
+// operand is a[i] = (7*i^2 + 3*i + 1) mod 2048 (see ring_test.c), BxxxCOEFFS
+// contains the indices of b1, b2, and b3 (the +1 indices of each polynomial
+// followed by its -1 indices), and CxxxCOEFFS = a*(b1*b2 + b3) mod 2048.
+
+#define B443COEFFS \
+0x183, 0x040, 0x00A, 0x146, 0x14B, 0x088, 0x0AB, 0x093, 0x037, 0x08E, \
+0x073, 0x006, 0x0B4, 0x16C, 0x125, 0x16A, 0x115, 0x105, 0x03C, 0x0A9, \
+0x0A4, 0x0E8, 0x16A, 0x078, 0x02E, 0x0DE, 0x0FF, 0x12E, 0x060, 0x0E6, \
+0x00F, 0x0B7, 0x1B4, 0x152, 0x07F, 0x1A9, 0x0D4, 0x196, 0x0E1, 0x0F5, \
+0x031, 0x123, 0x005, 0x185
+
+#define C443COEFFS \
+0x472, 0x014, 0x202, 0x750, 0x618, 0x366, 0x0EE, 0x350, 0x252, 0x47A, \
+0x342, 0x530, 0x71E, 0x10C, 0x65A, 0x522, 0x710, 0x23E, 0x3B8, 0x092, \
+0x246, 0x09A, 0x214, 0x38E, 0x508, 0x1E2, 0x396, 0x54A, 0x6FE, 0x0B2, \
+0x5C6, 0x314, 0x53C, 0x404, 0x152, 0x37A, 0x5A2, 0x46A, 0x658, 0x046, \
+0x0F4, 0x6B6, 0x4B2, 0x788, 0x25E, 0x534, 0x00A, 0x780, 0x21C, 0x018, \
+0x64E, 0x15E, 0x10E, 0x3E4, 0x6BA, 0x630, 0x0CC, 0x368, 0x604, 0x0A0, \
+0x33C, 0x138, 0x40E, 0x6E4, 0x2FA, 0x55C, 0x1DE, 0x4EE, 0x7FE, 0x30E, \
+0x61E, 0x48E, 0x338, 0x35C, 0x6A6, 0x690, 0x1A0, 0x4B0, 0x7C0, 0x630, \
+0x61A, 0x12A, 0x79A, 0x644, 0x1C8, 0x0AC, 0x46A, 0x028, 0x746, 0x7DE, \
+0x39C, 0x75A, 0x318, 0x6D6, 0x294, 0x652, 0x210, 0x5CE, 0x18C, 0x0AA, \
+0x4A2, 0x53A, 0x238, 0x582, 0x56C, 0x1BC, 0x7B8, 0x28E, 0x6A4, 0x106, \
+0x4A8, 0x696, 0x084, 0x272, 0x460, 0x78E, 0x108, 0x282, 0x75C, 0x110, \
+0x404, 0x544, 0x684, 0x7C4, 0x5A4, 0x6AA, 0x310, 0x450, 0x590, 0x230, \
+0x4EA, 0x5F0, 0x6F6, 0x7FC, 0x102, 0x6A8, 0x414, 0x4A6, 0x098, 0x164, \
+0x590, 0x1F6, 0x336, 0x336, 0x4EA, 0x69E, 0x052, 0x206, 0x3BA, 0x20E, \
+0x388, 0x3C2, 0x250, 0x764, 0x152, 0x340, 0x1CE, 0x022, 0x19C, 0x316, \
+0x7F0, 0x504, 0x252, 0x47A, 0x202, 0x464, 0x366, 0x58E, 0x7B6, 0x1DE, \
+0x766, 0x1C8, 0x0CA, 0x792, 0x620, 0x334, 0x662, 0x7DC, 0x156, 0x770, \
+0x410, 0x58A, 0x3A4, 0x4E4, 0x2C4, 0x72A, 0x3CA, 0x544, 0x6BE, 0x4D8, \
+0x178, 0x2F2, 0x46C, 0x5E6, 0x760, 0x57A, 0x6BA, 0x7FA, 0x13A, 0x5DA, \
+0x754, 0x0CE, 0x5A8, 0x75C, 0x110, 0x2C4, 0x478, 0x2CC, 0x446, 0x5C0, \
+0x73A, 0x554, 0x694, 0x7D4, 0x114, 0x254, 0x394, 0x174, 0x27A, 0x020, \
+0x0EC, 0x1B8, 0x284, 0x7F0, 0x522, 0x21A, 0x0F8, 0x18A, 0x21C, 0x2AE, \
+0x340, 0x072, 0x0CA, 0x5C2, 0x5E0, 0x15E, 0x656, 0x674, 0x1F2, 0x24A, \
+0x162, 0x22E, 0x79A, 0x38C, 0x458, 0x524, 0x150, 0x5B6, 0x6F6, 0x036, \
+0x616, 0x71C, 0x022, 0x128, 0x6CE, 0x79A, 0x506, 0x238, 0x290, 0x788, \
+0x7A6, 0x464, 0x7A8, 0x7C6, 0x7E4, 0x362, 0x3BA, 0x412, 0x46A, 0x4C2, \
+0x1BA, 0x1D8, 0x1F6, 0x214, 0x232, 0x250, 0x3AE, 0x7F8, 0x768, 0x238, \
+0x1E2, 0x4EC, 0x030, 0x3AE, 0x766, 0x358, 0x564, 0x25C, 0x27A, 0x298, \
+0x2B6, 0x2D4, 0x792, 0x776, 0x2BA, 0x2D8, 0x796, 0x77A, 0x3FE, 0x3A8, \
+0x352, 0x2FC, 0x2A6, 0x250, 0x1FA, 0x644, 0x5B4, 0x084, 0x16E, 0x0A4, \
+0x33A, 0x2AA, 0x57A, 0x524, 0x4CE, 0x478, 0x0C2, 0x032, 0x7A2, 0x132, \
+0x150, 0x4CE, 0x526, 0x0DE, 0x4D0, 0x23C, 0x2CE, 0x360, 0x3F2, 0x484, \
+0x076, 0x142, 0x20E, 0x2DA, 0x3A6, 0x112, 0x1A4, 0x0F6, 0x1FC, 0x662, \
+0x442, 0x0A8, 0x1E8, 0x328, 0x468, 0x248, 0x6AE, 0x34E, 0x028, 0x53C, \
+0x72A, 0x118, 0x306, 0x054, 0x5DC, 0x4DE, 0x706, 0x5CE, 0x45C, 0x610, \
+0x7C4, 0x178, 0x32C, 0x180, 0x65A, 0x00E, 0x082, 0x2AA, 0x4D2, 0x39A, \
+0x228, 0x3DC, 0x370, 0x116, 0x542, 0x648, 0x74E, 0x4F4, 0x5C0, 0x7CC, \
+0x384, 0x776, 0x042, 0x10E, 0x1DA, 0x2A6, 0x012, 0x0A4, 0x136, 0x1C8, \
+0x25A, 0x2EC, 0x37E, 0x410, 0x4A2, 0x534, 0x5C6, 0x658, 0x6EA, 0x77C, \
+0x00E, 0x400, 0x24C, 0x0A0, 0x21A, 0x394, 0x1AE, 0x2EE, 0x78E, 0x108, \
+0x282, 0x3FC, 0x0D6, 0x5EA, 0x7D8, 0x1C6, 0x3B4, 0x6E2, 0x05C, 0x1D6, \
+0x350, 0x4CA, 0x504, 0x6F2, 0x440, 0x668, 0x090, 0x618, 0x07A, 0x2DC, \
+0x09E, 0x33A, 0x5D6, 0x512, 0x774, 0x676, 0x09E, 0x2C6, 0x04E, 0x2B0, \
+0x512, 0x2D4, 0x210
+
+#define B587COEFFS \
+0x14D, 0x02B, 0x22D, 0x204, 0x164, 0x1C3, 0x0F4, 0x18B, 0x08C, 0x209, \
+0x0C4, 0x0FB, 0x1AA, 0x1D9, 0x1FE, 0x022, 0x01E, 0x04A, 0x1CA, 0x205, \
+0x1C8, 0x14C, 0x020, 0x1E1, 0x0E7, 0x1A0, 0x183, 0x01F, 0x13A, 0x1E8, \
+0x179, 0x161, 0x22B, 0x038, 0x162, 0x0B1, 0x0A6, 0x1BE, 0x0F8, 0x0B7, \
+0x158, 0x0A2, 0x06F, 0x130, 0x21A, 0x1F4, 0x191, 0x0D8, 0x128, 0x045, \
+0x0C7, 0x135, 0x085, 0x1B8, 0x222, 0x208
+
+#define C587COEFFS \
+0x7F6, 0x096, 0x46C, 0x16E, 0x670, 0x6C2, 0x3AA, 0x092, 0x57A, 0x5B2, \
+0x730, 0x578, 0x294, 0x7B0, 0x4CC, 0x1E8, 0x254, 0x756, 0x7A8, 0x490, \
+0x178, 0x660, 0x698, 0x366, 0x034, 0x1B2, 0x34A, 0x04C, 0x54E, 0x250, \
+0x402, 0x11E, 0x63A, 0x356, 0x072, 0x58E, 0x2AA, 0x316, 0x018, 0x06A, \
+0x552, 0x58A, 0x5A8, 0x25C, 0x260, 0x6FA, 0x394, 0x4DE, 0x4E2, 0x17C, \
+0x616, 0x760, 0x764, 0x3FE, 0x3E8, 0x3B8, 0x4CE, 0x14E, 0x5CE, 0x24E, \
+0x21E, 0x334, 0x464, 0x44E, 0x0CE, 0x6AE, 0x012, 0x4E0, 0x1AE, 0x67C, \
+0x7FA, 0x4E2, 0x1CA, 0x202, 0x220, 0x224, 0x6BE, 0x358, 0x342, 0x7C2, \
+0x0F2, 0x58C, 0x226, 0x210, 0x690, 0x310, 0x2E0, 0x296, 0x6E2, 0x67E, \
+0x2B0, 0x6E2, 0x314, 0x746, 0x378, 0x7AA, 0x72C, 0x7F4, 0x426, 0x1B8, \
+0x2CE, 0x29E, 0x3B4, 0x4E4, 0x17E, 0x2C8, 0x42C, 0x44A, 0x5AE, 0x27C, \
+0x29A, 0x74E, 0x562, 0x0EA, 0x59E, 0x252, 0x706, 0x51A, 0x202, 0x23A, \
+0x3B8, 0x0A0, 0x588, 0x3D0, 0x0EC, 0x608, 0x324, 0x040, 0x55C, 0x278, \
+0x2E4, 0x7E6, 0x4E8, 0x1EA, 0x23C, 0x724, 0x0BC, 0x5BE, 0x610, 0x2F8, \
+0x330, 0x7FE, 0x4CC, 0x19A, 0x668, 0x336, 0x4B4, 0x64C, 0x34E, 0x050, \
+0x552, 0x254, 0x406, 0x282, 0x482, 0x1EC, 0x2A6, 0x7F6, 0x546, 0x296, \
+0x336, 0x1CC, 0x286, 0x7D6, 0x076, 0x0FC, 0x618, 0x334, 0x050, 0x56C, \
+0x288, 0x2F4, 0x346, 0x02E, 0x516, 0x1FE, 0x6E6, 0x07E, 0x420, 0x0EE, \
+0x5BC, 0x28A, 0x408, 0x0F0, 0x5D8, 0x770, 0x472, 0x174, 0x676, 0x378, \
+0x07A, 0x57C, 0x27E, 0x2D0, 0x7B8, 0x7F0, 0x00E, 0x4C2, 0x176, 0x2DA, \
+0x7A8, 0x7C6, 0x7CA, 0x114, 0x5C8, 0x27C, 0x730, 0x734, 0x3CE, 0x518, \
+0x1CC, 0x1D0, 0x31A, 0x31E, 0x7B8, 0x102, 0x456, 0x0D6, 0x366, 0x384, \
+0x4E8, 0x1B6, 0x684, 0x352, 0x6C0, 0x1FA, 0x7C0, 0x45A, 0x5A4, 0x258, \
+0x70C, 0x3C0, 0x074, 0x528, 0x52C, 0x1C6, 0x660, 0x7AA, 0x45E, 0x462, \
+0x79C, 0x0B2, 0x532, 0x502, 0x618, 0x298, 0x718, 0x398, 0x6B8, 0x304, \
+0x2A0, 0x572, 0x4C0, 0x0A4, 0x138, 0x696, 0x2C8, 0x59A, 0x648, 0x260, \
+0x678, 0x290, 0x358, 0x2DA, 0x242, 0x2F0, 0x258, 0x656, 0x254, 0x652, \
+0x250, 0x64E, 0x24C, 0x2FA, 0x262, 0x1B0, 0x434, 0x334, 0x21A, 0x596, \
+0x462, 0x7C4, 0x7D6, 0x002, 0x238, 0x0EA, 0x432, 0x0DA, 0x106, 0x7EC, \
+0x368, 0x394, 0x72A, 0x2C0, 0x656, 0x69C, 0x24C, 0x5FC, 0x1AC, 0x55C, \
+0x10C, 0x16C, 0x536, 0x100, 0x01A, 0x07A, 0x5A4, 0x042, 0x40C, 0x486, \
+0x1CA, 0x292, 0x6C4, 0x2F6, 0x728, 0x35A, 0x2DC, 0x3A4, 0x7D6, 0x408, \
+0x03A, 0x7BC, 0x724, 0x482, 0x214, 0x67A, 0x2E0, 0x0A6, 0x540, 0x1DA, \
+0x674, 0x30E, 0x2F8, 0x778, 0x3F8, 0x078, 0x4F8, 0x178, 0x5F8, 0x728, \
+0x3C2, 0x05C, 0x1A6, 0x65A, 0x30E, 0x662, 0x792, 0x0DC, 0x240, 0x70E, \
+0x72C, 0x3E0, 0x094, 0x548, 0x1FC, 0x6B0, 0x364, 0x6B8, 0x338, 0x468, \
+0x102, 0x59C, 0x236, 0x380, 0x384, 0x36E, 0x49E, 0x5E8, 0x29C, 0x2A0, \
+0x73A, 0x724, 0x3A4, 0x374, 0x48A, 0x10A, 0x0DA, 0x540, 0x1A6, 0x60C, \
+0x722, 0x3A2, 0x022, 0x7F2, 0x7A8, 0x744, 0x376, 0x648, 0x246, 0x2F4, \
+0x25C, 0x65A, 0x258, 0x656, 0x5A4, 0x188, 0x21C, 0x2CA, 0x6E2, 0x2FA, \
+0x712, 0x67A, 0x278, 0x676, 0x724, 0x33C, 0x404, 0x386, 0x79E, 0x3B6, \
+0x7CE, 0x096, 0x178, 0x5C4, 0x210, 0x1AC, 0x28E, 0x22A, 0x30C, 0x408, \
+0x51E, 0x2FE, 0x302, 0x79C, 0x436, 0x0D0, 0x75A, 0x3A6, 0x692, 0x2AA, \
+0x212, 0x610, 0x20E, 0x60C, 0x55A, 0x13E, 0x522, 0x106, 0x4EA, 0x0CE, \
+0x162, 0x0B0, 0x494, 0x078, 0x7AC, 0x376, 0x3F0, 0x7D4, 0x3B8, 0x79C, \
+0x030, 0x77E, 0x362, 0x746, 0x67A, 0x244, 0x60E, 0x688, 0x26C, 0x1A0, \
+0x56A, 0x5E4, 0x1C8, 0x5AC, 0x190, 0x574, 0x158, 0x53C, 0x120, 0x504, \
+0x0E8, 0x4CC, 0x400, 0x7CA, 0x394, 0x2AE, 0x1AE, 0x544, 0x42A, 0x7A6, \
+0x672, 0x1D4, 0x086, 0x71E, 0x6FC, 0x594, 0x572, 0x0BA, 0x402, 0x55A, \
+0x700, 0x2E4, 0x378, 0x426, 0x4EE, 0x120, 0x552, 0x184, 0x5B6, 0x538, \
+0x4A0, 0x09E, 0x49C, 0x09A, 0x148, 0x210, 0x642, 0x724, 0x370, 0x7BC, \
+0x568, 0x698, 0x332, 0x7CC, 0x7B6, 0x0E6, 0x230, 0x394, 0x512, 0x1FA, \
+0x6E2, 0x3CA, 0x212, 0x72E, 0x79A, 0x14C, 0x668, 0x6D4, 0x086, 0x0F2, \
+0x2A4, 0x310, 0x012, 0x1C4, 0x6E0, 0x3FC, 0x118, 0x634, 0x6A0, 0x052, \
+0x56E, 0x73A, 0x120, 0x670, 0x3C0, 0x110, 0x310, 0x3CA, 0x11A, 0x66A, \
+0x70A, 0x440, 0x4C6, 0x532, 0x234, 0x3E6, 0x452, 0x154, 0x1A6, 0x68E, \
+0x376, 0x50E, 0x6C0, 0x3DC, 0x448, 0x5FA, 0x666, 0x368, 0x06A, 0x56C, \
+0x26E, 0x770, 0x5D2, 0x1A8, 0x6AA, 0x3AC, 0x3FE, 0x596, 0x748, 0x464, \
+0x180, 0x34C, 0x082, 0x718, 0x482, 0x53C, 0x73C
+
+#define B743COEFFS \
+0x2CC, 0x122, 0x255, 0x029, 0x018, 0x193, 0x1B2, 0x15F, 0x0F9, 0x13F, \
+0x230, 0x106, 0x2BB, 0x116, 0x26C, 0x05F, 0x04C, 0x123, 0x2BC, 0x276, \
+0x294, 0x21F, 0x082, 0x128, 0x046, 0x2E4, 0x1C8, 0x1E3, 0x0EA, 0x042, \
+0x2AB, 0x0BB, 0x1BE, 0x25E, 0x122, 0x289, 0x2A5, 0x16D, 0x007, 0x225, \
+0x1E9, 0x1C0, 0x07B, 0x09F, 0x28F, 0x2D2, 0x1B8, 0x230, 0x220, 0x00E, \
+0x216, 0x2C6, 0x068, 0x1F9, 0x288, 0x2AC, 0x01B, 0x22A, 0x163, 0x172, \
+0x2DC, 0x04B, 0x034, 0x148, 0x008, 0x2E2, 0x08C, 0x29C, 0x0F8, 0x204, \
+0x164, 0x1A1, 0x0B5, 0x270
+
+#define C743COEFFS \
+0x14E, 0x094, 0x6D0, 0x616, 0x486, 0x2F6, 0x166, 0x7A2, 0x6B4, 0x5C6, \
+0x540, 0x30E, 0x0DC, 0x676, 0x51A, 0x2E8, 0x082, 0x6BE, 0x59C, 0x550, \
+0x504, 0x4EC, 0x3FE, 0x2DC, 0x290, 0x210, 0x232, 0x32A, 0x422, 0x54E, \
+0x5D8, 0x524, 0x650, 0x6A6, 0x6C8, 0x78C, 0x126, 0x2F4, 0x420, 0x4AA, \
+0x492, 0x3D8, 0x248, 0x0EC, 0x6BA, 0x488, 0x28A, 0x782, 0x51C, 0x38C, \
+0x1FC, 0x0A0, 0x63A, 0x4AA, 0x34E, 0x0E8, 0x6F0, 0x6A4, 0x658, 0x640, \
+0x552, 0x464, 0x376, 0x288, 0x19A, 0x078, 0x02C, 0x7E0, 0x7C8, 0x6DA, \
+0x5EC, 0x4FE, 0x410, 0x2EE, 0x26E, 0x290, 0x3BC, 0x412, 0x468, 0x4F2, \
+0x4DA, 0x3EC, 0x2FE, 0x244, 0x0E8, 0x6B6, 0x450, 0x28C, 0x1D2, 0x042, \
+0x71A, 0x47A, 0x0D0, 0x5FC, 0x35C, 0x7E6, 0x3D4, 0x244, 0x0B4, 0x724, \
+0x594, 0x404, 0x2A8, 0x0AA, 0x5D6, 0x302, 0x062, 0x4EC, 0x142, 0x66E, \
+0x39A, 0x0C6, 0x5BE, 0x3C0, 0x0EC, 0x64C, 0x33E, 0x684, 0x1CA, 0x510, \
+0x056, 0x368, 0x750, 0x338, 0x720, 0x308, 0x6F0, 0x2D8, 0x6C0, 0x2A8, \
+0x690, 0x278, 0x62C, 0x2B6, 0x740, 0x3CA, 0x054, 0x512, 0x0FA, 0x4AE, \
+0x104, 0x664, 0x2BA, 0x7E6, 0x4AA, 0x31A, 0x156, 0x068, 0x77A, 0x658, \
+0x640, 0x51E, 0x4D2, 0x452, 0x510, 0x3EE, 0x3A2, 0x322, 0x378, 0x3CE, \
+0x458, 0x3D8, 0x42E, 0x484, 0x4A6, 0x59E, 0x696, 0x7C2, 0x04C, 0x000, \
+0x7B4, 0x79C, 0x6AE, 0x58C, 0x574, 0x486, 0x398, 0x2DE, 0x14E, 0x7BE, \
+0x5FA, 0x4D8, 0x424, 0x480, 0x792, 0x1CE, 0x40A, 0x646, 0x082, 0x2F2, \
+0x458, 0x660, 0x13E, 0x41C, 0x6FA, 0x1D8, 0x4B6, 0x7C8, 0x204, 0x474, \
+0x5DA, 0x016, 0x21E, 0x4FC, 0x7DA, 0x2B8, 0x562, 0x14A, 0x386, 0x58E, \
+0x06C, 0x37E, 0x5EE, 0x754, 0x15C, 0x43A, 0x718, 0x1F6, 0x4D4, 0x77E, \
+0x2FE, 0x67E, 0x1FE, 0x57E, 0x0CA, 0x4B8, 0x17C, 0x640, 0x338, 0x75A, \
+0x3B0, 0x6FC, 0x31E, 0x740, 0x362, 0x7B8, 0x338, 0x6B8, 0x238, 0x5B8, \
+0x104, 0x526, 0x17C, 0x4FC, 0x07C, 0x3FC, 0x7B0, 0x2C2, 0x4FE, 0x73A, \
+0x176, 0x3B2, 0x5EE, 0x7C2, 0x376, 0x654, 0x0CA, 0x4B8, 0x1B0, 0x5D2, \
+0x1F4, 0x616, 0x238, 0x626, 0x2EA, 0x77A, 0x4AC, 0x2B4, 0x0BC, 0x72C, \
+0x3F0, 0x0B4, 0x578, 0x270, 0x692, 0x2B4, 0x6D6, 0x2F8, 0x71A, 0x33C, \
+0x75E, 0x380, 0x7A2, 0x390, 0x054, 0x518, 0x1DC, 0x6D4, 0x2C2, 0x7BA, \
+0x3DC, 0x032, 0x3B2, 0x732, 0x2B2, 0x632, 0x1B2, 0x4CA, 0x1C2, 0x5E4, \
+0x26E, 0x54C, 0x7F6, 0x376, 0x6F6, 0x276, 0x5C2, 0x1E4, 0x606, 0x1F4, \
+0x6B8, 0x37C, 0x040, 0x504, 0x194, 0x72E, 0x426, 0x048, 0x46A, 0x0C0, \
+0x474, 0x786, 0x1F6, 0x35C, 0x598, 0x008, 0x16E, 0x3AA, 0x57E, 0x0CA, \
+0x4EC, 0x0DA, 0x56A, 0x268, 0x112, 0x7F0, 0x5F8, 0x434, 0x166, 0x76E, \
+0x542, 0x3EC, 0x296, 0x10C, 0x024, 0x012, 0x000, 0x7EE, 0x7DC, 0x7FE, \
+0x74A, 0x696, 0x5E2, 0x52E, 0x47A, 0x3FA, 0x2A4, 0x11A, 0x032, 0x020, \
+0x00E, 0x7C8, 0x058, 0x0B4, 0x1E6, 0x34C, 0x410, 0x3FE, 0x3B8, 0x448, \
+0x470, 0x644, 0x7B0, 0x294, 0x682, 0x19A, 0x4E6, 0x75C, 0x1D2, 0x47C, \
+0x650, 0x024, 0x1F8, 0x3CC, 0x5A0, 0x010, 0x7FE, 0x7EC, 0x7DA, 0x7C8, \
+0x7B6, 0x770, 0x7CC, 0x0FE, 0x230, 0x362, 0x494, 0x5C6, 0x6F8, 0x02A, \
+0x15C, 0x2C2, 0x31E, 0x3E8, 0x692, 0x09A, 0x200, 0x290, 0x2B8, 0x48C, \
+0x62C, 0x0A2, 0x2E4, 0x594, 0x224, 0x5DE, 0x198, 0x552, 0x10C, 0x4FA, \
+0x046, 0x2BC, 0x532, 0x774, 0x28C, 0x5A4, 0x0F0, 0x366, 0x5DC, 0x086, \
+0x25A, 0x462, 0x594, 0x6C6, 0x7F8, 0x12A, 0x2C4, 0x2E6, 0x232, 0x14A, \
+0x138, 0x126, 0x0E0, 0x170, 0x200, 0x2C4, 0x2E6, 0x232, 0x17E, 0x0CA, \
+0x04A, 0x6F4, 0x59E, 0x448, 0x2F2, 0x19C, 0x07A, 0x682, 0x48A, 0x292, \
+0x09A, 0x6A2, 0x476, 0x320, 0x1CA, 0x040, 0x78C, 0x6D8, 0x624, 0x5A4, \
+0x482, 0x28A, 0x05E, 0x73C, 0x510, 0x3BA, 0x264, 0x176, 0x674, 0x51E, \
+0x3FC, 0x238, 0x79E, 0x538, 0x1FC, 0x6C0, 0x384, 0x07C, 0x49E, 0x08C, \
+0x550, 0x214, 0x6D8, 0x3D0, 0x7BE, 0x482, 0x112, 0x6AC, 0x370, 0x034, \
+0x560, 0x0E0, 0x460, 0x7AC, 0x402, 0x7EA, 0x28E, 0x3BA, 0x410, 0x466, \
+0x488, 0x580, 0x644, 0x7AA, 0x1E6, 0x422, 0x62A, 0x108, 0x3E6, 0x6C4, \
+0x1A2, 0x480, 0x6F6, 0x34C, 0x768, 0x0CE, 0x30A, 0x546, 0x782, 0x1BE, \
+0x3C6, 0x670, 0x1BC, 0x612, 0x1C6, 0x4A4, 0x7B6, 0x226, 0x3F4, 0x4B8, \
+0x61E, 0x026, 0x304, 0x616, 0x086, 0x254, 0x34C, 0x444, 0x53C, 0x634, \
+0x760, 0x782, 0x0AE, 0x138, 0x154, 0x7C4, 0x634, 0x4A4, 0x2E0, 0x1BE, \
+0x172, 0x126, 0x0DA, 0x0C2, 0x03C, 0x63E, 0x39E, 0x7F4, 0x554, 0x1DE, \
+0x634, 0x360, 0x08C, 0x584, 0x31E, 0x18E, 0x7FE, 0x66E, 0x4AA, 0x388, \
+0x308, 0x392, 0x346, 0x2FA, 0x2E2, 0x228, 0x0CC, 0x666, 0x4D6, 0x346, \
+0x1B6, 0x026, 0x696, 0x4D2, 0x44C, 0x21A, 0x7E8, 0x5B6, 0x384, 0x152, \
+0x6EC, 0x55C, 0x3CC, 0x23C, 0x078, 0x7BE, 0x662, 0x430, 0x1FE, 0x764, \
+0x676, 0x588, 0x49A, 0x378, 0x2F8, 0x382, 0x336, 0x2B6, 0x30C, 0x362, \
+0x3B8, 0x442, 0x3C2, 0x418, 0x43A, 0x566, 0x5F0, 0x5D8, 0x4EA, 0x3FC, \
+0x30E, 0x220, 0x132, 0x078, 0x71C, 0x4EA, 0x2B8, 0x0EE, 0x578, 0x1CE, \
+0x6C6, 0x460, 0x2D0, 0x174, 0x776, 0x4A2, 0x1CE, 0x6FA, 0x45A, 0x0E4, \
+0x53A, 0x266, 0x792, 0x4BE, 0x1EA, 0x716, 0x4AA, 0x05E, 0x4E8, 0x172, \
+0x5FC, 0x286, 0x710, 0x3CE, 0x7B6, 0x39E, 0x7BA, 0x368, 0x56A, 0x76C, \
+0x16E, 0x370, 0x572, 0x70C, 0x252, 0x598, 0x0DE, 0x424, 0x76A, 0x2B0, \
+0x5F6, 0x13C, 0x4B6, 0x726, 0x26C, 0x5B2, 0x0C4, 0x4AC, 0x094, 0x47C, \
+0x030, 0x4BA, 0x144, 0x59A, 0x2C6, 0x026, 0x448, 0x1AE, 0x0C0, 0x006, \
+0x642, 0x554, 0x49A, 0x30A, 0x17A, 0x01E, 0x620, 0x3B4, 0x768, 0x3F2, \
+0x0E4, 0x42A, 0x770, 0x2EA, 0x58E, 0x032, 0x2A2, 0x5E8, 0x0C6, 0x51C, \
+0x214, 0x7E2, 0x5E4, 0x2DC, 0x076, 0x71A, 0x4E8, 0x2EA, 0x016, 0x542, \
+0x23A, 0x008, 0x5D6, 0x3A4, 0x13E, 0x7AE, 0x652, 0x3EC, 0x1C0, 0x24A, \
+0x1FE, 0x1B2, 0x166
+
 #endif
 
@@ -36,6 +36,22 @@
 #define DTLS_PSK
 #endif
 
+/* support for the AES_128_GCM_SHA256 cipher suites */
+#ifndef DTLS_CONF_GCM
+#define DTLS_CONF_GCM 0
+#endif
+#if DTLS_CONF_GCM
+#define DTLS_GCM
+#endif
+
+/* support for the CHACHA20_POLY1305_SHA256 cipher suites */
+#ifndef DTLS_CONF_CHACHA20
+#define DTLS_CONF_CHACHA20 0
+#endif
+#if DTLS_CONF_CHACHA20
+#define DTLS_CHACHA20
+#endif
+
 /* Disable all debug output and assertions */
 #ifndef DTLS_CONF_NDEBUG
 #if DTLS_CONF_NDEBUG
@@ -67,6 +83,11 @@
 #  define DTLS_HASH_MAX (3 * DTLS_PEER_MAX)
 #endif
 
+#ifndef DTLS_COOKIE_BATCH
+/** The number of cookies computed at once by dtls_handle_messages(). */
+#  define DTLS_COOKIE_BATCH 1
+#endif
+
 /** do not use uthash hash tables */
 #define DTLS_PEERS_NOHASH 1
 
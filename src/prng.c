@@ -0,0 +1,195 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2011, 2012, 2013, 2014, 2015 Olaf Bergmann (TZI) and others.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v. 1.0 which accompanies this distribution.
+ *
+ * The Eclipse Public License is available at http://www.eclipse.org/legal/epl-v10.html
+ * and the Eclipse Distribution License is available at
+ * http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ *******************************************************************************/
+
+/*
+ * dtls_prng() for platforms other than Contiki: AES-128 in counter mode
+ * keyed from the operating system (getrandom() or /dev/urandom), with
+ * one generator per thread, so that the fast path takes no lock.
+ *
+ * The output is computed in batches of DTLS_PRNG_BATCH bytes. The first
+ * block of each batch becomes the key of the next one, and the bytes are
+ * erased from the buffer once they have been returned, so the state of
+ * a generator does not reveal its earlier output. The key is renewed
+ * from the operating system every DTLS_PRNG_RESEED_INTERVAL batches and
+ * in the child after fork(), which would otherwise continue with a copy
+ * of the parent's state.
+ */
+
+#include "tinydtls.h"
+
+#ifndef WITH_CONTIKI
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#ifdef HAVE_SYS_RANDOM_H
+#include <sys/random.h>
+#endif
+
+#include "aes/rijndael.h"
+#include "prng.h"
+
+/** Output computed at once, a multiple of the AES block size. */
+#define DTLS_PRNG_BATCH 512
+
+/** Number of batches after which the key is renewed from the OS. */
+#define DTLS_PRNG_RESEED_INTERVAL 65536
+
+#define DTLS_PRNG_BLOCK 16
+
+typedef struct {
+  rijndael_ctx aes;			/**< AES-128 with the current key */
+  unsigned char ctr[DTLS_PRNG_BLOCK];	/**< counter block */
+  unsigned char buf[DTLS_PRNG_BATCH];	/**< output of the current batch */
+  size_t avail;				/**< unused bytes at the end of buf */
+  unsigned long batches;		/**< batches since the last seed */
+  unsigned int fork_count;		/**< prng_fork_count when seeded */
+  int seeded;
+} dtls_prng_state_t;
+
+#ifdef __GNUC__
+static __thread dtls_prng_state_t prng_state;
+#define PRNG_LOCK()
+#define PRNG_UNLOCK()
+#else /* __GNUC__ */
+/* without thread-local storage all threads share one generator */
+static dtls_prng_state_t prng_state;
+static pthread_mutex_t prng_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define PRNG_LOCK() pthread_mutex_lock(&prng_mutex)
+#define PRNG_UNLOCK() pthread_mutex_unlock(&prng_mutex)
+#endif /* __GNUC__ */
+
+/* incremented in the child after each fork() */
+static volatile unsigned int prng_fork_count;
+static pthread_once_t prng_once = PTHREAD_ONCE_INIT;
+
+static void
+prng_forked(void) {
+  prng_fork_count++;
+}
+
+static void
+prng_register_fork_handler(void) {
+  pthread_atfork(NULL, NULL, prng_forked);
+}
+
+/** Reads @p len bytes of entropy from the operating system. */
+static int
+prng_entropy(unsigned char *buf, size_t len) {
+  FILE *urandom;
+  size_t n;
+
+#ifdef HAVE_GETRANDOM
+  ssize_t res;
+
+  while (len > 0) {
+    res = getrandom(buf, len, 0);
+    if (res < 0) {
+      if (errno == EINTR)
+	continue;
+      break;			/* e.g. ENOSYS, try /dev/urandom */
+    }
+    buf += res;
+    len -= res;
+  }
+  if (len == 0)
+    return 1;
+#endif /* HAVE_GETRANDOM */
+
+  urandom = fopen("/dev/urandom", "rb");
+  if (!urandom)
+    return 0;
+  n = fread(buf, 1, len, urandom);
+  fclose(urandom);
+  return n == len;
+}
+
+static int
+prng_seed(dtls_prng_state_t *st) {
+  unsigned char seed[2 * DTLS_PRNG_BLOCK];
+
+  pthread_once(&prng_once, prng_register_fork_handler);
+
+  if (!prng_entropy(seed, sizeof(seed)))
+    return 0;
+
+  rijndael_set_key_enc_only(&st->aes, seed, 8 * DTLS_PRNG_BLOCK);
+  memcpy(st->ctr, seed + DTLS_PRNG_BLOCK, DTLS_PRNG_BLOCK);
+  memset(st->buf, 0, sizeof(st->buf));
+  memset(seed, 0, sizeof(seed));
+  st->avail = 0;
+  st->batches = 0;
+  st->fork_count = prng_fork_count;
+  st->seeded = 1;
+  return 1;
+}
+
+static void
+prng_refill(dtls_prng_state_t *st) {
+  int i, j;
+
+  for (i = 0; i < DTLS_PRNG_BATCH; i += DTLS_PRNG_BLOCK) {
+    /* big-endian increment of the counter block */
+    for (j = DTLS_PRNG_BLOCK - 1; j >= 0 && ++st->ctr[j] == 0; j--)
+      ;
+    rijndael_encrypt(&st->aes, st->ctr, st->buf + i);
+  }
+
+  /* the first block is the next key and never returned */
+  rijndael_set_key_enc_only(&st->aes, st->buf, 8 * DTLS_PRNG_BLOCK);
+  memset(st->buf, 0, DTLS_PRNG_BLOCK);
+  st->avail = DTLS_PRNG_BATCH - DTLS_PRNG_BLOCK;
+  st->batches++;
+}
+
+int
+dtls_prng(unsigned char *buf, size_t len) {
+  dtls_prng_state_t *st = &prng_state;
+  unsigned char *out;
+  size_t n;
+
+  PRNG_LOCK();
+  if (!st->seeded || st->fork_count != prng_fork_count
+      || st->batches >= DTLS_PRNG_RESEED_INTERVAL) {
+    if (!prng_seed(st)) {
+      PRNG_UNLOCK();
+      return 0;
+    }
+  }
+
+  while (len > 0) {
+    if (st->avail == 0)
+      prng_refill(st);
+
+    n = len < st->avail ? len : st->avail;
+    out = st->buf + DTLS_PRNG_BATCH - st->avail;
+    memcpy(buf, out, n);
+    memset(out, 0, n);
+    st->avail -= n;
+    buf += n;
+    len -= n;
+  }
+  PRNG_UNLOCK();
+  return 1;
+}
+
+void
+dtls_prng_init(unsigned short seed) {
+  /* the generator is seeded from the operating system, the next call
+   * of dtls_prng() in this thread takes a new key */
+  (void)seed;
+  PRNG_LOCK();
+  prng_state.seeded = 0;
+  PRNG_UNLOCK();
+}
+#endif /* WITH_CONTIKI */
@@ -31,24 +31,24 @@
  */
 
 #ifndef WITH_CONTIKI
-#include <stdlib.h>
+#include <stddef.h>
 
 /**
- * Fills \p buf with \p len random bytes. This is the default
- * implementation for prng().  You might want to change prng() to use
- * a better PRNG on your specific platform.
+ * Fills \p buf with \p len random bytes from a cryptographically
+ * secure generator (AES-128 in counter mode, see prng.c). Each thread
+ * has its own generator that is seeded from the operating system on
+ * first use, again after fork() and at regular intervals. This
+ * function returns \c 1 on success, or \c 0 if no entropy could be
+ * obtained from the operating system.
  */
-static inline int
-dtls_prng(unsigned char *buf, size_t len) {
-  while (len--)
-    *buf++ = rand() & 0xFF;
-  return 1;
-}
+int dtls_prng(unsigned char *buf, size_t len);
 
-static inline void
-dtls_prng_init(unsigned short seed) {
-	srand(seed);
-}
+/**
+ * Makes the calling thread's generator take a new key from the
+ * operating system on its next use. The \p seed is ignored, it is
+ * kept for the Contiki version.
+ */
+void dtls_prng_init(unsigned short seed);
 #else /* WITH_CONTIKI */
 #include <string.h>
 #include "random.h"
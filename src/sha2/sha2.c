@@ -245,7 +245,20 @@ typedef u_int64_t sha2_word64;	/* Exactly 8 bytes */
  * only.
  */
 void dtls_sha512_last(dtls_sha512_ctx*);
-void dtls_sha256_transform(dtls_sha256_ctx*, const sha2_word32*);
+#ifdef SHA2_X86
+/*
+ * On x86 the portable transform below is one of the backends of
+ * sha2_x86.c, which dtls_sha256_compress() selects at run time.
+ */
+#define dtls_sha256_transform dtls_sha256_transform_c
+void dtls_sha256_blocks_x86(sha2_word32*, const sha2_byte*, size_t);
+#elif defined(AVRSHA_USE_ASM)
+/* The AVR assembler transform of the NTRU code (ntru/avrasm): */
+void sha256_compress_avr(sha2_word32*, const sha2_byte*);
+#endif /* SHA2_X86 */
+void dtls_sha256_transform(sha2_word32*, const sha2_word32*);
+#define SHA256_TRANSFORM(context, data) \
+	dtls_sha256_compress((context)->state, (const sha2_byte*)(data), 1)
 void dtls_sha512_transform(dtls_sha512_ctx*, const sha2_word64*);
 
 #ifdef WITH_SHA256
@@ -412,22 +425,20 @@ void dtls_sha256_init(dtls_sha256_ctx* context) {
 	(h) = T1 + Sigma0_256(a) + Maj((a), (b), (c)); \
 	j++
 
-void dtls_sha256_transform(dtls_sha256_ctx* context, const sha2_word32* data) {
+void dtls_sha256_transform(sha2_word32* state, const sha2_word32* data) {
 	sha2_word32	a, b, c, d, e, f, g, h, s0, s1;
-	sha2_word32	T1, *W256;
+	sha2_word32	T1, W256[16];
 	int		j;
 
-	W256 = (sha2_word32*)context->buffer;
-
 	/* Initialize registers with the prev. intermediate value */
-	a = context->state[0];
-	b = context->state[1];
-	c = context->state[2];
-	d = context->state[3];
-	e = context->state[4];
-	f = context->state[5];
-	g = context->state[6];
-	h = context->state[7];
+	a = state[0];
+	b = state[1];
+	c = state[2];
+	d = state[3];
+	e = state[4];
+	f = state[5];
+	g = state[6];
+	h = state[7];
 
 	j = 0;
 	do {
@@ -455,14 +466,14 @@ void dtls_sha256_transform(dtls_sha256_ctx* context, const sha2_word32* data) {
 	} while (j < 64);
 
 	/* Compute the current intermediate hash value */
-	context->state[0] += a;
-	context->state[1] += b;
-	context->state[2] += c;
-	context->state[3] += d;
-	context->state[4] += e;
-	context->state[5] += f;
-	context->state[6] += g;
-	context->state[7] += h;
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
+	state[5] += f;
+	state[6] += g;
+	state[7] += h;
 
 	/* Clean up */
 	a = b = c = d = e = f = g = h = T1 = 0;
@@ -470,22 +481,20 @@ void dtls_sha256_transform(dtls_sha256_ctx* context, const sha2_word32* data) {
 
 #else /* SHA2_UNROLL_TRANSFORM */
 
-void dtls_sha256_transform(dtls_sha256_ctx* context, const sha2_word32* data) {
+void dtls_sha256_transform(sha2_word32* state, const sha2_word32* data) {
 	sha2_word32	a, b, c, d, e, f, g, h, s0, s1;
-	sha2_word32	T1, T2, *W256;
+	sha2_word32	T1, T2, W256[16];
 	int		j;
 
-	W256 = (sha2_word32*)context->buffer;
-
 	/* Initialize registers with the prev. intermediate value */
-	a = context->state[0];
-	b = context->state[1];
-	c = context->state[2];
-	d = context->state[3];
-	e = context->state[4];
-	f = context->state[5];
-	g = context->state[6];
-	h = context->state[7];
+	a = state[0];
+	b = state[1];
+	c = state[2];
+	d = state[3];
+	e = state[4];
+	f = state[5];
+	g = state[6];
+	h = state[7];
 
 	j = 0;
 	do {
@@ -535,14 +544,14 @@ void dtls_sha256_transform(dtls_sha256_ctx* context, const sha2_word32* data) {
 	} while (j < 64);
 
 	/* Compute the current intermediate hash value */
-	context->state[0] += a;
-	context->state[1] += b;
-	context->state[2] += c;
-	context->state[3] += d;
-	context->state[4] += e;
-	context->state[5] += f;
-	context->state[6] += g;
-	context->state[7] += h;
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
+	state[5] += f;
+	state[6] += g;
+	state[7] += h;
 
 	/* Clean up */
 	a = b = c = d = e = f = g = h = T1 = T2 = 0;
@@ -550,8 +559,30 @@ void dtls_sha256_transform(dtls_sha256_ctx* context, const sha2_word32* data) {
 
 #endif /* SHA2_UNROLL_TRANSFORM */
 
+/*
+ * The transform of complete blocks for dtls_sha256_update() and the
+ * NTRU code (ntru/sha256.c): on x86 the backend of sha2_x86.c, on AVR
+ * the assembler version if AVRSHA_USE_ASM is defined, and the portable
+ * C version otherwise.
+ */
+void dtls_sha256_compress(sha2_word32* state, const sha2_byte* data, size_t blocks) {
+#ifdef SHA2_X86
+	dtls_sha256_blocks_x86(state, data, blocks);
+#else /* SHA2_X86 */
+	for (; blocks > 0; blocks--) {
+#ifdef AVRSHA_USE_ASM
+		sha256_compress_avr(state, data);
+#else
+		dtls_sha256_transform(state, (const sha2_word32*)data);
+#endif
+		data += DTLS_SHA256_BLOCK_LENGTH;
+	}
+#endif /* SHA2_X86 */
+}
+
 void dtls_sha256_update(dtls_sha256_ctx* context, const sha2_byte *data, size_t len) {
 	unsigned int	freespace, usedspace;
+	size_t		blocks;
 
 	if (len == 0) {
 		/* Calling with no data is valid - we do nothing */
@@ -572,7 +603,7 @@ void dtls_sha256_update(dtls_sha256_ctx* context, const sha2_byte *data, size_t
 			context->bitcount += freespace << 3;
 			len -= freespace;
 			data += freespace;
-			dtls_sha256_transform(context, (sha2_word32*)context->buffer);
+			SHA256_TRANSFORM(context, context->buffer);
 		} else {
 			/* The buffer is not yet full */
 			MEMCPY_BCOPY(&context->buffer[usedspace], data, len);
@@ -582,12 +613,13 @@ void dtls_sha256_update(dtls_sha256_ctx* context, const sha2_byte *data, size_t
 			return;
 		}
 	}
-	while (len >= DTLS_SHA256_BLOCK_LENGTH) {
-		/* Process as many complete blocks as we can */
-		dtls_sha256_transform(context, (sha2_word32*)data);
-		context->bitcount += DTLS_SHA256_BLOCK_LENGTH << 3;
-		len -= DTLS_SHA256_BLOCK_LENGTH;
-		data += DTLS_SHA256_BLOCK_LENGTH;
+	if (len >= DTLS_SHA256_BLOCK_LENGTH) {
+		/* Process all complete blocks with one call of the transform */
+		blocks = len / DTLS_SHA256_BLOCK_LENGTH;
+		dtls_sha256_compress(context->state, data, blocks);
+		context->bitcount += (sha2_word64)blocks * DTLS_SHA256_BLOCK_LENGTH << 3;
+		len -= blocks * DTLS_SHA256_BLOCK_LENGTH;
+		data += blocks * DTLS_SHA256_BLOCK_LENGTH;
 	}
 	if (len > 0) {
 		/* There's left-overs, so save 'em */
@@ -624,7 +656,7 @@ void dtls_sha256_final(sha2_byte digest[], dtls_sha256_ctx* context) {
 					MEMSET_BZERO(&context->buffer[usedspace], DTLS_SHA256_BLOCK_LENGTH - usedspace);
 				}
 				/* Do second-to-last transform: */
-				dtls_sha256_transform(context, (sha2_word32*)context->buffer);
+				SHA256_TRANSFORM(context, context->buffer);
 
 				/* And set-up for the last transform: */
 				MEMSET_BZERO(context->buffer, DTLS_SHA256_SHORT_BLOCK_LENGTH);
@@ -640,7 +672,7 @@ void dtls_sha256_final(sha2_byte digest[], dtls_sha256_ctx* context) {
                 *(sha2_word64*)(context->buffer+DTLS_SHA256_SHORT_BLOCK_LENGTH) = context->bitcount;
 
 		/* Final transform: */
-		dtls_sha256_transform(context, (sha2_word32*)context->buffer);
+		SHA256_TRANSFORM(context, context->buffer);
 
 #if BYTE_ORDER == LITTLE_ENDIAN
 		{
@@ -691,6 +723,81 @@ char* dtls_sha256_data(const sha2_byte* data, size_t len, char digest[DTLS_SHA25
 	dtls_sha256_update(&context, data, len);
 	return dtls_sha256_end(&context, digest);
 }
+
+/*** SHA-256 Multi-Buffer: ********************************************/
+#ifdef SHA2_X86
+void dtls_sha256_mb_blocks_x86(sha2_word32* const[], const sha2_byte* const[], int);
+#define SHA256_MB_BLOCKS(state, block, n) \
+	dtls_sha256_mb_blocks_x86((state), (block), (n))
+#else /* SHA2_X86 */
+static void sha256_mb_blocks(sha2_word32* const state[], const sha2_byte* const block[], int n) {
+	int		i;
+
+	for (i = 0; i < n; i++) {
+		dtls_sha256_compress(state[i], block[i], 1);
+	}
+}
+#define SHA256_MB_BLOCKS(state, block, n) \
+	sha256_mb_blocks((state), (block), (n))
+#endif /* SHA2_X86 */
+
+void dtls_sha256_mb(const dtls_sha256_ctx* prefix, int n, const sha2_byte* const msg[], const size_t len[], sha2_byte* const digest[]) {
+	sha2_word32	state[DTLS_SHA256_MB_MAX][8], *st[DTLS_SHA256_MB_MAX];
+	sha2_byte	tail[DTLS_SHA256_MB_MAX][2 * DTLS_SHA256_BLOCK_LENGTH];
+	const sha2_byte	*blk[DTLS_SHA256_MB_MAX];
+	size_t		full[DTLS_SHA256_MB_MAX], total[DTLS_SHA256_MB_MAX];
+	size_t		rest, t;
+	sha2_word64	bitcount;
+	int		i, j, m;
+
+	/* Sanity check: */
+	assert(n >= 0 && n <= DTLS_SHA256_MB_MAX);
+	assert(prefix == (dtls_sha256_ctx*)0 ||
+	       ((prefix->bitcount >> 3) % DTLS_SHA256_BLOCK_LENGTH) == 0);
+
+	/* Complete blocks are read from the messages, the padded rest
+	 * (one or two blocks) from tail: */
+	for (i = 0; i < n; i++) {
+		MEMCPY_BCOPY(state[i], prefix ? prefix->state : sha256_initial_hash_value, sizeof(state[i]));
+		full[i] = len[i] / DTLS_SHA256_BLOCK_LENGTH;
+		rest = len[i] % DTLS_SHA256_BLOCK_LENGTH;
+		MEMSET_BZERO(tail[i], sizeof(tail[i]));
+		MEMCPY_BCOPY(tail[i], msg[i] + full[i] * DTLS_SHA256_BLOCK_LENGTH, rest);
+		tail[i][rest] = 0x80;
+		total[i] = full[i] + (rest < DTLS_SHA256_SHORT_BLOCK_LENGTH ? 1 : 2);
+		bitcount = (prefix ? prefix->bitcount : 0) + ((sha2_word64)len[i] << 3);
+		for (j = 0; j < 8; j++) {
+			tail[i][(total[i] - full[i]) * DTLS_SHA256_BLOCK_LENGTH - 1 - j] = (sha2_byte)(bitcount >> 8 * j);
+		}
+	}
+
+	/* Block t of all messages that are not yet finished: */
+	for (t = 0; ; t++) {
+		for (i = m = 0; i < n; i++) {
+			if (t < total[i]) {
+				st[m] = state[i];
+				blk[m++] = t < full[i] ? msg[i] + t * DTLS_SHA256_BLOCK_LENGTH :
+					tail[i] + (t - full[i]) * DTLS_SHA256_BLOCK_LENGTH;
+			}
+		}
+		if (m == 0)
+			break;
+		SHA256_MB_BLOCKS(st, blk, m);
+	}
+
+	for (i = 0; i < n; i++) {
+		for (j = 0; j < 8; j++) {
+			digest[i][4 * j] = (sha2_byte)(state[i][j] >> 24);
+			digest[i][4 * j + 1] = (sha2_byte)(state[i][j] >> 16);
+			digest[i][4 * j + 2] = (sha2_byte)(state[i][j] >> 8);
+			digest[i][4 * j + 3] = (sha2_byte)state[i][j];
+		}
+	}
+
+	/* Clean up state data: */
+	MEMSET_BZERO(state, sizeof(state));
+	MEMSET_BZERO(tail, sizeof(tail));
+}
 #endif
 
 /*** SHA-512: *********************************************************/
@@ -988,7 +1095,7 @@ void dtls_sha512_final(sha2_byte digest[], dtls_sha512_ctx* context) {
 	}
 
 	/* Zero out state data */
-	MEMSET_BZERO(context, sizeof(context));
+	MEMSET_BZERO(context, sizeof(*context));
 }
 
 char *dtls_sha512_end(dtls_sha512_ctx* context, char buffer[]) {
@@ -1008,7 +1115,7 @@ char *dtls_sha512_end(dtls_sha512_ctx* context, char buffer[]) {
 		}
 		*buffer = (char)0;
 	} else {
-		MEMSET_BZERO(context, sizeof(context));
+		MEMSET_BZERO(context, sizeof(*context));
 	}
 	MEMSET_BZERO(digest, DTLS_SHA512_DIGEST_LENGTH);
 	return buffer;
@@ -1064,7 +1171,7 @@ void dtls_sha384_final(sha2_byte digest[], dtls_sha384_ctx* context) {
 	}
 
 	/* Zero out state data */
-	MEMSET_BZERO(context, sizeof(context));
+	MEMSET_BZERO(context, sizeof(*context));
 }
 
 char *dtls_sha384_end(dtls_sha384_ctx* context, char buffer[]) {
@@ -1084,7 +1191,7 @@ char *dtls_sha384_end(dtls_sha384_ctx* context, char buffer[]) {
 		}
 		*buffer = (char)0;
 	} else {
-		MEMSET_BZERO(context, sizeof(context));
+		MEMSET_BZERO(context, sizeof(*context));
 	}
 	MEMSET_BZERO(digest, DTLS_SHA384_DIGEST_LENGTH);
 	return buffer;
@@ -124,6 +124,62 @@ typedef struct _dtls_sha512_ctx {
 typedef dtls_sha512_ctx dtls_sha384_ctx;
 
 
+/*** SHA-256 Backends on x86 ******************************************/
+/*
+ * With GCC or Clang on x86, the SHA-256 transform is selected at run
+ * time: the SHA extensions (SHA-NI) if the CPU has them, otherwise an
+ * AVX2 version that computes the message schedule with vector
+ * instructions, otherwise the portable C version.  SSE2 only adds
+ * 4-lane multi-buffer hashing (see below) to the C version.  The
+ * best backend is selected once at program start-up.  A test or
+ * benchmark can switch to another one with dtls_sha256_select(),
+ * which returns the selected backend (see sha2speed.c), but not while
+ * other threads are hashing.
+ */
+#if defined(WITH_SHA256) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define SHA2_X86
+#define DTLS_SHA256_C		0
+#define DTLS_SHA256_SSE2	1
+#define DTLS_SHA256_AVX2	2
+#define DTLS_SHA256_SHANI	3
+#define DTLS_SHA256_BEST	4
+int dtls_sha256_select(int impl);
+#endif
+
+
+/*** SHA-256 Compression Function *************************************/
+/*
+ * dtls_sha256_compress() processes complete 64-byte blocks with the
+ * fastest transform of the platform: the backend selected on x86 (see
+ * above), the assembler version of the NTRU code on AVR if
+ * AVRSHA_USE_ASM is defined, and the portable C version otherwise.
+ * AVRSHA_USE_ASM is defined for all AVR targets, which then have to
+ * link ntru/avrasm/sha256_compress.S (see Makefile.tinydtls).  It
+ * is used by dtls_sha256_update() and, when built with SHA256_DTLS, by
+ * the NTRU code (ntru/sha256.c), so that both get the same speed.  The
+ * caller is responsible for the padding.
+ */
+#if defined(__AVR__) && !defined(AVRSHA_USE_ASM)
+#define AVRSHA_USE_ASM
+#endif
+
+
+/*** SHA-256 Multi-Buffer *********************************************/
+/*
+ * dtls_sha256_mb() hashes up to DTLS_SHA256_MB_MAX independent messages
+ * at once, which is faster than one after the other for short messages
+ * such as the cookies of a burst of ClientHellos: on x86 the blocks of
+ * 8 (AVX2) or 4 (SSE2) messages are processed in the lanes of a vector
+ * register.  The digest of msg[i] is written to digest[i].  If prefix
+ * is not NULL, every message is hashed as if prefix had been fed to
+ * dtls_sha256_update() first; prefix must contain a multiple of
+ * DTLS_SHA256_BLOCK_LENGTH bytes (e.g. the HMAC ipad) and is not
+ * modified.
+ */
+#define DTLS_SHA256_MB_MAX	8
+
+
 /*** SHA-256/384/512 Function Prototypes ******************************/
 #ifndef NOPROTO
 #ifdef SHA2_USE_INTTYPES_H
@@ -134,6 +190,8 @@ void dtls_sha256_update(dtls_sha256_ctx*, const uint8_t*, size_t);
 void dtls_sha256_final(uint8_t[DTLS_SHA256_DIGEST_LENGTH], dtls_sha256_ctx*);
 char* dtls_sha256_end(dtls_sha256_ctx*, char[DTLS_SHA256_DIGEST_STRING_LENGTH]);
 char* dtls_sha256_data(const uint8_t*, size_t, char[DTLS_SHA256_DIGEST_STRING_LENGTH]);
+void dtls_sha256_mb(const dtls_sha256_ctx*, int, const uint8_t* const[], const size_t[], uint8_t* const[]);
+void dtls_sha256_compress(uint32_t*, const uint8_t*, size_t);
 #endif
 
 #ifdef WITH_SHA384
@@ -160,6 +218,8 @@ void dtls_sha256_update(dtls_sha256_ctx*, const u_int8_t*, size_t);
 void dtls_sha256_final(u_int8_t[DTLS_SHA256_DIGEST_LENGTH], dtls_sha256_ctx*);
 char* dtls_sha256_end(dtls_sha256_ctx*, char[DTLS_SHA256_DIGEST_STRING_LENGTH]);
 char* dtls_sha256_data(const u_int8_t*, size_t, char[DTLS_SHA256_DIGEST_STRING_LENGTH]);
+void dtls_sha256_mb(const dtls_sha256_ctx*, int, const u_int8_t* const[], const size_t[], u_int8_t* const[]);
+void dtls_sha256_compress(u_int32_t*, const u_int8_t*, size_t);
 #endif
 
 #ifdef WITH_SHA384
@@ -188,6 +248,8 @@ void dtls_sha256_update();
 void dtls_sha256_final();
 char* dtls_sha256_end();
 char* dtls_sha256_data();
+void dtls_sha256_mb();
+void dtls_sha256_compress();
 #endif
 
 #ifdef WITH_SHA384
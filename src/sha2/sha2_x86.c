@@ -0,0 +1,430 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2011, 2012, 2013, 2014, 2015 Olaf Bergmann (TZI) and others.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v. 1.0 which accompanies this distribution.
+ *
+ * The Eclipse Public License is available at http://www.eclipse.org/legal/epl-v10.html
+ * and the Eclipse Distribution License is available at
+ * http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ *******************************************************************************/
+
+/*
+ * SHA-256 backends for x86, selected at run time by dtls_sha256_select()
+ * (see sha2.h):
+ *
+ * - SHA-NI: the rounds and the message schedule use the SHA extensions
+ *   (sha256rnds2, sha256msg1, sha256msg2), the state is kept in two
+ *   vector registers in the ABEF/CDGH order these instructions expect.
+ *
+ * - AVX2: the message schedule of two blocks is computed at once, one
+ *   block in each 128-bit lane, and stored with the round constants
+ *   already added; the rounds are scalar and use the BMI2 rotations.
+ *   Since sigma1 of W[t] depends on W[t-2], four words of the schedule
+ *   are computed in two steps of two words.
+ *
+ * - C: the portable dtls_sha256_transform() of sha2.c.
+ *
+ * All backends process any number of complete blocks per call, so that
+ * the state stays in registers for long messages.
+ */
+
+#include "sha2.h"
+
+#ifdef SHA2_X86
+
+#include <cpuid.h>
+#include <immintrin.h>
+
+#ifdef SHA2_USE_INTTYPES_H
+typedef uint8_t  sha2_byte;
+typedef uint32_t sha2_word32;
+#else /* SHA2_USE_INTTYPES_H */
+typedef u_int8_t  sha2_byte;
+typedef u_int32_t sha2_word32;
+#endif /* SHA2_USE_INTTYPES_H */
+
+/* the portable transform of sha2.c */
+void dtls_sha256_transform_c(sha2_word32*, const sha2_word32*);
+
+static const sha2_word32 K256[64] = {
+	0x428a2f98UL, 0x71374491UL, 0xb5c0fbcfUL, 0xe9b5dba5UL,
+	0x3956c25bUL, 0x59f111f1UL, 0x923f82a4UL, 0xab1c5ed5UL,
+	0xd807aa98UL, 0x12835b01UL, 0x243185beUL, 0x550c7dc3UL,
+	0x72be5d74UL, 0x80deb1feUL, 0x9bdc06a7UL, 0xc19bf174UL,
+	0xe49b69c1UL, 0xefbe4786UL, 0x0fc19dc6UL, 0x240ca1ccUL,
+	0x2de92c6fUL, 0x4a7484aaUL, 0x5cb0a9dcUL, 0x76f988daUL,
+	0x983e5152UL, 0xa831c66dUL, 0xb00327c8UL, 0xbf597fc7UL,
+	0xc6e00bf3UL, 0xd5a79147UL, 0x06ca6351UL, 0x14292967UL,
+	0x27b70a85UL, 0x2e1b2138UL, 0x4d2c6dfcUL, 0x53380d13UL,
+	0x650a7354UL, 0x766a0abbUL, 0x81c2c92eUL, 0x92722c85UL,
+	0xa2bfe8a1UL, 0xa81a664bUL, 0xc24b8b70UL, 0xc76c51a3UL,
+	0xd192e819UL, 0xd6990624UL, 0xf40e3585UL, 0x106aa070UL,
+	0x19a4c116UL, 0x1e376c08UL, 0x2748774cUL, 0x34b0bcb5UL,
+	0x391c0cb3UL, 0x4ed8aa4aUL, 0x5b9cca4fUL, 0x682e6ff3UL,
+	0x748f82eeUL, 0x78a5636fUL, 0x84c87814UL, 0x8cc70208UL,
+	0x90befffaUL, 0xa4506cebUL, 0xbef9a3f7UL, 0xc67178f2UL
+};
+
+/*** SHA-NI: ***********************************************************/
+
+__attribute__((target("sha,sse4.1")))
+static void sha256_blocks_shani(sha2_word32 *state,
+				const sha2_byte *data, size_t blocks) {
+	const __m128i	bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL,
+					       0x0405060700010203ULL);
+	__m128i		abef, cdgh, abef_save, cdgh_save, tmp, wk, w[4];
+	int		i;
+
+	/* state[0..7] = ABCDEFGH is rearranged to ABEF and CDGH */
+	tmp = _mm_loadu_si128((const __m128i*)&state[0]);
+	cdgh = _mm_loadu_si128((const __m128i*)&state[4]);
+	tmp = _mm_shuffle_epi32(tmp, 0xb1);		/* CDAB */
+	cdgh = _mm_shuffle_epi32(cdgh, 0x1b);		/* EFGH */
+	abef = _mm_alignr_epi8(tmp, cdgh, 8);		/* ABEF */
+	cdgh = _mm_blend_epi16(cdgh, tmp, 0xf0);	/* CDGH */
+
+	while (blocks--) {
+		abef_save = abef;
+		cdgh_save = cdgh;
+
+		for (i = 0; i < 16; i++) {
+			if (i < 4) {
+				tmp = _mm_loadu_si128((const __m128i*)(data + 16*i));
+				w[i] = _mm_shuffle_epi8(tmp, bswap);
+			} else {
+				/* W[t..t+3] from W[t-16..t-1] */
+				tmp = _mm_sha256msg1_epu32(w[i & 3], w[(i+1) & 3]);
+				tmp = _mm_add_epi32(tmp, _mm_alignr_epi8(w[(i+3) & 3],
+									 w[(i+2) & 3], 4));
+				w[i & 3] = _mm_sha256msg2_epu32(tmp, w[(i+3) & 3]);
+			}
+			wk = _mm_add_epi32(w[i & 3],
+					   _mm_loadu_si128((const __m128i*)&K256[4*i]));
+			cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+			wk = _mm_shuffle_epi32(wk, 0x0e);
+			abef = _mm_sha256rnds2_epu32(abef, cdgh, wk);
+		}
+
+		abef = _mm_add_epi32(abef, abef_save);
+		cdgh = _mm_add_epi32(cdgh, cdgh_save);
+		data += DTLS_SHA256_BLOCK_LENGTH;
+	}
+
+	tmp = _mm_shuffle_epi32(abef, 0x1b);		/* FEBA */
+	cdgh = _mm_shuffle_epi32(cdgh, 0xb1);		/* DCHG */
+	abef = _mm_blend_epi16(tmp, cdgh, 0xf0);	/* DCBA */
+	cdgh = _mm_alignr_epi8(cdgh, tmp, 8);		/* HGFE */
+	_mm_storeu_si128((__m128i*)&state[0], abef);
+	_mm_storeu_si128((__m128i*)&state[4], cdgh);
+}
+
+/*** AVX2: *************************************************************/
+
+#define S32(b,x)	(((x) >> (b)) | ((x) << (32 - (b))))
+#define Ch(x,y,z)	(((x) & (y)) ^ ((~(x)) & (z)))
+#define Maj(x,y,z)	(((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define Sigma0_256(x)	(S32(2,  (x)) ^ S32(13, (x)) ^ S32(22, (x)))
+#define Sigma1_256(x)	(S32(6,  (x)) ^ S32(11, (x)) ^ S32(25, (x)))
+
+/* sigma0 and sigma1 of the eight words of a vector */
+#define VROR(x,b)	_mm256_or_si256(_mm256_srli_epi32((x), (b)), \
+					_mm256_slli_epi32((x), 32 - (b)))
+#define VSIGMA0(x)	_mm256_xor_si256(_mm256_xor_si256(VROR((x), 7), \
+				VROR((x), 18)), _mm256_srli_epi32((x), 3))
+#define VSIGMA1(x)	_mm256_xor_si256(_mm256_xor_si256(VROR((x), 17), \
+				VROR((x), 19)), _mm256_srli_epi32((x), 10))
+
+#define ROUND256(a,b,c,d,e,f,g,h,j)	\
+	T1 = (h) + Sigma1_256(e) + Ch((e), (f), (g)) + wk[j]; \
+	(d) += T1; \
+	(h) = T1 + Sigma0_256(a) + Maj((a), (b), (c))
+
+/*
+ * Message schedule of the blocks data0 (low lane) and data1 (high lane),
+ * stored as W[t] + K[t] in wk0 and wk1.
+ */
+__attribute__((target("avx2")))
+static void sha256_schedule_avx2(sha2_word32 *wk0, sha2_word32 *wk1,
+				 const sha2_byte *data0,
+				 const sha2_byte *data1) {
+	const __m256i	bswap = _mm256_set_epi64x(0x0c0d0e0f08090a0bULL,
+						  0x0405060700010203ULL,
+						  0x0c0d0e0f08090a0bULL,
+						  0x0405060700010203ULL);
+	__m256i		w[4], tmp, s1, k;
+	int		i;
+
+	for (i = 0; i < 16; i++) {
+		if (i < 4) {
+			tmp = _mm256_castsi128_si256(
+				_mm_loadu_si128((const __m128i*)(data0 + 16*i)));
+			tmp = _mm256_inserti128_si256(tmp,
+				_mm_loadu_si128((const __m128i*)(data1 + 16*i)), 1);
+			w[i] = _mm256_shuffle_epi8(tmp, bswap);
+		} else {
+			/* W[t-16] + sigma0(W[t-15]) + W[t-7] */
+			tmp = _mm256_alignr_epi8(w[(i+1) & 3], w[i & 3], 4);
+			tmp = _mm256_add_epi32(w[i & 3], VSIGMA0(tmp));
+			tmp = _mm256_add_epi32(tmp, _mm256_alignr_epi8(w[(i+3) & 3],
+								   w[(i+2) & 3], 4));
+			/* sigma1(W[t-2]), sigma1(W[t-1]) in the lower two words */
+			s1 = _mm256_shuffle_epi32(w[(i+3) & 3], 0xfe);
+			s1 = _mm256_srli_si256(_mm256_slli_si256(VSIGMA1(s1), 8), 8);
+			tmp = _mm256_add_epi32(tmp, s1);
+			/* sigma1(W[t]), sigma1(W[t+1]) in the upper two words */
+			s1 = _mm256_slli_si256(VSIGMA1(tmp), 8);
+			w[i & 3] = _mm256_add_epi32(tmp, s1);
+		}
+		k = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((const __m128i*)&K256[4*i]));
+		tmp = _mm256_add_epi32(w[i & 3], k);
+		_mm_storeu_si128((__m128i*)&wk0[4*i],
+				 _mm256_castsi256_si128(tmp));
+		_mm_storeu_si128((__m128i*)&wk1[4*i],
+				 _mm256_extracti128_si256(tmp, 1));
+	}
+}
+
+__attribute__((target("avx2,bmi2")))
+static void sha256_rounds_avx2(sha2_word32 *state, const sha2_word32 *wk) {
+	sha2_word32	a, b, c, d, e, f, g, h, T1;
+	int		j;
+
+	a = state[0];
+	b = state[1];
+	c = state[2];
+	d = state[3];
+	e = state[4];
+	f = state[5];
+	g = state[6];
+	h = state[7];
+
+	for (j = 0; j < 64; j += 8) {
+		ROUND256(a,b,c,d,e,f,g,h,j);
+		ROUND256(h,a,b,c,d,e,f,g,j+1);
+		ROUND256(g,h,a,b,c,d,e,f,j+2);
+		ROUND256(f,g,h,a,b,c,d,e,j+3);
+		ROUND256(e,f,g,h,a,b,c,d,j+4);
+		ROUND256(d,e,f,g,h,a,b,c,j+5);
+		ROUND256(c,d,e,f,g,h,a,b,j+6);
+		ROUND256(b,c,d,e,f,g,h,a,j+7);
+	}
+
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
+	state[5] += f;
+	state[6] += g;
+	state[7] += h;
+}
+
+static void sha256_blocks_avx2(sha2_word32 *state,
+			       const sha2_byte *data, size_t blocks) {
+	sha2_word32	wk[2][64];
+
+	while (blocks >= 2) {
+		sha256_schedule_avx2(wk[0], wk[1], data,
+				     data + DTLS_SHA256_BLOCK_LENGTH);
+		sha256_rounds_avx2(state, wk[0]);
+		sha256_rounds_avx2(state, wk[1]);
+		data += 2*DTLS_SHA256_BLOCK_LENGTH;
+		blocks -= 2;
+	}
+	if (blocks) {
+		/* the upper lane repeats the last block and is not used */
+		sha256_schedule_avx2(wk[0], wk[1], data, data);
+		sha256_rounds_avx2(state, wk[0]);
+	}
+}
+
+/*** C: ****************************************************************/
+
+static void sha256_blocks_c(sha2_word32 *state,
+			    const sha2_byte *data, size_t blocks) {
+	while (blocks--) {
+		dtls_sha256_transform_c(state, (const sha2_word32*)data);
+		data += DTLS_SHA256_BLOCK_LENGTH;
+	}
+}
+
+/*** Multi-buffer: ****************************************************/
+
+/*
+ * The multi-buffer kernels compute one block of each of 4 (SSE2) or 8
+ * (AVX2) independent messages, whereby vector register j holds word j
+ * of the state (or of the message schedule) of every lane. Unused lanes
+ * repeat lane 0 and are not stored. The GCC vector extensions are used
+ * instead of intrinsics, so that the rounds can be written once with
+ * the macros above.
+ */
+typedef sha2_word32 v4u32 __attribute__((vector_size(16)));
+typedef sha2_word32 v8u32 __attribute__((vector_size(32)));
+
+#define sigma0_256(x)	(S32(7,  (x)) ^ S32(18, (x)) ^ ((x) >> 3))
+#define sigma1_256(x)	(S32(17, (x)) ^ S32(19, (x)) ^ ((x) >> 10))
+
+/* round t of all lanes; W[t] is kept in w[t & 15] */
+#define MB_ROUND(a,b,c,d,e,f,g,h,t)	\
+	if ((t) >= 16) \
+		w[(t) & 15] += sigma1_256(w[((t) - 2) & 15]) + \
+			       w[((t) - 7) & 15] + sigma0_256(w[((t) - 15) & 15]); \
+	T1 = (h) + Sigma1_256(e) + Ch((e), (f), (g)) + K256[t] + w[(t) & 15]; \
+	(d) += T1; \
+	(h) = T1 + Sigma0_256(a) + Maj((a), (b), (c))
+
+#define MB_ROUNDS	\
+	for (j = 0; j < 64; j += 8) { \
+		MB_ROUND(a,b,c,d,e,f,g,h,j); \
+		MB_ROUND(h,a,b,c,d,e,f,g,j+1); \
+		MB_ROUND(g,h,a,b,c,d,e,f,j+2); \
+		MB_ROUND(f,g,h,a,b,c,d,e,j+3); \
+		MB_ROUND(e,f,g,h,a,b,c,d,j+4); \
+		MB_ROUND(d,e,f,g,h,a,b,c,j+5); \
+		MB_ROUND(c,d,e,f,g,h,a,b,j+6); \
+		MB_ROUND(b,c,d,e,f,g,h,a,j+7); \
+	}
+
+static inline sha2_word32 load_be32(const sha2_byte *p) {
+	return ((sha2_word32)p[0] << 24) | ((sha2_word32)p[1] << 16) |
+	       ((sha2_word32)p[2] << 8) | p[3];
+}
+
+__attribute__((target("sse2")))
+static void sha256_mb4_sse2(sha2_word32 *const state[],
+			    const sha2_byte *const block[], int n) {
+	v4u32		a, b, c, d, e, f, g, h, T1, w[16], s[8];
+	int		i, j;
+
+	for (j = 0; j < 8; j++)
+		for (i = 0; i < 4; i++)
+			s[j][i] = state[i < n ? i : 0][j];
+	for (j = 0; j < 16; j++)
+		for (i = 0; i < 4; i++)
+			w[j][i] = load_be32(block[i < n ? i : 0] + 4*j);
+	a = s[0]; b = s[1]; c = s[2]; d = s[3];
+	e = s[4]; f = s[5]; g = s[6]; h = s[7];
+
+	MB_ROUNDS
+
+	s[0] += a; s[1] += b; s[2] += c; s[3] += d;
+	s[4] += e; s[5] += f; s[6] += g; s[7] += h;
+	for (j = 0; j < 8; j++)
+		for (i = 0; i < n; i++)
+			state[i][j] = s[j][i];
+}
+
+__attribute__((target("avx2")))
+static void sha256_mb8_avx2(sha2_word32 *const state[],
+			    const sha2_byte *const block[], int n) {
+	v8u32		a, b, c, d, e, f, g, h, T1, w[16], s[8];
+	int		i, j;
+
+	for (j = 0; j < 8; j++)
+		for (i = 0; i < 8; i++)
+			s[j][i] = state[i < n ? i : 0][j];
+	for (j = 0; j < 16; j++)
+		for (i = 0; i < 8; i++)
+			w[j][i] = load_be32(block[i < n ? i : 0] + 4*j);
+	a = s[0]; b = s[1]; c = s[2]; d = s[3];
+	e = s[4]; f = s[5]; g = s[6]; h = s[7];
+
+	MB_ROUNDS
+
+	s[0] += a; s[1] += b; s[2] += c; s[3] += d;
+	s[4] += e; s[5] += f; s[6] += g; s[7] += h;
+	for (j = 0; j < 8; j++)
+		for (i = 0; i < n; i++)
+			state[i][j] = s[j][i];
+}
+
+/*** Selection: ********************************************************/
+
+typedef void (*sha256_blocks_fn)(sha2_word32*, const sha2_byte*, size_t);
+
+/*
+ * Set by dtls_sha256_select(), which sha256_select_best() calls before
+ * main(). Setting them on the first call of a backend would be a data
+ * race when several threads hash at the same time.
+ */
+static sha256_blocks_fn blocks_fn;
+static int mb_impl;
+
+/* the SHA extensions are reported in bit 29 of EBX of CPUID leaf 7 */
+static int cpu_has_sha(void) {
+	unsigned int	eax, ebx, ecx, edx;
+
+	if (__get_cpuid_max(0, NULL) < 7)
+		return 0;
+	__cpuid_count(7, 0, eax, ebx, ecx, edx);
+	return (ebx >> 29) & 1;
+}
+
+int dtls_sha256_select(int impl) {
+	int best = DTLS_SHA256_C;
+
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse2"))
+		best = DTLS_SHA256_SSE2;
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2"))
+		best = DTLS_SHA256_AVX2;
+	if (__builtin_cpu_supports("sse4.1") && cpu_has_sha())
+		best = DTLS_SHA256_SHANI;
+	if (impl > best)
+		impl = best;
+
+	switch (impl) {
+	case DTLS_SHA256_SHANI:
+		blocks_fn = sha256_blocks_shani;
+		break;
+	case DTLS_SHA256_AVX2:
+		blocks_fn = sha256_blocks_avx2;
+		break;
+	case DTLS_SHA256_SSE2:
+		/* there is no single-stream SSE2 version */
+		blocks_fn = sha256_blocks_c;
+		break;
+	default:
+		impl = DTLS_SHA256_C;
+		blocks_fn = sha256_blocks_c;
+	}
+	mb_impl = impl;
+
+	return impl;
+}
+
+static void __attribute__((constructor)) sha256_select_best(void) {
+	dtls_sha256_select(DTLS_SHA256_BEST);
+}
+
+void dtls_sha256_blocks_x86(sha2_word32 *state, const sha2_byte *data,
+			    size_t blocks) {
+	blocks_fn(state, data, blocks);
+}
+
+/*
+ * One block of each of n <= DTLS_SHA256_MB_MAX messages, see
+ * dtls_sha256_mb() in sha2.c. A single message, and all messages when
+ * the SHA extensions are selected (which are faster than eight AVX2
+ * lanes), are passed one after the other to the single-stream backend.
+ */
+void dtls_sha256_mb_blocks_x86(sha2_word32 *const state[],
+			       const sha2_byte *const block[], int n) {
+	int		i;
+
+	if (n > 1 && mb_impl == DTLS_SHA256_AVX2) {
+		sha256_mb8_avx2(state, block, n);
+	} else if (n > 1 && mb_impl == DTLS_SHA256_SSE2) {
+		for (i = 0; i < n; i += 4)
+			sha256_mb4_sse2(state + i, block + i, n - i < 4 ? n - i : 4);
+	} else {
+		for (i = 0; i < n; i++)
+			blocks_fn(state[i], block[i], 1);
+	}
+}
+
+#endif /* SHA2_X86 */
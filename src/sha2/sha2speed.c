@@ -39,8 +39,134 @@
 
 #include "sha2.h"
 
+#ifdef SHA2_X86
+#include <x86intrin.h>
+#endif
+
 #define BUFSIZE	16384
 
+/*
+ * Time stamp in cycles on x86 and in nanoseconds elsewhere, where only
+ * the portable SHA-256 transform exists.
+ */
+#ifdef SHA2_X86
+#define TIME_UNIT	"cycles/byte"
+static double timestamp(void) {
+	return (double)__rdtsc();
+}
+#else /* SHA2_X86 */
+#define TIME_UNIT	"ns/byte"
+static double timestamp(void) {
+	struct timeval	tv;
+
+	gettimeofday(&tv, (struct timezone*)0);
+	return tv.tv_sec * 1e9 + tv.tv_usec * 1e3;
+}
+#endif /* SHA2_X86 */
+
+/*
+ * Time per byte to hash a message of len bytes (init, update and final,
+ * so the padding block is included), the best of 10 runs.
+ */
+double sha256_per_byte(const unsigned char *buf, int len) {
+	dtls_sha256_ctx	c256;
+	unsigned char	md[DTLS_SHA256_DIGEST_LENGTH];
+	int		loops = 1048576 / len, i, j;
+	double		t, best = 0;
+
+	for (i = 0; i < 10; i++) {
+		t = timestamp();
+		for (j = 0; j < loops; j++) {
+			dtls_sha256_init(&c256);
+			dtls_sha256_update(&c256, buf, len);
+			dtls_sha256_final(md, &c256);
+		}
+		t = (timestamp() - t) / loops / len;
+		if (i == 0 || t < best) {
+			best = t;
+		}
+	}
+	return best;
+}
+
+/*
+ * The same for DTLS_SHA256_MB_MAX messages of len bytes hashed at once
+ * with dtls_sha256_mb(), per byte of all messages.
+ */
+double sha256_mb_per_byte(const unsigned char *buf, int len) {
+	const unsigned char	*msg[DTLS_SHA256_MB_MAX];
+	unsigned char		md[DTLS_SHA256_MB_MAX][DTLS_SHA256_DIGEST_LENGTH];
+	unsigned char		*digest[DTLS_SHA256_MB_MAX];
+	size_t			lens[DTLS_SHA256_MB_MAX];
+	int			loops = 1048576 / len / DTLS_SHA256_MB_MAX + 1, i, j;
+	double			t, best = 0;
+
+	for (i = 0; i < DTLS_SHA256_MB_MAX; i++) {
+		msg[i] = buf;
+		lens[i] = len;
+		digest[i] = md[i];
+	}
+	for (i = 0; i < 10; i++) {
+		t = timestamp();
+		for (j = 0; j < loops; j++) {
+			dtls_sha256_mb(NULL, DTLS_SHA256_MB_MAX, msg, lens, digest);
+		}
+		t = (timestamp() - t) / loops / len / DTLS_SHA256_MB_MAX;
+		if (i == 0 || t < best) {
+			best = t;
+		}
+	}
+	return best;
+}
+
+/*
+ * Table of the speed of each SHA-256 backend for messages of 32 bytes
+ * up to 16 KB, i.e. from cookies and PRF blocks to large records, one
+ * message at a time and with the multi-buffer function.
+ */
+void sha256_backends(const unsigned char *buf) {
+#ifdef SHA2_X86
+	const char	*names[] = { "C", "SSE2", "AVX2", "SHA-NI" };
+	int		impl;
+#endif
+	int		len;
+
+	printf("SHA-256 %-12s", TIME_UNIT);
+	for (len = 32; len <= BUFSIZE; len *= 2) {
+		printf(" %6d", len);
+	}
+	printf("\n");
+#ifdef SHA2_X86
+	for (impl = DTLS_SHA256_C; impl <= DTLS_SHA256_SHANI; impl++) {
+		if (dtls_sha256_select(impl) != impl) {
+			printf("%-20s not supported by this CPU\n", names[impl]);
+			continue;
+		}
+		printf("%-20s", names[impl]);
+		for (len = 32; len <= BUFSIZE; len *= 2) {
+			printf(" %6.2f", sha256_per_byte(buf, len));
+		}
+		printf("\n%-15s x %-2d", names[impl], DTLS_SHA256_MB_MAX);
+		for (len = 32; len <= BUFSIZE; len *= 2) {
+			printf(" %6.2f", sha256_mb_per_byte(buf, len));
+		}
+		printf("\n");
+	}
+	dtls_sha256_select(DTLS_SHA256_BEST);
+#else /* SHA2_X86 */
+	printf("%-20s", "C");
+	for (len = 32; len <= BUFSIZE; len *= 2) {
+		printf(" %6.2f", sha256_per_byte(buf, len));
+	}
+	printf("\n%-15s x %-2d", "C", DTLS_SHA256_MB_MAX);
+	for (len = 32; len <= BUFSIZE; len *= 2) {
+		printf(" %6.2f", sha256_mb_per_byte(buf, len));
+	}
+	printf("\n");
+#endif /* SHA2_X86 */
+	printf("\n");
+}
+
 void usage(char *prog) {
 	fprintf(stderr, "Usage:\t%s [<num-of-bytes>] [<num-of-loops>] [<fill-byte>]\n", prog);
 	exit(-1);
@@ -94,6 +220,8 @@ int main(int argc, char **argv) {
 		memset(buf, 0xb7, BUFSIZE);
 	}
 
+	sha256_backends((unsigned char*)buf);
+
 	ave256 = ave384 = ave512 = 0;
 	best256 = best384 = best512 = 100000;
 	for (i = 0; i < rep; i++) {
@@ -43,6 +43,25 @@ typedef enum {
   DTLS_STATE_CLOSED
 } dtls_state_t;
 
+/**
+ * Maximum size of the handshake messages that are kept for an Ed25519
+ * signature in the CertificateVerify message. Ed25519 signs the
+ * messages themselves instead of their hash. The buffer is allocated
+ * with the first handshake message and released as soon as the
+ * handshake cannot end in an Ed25519 CertificateVerify. Set to 0 to
+ * disable Ed25519 client authentication.
+ */
+#ifndef DTLS_HS_TRANSCRIPT_SIZE
+#ifdef WITH_CONTIKI
+#define DTLS_HS_TRANSCRIPT_SIZE 0
+#elif defined(DTLS_NTRU)
+/* the packed NTRU key and ciphertext add about 1.1k to the handshake */
+#define DTLS_HS_TRANSCRIPT_SIZE 3072
+#else /* WITH_CONTIKI */
+#define DTLS_HS_TRANSCRIPT_SIZE 1024
+#endif /* WITH_CONTIKI */
+#endif /* DTLS_HS_TRANSCRIPT_SIZE */
+
 typedef struct {
   uint16_t mseq_s;	     /**< send handshake message sequence number counter */
   uint16_t mseq_r;	     /**< received handshake message sequence number counter */
@@ -52,5 +71,14 @@ typedef struct {
 
   /* temporary storage for the final handshake hash */
   dtls_hash_ctx hs_hash;
+
+#if DTLS_HS_TRANSCRIPT_SIZE > 0
+  /** length of all handshake messages, may exceed DTLS_HS_TRANSCRIPT_SIZE */
+  size_t transcript_length;
+  /** the handshake messages, NULL until the first one or when unused */
+  uint8 *transcript;
+  /** set when the transcript is not needed for this handshake */
+  int transcript_unused;
+#endif /* DTLS_HS_TRANSCRIPT_SIZE */
 } dtls_hs_state_t;
 #endif /* _DTLS_STATE_H_ */
@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "tinydtls.h"
+#include "chacha20poly1305.h"
+#include "prng.h"
+#include "test-util.h"
+
+#ifdef POLY1305_FORCE_32BIT
+/* built once more with the 26-bit Poly1305, see Makefile.in */
+#define POLY1305_NAME "Poly1305 (26-bit limbs)"
+#else /* POLY1305_FORCE_32BIT */
+#define POLY1305_NAME "Poly1305"
+#endif /* POLY1305_FORCE_32BIT */
+
+static const char sunscreen[] = "Ladies and Gentlemen of the class of '99: "
+  "If I could offer you only one tip for the future, sunscreen would be it.";
+
+/* RFC 8439, section 2.4.2 */
+static void
+chacha20_test(const char *impl) {
+  unsigned char key[32], nonce[12], msg[114], c[114];
+  char name[64];
+  size_t i;
+
+  for (i = 0; i < sizeof(key); i++)
+    key[i] = i;
+  unhex("000000000000004a00000000", nonce);
+  unhex("6e2e359a2568f98041ba0728dd0d6981e97e7aec1d4360c20a27afccfd9fae0b"
+	"f91b65c5524733ab8f593dabcd62b3571639d624e65152ab8f530c359f0861d8"
+	"07ca0dbf500d6a6156a38e088a22b65e52bc514d16ccf806818ce91ab7793736"
+	"5af90bbf74a35be6b40b8eedf2785e42874d", c);
+  memcpy(msg, sunscreen, sizeof(msg));
+  dtls_chacha20(key, nonce, 1, msg, sizeof(msg));
+
+  snprintf(name, sizeof(name), "%s ChaCha20", impl);
+  result(name, memcmp(msg, c, sizeof(msg)) == 0);
+}
+
+/* RFC 8439, section 2.5.2, also with the message in pieces */
+static void
+poly1305_test(void) {
+  static const char text[] = "Cryptographic Forum Research Group";
+  unsigned char key[32], tag[16], expected[16];
+  dtls_poly1305_ctx ctx;
+  size_t split;
+  int ok = 1;
+
+  unhex("85d6be7857556d337f4452fe42d506a80103808afb0db2fd4abff6af4149f51b",
+	key);
+  unhex("a8061dc1305136c6c22b8baf0c0127a9", expected);
+  for (split = 0; split < sizeof(text) - 1; split++) {
+    dtls_poly1305_init(&ctx, key);
+    dtls_poly1305_update(&ctx, (const unsigned char *)text, split);
+    dtls_poly1305_update(&ctx, (const unsigned char *)text + split,
+			 sizeof(text) - 1 - split);
+    dtls_poly1305_finish(&ctx, tag);
+    ok &= memcmp(tag, expected, sizeof(tag)) == 0;
+  }
+  result(POLY1305_NAME, ok);
+}
+
+/* RFC 8439, section 2.8.2 */
+static void
+aead_test(const char *impl) {
+  unsigned char key[32], nonce[12], aad[12], msg[114 + 16], c[114 + 16];
+  char name[64];
+  long int len;
+  size_t i;
+  int ok;
+
+  for (i = 0; i < sizeof(key); i++)
+    key[i] = 0x80 + i;
+  unhex("070000004041424344454647", nonce);
+  unhex("50515253c0c1c2c3c4c5c6c7", aad);
+  unhex("d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d6"
+	"3dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b36"
+	"92ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc"
+	"3ff4def08e4b7a9de576d26586cec64b6116"
+	"1ae10b594f09e26a7e902ecbd0600691", c);
+
+  memcpy(msg, sunscreen, 114);
+  len = dtls_chacha20_poly1305_encrypt_message(key, nonce, msg, 114,
+					       aad, sizeof(aad));
+  ok = len == sizeof(c) && memcmp(msg, c, sizeof(c)) == 0;
+  len = dtls_chacha20_poly1305_decrypt_message(key, nonce, msg, len,
+					       aad, sizeof(aad));
+  ok &= len == 114 && memcmp(msg, sunscreen, 114) == 0;
+
+  /* a modified ciphertext or tag is rejected and not decrypted */
+  for (i = 0; i < sizeof(c); i += 5) {
+    memcpy(msg, c, sizeof(c));
+    msg[i] ^= 0x20;
+    ok &= dtls_chacha20_poly1305_decrypt_message(key, nonce, msg, sizeof(c),
+						 aad, sizeof(aad)) < 0;
+    msg[i] ^= 0x20;
+    ok &= memcmp(msg, c, sizeof(c)) == 0;
+  }
+
+  snprintf(name, sizeof(name), "%s AEAD", impl);
+  result(name, ok);
+}
+
+/* all implementations must agree on the lengths around the groups of
+ * four and eight blocks */
+static void
+cross_test(int best) {
+  unsigned char key[32], nonce[12], orig[1100], msg[1100], ref[1100];
+  size_t len;
+  int impl, ok = 1;
+
+  dtls_prng(key, sizeof(key));
+  dtls_prng(nonce, sizeof(nonce));
+  for (len = 0; len <= sizeof(msg); len += 1 + len / 64) {
+    dtls_prng(orig, len);
+    memcpy(ref, orig, len);
+    dtls_chacha20_select(DTLS_CHACHA20_C);
+    dtls_chacha20(key, nonce, 7, ref, len);
+    for (impl = DTLS_CHACHA20_SSE2; impl <= best; impl++) {
+      memcpy(msg, orig, len);
+      dtls_chacha20_select(impl);
+      dtls_chacha20(key, nonce, 7, msg, len);
+      ok &= memcmp(msg, ref, len) == 0;
+    }
+  }
+  result("implementations agree", ok);
+}
+
+/* throughput of the AEAD for records of the given size */
+static void
+speed(const char *impl, size_t len) {
+  static unsigned char buf[16384 + 16];
+  unsigned char key[32] = { 0 }, nonce[12] = { 0 }, aad[13] = { 0 };
+  struct timeval start, end;
+  double secs;
+  long i, n = (64L << 20) / len;
+
+  gettimeofday(&start, NULL);
+  for (i = 0; i < n; i++)
+    dtls_chacha20_poly1305_encrypt_message(key, nonce, buf, len,
+					   aad, sizeof(aad));
+  gettimeofday(&end, NULL);
+  secs = (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1e6;
+  printf("%s, %5u byte records: %.1f MB/s\n", impl, (unsigned int)len,
+	 n * len / secs / 1e6);
+}
+
+int
+main(void) {
+  static const char *names[] = { "C", "SSE2", "AVX2" };
+  int impl, best;
+
+  best = dtls_chacha20_select(DTLS_CHACHA20_BEST);
+  for (impl = DTLS_CHACHA20_C; impl <= best; impl++) {
+    dtls_chacha20_select(impl);
+    chacha20_test(names[impl]);
+    aead_test(names[impl]);
+  }
+  poly1305_test();
+  cross_test(best);
+
+  for (impl = DTLS_CHACHA20_C; impl <= best; impl++) {
+    dtls_chacha20_select(impl);
+    speed(names[impl], 64);
+    speed(names[impl], 1024);
+    speed(names[impl], 16384);
+  }
+
+  return test_summary();
+}
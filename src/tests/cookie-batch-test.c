@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <string.h>
+#include <netinet/in.h>
+
+#include "tinydtls.h"
+#include "dtls_debug.h"
+#include "dtls.h"
+#include "test-util.h"
+
+#define PEERS 5
+
+/* offset of the cookie length in a HelloVerifyRequest record: 13 bytes
+ * record header, 12 bytes handshake header and server_version */
+#define HVR_COOKIE_OFFSET (13 + 12 + 2)
+
+static dtls_context_t *client, *server;
+static session_t sessions[PEERS];
+
+/* the Client Hellos sent by the client */
+static uint8 hello[PEERS][DTLS_MAX_BUF];
+static int hello_len[PEERS];
+
+/* the cookies of the HelloVerifyRequests sent by the server */
+static uint8 cookie[PEERS][DTLS_COOKIE_LENGTH];
+static int cookie_len[PEERS];
+
+static int
+peer_index(const session_t *session) {
+  int i;
+
+  for (i = 0; i < PEERS; i++)
+    if (dtls_session_equals(session, &sessions[i]))
+      return i;
+  return -1;
+}
+
+static int
+send_to_peer(struct dtls_context_t *ctx, session_t *session,
+	     uint8 *data, size_t len) {
+  int i = peer_index(session);
+
+  if (i < 0)
+    return -1;
+
+  if (ctx == client) {
+    memcpy(hello[i], data, len);
+    hello_len[i] = len;
+  } else if (len > HVR_COOKIE_OFFSET
+	     && len >= HVR_COOKIE_OFFSET + 1 + data[HVR_COOKIE_OFFSET]
+	     && data[HVR_COOKIE_OFFSET] <= DTLS_COOKIE_LENGTH) {
+    cookie_len[i] = data[HVR_COOKIE_OFFSET];
+    memcpy(cookie[i], data + HVR_COOKIE_OFFSET + 1, cookie_len[i]);
+  }
+  return len;
+}
+
+#ifdef DTLS_PSK
+static int
+get_psk_info(struct dtls_context_t *ctx, const session_t *session,
+	     dtls_credentials_type_t type,
+	     const unsigned char *id, size_t id_len,
+	     unsigned char *result, size_t result_length) {
+  static const unsigned char key[] = "secretPSK";
+
+  if (result_length < sizeof(key) - 1)
+    return dtls_alert_fatal_create(DTLS_ALERT_INTERNAL_ERROR);
+  switch (type) {
+  case DTLS_PSK_IDENTITY:
+    memcpy(result, "Client_identity", 15);
+    return 15;
+  case DTLS_PSK_KEY:
+    memcpy(result, key, sizeof(key) - 1);
+    return sizeof(key) - 1;
+  default:
+    return dtls_alert_fatal_create(DTLS_ALERT_INTERNAL_ERROR);
+  }
+}
+#endif /* DTLS_PSK */
+
+static dtls_handler_t cb = {
+  .write = send_to_peer,
+#ifdef DTLS_PSK
+  .get_psk_info = get_psk_info,
+#endif /* DTLS_PSK */
+};
+
+/* hands all Client Hellos to the server, either one by one or in one
+ * call of dtls_handle_messages(), and returns whether each of them
+ * was answered with a cookie */
+static int
+answer_hellos(int batched) {
+  uint8 buf[PEERS][DTLS_MAX_BUF];
+  session_t *session[PEERS];
+  uint8 *msg[PEERS];
+  int len[PEERS];
+  int i, ok = 1;
+
+  /* the server may modify the messages in place */
+  for (i = 0; i < PEERS; i++) {
+    memcpy(buf[i], hello[i], hello_len[i]);
+    session[i] = &sessions[i];
+    msg[i] = buf[i];
+    len[i] = hello_len[i];
+    cookie_len[i] = 0;
+  }
+
+  if (batched) {
+    ok &= dtls_handle_messages(server, session, msg, len, PEERS) == 0;
+  } else {
+    for (i = 0; i < PEERS; i++)
+      ok &= dtls_handle_message(server, session[i], msg[i], len[i]) == 0;
+  }
+
+  for (i = 0; i < PEERS; i++)
+    ok &= cookie_len[i] > 0;
+  return ok;
+}
+
+int
+main(void) {
+  uint8 single[PEERS][DTLS_COOKIE_LENGTH];
+  int single_len[PEERS];
+  int i, ok = 1;
+
+  dtls_init();
+  dtls_set_log_level(DTLS_LOG_WARN);
+
+  client = dtls_new_context(NULL);
+  server = dtls_new_context(NULL);
+  dtls_set_handler(client, &cb);
+  dtls_set_handler(server, &cb);
+
+  /* a Client Hello from each of a few ports */
+  for (i = 0; i < PEERS; i++) {
+    dtls_session_init(&sessions[i]);
+    sessions[i].size = sizeof(sessions[i].addr.sin);
+    sessions[i].addr.sin.sin_family = AF_INET;
+    sessions[i].addr.sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sessions[i].addr.sin.sin_port = htons(20000 + i);
+    ok &= dtls_connect(client, &sessions[i]) > 0 && hello_len[i] > 0;
+  }
+  result("client hellos", ok);
+
+  ok = answer_hellos(0);
+  memcpy(single, cookie, sizeof(cookie));
+  memcpy(single_len, cookie_len, sizeof(cookie_len));
+  result("cookies one by one", ok);
+
+  ok = answer_hellos(1);
+  result("cookies in a batch", ok);
+
+  ok = 1;
+  for (i = 0; i < PEERS; i++)
+    ok &= cookie_len[i] == single_len[i]
+      && memcmp(cookie[i], single[i], cookie_len[i]) == 0;
+  result("same cookies", ok);
+
+  /* the cookie depends on the peer address */
+  ok = 1;
+  for (i = 1; i < PEERS; i++)
+    ok &= memcmp(cookie[i], cookie[0], cookie_len[0]) != 0;
+  result("cookies differ between peers", ok);
+
+  dtls_free_context(client);
+  dtls_free_context(server);
+
+  return test_summary();
+}
@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "tinydtls.h"
+#include "dtls_debug.h"
+#include "global.h"
+#include "crypto.h"
+#include "prng.h"
+#include "ecc/curve25519.h"
+
+#ifdef DTLS_ECC
+static int failed = 0;
+
+static int
+fromhex(unsigned char *buf, const char *hex) {
+  int len = 0;
+  unsigned int byte;
+
+  while (*hex && sscanf(hex, "%2x", &byte) == 1) {
+    buf[len++] = byte;
+    hex += 2;
+  }
+  return len;
+}
+
+static void
+check(const char *name, const unsigned char *result,
+      const unsigned char *expected, size_t len) {
+  if (memcmp(result, expected, len)) {
+    printf("%s: FAILED\n", name);
+    hexdump(result, len);
+    printf("\n");
+    failed++;
+  } else {
+    printf("%s: ok\n", name);
+  }
+}
+
+/* RFC 7748, section 5.2 and 6.1 */
+static void
+x25519_test(void) {
+  unsigned char k[32], u[32], r[32], expected[32];
+  unsigned char alice[32], bob[32], shared[32];
+  int i;
+
+  fromhex(k, "a546e36bf0527c9d3b16154b82465edd62144c0ac1fc5a18506a2244ba449ac4");
+  fromhex(u, "e6db6867583030db3594c1a424b15f7c726624ec26b3353b10a903a6d0ab1c4c");
+  fromhex(expected, "c3da55379de9c6908e94ea4df28d084f32eccf03491c71f754b4075577a28552");
+  ecc_x25519(r, k, u);
+  check("x25519 vector 1", r, expected, 32);
+
+  fromhex(k, "4b66e9d4d1b4673c5ad22691957d6af5c11b6421e0ea01d42ca4169e7918ba0d");
+  fromhex(u, "e5210f12786811d3f4b7959d0538ae2c31dbe7106fc03c3efc4cd549c715a493");
+  fromhex(expected, "95cbde9476e8907d7aade45cb4b873f88b595a68799fa152e6f8f7647aac7957");
+  ecc_x25519(r, k, u);
+  check("x25519 vector 2", r, expected, 32);
+
+  memset(k, 0, sizeof(k));
+  k[0] = 9;
+  memcpy(u, k, sizeof(u));
+  for (i = 0; i < 1000; i++) {
+    ecc_x25519(r, k, u);
+    memcpy(u, k, sizeof(u));
+    memcpy(k, r, sizeof(k));
+  }
+  fromhex(expected, "684cf59ba83309552800ef566f2f4d3c1c3887c49360e3875f2eb94d99532c51");
+  check("x25519 1000 iterations", k, expected, 32);
+
+  fromhex(k, "77076d0a7318a57d3c16c17251b26645df4c2f87ebc0992ab177fba51db92c2a");
+  ecc_x25519_base(alice, k);
+  fromhex(expected, "8520f0098930a754748b7ddcb43ef75a0dbf3a0d26381af4eba4a98eaa9b4e6a");
+  check("x25519 alice public", alice, expected, 32);
+
+  fromhex(u, "5dab087e624a8a4b79e17f8b83800ee66f3bb1292618b6fd1c2f8b27ff88e0eb");
+  ecc_x25519_base(bob, u);
+  fromhex(expected, "de9edb7d7b7dc1b4d35b61c2ece435373f8343c85b78674dadfc7e146f882b4f");
+  check("x25519 bob public", bob, expected, 32);
+
+  fromhex(expected, "4a5d9d5ba4ce2de1728e3bf480350f25e07e21c947d19e3376f09b3c1e161742");
+  dtls_x25519_pre_master_secret(k, bob, shared, sizeof(shared));
+  check("x25519 shared secret alice", shared, expected, 32);
+  dtls_x25519_pre_master_secret(u, alice, shared, sizeof(shared));
+  check("x25519 shared secret bob", shared, expected, 32);
+
+  /* a point of small order must be rejected */
+  memset(u, 0, sizeof(u));
+  if (dtls_x25519_pre_master_secret(k, u, shared, sizeof(shared)) >= 0) {
+    printf("x25519 zero point: FAILED\n");
+    failed++;
+  } else {
+    printf("x25519 zero point: ok\n");
+  }
+}
+
+/* RFC 8032, section 7.1 */
+static const struct {
+  const char *priv;
+  const char *pub;
+  const char *msg;
+  const char *sig;
+} ed25519_vectors[] = {
+  { "9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60",
+    "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a",
+    "",
+    "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e065224901555fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b" },
+  { "4ccd089b28ff96da9db6c346ec114e0f5b8a319f35aba624da8cf6ed4fb8a6fb",
+    "3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c",
+    "72",
+    "92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00" },
+  { "c5aa8df43f9f837bedb7442f31dcb7b166d38535076f094b85ce3a2e0b4458f7",
+    "fc51cd8e6218a1a38da47ed00230f0580816ed13ba3303ac5deb911548908025",
+    "af82",
+    "6291d657deec24024827e69c3abe01a30ce548a284743a445e3680d7db5ac3ac18ff9b538d16f290ae67f760984dc6594a7c15e9716ed28dc027beceea1ec40a" },
+};
+
+static void
+ed25519_test(void) {
+  unsigned char priv[32], pub[32], expected[64], sig[64], msg[32];
+  unsigned char random[2 * DTLS_RANDOM_LENGTH];
+  size_t msg_len;
+  size_t i;
+
+  for (i = 0; i < sizeof(ed25519_vectors) / sizeof(ed25519_vectors[0]); i++) {
+    fromhex(priv, ed25519_vectors[i].priv);
+    msg_len = fromhex(msg, ed25519_vectors[i].msg);
+
+    dtls_ed25519_public_key(priv, pub);
+    fromhex(expected, ed25519_vectors[i].pub);
+    check("ed25519 public key", pub, expected, 32);
+
+    dtls_ed25519_create_sig_msg(priv, pub, msg, msg_len, sig);
+    fromhex(expected, ed25519_vectors[i].sig);
+    check("ed25519 signature", sig, expected, 64);
+
+    if (dtls_ed25519_verify_sig_msg(pub, msg, msg_len, sig)) {
+      printf("ed25519 verify: FAILED\n");
+      failed++;
+    }
+    sig[7] ^= 1;
+    if (!dtls_ed25519_verify_sig_msg(pub, msg, msg_len, sig)) {
+      printf("ed25519 verify of a modified signature: FAILED\n");
+      failed++;
+    }
+  }
+
+  /* the ServerKeyExchange signature covers three parts */
+  dtls_prng(random, sizeof(random));
+  dtls_ed25519_create_sig(priv, pub, random, DTLS_RANDOM_LENGTH,
+			  random + DTLS_RANDOM_LENGTH, DTLS_RANDOM_LENGTH,
+			  msg, msg_len, sig);
+  if (dtls_ed25519_verify_sig(pub, random, DTLS_RANDOM_LENGTH,
+			      random + DTLS_RANDOM_LENGTH, DTLS_RANDOM_LENGTH,
+			      msg, msg_len, sig)) {
+    printf("ed25519 verify of key exchange parameters: FAILED\n");
+    failed++;
+  }
+  random[0] ^= 1;
+  if (!dtls_ed25519_verify_sig(pub, random, DTLS_RANDOM_LENGTH,
+			       random + DTLS_RANDOM_LENGTH, DTLS_RANDOM_LENGTH,
+			       msg, msg_len, sig)) {
+    printf("ed25519 verify of modified key exchange parameters: FAILED\n");
+    failed++;
+  }
+}
+
+int
+main(void) {
+  x25519_test();
+  ed25519_test();
+
+  printf("%s\n", failed ? "Tests FAILED." : "All Tests successful.");
+  return failed ? 1 : 0;
+}
+#else /* DTLS_ECC */
+int
+main(void) {
+  printf("curve25519-test: built without DTLS_ECC, nothing to test\n");
+  return 0;
+}
+#endif /* DTLS_ECC */
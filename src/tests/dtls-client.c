@@ -167,6 +167,14 @@ verify_ecdsa_key(struct dtls_context_t *ctx,
 		 size_t key_size) {
   return 0;
 }
+
+static int
+verify_ed25519_key(struct dtls_context_t *ctx,
+		   const session_t *session,
+		   const unsigned char *other_pub,
+		   size_t key_size) {
+  return 0;
+}
 #endif /* DTLS_ECC */
 
 static void
@@ -318,7 +326,8 @@ static dtls_handler_t cb = {
 #endif /* DTLS_PSK */
 #ifdef DTLS_ECC
   .get_ecdsa_key = get_ecdsa_key,
-  .verify_ecdsa_key = verify_ecdsa_key
+  .verify_ecdsa_key = verify_ecdsa_key,
+  .verify_ed25519_key = verify_ed25519_key
 #endif /* DTLS_ECC */
 };
 
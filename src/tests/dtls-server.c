@@ -112,6 +112,14 @@ verify_ecdsa_key(struct dtls_context_t *ctx,
 		 size_t key_size) {
   return 0;
 }
+
+static int
+verify_ed25519_key(struct dtls_context_t *ctx,
+		   const session_t *session,
+		   const unsigned char *other_pub,
+		   size_t key_size) {
+  return 0;
+}
 #endif /* DTLS_ECC */
 
 #define DTLS_SERVER_CMD_CLOSE "server:close"
@@ -147,34 +155,47 @@ send_to_peer(struct dtls_context_t *ctx,
 		&session->addr.sa, session->size);
 }
 
+/* All datagrams that have arrived (up to DTLS_COOKIE_BATCH) are passed
+ * to dtls_handle_messages() at once, so that the cookies of a burst of
+ * Client Hellos are computed together. */
 static int
 dtls_handle_read(struct dtls_context_t *ctx) {
   int *fd;
-  session_t session;
-  static uint8 buf[DTLS_MAX_BUF];
-  int len;
+  static session_t session[DTLS_COOKIE_BATCH];
+  static uint8 buf[DTLS_COOKIE_BATCH][DTLS_MAX_BUF];
+  session_t *sessions[DTLS_COOKIE_BATCH];
+  uint8 *msg[DTLS_COOKIE_BATCH];
+  int msglen[DTLS_COOKIE_BATCH];
+  int len, n;
 
   fd = dtls_get_app_data(ctx);
 
   assert(fd);
 
-  memset(&session, 0, sizeof(session_t));
-  session.size = sizeof(session.addr);
-  len = recvfrom(*fd, buf, sizeof(buf), MSG_TRUNC,
-		 &session.addr.sa, &session.size);
+  for (n = 0; n < DTLS_COOKIE_BATCH; n++) {
+    memset(&session[n], 0, sizeof(session_t));
+    session[n].size = sizeof(session[n].addr);
+    /* only the first read may block */
+    len = recvfrom(*fd, buf[n], sizeof(buf[n]), MSG_TRUNC | (n ? MSG_DONTWAIT : 0),
+		   &session[n].addr.sa, &session[n].size);
 
-  if (len < 0) {
-    perror("recvfrom");
-    return -1;
-  } else {
+    if (len < 0) {
+      if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK))
+	perror("recvfrom");
+      break;
+    }
     dtls_debug("got %d bytes from port %d\n", len, 
-	     ntohs(session.addr.sin6.sin6_port));
-    if (sizeof(buf) < len) {
-      dtls_warn("packet was truncated (%d bytes lost)\n", len - sizeof(buf));
+	       ntohs(session[n].addr.sin6.sin6_port));
+    if (sizeof(buf[n]) < len) {
+      dtls_warn("packet was truncated (%d bytes lost)\n", len - sizeof(buf[n]));
+      len = sizeof(buf[n]);
     }
+    sessions[n] = &session[n];
+    msg[n] = buf[n];
+    msglen[n] = len;
   }
 
-  return dtls_handle_message(ctx, &session, buf, len);
+  return n ? dtls_handle_messages(ctx, sessions, msg, msglen, n) : -1;
 }    
 
 static int
@@ -244,7 +265,8 @@ static dtls_handler_t cb = {
 #endif /* DTLS_PSK */
 #ifdef DTLS_ECC
   .get_ecdsa_key = get_ecdsa_key,
-  .verify_ecdsa_key = verify_ecdsa_key
+  .verify_ecdsa_key = verify_ecdsa_key,
+  .verify_ed25519_key = verify_ed25519_key
 #endif /* DTLS_ECC */
 };
 
@@ -329,6 +351,13 @@ main(int argc, char **argv) {
 
   dtls_set_handler(the_context, &cb);
 
+#ifdef DTLS_ECC
+  /* compute signing nonces in the background, starting before the
+   * first handshake */
+  dtls_ecdsa_sign_pool_configure(DTLS_ECDSA_SIGN_POOL_SIZE, 1);
+  dtls_ecdsa_sign_pool_bind(ecdsa_priv_key, sizeof(ecdsa_priv_key));
+#endif /* DTLS_ECC */
+
   while (1) {
     FD_ZERO(&rfds);
     FD_ZERO(&wfds);
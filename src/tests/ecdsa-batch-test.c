@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "tinydtls.h"
+#include "dtls_debug.h"
+#include "dtls.h"
+#include "crypto.h"
+#include "numeric.h"
+#include "prng.h"
+#include "test-util.h"
+
+/* more handshakes than fit into the queue, so it is flushed once while
+ * they are added */
+#define HANDSHAKES (DTLS_ECDSA_BATCH_SIZE + 3)
+#define KEYS 3
+
+static unsigned char priv[KEYS][DTLS_EC_KEY_SIZE];
+static unsigned char pub_x[KEYS][DTLS_EC_KEY_SIZE];
+static unsigned char pub_y[KEYS][DTLS_EC_KEY_SIZE];
+
+/* the big-endian form used on the wire */
+static void
+to_bytes(const uint32_t *v, unsigned char *buf) {
+  int i;
+
+  for (i = 0; i < 8; i++)
+    dtls_int_to_uint32(buf + (7 - i) * 4, v[i]);
+}
+
+/* whether the signature of handshake i is made invalid */
+static int
+invalid(int i) {
+  return i % 3 == 1 || i == 6;
+}
+
+int
+main(void) {
+  dtls_handshake_parameters_t *hs[HANDSHAKES];
+  unsigned char hash[DTLS_EC_KEY_SIZE], r[DTLS_EC_KEY_SIZE], s[DTLS_EC_KEY_SIZE];
+  uint32_t point_r[9], point_s[9];
+  int i, key, ok_add = 1, ok_flush = 1, ok_verdict = 1;
+
+  dtls_init();
+  dtls_set_log_level(DTLS_LOG_WARN);
+
+  for (key = 0; key < KEYS; key++)
+    dtls_ecdsa_generate_key(priv[key], pub_x[key], pub_y[key],
+			    DTLS_EC_KEY_SIZE);
+
+  for (i = 0; i < HANDSHAKES; i++) {
+    hs[i] = dtls_handshake_new();
+    key = i % KEYS;
+
+    dtls_prng(hash, sizeof(hash));
+    dtls_ecdsa_create_sig_hash(priv[key], DTLS_EC_KEY_SIZE,
+			       hash, sizeof(hash), point_r, point_s);
+    to_bytes(point_r, r);
+    to_bytes(point_s, s);
+
+    /* a different hash, or the public key of another peer */
+    if (i % 3 == 1)
+      hash[0] ^= 0x01;
+    else if (i == 6)
+      key = (key + 1) % KEYS;
+
+    ok_add &= hs[i] && dtls_ecdsa_batch_add(hs[i], pub_x[key], pub_y[key],
+					    DTLS_EC_KEY_SIZE, hash, sizeof(hash),
+					    r, s) == 0;
+  }
+  result("queue signatures", ok_add);
+
+  /* the first DTLS_ECDSA_BATCH_SIZE were verified when the queue was full */
+  for (i = 0; i < HANDSHAKES; i++) {
+    ok_flush &= hs[i]->ecdsa_verify_pending == (i >= DTLS_ECDSA_BATCH_SIZE);
+    if (i < DTLS_ECDSA_BATCH_SIZE)
+      ok_flush &= hs[i]->ecdsa_verify_failed == invalid(i);
+  }
+  result("flush of a full queue", ok_flush);
+
+  /* a released handshake leaves the queue, the last entry moves into
+   * its slot and must still get its own verdict */
+  dtls_handshake_free(hs[DTLS_ECDSA_BATCH_SIZE]);
+  hs[DTLS_ECDSA_BATCH_SIZE] = NULL;
+
+  for (i = 0; i < HANDSHAKES; i++) {
+    if (!hs[i])
+      continue;
+    ok_verdict &= (dtls_ecdsa_batch_result(hs[i]) < 0) == invalid(i)
+      && !hs[i]->ecdsa_verify_pending;
+  }
+  result("verdicts of a mixed batch", ok_verdict);
+
+  for (i = 0; i < HANDSHAKES; i++)
+    dtls_handshake_free(hs[i]);
+
+  return test_summary();
+}
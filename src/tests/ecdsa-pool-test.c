@@ -0,0 +1,238 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+
+#include "tinydtls.h"
+#include "dtls_debug.h"
+#include "crypto.h"
+#include "test-util.h"
+
+#define POOL_DEPTH 16
+
+/* the key of RFC 6979, section A.2.5 */
+static const unsigned char priv[DTLS_EC_KEY_SIZE] = {
+  0xc9, 0xaf, 0xa9, 0xd8, 0x45, 0xba, 0x75, 0x16,
+  0x6b, 0x5c, 0x21, 0x57, 0x67, 0xb1, 0xd6, 0x93,
+  0x4e, 0x50, 0xc3, 0xdb, 0x36, 0xe8, 0x9b, 0x12,
+  0x7b, 0x8a, 0x62, 0x2b, 0x12, 0x0f, 0x67, 0x21
+};
+static const unsigned char pub_x[DTLS_EC_KEY_SIZE] = {
+  0x60, 0xfe, 0xd4, 0xba, 0x25, 0x5a, 0x9d, 0x31,
+  0xc9, 0x61, 0xeb, 0x74, 0xc6, 0x35, 0x6d, 0x68,
+  0xc0, 0x49, 0xb8, 0x92, 0x3b, 0x61, 0xfa, 0x6c,
+  0xe6, 0x69, 0x62, 0x2e, 0x60, 0xf2, 0x9f, 0xb6
+};
+static const unsigned char pub_y[DTLS_EC_KEY_SIZE] = {
+  0x79, 0x03, 0xfe, 0x10, 0x08, 0xb8, 0xbc, 0x99,
+  0xa4, 0x1a, 0xe9, 0xe9, 0x56, 0x28, 0xbc, 0x64,
+  0xf2, 0xf1, 0xb2, 0x0c, 0x2d, 0x7e, 0x9f, 0x51,
+  0x77, 0xa3, 0xc2, 0x94, 0xd4, 0x46, 0x22, 0x99
+};
+/* r of the deterministic signature of "sample" */
+static const unsigned char sample_r[DTLS_EC_KEY_SIZE] = {
+  0xef, 0xd4, 0x8b, 0x2a, 0xac, 0xb6, 0xa8, 0xfd,
+  0x11, 0x40, 0xdd, 0x9c, 0xd4, 0x5e, 0x81, 0xd6,
+  0x9d, 0x2c, 0x87, 0x7b, 0x56, 0xaa, 0xf9, 0x91,
+  0xc3, 0x4d, 0x0e, 0xa8, 0x4e, 0xaf, 0x37, 0x16
+};
+
+/* r and s are returned as little-endian words */
+static void
+from_words(unsigned char *buf, const uint32_t *words) {
+  int i;
+
+  for (i = 0; i < 8; i++) {
+    buf[4 * i] = words[7 - i] >> 24;
+    buf[4 * i + 1] = words[7 - i] >> 16;
+    buf[4 * i + 2] = words[7 - i] >> 8;
+    buf[4 * i + 3] = words[7 - i];
+  }
+}
+
+static void
+hash_msg(const char *msg, unsigned char *hash) {
+  dtls_hash_ctx ctx;
+
+  dtls_hash_init(&ctx);
+  dtls_hash_update(&ctx, (const unsigned char *)msg, strlen(msg));
+  dtls_hash_finalize(hash, &ctx);
+}
+
+/* signs @p msg, returns 1 if the signature is valid */
+static int
+sign(const char *msg, unsigned char *r) {
+  unsigned char hash[DTLS_HMAC_DIGEST_SIZE], s[DTLS_EC_KEY_SIZE];
+  uint32_t point_r[9], point_s[9];
+
+  hash_msg(msg, hash);
+  dtls_ecdsa_create_sig_hash(priv, sizeof(priv), hash, sizeof(hash),
+			     point_r, point_s);
+  from_words(r, point_r);
+  from_words(s, point_s);
+  return dtls_ecdsa_verify_sig_hash(pub_x, pub_y, sizeof(pub_x),
+				    hash, sizeof(hash), r, s) == 0;
+}
+
+/* nonces from the pool give valid, distinct signatures, when it is
+ * empty the signature is the deterministic one again */
+static void
+pool_test(void) {
+  unsigned char r[POOL_DEPTH + 1][DTLS_EC_KEY_SIZE];
+  dtls_ecdsa_sign_pool_stats_t before, after;
+  int i, j, ok;
+
+  dtls_ecdsa_sign_pool_configure(POOL_DEPTH, 0);
+  dtls_ecdsa_sign_pool_bind(priv, sizeof(priv));
+  dtls_ecdsa_sign_pool_stats(&before);
+  ok = dtls_ecdsa_sign_pool_refill(2 * POOL_DEPTH) == POOL_DEPTH;
+  dtls_ecdsa_sign_pool_stats(&after);
+  result("refill", ok && after.available == POOL_DEPTH
+	 && after.refilled - before.refilled == POOL_DEPTH);
+
+  ok = 1;
+  for (i = 0; i <= POOL_DEPTH; i++)
+    ok &= sign("sample", r[i]);
+  for (i = 0; i < POOL_DEPTH; i++)
+    for (j = 0; j < i; j++)
+      ok &= memcmp(r[i], r[j], sizeof(r[i])) != 0;
+  dtls_ecdsa_sign_pool_stats(&before);
+  result("signatures", ok && before.available == 0
+	 && before.hits - after.hits == POOL_DEPTH
+	 && before.misses - after.misses == 1);
+  result("deterministic on a miss",
+	 memcmp(r[POOL_DEPTH], sample_r, sizeof(sample_r)) == 0);
+}
+
+/* a signature with another key neither uses nor drops the nonces of
+ * the key the pool belongs to */
+static void
+other_key_test(void) {
+  unsigned char other[DTLS_EC_KEY_SIZE], hash[DTLS_HMAC_DIGEST_SIZE];
+  uint32_t point_r[9], point_s[9];
+  dtls_ecdsa_sign_pool_stats_t before, after;
+
+  memcpy(other, priv, sizeof(other));
+  other[DTLS_EC_KEY_SIZE - 1] ^= 0x01;
+  hash_msg("sample", hash);
+
+  dtls_ecdsa_sign_pool_refill(POOL_DEPTH);
+  dtls_ecdsa_sign_pool_stats(&before);
+  dtls_ecdsa_create_sig_hash(other, sizeof(other), hash, sizeof(hash),
+			     point_r, point_s);
+  dtls_ecdsa_sign_pool_stats(&after);
+  result("other key", before.available == POOL_DEPTH
+	 && after.available == POOL_DEPTH && after.hits == before.hits
+	 && after.misses - before.misses == 1);
+
+  /* once released, the pool belongs to the next key that signs */
+  dtls_ecdsa_sign_pool_bind(NULL, 0);
+  dtls_ecdsa_sign_pool_stats(&before);
+  dtls_ecdsa_create_sig_hash(other, sizeof(other), hash, sizeof(hash),
+			     point_r, point_s);
+  dtls_ecdsa_sign_pool_refill(POOL_DEPTH);
+  dtls_ecdsa_create_sig_hash(other, sizeof(other), hash, sizeof(hash),
+			     point_r, point_s);
+  dtls_ecdsa_sign_pool_stats(&after);
+  result("release", before.available == 0
+	 && after.available == POOL_DEPTH - 1 && after.hits - before.hits == 1);
+  dtls_ecdsa_sign_pool_bind(priv, sizeof(priv));
+}
+
+/* the child of fork() must not reuse the nonces of its parent */
+static void
+fork_test(void) {
+  dtls_ecdsa_sign_pool_stats_t stats;
+  int status, ok;
+  pid_t pid;
+
+  dtls_ecdsa_sign_pool_refill(POOL_DEPTH);
+  pid = fork();
+  if (pid == 0) {
+    dtls_ecdsa_sign_pool_stats(&stats);
+    _exit(stats.available != 0);
+  }
+  ok = pid > 0 && waitpid(pid, &status, 0) == pid
+    && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  dtls_ecdsa_sign_pool_stats(&stats);
+  result("fork", ok && stats.available == POOL_DEPTH);
+}
+
+/* the background thread fills the pool after the first signature */
+static void
+thread_test(void) {
+  dtls_ecdsa_sign_pool_stats_t stats;
+  unsigned char r[DTLS_EC_KEY_SIZE];
+  int i;
+
+  dtls_ecdsa_sign_pool_configure(0, 0);
+  dtls_ecdsa_sign_pool_configure(POOL_DEPTH, 1);
+  sign("sample", r);
+  for (i = 0; i < 500; i++) {
+    dtls_ecdsa_sign_pool_stats(&stats);
+    if (stats.available == POOL_DEPTH)
+      break;
+    usleep(10000);
+  }
+  result("thread", stats.available == POOL_DEPTH);
+  dtls_ecdsa_sign_pool_configure(POOL_DEPTH, 0);
+}
+
+static double
+now(void) {
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/* time on the critical path with and without a ready nonce */
+static void
+speed(void) {
+  unsigned char hash[DTLS_HMAC_DIGEST_SIZE];
+  uint32_t point_r[9], point_s[9];
+  double start, hit, miss;
+  int i;
+
+  hash_msg("speed", hash);
+  dtls_ecdsa_sign_pool_refill(POOL_DEPTH);
+  start = now();
+  for (i = 0; i < POOL_DEPTH; i++)
+    dtls_ecdsa_create_sig_hash(priv, sizeof(priv), hash, sizeof(hash),
+			       point_r, point_s);
+  hit = (now() - start) / POOL_DEPTH;
+
+  start = now();
+  for (i = 0; i < POOL_DEPTH; i++)
+    dtls_ecdsa_create_sig_hash(priv, sizeof(priv), hash, sizeof(hash),
+			       point_r, point_s);
+  miss = (now() - start) / POOL_DEPTH;
+
+  printf("sign with a ready nonce: %.1f us, without: %.1f us\n",
+	 hit * 1e6, miss * 1e6);
+}
+
+/* the background thread only runs when it has been asked for */
+static void
+no_thread_test(void) {
+  dtls_ecdsa_sign_pool_stats_t stats;
+  unsigned char r[DTLS_EC_KEY_SIZE];
+
+  sign("sample", r);
+  usleep(100000);
+  dtls_ecdsa_sign_pool_stats(&stats);
+  result("no thread by default", stats.available == 0);
+}
+
+int
+main(void) {
+  no_thread_test();
+  pool_test();
+  other_key_test();
+  fork_test();
+  thread_test();
+  speed();
+
+  return test_summary();
+}
@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "tinydtls.h"
+#include "gcm.h"
+#include "prng.h"
+#include "test-util.h"
+
+/* test cases 2 to 4 of the GCM specification (McGrew and Viega) */
+static const struct {
+  const char *key, *iv, *p, *a, *c, *t;
+} vectors[] = {
+  { "00000000000000000000000000000000", "000000000000000000000000",
+    "00000000000000000000000000000000", "",
+    "0388dace60b6a392f328c2b971b2fe78",
+    "ab6e47d42cec13bdf53a67b21257bddf" },
+  { "feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888",
+    "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+    "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255", "",
+    "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+    "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985",
+    "4d5c2af327cd64a62cf35abd2ba6fab4" },
+  { "feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888",
+    "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+    "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39",
+    "feedfacedeadbeeffeedfacedeadbeefabaddad2",
+    "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+    "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091",
+    "5bc94fbc3221a5db94fae95ae7121a47" }
+};
+
+static void
+vector_test(const char *impl) {
+  unsigned char key[16], iv[12], msg[80], a[32], c[80], t[16];
+  dtls_gcm_ctx ctx;
+  char name[64];
+  size_t i, lm, la;
+  long int len;
+  int ok;
+
+  for (i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+    unhex(vectors[i].key, key);
+    unhex(vectors[i].iv, iv);
+    lm = unhex(vectors[i].p, msg);
+    la = unhex(vectors[i].a, a);
+    unhex(vectors[i].c, c);
+    unhex(vectors[i].t, t);
+
+    ok = dtls_gcm_init(&ctx, key, sizeof(key)) == 0;
+    len = dtls_gcm_encrypt_message(&ctx, iv, msg, lm, a, la);
+    ok &= len == (long int)(lm + 16) && memcmp(msg, c, lm) == 0
+      && memcmp(msg + lm, t, 16) == 0;
+    len = dtls_gcm_decrypt_message(&ctx, iv, msg, len, a, la);
+    ok &= len == (long int)lm && unhex(vectors[i].p, c) == lm
+      && memcmp(msg, c, lm) == 0;
+
+    snprintf(name, sizeof(name), "%s test case %u", impl, (unsigned int)i + 2);
+    result(name, ok);
+  }
+}
+
+/* a modified ciphertext, tag or additional data must be rejected */
+static void
+forgery_test(const char *impl) {
+  unsigned char key[16] = { 1 }, iv[12] = { 2 }, a[13] = { 3 };
+  unsigned char msg[100 + 16], copy[100 + 16];
+  dtls_gcm_ctx ctx;
+  char name[64];
+  size_t i;
+  int ok = 1;
+
+  dtls_gcm_init(&ctx, key, sizeof(key));
+  memset(msg, 0x5a, sizeof(msg));
+  dtls_gcm_encrypt_message(&ctx, iv, msg, 100, a, sizeof(a));
+
+  for (i = 0; i < sizeof(msg); i += 7) {
+    memcpy(copy, msg, sizeof(msg));
+    copy[i] ^= 0x01;
+    ok &= dtls_gcm_decrypt_message(&ctx, iv, copy, sizeof(copy),
+				   a, sizeof(a)) < 0;
+    /* the ciphertext is not decrypted */
+    copy[i] ^= 0x01;
+    ok &= memcmp(copy, msg, sizeof(msg)) == 0;
+  }
+  a[12] ^= 0x80;
+  memcpy(copy, msg, sizeof(msg));
+  ok &= dtls_gcm_decrypt_message(&ctx, iv, copy, sizeof(copy),
+				 a, sizeof(a)) < 0;
+
+  snprintf(name, sizeof(name), "%s forgery", impl);
+  result(name, ok);
+}
+
+/* both implementations must agree on all lengths around the 4-block
+ * steps of the x86 code */
+static void
+cross_test(void) {
+  unsigned char key[16], iv[12], a[40], msg[200 + 16], ref[200 + 16];
+  dtls_gcm_ctx ctx;
+  size_t lm, la;
+  int ok = 1;
+
+  for (lm = 0; lm <= 200; lm++) {
+    la = lm % 41;
+    dtls_prng(key, sizeof(key));
+    dtls_prng(iv, sizeof(iv));
+    dtls_prng(a, sizeof(a));
+    dtls_prng(msg, lm);
+    memcpy(ref, msg, lm);
+
+    dtls_gcm_select(DTLS_GCM_C);
+    dtls_gcm_init(&ctx, key, sizeof(key));
+    dtls_gcm_encrypt_message(&ctx, iv, ref, lm, a, la);
+
+    dtls_gcm_select(DTLS_GCM_CLMUL);
+    dtls_gcm_init(&ctx, key, sizeof(key));
+    dtls_gcm_encrypt_message(&ctx, iv, msg, lm, a, la);
+    ok &= memcmp(msg, ref, lm + 16) == 0;
+    ok &= dtls_gcm_decrypt_message(&ctx, iv, msg, lm + 16, a, la)
+      == (long int)lm;
+  }
+  result("C and CLMUL agree", ok);
+}
+
+/* throughput for records of the given size, including the key setup
+ * that dtls_encrypt() does for each record */
+static void
+speed(const char *impl, size_t len) {
+  static unsigned char buf[16384 + 16];
+  unsigned char key[16] = { 0 }, iv[12] = { 0 }, a[13] = { 0 };
+  dtls_gcm_ctx ctx;
+  struct timeval start, end;
+  double secs;
+  long i, n = (64L << 20) / len;
+
+  gettimeofday(&start, NULL);
+  for (i = 0; i < n; i++) {
+    dtls_gcm_init(&ctx, key, sizeof(key));
+    dtls_gcm_encrypt_message(&ctx, iv, buf, len, a, sizeof(a));
+  }
+  gettimeofday(&end, NULL);
+  secs = (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1e6;
+  printf("%s, %5u byte records: %.1f MB/s\n", impl, (unsigned int)len,
+	 n * len / secs / 1e6);
+}
+
+int
+main(void) {
+  static const char *names[] = { "C", "CLMUL" };
+  int impl;
+
+  for (impl = DTLS_GCM_C; impl <= DTLS_GCM_CLMUL; impl++) {
+    if (dtls_gcm_select(impl) != impl) {
+      printf("%s: not supported\n", names[impl]);
+      continue;
+    }
+    vector_test(names[impl]);
+    forgery_test(names[impl]);
+  }
+  if (dtls_gcm_select(DTLS_GCM_CLMUL) == DTLS_GCM_CLMUL)
+    cross_test();
+
+  for (impl = DTLS_GCM_C; impl <= DTLS_GCM_CLMUL; impl++) {
+    if (dtls_gcm_select(impl) != impl)
+      continue;
+    speed(names[impl], 64);
+    speed(names[impl], 1024);
+    speed(names[impl], 16384);
+  }
+
+  return test_summary();
+}
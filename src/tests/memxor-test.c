@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "tinydtls.h"
+#include "global.h"
+#include "prng.h"
+#include "test-util.h"
+
+/* the byte-by-byte versions, for comparison */
+static void
+memxor_bytes(unsigned char *x, const unsigned char *y, size_t n) {
+  while (n--)
+    *x++ ^= *y++;
+}
+
+static int
+equals_bytes(const unsigned char *a, const unsigned char *b, size_t len) {
+  int result = 1;
+
+  while (len--)
+    result &= (*a++ == *b++);
+  return result;
+}
+
+/* all lengths up to a few SSE2 blocks, at all alignments of a word */
+static void
+memxor_test(void) {
+  unsigned char x[80 + 8], y[80 + 8], ref[80 + 8];
+  size_t len, ox, oy;
+  int ok = 1;
+
+  for (len = 0; len <= 80; len++) {
+    for (ox = 0; ox < 8; ox++) {
+      for (oy = 0; oy < 8; oy++) {
+	dtls_prng(x, sizeof(x));
+	dtls_prng(y, sizeof(y));
+	memcpy(ref, x, sizeof(x));
+	memxor(x + ox, y + oy, len);
+	memxor_bytes(ref + ox, y + oy, len);
+	ok &= memcmp(x, ref, sizeof(x)) == 0;
+      }
+    }
+  }
+  result("memxor", ok);
+}
+
+/* a difference in any byte must be found */
+static void
+equals_test(void) {
+  unsigned char a[80 + 8], b[80 + 8];
+  size_t len, i, off;
+  int ok = 1;
+
+  for (len = 0; len <= 80; len++) {
+    off = len % 8;
+    dtls_prng(a, sizeof(a));
+    memcpy(b, a, sizeof(a));
+    ok &= equals(a + off, b + off, len);
+    for (i = 0; i < len; i++) {
+      b[off + i] ^= 1 << (i % 8);
+      ok &= !equals(a + off, b + off, len);
+      b[off + i] ^= 1 << (i % 8);
+    }
+    /* the bytes around the compared ones do not matter */
+    b[off + len] ^= 0xff;
+    if (off)
+      b[off - 1] ^= 0xff;
+    ok &= equals(a + off, b + off, len);
+  }
+  result("equals", ok);
+}
+
+static double
+elapsed(const struct timeval *start) {
+  struct timeval end;
+
+  gettimeofday(&end, NULL);
+  return (end.tv_sec - start->tv_sec) + (end.tv_usec - start->tv_usec) / 1e6;
+}
+
+/* time per call for a CCM block and for a record */
+static void
+speed(size_t len) {
+  static unsigned char x[1400], y[1400];
+  volatile int sink = 0;
+  struct timeval start;
+  long i, n = (256L << 20) / len;
+  double t_xor, t_xor_bytes, t_eq, t_eq_bytes;
+
+  gettimeofday(&start, NULL);
+  for (i = 0; i < n; i++)
+    memxor(x, y, len);
+  t_xor = elapsed(&start);
+
+  gettimeofday(&start, NULL);
+  for (i = 0; i < n; i++)
+    memxor_bytes(x, y, len);
+  t_xor_bytes = elapsed(&start);
+
+  gettimeofday(&start, NULL);
+  for (i = 0; i < n; i++)
+    sink += equals(x, y, len);
+  t_eq = elapsed(&start);
+
+  gettimeofday(&start, NULL);
+  for (i = 0; i < n; i++)
+    sink += equals_bytes(x, y, len);
+  t_eq_bytes = elapsed(&start);
+
+  printf("%4u bytes: memxor %.1f ns (bytewise %.1f ns), "
+	 "equals %.1f ns (bytewise %.1f ns)\n", (unsigned int)len,
+	 t_xor / n * 1e9, t_xor_bytes / n * 1e9,
+	 t_eq / n * 1e9, t_eq_bytes / n * 1e9);
+  (void)sink;
+}
+
+int
+main(void) {
+  memxor_test();
+  equals_test();
+
+  speed(16);
+  speed(1400);
+
+  return test_summary();
+}
@@ -1,9 +1,77 @@
 #include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
 
 #include "tinydtls.h"
 #include "dtls_debug.h"
 #include "global.h"
 #include "crypto.h"
+#include "test-util.h"
+
+/* dtls_key_schedule() must give the same as the two PRF calls */
+static void
+key_schedule_test(void) {
+  static const unsigned char label_master[] = "master secret";
+  static const unsigned char label_key[] = "key expansion";
+  unsigned char pre_master[36], client[DTLS_RANDOM_LENGTH];
+  unsigned char server[DTLS_RANDOM_LENGTH];
+  unsigned char master1[DTLS_MASTER_SECRET_LENGTH];
+  unsigned char master2[DTLS_MASTER_SECRET_LENGTH];
+  unsigned char block1[MAX_KEYBLOCK_LENGTH], block2[MAX_KEYBLOCK_LENGTH];
+  size_t i;
+
+  for (i = 0; i < sizeof(pre_master); i++)
+    pre_master[i] = i;
+  for (i = 0; i < DTLS_RANDOM_LENGTH; i++) {
+    client[i] = 0x40 + i;
+    server[i] = 0x80 + i;
+  }
+
+  dtls_prf(pre_master, sizeof(pre_master),
+	   label_master, sizeof(label_master) - 1,
+	   client, sizeof(client), server, sizeof(server),
+	   master1, sizeof(master1));
+  dtls_prf(master1, sizeof(master1),
+	   label_key, sizeof(label_key) - 1,
+	   server, sizeof(server), client, sizeof(client),
+	   block1, sizeof(block1));
+
+  /* the pre master secret is stored in the key block by dtls.c */
+  memcpy(block2, pre_master, sizeof(pre_master));
+  dtls_key_schedule(block2, sizeof(pre_master), client, server,
+		    master2, block2, sizeof(block2));
+
+  result("key schedule",
+	 memcmp(master1, master2, sizeof(master1)) == 0
+	 && memcmp(block1, block2, sizeof(block1)) == 0);
+}
+
+/* derivations per second for the pre master secret of ECDHE */
+static void
+speed(void) {
+  unsigned char pre_master[DTLS_EC_KEY_SIZE], client[DTLS_RANDOM_LENGTH];
+  unsigned char server[DTLS_RANDOM_LENGTH];
+  unsigned char master[DTLS_MASTER_SECRET_LENGTH];
+  unsigned char block[MAX_KEYBLOCK_LENGTH];
+  struct timeval start, end;
+  double secs;
+  long i, n = 100000;
+
+  memset(pre_master, 0x11, sizeof(pre_master));
+  memset(client, 0x22, sizeof(client));
+  memset(server, 0x33, sizeof(server));
+
+  gettimeofday(&start, NULL);
+  for (i = 0; i < n; i++) {
+    dtls_key_schedule(pre_master, sizeof(pre_master), client, server,
+		      master, block, sizeof(block));
+    pre_master[0] = block[0];
+  }
+  gettimeofday(&end, NULL);
+  secs = (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1e6;
+  printf("key schedule: %.0f derivations/s (%.2f us each)\n",
+	 n / secs, secs * 1e6 / n);
+}
 
 int 
 main() {
@@ -15,17 +83,38 @@ main() {
   unsigned char random1[] = { 0xa0, 0xba, 0x9f, 0x93, 0x6c, 0xda, 0x31, 0x18};
   unsigned char random2[] = {0x27, 0xa6, 0xf7, 0x96, 0xff, 0xd5, 0x19, 0x8c
   };
+  static const unsigned char expected[] = {
+    0xe3, 0xf2, 0x29, 0xba, 0x72, 0x7b, 0xe1, 0x7b,
+    0x8d, 0x12, 0x26, 0x20, 0x55, 0x7c, 0xd4, 0x53,
+    0xc2, 0xaa, 0xb2, 0x1d, 0x07, 0xc3, 0xd4, 0x95,
+    0x32, 0x9b, 0x52, 0xd4, 0xe6, 0x1e, 0xdb, 0x5a,
+    0x6b, 0x30, 0x17, 0x91, 0xe9, 0x0d, 0x35, 0xc9,
+    0xc9, 0xa4, 0x6b, 0x4e, 0x14, 0xba, 0xf9, 0xaf,
+    0x0f, 0xa0, 0x22, 0xf7, 0x07, 0x7d, 0xef, 0x17,
+    0xab, 0xfd, 0x37, 0x97, 0xc0, 0x56, 0x4b, 0xab,
+    0x4f, 0xbc, 0x91, 0x66, 0x6e, 0x9d, 0xef, 0x9b,
+    0x97, 0xfc, 0xe3, 0x4f, 0x79, 0x67, 0x89, 0xba,
+    0xa4, 0x80, 0x82, 0xd1, 0x22, 0xee, 0x42, 0xc5,
+    0xa7, 0x2e, 0x5a, 0x51, 0x10, 0xff, 0xf7, 0x01,
+    0x87, 0x34, 0x7b, 0x66
+  };
   unsigned char buf[200];
-  size_t result;
+  size_t result_len;
   
-  result = dtls_prf(key, sizeof(key),
-		    label, sizeof(label),
-		    random1, sizeof(random1),
-		    random2, sizeof(random2),
-		    buf, 100);
-
-  printf("PRF yields %zu bytes of random data:\n", result);
-  hexdump(buf, result);
+  result_len = dtls_prf(key, sizeof(key),
+			label, sizeof(label),
+			random1, sizeof(random1),
+			random2, sizeof(random2),
+			buf, 100);
+
+  printf("PRF yields %zu bytes of random data:\n", result_len);
+  hexdump(buf, result_len);
   printf("\n");
-  return 0;
+  result("prf", result_len == sizeof(expected)
+	 && memcmp(buf, expected, sizeof(expected)) == 0);
+
+  key_schedule_test();
+  speed();
+
+  return test_summary();
 }
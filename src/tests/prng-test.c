@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+
+#include "tinydtls.h"
+#include "prng.h"
+#include "test-util.h"
+
+/* Every byte value must occur about equally often in 1 MB of output,
+ * requested in pieces of various sizes that do not line up with the
+ * batches of the generator. The chi-square statistic with 255 degrees
+ * of freedom exceeds 400 with a probability of less than 1e-8. */
+static void
+distribution_test(void) {
+  static unsigned char buf[1 << 20];
+  unsigned long count[256];
+  double chi2 = 0, e = sizeof(buf) / 256.0;
+  size_t i, n;
+  int ok = 1;
+
+  memset(count, 0, sizeof(count));
+  for (i = 0; i < sizeof(buf); i += n) {
+    n = 1 + (i * 7) % 1000;
+    if (n > sizeof(buf) - i)
+      n = sizeof(buf) - i;
+    ok &= dtls_prng(buf + i, n);
+  }
+  for (i = 0; i < sizeof(buf); i++)
+    count[buf[i]]++;
+  for (i = 0; i < 256; i++)
+    chi2 += (count[i] - e) * (count[i] - e) / e;
+  result("byte distribution", ok && chi2 < 400);
+}
+
+/* after fork() the child must not repeat the output of the parent */
+static void
+fork_test(void) {
+  unsigned char parent[32], child[32], warmup[8];
+  int fd[2], status, ok = 0;
+  pid_t pid;
+
+  dtls_prng(warmup, sizeof(warmup));
+  if (pipe(fd) < 0)
+    goto done;
+  pid = fork();
+  if (pid < 0)
+    goto done;
+  if (pid == 0) {
+    dtls_prng(child, sizeof(child));
+    _exit(write(fd[1], child, sizeof(child)) != sizeof(child));
+  }
+  dtls_prng(parent, sizeof(parent));
+  ok = read(fd[0], child, sizeof(child)) == sizeof(child)
+    && waitpid(pid, &status, 0) == pid
+    && memcmp(parent, child, sizeof(child)) != 0;
+  close(fd[0]);
+  close(fd[1]);
+
+ done:
+  result("fork", ok);
+}
+
+/* the threads have their own generators */
+static void *
+thread_main(void *arg) {
+  dtls_prng(arg, 32);
+  return NULL;
+}
+
+static void
+thread_test(void) {
+  unsigned char out[4][32];
+  pthread_t thread[4];
+  int i, j, ok = 1;
+
+  for (i = 0; i < 4; i++)
+    ok &= pthread_create(&thread[i], NULL, thread_main, out[i]) == 0;
+  for (i = 0; i < 4 && ok; i++)
+    pthread_join(thread[i], NULL);
+  for (i = 0; i < 4 && ok; i++)
+    for (j = 0; j < i; j++)
+      ok &= memcmp(out[i], out[j], sizeof(out[i])) != 0;
+  result("threads", ok);
+}
+
+/* speed for requests of the size of a DTLS random and of a P-256 key */
+static void
+speed(size_t len) {
+  unsigned char buf[64];
+  struct timeval start, end;
+  double secs;
+  long i, n = 1000000 / len * 16;
+
+  gettimeofday(&start, NULL);
+  for (i = 0; i < n; i++)
+    dtls_prng(buf, len);
+  gettimeofday(&end, NULL);
+  secs = (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1e6;
+  printf("%2u bytes: %.0f ns per call (%.1f MB/s)\n", (unsigned int)len,
+	 secs * 1e9 / n, n * len / secs / 1e6);
+}
+
+int
+main(void) {
+  distribution_test();
+  fork_test();
+  thread_test();
+  speed(28);
+  speed(32);
+
+  return test_summary();
+}
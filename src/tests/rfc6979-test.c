@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "tinydtls.h"
+#include "dtls_debug.h"
+#include "crypto.h"
+
+static int failed = 0;
+
+static int
+fromhex(unsigned char *buf, const char *hex) {
+  int len = 0;
+  unsigned int byte;
+
+  while (*hex && sscanf(hex, "%2x", &byte) == 1) {
+    buf[len++] = byte;
+    hex += 2;
+  }
+  return len;
+}
+
+/* r and s are returned as little-endian words */
+static void
+from_words(unsigned char *buf, const uint32_t *words) {
+  int i;
+
+  for (i = 0; i < 8; i++) {
+    buf[4 * i] = words[7 - i] >> 24;
+    buf[4 * i + 1] = words[7 - i] >> 16;
+    buf[4 * i + 2] = words[7 - i] >> 8;
+    buf[4 * i + 3] = words[7 - i];
+  }
+}
+
+/* test vectors from RFC 6979, section A.2.5, and one more key */
+static const struct {
+  const char *name;
+  const char *priv;
+  const char *pub_x;
+  const char *pub_y;
+  const char *msg;
+  const char *r;
+  const char *s;
+} vectors[] = {
+  { "sample",
+    "C9AFA9D845BA75166B5C215767B1D6934E50C3DB36E89B127B8A622B120F6721",
+    "60FED4BA255A9D31C961EB74C6356D68C049B8923B61FA6CE669622E60F29FB6",
+    "7903FE1008B8BC99A41AE9E95628BC64F2F1B20C2D7E9F5177A3C294D4462299",
+    "sample",
+    "EFD48B2AACB6A8FD1140DD9CD45E81D69D2C877B56AAF991C34D0EA84EAF3716",
+    "F7CB1C942D657C41D436C7A1B6E29F65F3E900DBB9AFF4064DC4AB2F843ACDA8" },
+  { "test",
+    "C9AFA9D845BA75166B5C215767B1D6934E50C3DB36E89B127B8A622B120F6721",
+    "60FED4BA255A9D31C961EB74C6356D68C049B8923B61FA6CE669622E60F29FB6",
+    "7903FE1008B8BC99A41AE9E95628BC64F2F1B20C2D7E9F5177A3C294D4462299",
+    "test",
+    "F1ABB023518351CD71D881567B1EA663ED3EFCF6C5132B354F28D3B0B7D38367",
+    "019F4113742A2B14BD25926B49C649155F267E60D3814B4C0CC84250E46F0083" },
+  { "other key",
+    "0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF",
+    NULL, NULL,
+    "sample",
+    "E7DB36E5358836028AE34F7533C0681AB2B4F9265B7DD492C19777861449AEA5",
+    "185BA52F3E64599388F39AA7DB8517ADE20877A6570E561DE302F993C6ED6AD2" },
+  /* the cached state of the first key has been replaced */
+  { "sample again",
+    "C9AFA9D845BA75166B5C215767B1D6934E50C3DB36E89B127B8A622B120F6721",
+    "60FED4BA255A9D31C961EB74C6356D68C049B8923B61FA6CE669622E60F29FB6",
+    "7903FE1008B8BC99A41AE9E95628BC64F2F1B20C2D7E9F5177A3C294D4462299",
+    "sample",
+    "EFD48B2AACB6A8FD1140DD9CD45E81D69D2C877B56AAF991C34D0EA84EAF3716",
+    "F7CB1C942D657C41D436C7A1B6E29F65F3E900DBB9AFF4064DC4AB2F843ACDA8" },
+};
+
+static void
+sign_test(int i) {
+  unsigned char priv[DTLS_EC_KEY_SIZE], pub_x[DTLS_EC_KEY_SIZE];
+  unsigned char pub_y[DTLS_EC_KEY_SIZE], hash[DTLS_HMAC_DIGEST_SIZE];
+  unsigned char r[DTLS_EC_KEY_SIZE], s[DTLS_EC_KEY_SIZE];
+  unsigned char expected_r[DTLS_EC_KEY_SIZE], expected_s[DTLS_EC_KEY_SIZE];
+  uint32_t point_r[9], point_s[9];
+  dtls_hash_ctx ctx;
+  int ok;
+
+  fromhex(priv, vectors[i].priv);
+  fromhex(expected_r, vectors[i].r);
+  fromhex(expected_s, vectors[i].s);
+  dtls_hash_init(&ctx);
+  dtls_hash_update(&ctx, (const unsigned char *)vectors[i].msg,
+		   strlen(vectors[i].msg));
+  dtls_hash_finalize(hash, &ctx);
+
+  dtls_ecdsa_create_sig_hash(priv, sizeof(priv), hash, sizeof(hash),
+			     point_r, point_s);
+  from_words(r, point_r);
+  from_words(s, point_s);
+  ok = !memcmp(r, expected_r, sizeof(r)) && !memcmp(s, expected_s, sizeof(s));
+
+  if (ok && vectors[i].pub_x) {
+    fromhex(pub_x, vectors[i].pub_x);
+    fromhex(pub_y, vectors[i].pub_y);
+    ok = dtls_ecdsa_verify_sig_hash(pub_x, pub_y, sizeof(pub_x),
+				    hash, sizeof(hash), r, s) == 0;
+  }
+
+  if (ok) {
+    printf("%s: ok\n", vectors[i].name);
+  } else {
+    printf("%s: FAILED\n", vectors[i].name);
+    hexdump(r, sizeof(r));
+    printf("\n");
+    hexdump(s, sizeof(s));
+    printf("\n");
+    failed++;
+  }
+}
+
+int
+main(void) {
+  unsigned int i;
+
+  /* nonces from the pool are random */
+  dtls_ecdsa_sign_pool_configure(0, 0);
+  for (i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++)
+    sign_test(i);
+
+  /* and again once the cached state has been cleared */
+  dtls_ecdsa_sign_cache_clear();
+  sign_test(0);
+
+  printf("%s\n", failed ? "Tests FAILED." : "All Tests successful.");
+  return failed ? 1 : 0;
+}
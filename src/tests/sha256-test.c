@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "tinydtls.h"
+#include "dtls_debug.h"
+#include "sha2/sha2.h"
+#include "hmac.h"
+
+static int failed = 0;
+
+static int
+fromhex(unsigned char *buf, const char *hex) {
+  int len = 0;
+  unsigned int byte;
+
+  while (*hex && sscanf(hex, "%2x", &byte) == 1) {
+    buf[len++] = byte;
+    hex += 2;
+  }
+  return len;
+}
+
+static void
+check(const char *name, const unsigned char *result,
+      const unsigned char *expected, size_t len) {
+  if (memcmp(result, expected, len)) {
+    printf("%s: FAILED\n", name);
+    hexdump(result, len);
+    printf("\n");
+    failed++;
+  } else {
+    printf("%s: ok\n", name);
+  }
+}
+
+/* hashes len bytes of msg, passed to dtls_sha256_update() in chunks of
+ * at most chunk bytes */
+static void
+sha256(unsigned char *digest, const unsigned char *msg, size_t len,
+       size_t chunk) {
+  dtls_sha256_ctx ctx;
+  size_t n;
+
+  dtls_sha256_init(&ctx);
+  while (len > 0) {
+    n = len < chunk ? len : chunk;
+    dtls_sha256_update(&ctx, msg, n);
+    msg += n;
+    len -= n;
+  }
+  dtls_sha256_final(digest, &ctx);
+}
+
+/* FIPS 180-4 examples and the one million times 'a' of FIPS 180-2 */
+static void
+vector_test(const char *backend) {
+  static unsigned char msg[1000];
+  unsigned char digest[DTLS_SHA256_DIGEST_LENGTH];
+  unsigned char expected[DTLS_SHA256_DIGEST_LENGTH];
+  char name[80];
+  dtls_sha256_ctx ctx;
+  int i;
+
+  fromhex(expected, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  sha256(digest, (const unsigned char *)"abc", 3, 3);
+  snprintf(name, sizeof(name), "%s: \"abc\"", backend);
+  check(name, digest, expected, sizeof(digest));
+
+  fromhex(expected, "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+  sha256(digest, (const unsigned char *)
+	 "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 56, 56);
+  snprintf(name, sizeof(name), "%s: two blocks", backend);
+  check(name, digest, expected, sizeof(digest));
+
+  fromhex(expected, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+  memset(msg, 'a', sizeof(msg));
+  dtls_sha256_init(&ctx);
+  for (i = 0; i < 1000; i++)
+    dtls_sha256_update(&ctx, msg, sizeof(msg));
+  dtls_sha256_final(digest, &ctx);
+  snprintf(name, sizeof(name), "%s: one million 'a'", backend);
+  check(name, digest, expected, sizeof(digest));
+}
+
+/* dtls_sha256_mb() must give the same digests as one message at a time,
+ * for 1 to DTLS_SHA256_MB_MAX messages of different lengths (so that
+ * the lanes finish at different blocks), with and without a prefix;
+ * dtls_hmac_mb() the same MACs as dtls_hmac_init() and friends */
+static void
+mb_test(const char *backend) {
+  unsigned char buf[5 * DTLS_SHA256_BLOCK_LENGTH];
+  unsigned char md[DTLS_SHA256_MB_MAX][DTLS_SHA256_DIGEST_LENGTH];
+  unsigned char expected[DTLS_SHA256_DIGEST_LENGTH];
+  const unsigned char *msg[DTLS_SHA256_MB_MAX];
+  unsigned char *digest[DTLS_SHA256_MB_MAX];
+  size_t len[DTLS_SHA256_MB_MAX];
+  dtls_sha256_ctx prefix, ctx;
+  dtls_hmac_context_t hmac;
+  char name[80];
+  int i, n, round, err = 0;
+
+  for (i = 0; i < (int)sizeof(buf); i++)
+    buf[i] = (unsigned char)(i * 29 + 7);
+  dtls_sha256_init(&prefix);
+  dtls_sha256_update(&prefix, buf + 100, DTLS_SHA256_BLOCK_LENGTH);
+
+  for (round = 0; round < 40; round++) {
+    for (n = 1; n <= DTLS_SHA256_MB_MAX; n++) {
+      for (i = 0; i < n; i++) {
+	msg[i] = buf + i;
+	len[i] = (size_t)(round * 7 + i * 23) % (sizeof(buf) - i);
+	digest[i] = md[i];
+      }
+
+      dtls_sha256_mb(NULL, n, msg, len, digest);
+      for (i = 0; i < n; i++) {
+	sha256(expected, msg[i], len[i], len[i] + 1);
+	err += memcmp(md[i], expected, sizeof(expected)) != 0;
+      }
+
+      dtls_sha256_mb(&prefix, n, msg, len, digest);
+      for (i = 0; i < n; i++) {
+	ctx = prefix;
+	dtls_sha256_update(&ctx, msg[i], len[i]);
+	dtls_sha256_final(expected, &ctx);
+	err += memcmp(md[i], expected, sizeof(expected)) != 0;
+      }
+
+      /* keys shorter and longer than a block */
+      dtls_hmac_mb(buf + round, round * 3, n, msg, len, digest);
+      for (i = 0; i < n; i++) {
+	dtls_hmac_init(&hmac, buf + round, round * 3);
+	dtls_hmac_update(&hmac, msg[i], len[i]);
+	dtls_hmac_finalize(&hmac, expected);
+	err += memcmp(md[i], expected, sizeof(expected)) != 0;
+      }
+    }
+  }
+  snprintf(name, sizeof(name), "%s: multi-buffer", backend);
+  if (err) {
+    printf("%s: FAILED\n", name);
+    failed++;
+  } else {
+    printf("%s: ok\n", name);
+  }
+}
+
+#ifdef SHA2_X86
+/* every backend must give the same digest as the portable C version for
+ * all lengths up to five blocks, whole or split into odd chunks */
+static void
+backend_test(int impl, const char *backend) {
+  unsigned char msg[5 * DTLS_SHA256_BLOCK_LENGTH + 1];
+  unsigned char digest[DTLS_SHA256_DIGEST_LENGTH];
+  unsigned char expected[DTLS_SHA256_DIGEST_LENGTH];
+  size_t len, err = 0;
+
+  for (len = 0; len < sizeof(msg); len++)
+    msg[len] = (unsigned char)(len * 73 + 11);
+  for (len = 0; len < sizeof(msg); len++) {
+    dtls_sha256_select(DTLS_SHA256_C);
+    sha256(expected, msg, len, len + 1);
+    dtls_sha256_select(impl);
+    sha256(digest, msg, len, len + 1);
+    err += memcmp(digest, expected, sizeof(digest)) != 0;
+    sha256(digest, msg, len, 37);
+    err += memcmp(digest, expected, sizeof(digest)) != 0;
+  }
+  if (err) {
+    printf("%s: lengths 0 to %u: FAILED\n", backend,
+	   (unsigned int)sizeof(msg) - 1);
+    failed++;
+  } else {
+    printf("%s: lengths 0 to %u: ok\n", backend,
+	   (unsigned int)sizeof(msg) - 1);
+  }
+}
+#endif /* SHA2_X86 */
+
+int
+main(void) {
+#ifdef SHA2_X86
+  const char *names[] = { "C", "SSE2", "AVX2", "SHA-NI" };
+  int impl;
+
+  for (impl = DTLS_SHA256_C; impl <= DTLS_SHA256_SHANI; impl++) {
+    if (dtls_sha256_select(impl) != impl) {
+      printf("%s: not supported by this CPU\n", names[impl]);
+      continue;
+    }
+    vector_test(names[impl]);
+    backend_test(impl, names[impl]);
+    mb_test(names[impl]);
+  }
+  dtls_sha256_select(DTLS_SHA256_BEST);
+#else /* SHA2_X86 */
+  vector_test("C");
+  mb_test("C");
+#endif /* SHA2_X86 */
+
+  printf("%s\n", failed ? "Tests FAILED." : "All Tests successful.");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,55 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2011, 2012, 2013, 2014, 2015 Olaf Bergmann (TZI) and others.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v. 1.0 which accompanies this distribution.
+ *
+ * The Eclipse Public License is available at http://www.eclipse.org/legal/epl-v10.html
+ * and the Eclipse Distribution License is available at
+ * http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ *******************************************************************************/
+
+/* helpers shared by the test programs that report one line per check */
+
+#ifndef _DTLS_TEST_UTIL_H_
+#define _DTLS_TEST_UTIL_H_
+
+#include <stdio.h>
+
+/** number of failed checks */
+static int failed = 0;
+
+/** Prints "name: ok" or "name: FAILED" and counts the failures. */
+static inline void
+result(const char *name, int ok) {
+  if (ok) {
+    printf("%s: ok\n", name);
+  } else {
+    printf("%s: FAILED\n", name);
+    failed++;
+  }
+}
+
+/** Reads the hex string @p hex into @p buf and returns its length. */
+static inline size_t
+unhex(const char *hex, unsigned char *buf) {
+  size_t n = 0;
+  unsigned int b;
+
+  while (hex[0] && hex[1] && sscanf(hex, "%2x", &b) == 1) {
+    buf[n++] = b;
+    hex += 2;
+  }
+  return n;
+}
+
+/** Prints the summary line and returns the exit status for main(). */
+static inline int
+test_summary(void) {
+  printf("%s\n", failed ? "Tests FAILED." : "All Tests successful.");
+  return failed ? 1 : 0;
+}
+
+#endif /* _DTLS_TEST_UTIL_H_ */